@@ -0,0 +1,304 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob_file_builder.h"
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#include <inttypes.h>
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "db/blob_source.h"
+#include "db/dbformat.h"
+#include "db/version_edit.h"
+#include "db/version_set.h"
+#include "monitoring/statistics.h"
+#include "table/block_based_table_builder.h"
+#include "util/compression.h"
+#include "util/file_reader_writer.h"
+#include "util/filename.h"
+#include "util/logging.h"
+#include "util/stop_watch.h"
+#include "utilities/blob_db/blob_index.h"
+#include "utilities/blob_db/blob_log_format.h"
+
+namespace rocksdb {
+
+BlobFileBuilder::BlobFileBuilder(VersionSet* versions, Env* env,
+                                 const EnvOptions& env_options,
+                                 const ImmutableCFOptions& ioptions,
+                                 uint32_t column_family_id,
+                                 BlobSource* blob_source,
+                                 uint64_t gc_cutoff_file_number,
+                                 Env::IOPriority io_priority,
+                                 Env::WriteLifeTimeHint write_hint)
+    : versions_(versions),
+      env_(env),
+      env_options_(env_options),
+      ioptions_(ioptions),
+      column_family_id_(column_family_id),
+      blob_source_(blob_source),
+      gc_cutoff_file_number_(gc_cutoff_file_number),
+      io_priority_(io_priority),
+      write_hint_(write_hint),
+      file_number_(0),
+      file_size_(0),
+      blob_count_(0),
+      smallest_seqno_(kMaxSequenceNumber),
+      largest_seqno_(0),
+      has_written_files_(false) {}
+
+// An unfinished blob file is not referred to by any table, so it is deleted
+// as an obsolete file once the job's pending outputs are released.
+BlobFileBuilder::~BlobFileBuilder() {}
+
+#ifndef ROCKSDB_LITE
+namespace {
+
+void AddBlobFileNumber(FileMetaData* meta, uint64_t file_number) {
+  std::vector<uint64_t>& numbers = meta->blob_file_numbers;
+  auto it = std::lower_bound(numbers.begin(), numbers.end(), file_number);
+  if (it == numbers.end() || *it != file_number) {
+    numbers.insert(it, file_number);
+  }
+}
+
+}  // namespace
+
+Status BlobFileBuilder::Add(Slice* key, Slice* value, FileMetaData* meta) {
+  ParsedInternalKey ikey;
+  if (!ParseInternalKey(*key, &ikey)) {
+    // Corrupted keys are passed through to the table, as they are without
+    // blob files
+    return Status::OK();
+  }
+  if (ikey.type == kTypeValue) {
+    if (!ioptions_.enable_blob_files ||
+        value->size() < ioptions_.min_blob_size) {
+      return Status::OK();
+    }
+    return WriteBlob(ikey, *value, key, value, meta);
+  }
+  if (ikey.type != kTypeBlobIndex) {
+    return Status::OK();
+  }
+
+  blob_db::BlobIndex index;
+  Status s = index.DecodeFrom(*value);
+  if (!s.ok()) {
+    return s;
+  }
+  if (index.HasTTL() || index.IsInlined()) {
+    return Status::Corruption("Unexpected TTL blob index for key ",
+                              ikey.user_key);
+  }
+  if (index.file_number() >= gc_cutoff_file_number_) {
+    AddBlobFileNumber(meta, index.file_number());
+    return Status::OK();
+  }
+
+  // The blob file is old enough to be garbage collected, so the value is
+  // moved to the current one or back into the table
+  PinnableSlice blob;
+  s = blob_source_->GetBlob(ReadOptions(), ikey.user_key, *value, &blob);
+  if (!s.ok()) {
+    return s;
+  }
+  RecordTick(ioptions_.statistics, BLOB_DB_GC_NUM_KEYS_RELOCATED);
+  RecordTick(ioptions_.statistics, BLOB_DB_GC_BYTES_RELOCATED, blob.size());
+  if (blob.size() >= ioptions_.min_blob_size) {
+    return WriteBlob(ikey, blob, key, value, meta);
+  }
+  key_buf_.clear();
+  AppendInternalKey(&key_buf_,
+                    ParsedInternalKey(ikey.user_key, ikey.sequence, kTypeValue));
+  value_buf_.assign(blob.data(), blob.size());
+  *key = key_buf_;
+  *value = value_buf_;
+  return Status::OK();
+}
+
+Status BlobFileBuilder::WriteBlob(const ParsedInternalKey& ikey,
+                                  const Slice& blob, Slice* key, Slice* value,
+                                  FileMetaData* meta) {
+  Status s;
+  if (writer_ == nullptr) {
+    s = OpenBlobFile();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  CompressionType compression = ioptions_.blob_compression_type;
+  Slice contents = blob;
+  if (compression != kNoCompression) {
+    StopWatch compression_sw(env_, ioptions_.statistics,
+                             BLOB_DB_COMPRESSION_MICROS);
+    contents = CompressBlock(blob, ioptions_.compression_opts, &compression,
+                             kBlobCompressionFormatVersion,
+                             CompressionDict::GetEmptyDict(),
+                             nullptr /* compression_ctx */, &compressed_buf_);
+  }
+
+  blob_db::BlobLogRecord record;
+  record.key = ikey.user_key;
+  record.value = contents;
+  record.key_size = ikey.user_key.size();
+  record.value_size = contents.size();
+  record.EncodeHeaderTo(&header_buf_);
+  s = writer_->Append(header_buf_);
+  if (s.ok()) {
+    s = writer_->Append(ikey.user_key);
+  }
+  if (s.ok()) {
+    s = writer_->Append(contents);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+  const uint64_t value_offset =
+      file_size_ + blob_db::BlobLogRecord::kHeaderSize + ikey.user_key.size();
+  file_size_ += record.record_size();
+  blob_count_++;
+  smallest_seqno_ = std::min(smallest_seqno_, ikey.sequence);
+  largest_seqno_ = std::max(largest_seqno_, ikey.sequence);
+  RecordTick(ioptions_.statistics, BLOB_DB_BLOB_FILE_BYTES_WRITTEN,
+             record.record_size());
+
+  blob_db::BlobIndex::EncodeBlob(&value_buf_, file_number_, value_offset,
+                                 contents.size(), compression);
+  key_buf_.clear();
+  AppendInternalKey(&key_buf_, ParsedInternalKey(ikey.user_key, ikey.sequence,
+                                                 kTypeBlobIndex));
+  *key = key_buf_;
+  *value = value_buf_;
+  AddBlobFileNumber(meta, file_number_);
+
+  if (file_size_ >= ioptions_.blob_file_size) {
+    s = CloseBlobFile();
+  }
+  return s;
+}
+
+Status BlobFileBuilder::OpenBlobFile() {
+  assert(writer_ == nullptr);
+  file_number_ = versions_->NewFileNumber();
+  const std::string fname =
+      BlobFileName(ioptions_.db_paths[0].path, file_number_);
+  unique_ptr<WritableFile> file;
+  Status s = NewWritableFile(env_, fname, &file, env_options_);
+  if (!s.ok()) {
+    return s;
+  }
+  file->SetIOPriority(io_priority_);
+  file->SetWriteLifeTimeHint(write_hint_);
+  writer_.reset(new WritableFileWriter(std::move(file), env_options_,
+                                       ioptions_.statistics));
+  has_written_files_ = true;
+
+  blob_db::BlobLogHeader header;
+  header.column_family_id = column_family_id_;
+  header.compression = ioptions_.blob_compression_type;
+  std::string buf;
+  header.EncodeTo(&buf);
+  s = writer_->Append(buf);
+  file_size_ = buf.size();
+  blob_count_ = 0;
+  smallest_seqno_ = kMaxSequenceNumber;
+  largest_seqno_ = 0;
+  return s;
+}
+
+Status BlobFileBuilder::CloseBlobFile() {
+  assert(writer_ != nullptr);
+  blob_db::BlobLogFooter footer;
+  footer.blob_count = blob_count_;
+  footer.sequence_range = std::make_pair(smallest_seqno_, largest_seqno_);
+  std::string buf;
+  footer.EncodeTo(&buf);
+  Status s = writer_->Append(buf);
+  if (s.ok()) {
+    StopWatch sync_sw(env_, ioptions_.statistics,
+                      BLOB_DB_BLOB_FILE_SYNC_MICROS);
+    s = writer_->Sync(ioptions_.use_fsync);
+  }
+  if (s.ok()) {
+    s = writer_->Close();
+  }
+  writer_.reset();
+  if (s.ok()) {
+    ROCKS_LOG_INFO(ioptions_.info_log,
+                   "[blob file %" PRIu64 "] %" PRIu64 " blobs, %" PRIu64
+                   " bytes",
+                   file_number_, blob_count_, file_size_ + buf.size());
+  }
+  return s;
+}
+
+Status BlobFileBuilder::Finish() {
+  Status s;
+  if (writer_ != nullptr) {
+    s = CloseBlobFile();
+  }
+  if (s.ok() && has_written_files_) {
+    unique_ptr<Directory> dir;
+    s = env_->NewDirectory(ioptions_.db_paths[0].path, &dir);
+    if (s.ok()) {
+      s = dir->Fsync();
+    }
+  }
+  return s;
+}
+
+uint64_t BlobFileBuilder::GarbageCollectionCutoff(
+    const ImmutableCFOptions& ioptions, const VersionStorageInfo* vstorage) {
+  if (!ioptions.enable_blob_files ||
+      !ioptions.enable_blob_garbage_collection) {
+    return 0;
+  }
+  std::set<uint64_t> numbers;
+  for (int level = 0; level < vstorage->num_levels(); level++) {
+    for (const auto* f : vstorage->LevelFiles(level)) {
+      numbers.insert(f->blob_file_numbers.begin(), f->blob_file_numbers.end());
+    }
+  }
+  if (numbers.empty()) {
+    return 0;
+  }
+  // Blob file numbers grow with time, so the oldest files come first
+  const size_t cutoff_index = static_cast<size_t>(
+      numbers.size() * ioptions.blob_garbage_collection_age_cutoff);
+  if (cutoff_index >= numbers.size()) {
+    return *numbers.rbegin() + 1;
+  }
+  auto it = numbers.begin();
+  std::advance(it, cutoff_index);
+  return *it;
+}
+
+#else   // ROCKSDB_LITE
+
+Status BlobFileBuilder::Add(Slice* /*key*/, Slice* /*value*/,
+                            FileMetaData* /*meta*/) {
+  return Status::NotSupported("Blob files are not supported in ROCKSDB_LITE");
+}
+
+Status BlobFileBuilder::Finish() {
+  return Status::NotSupported("Blob files are not supported in ROCKSDB_LITE");
+}
+
+uint64_t BlobFileBuilder::GarbageCollectionCutoff(
+    const ImmutableCFOptions& /*ioptions*/,
+    const VersionStorageInfo* /*vstorage*/) {
+  return 0;
+}
+
+#endif  // ROCKSDB_LITE
+
+}  // namespace rocksdb
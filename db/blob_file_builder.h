@@ -0,0 +1,100 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+#include "options/cf_options.h"
+#include "rocksdb/env.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "rocksdb/types.h"
+
+namespace rocksdb {
+
+class BlobSource;
+class VersionSet;
+class VersionStorageInfo;
+class WritableFileWriter;
+struct FileMetaData;
+struct ParsedInternalKey;
+
+// Moves the large values of the entries that a flush or a compaction writes
+// to table files into blob files (see ColumnFamilyOptions::enable_blob_files),
+// leaving kTypeBlobIndex entries that point at them in the tables. It also
+// relocates the values still stored in the oldest blob files, so that these
+// files can be deleted once no table refers to them.
+//
+// Not thread-safe; every flush job or subcompaction uses its own builder.
+class BlobFileBuilder {
+ public:
+  // The values of the blob indexes that refer to a blob file numbered below
+  // gc_cutoff_file_number are relocated. Blob file numbers are allocated from
+  // versions.
+  BlobFileBuilder(VersionSet* versions, Env* env,
+                  const EnvOptions& env_options,
+                  const ImmutableCFOptions& ioptions,
+                  uint32_t column_family_id, BlobSource* blob_source,
+                  uint64_t gc_cutoff_file_number,
+                  Env::IOPriority io_priority = Env::IO_HIGH,
+                  Env::WriteLifeTimeHint write_hint = Env::WLTH_NOT_SET);
+  ~BlobFileBuilder();
+
+  // Must be called for every entry before it is added to the table file that
+  // meta describes. If the entry is to be stored differently, *key and *value
+  // are pointed at the replacement, which stays valid until the next call.
+  // The blob files that the entry refers to are added to
+  // meta->blob_file_numbers.
+  Status Add(Slice* key, Slice* value, FileMetaData* meta);
+
+  // Syncs and closes the blob files written. Must be called after the last
+  // Add() and before the table files are installed.
+  Status Finish();
+
+  // Returns the number below which blob files are old enough to have their
+  // values relocated by a compaction of vstorage, according to
+  // ioptions.blob_garbage_collection_age_cutoff, or 0 if there are none.
+  static uint64_t GarbageCollectionCutoff(const ImmutableCFOptions& ioptions,
+                                          const VersionStorageInfo* vstorage);
+
+ private:
+  Status WriteBlob(const ParsedInternalKey& ikey, const Slice& blob,
+                   Slice* key, Slice* value, FileMetaData* meta);
+  Status OpenBlobFile();
+  Status CloseBlobFile();
+
+  VersionSet* const versions_;
+  Env* const env_;
+  const EnvOptions& env_options_;
+  const ImmutableCFOptions& ioptions_;
+  const uint32_t column_family_id_;
+  BlobSource* const blob_source_;
+  const uint64_t gc_cutoff_file_number_;
+  const Env::IOPriority io_priority_;
+  const Env::WriteLifeTimeHint write_hint_;
+
+  // The blob file being written, if any
+  std::unique_ptr<WritableFileWriter> writer_;
+  uint64_t file_number_;
+  uint64_t file_size_;
+  uint64_t blob_count_;
+  SequenceNumber smallest_seqno_;
+  SequenceNumber largest_seqno_;
+  bool has_written_files_;
+
+  // Backing storage for the replaced key and value
+  std::string key_buf_;
+  std::string value_buf_;
+  std::string header_buf_;
+  std::string compressed_buf_;
+
+  // No copying allowed
+  BlobFileBuilder(const BlobFileBuilder&) = delete;
+  void operator=(const BlobFileBuilder&) = delete;
+};
+
+}  // namespace rocksdb
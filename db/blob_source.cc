@@ -0,0 +1,177 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/blob_source.h"
+
+#include <memory>
+
+#include "monitoring/statistics.h"
+#include "table/format.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/file_reader_writer.h"
+#include "util/filename.h"
+#include "util/stop_watch.h"
+#include "utilities/blob_db/blob_index.h"
+#include "utilities/blob_db/blob_log_format.h"
+
+namespace rocksdb {
+
+#ifndef ROCKSDB_LITE
+namespace {
+
+// Table readers are cached under the 8 bytes of their file number, so blob
+// file readers are given a 9 byte key to stay apart from them.
+std::string BlobCacheKey(uint64_t file_number) {
+  std::string key;
+  PutFixed64(&key, file_number);
+  key.push_back('b');
+  return key;
+}
+
+void DeleteBlobFileReader(const Slice& /*key*/, void* value) {
+  delete reinterpret_cast<RandomAccessFileReader*>(value);
+}
+
+}  // namespace
+#endif  // ROCKSDB_LITE
+
+BlobSource::BlobSource(const ImmutableCFOptions& ioptions,
+                       const EnvOptions& env_options, Cache* const cache)
+    : ioptions_(ioptions), env_options_(env_options), cache_(cache) {}
+
+BlobSource::~BlobSource() {}
+
+#ifndef ROCKSDB_LITE
+Status BlobSource::FindBlobFile(uint64_t file_number, bool no_io,
+                                Cache::Handle** handle) {
+  const std::string key = BlobCacheKey(file_number);
+  *handle = cache_->Lookup(key);
+  if (*handle != nullptr) {
+    return Status::OK();
+  }
+  if (no_io) {
+    return Status::Incomplete("Blob file not found in table_cache, no_io is set");
+  }
+
+  const std::string fname =
+      BlobFileName(ioptions_.db_paths[0].path, file_number);
+  unique_ptr<RandomAccessFile> file;
+  Status s = ioptions_.env->NewRandomAccessFile(fname, &file, env_options_);
+  RecordTick(ioptions_.statistics, NO_FILE_OPENS);
+  if (!s.ok()) {
+    RecordTick(ioptions_.statistics, NO_FILE_ERRORS);
+    return s;
+  }
+  if (ioptions_.advise_random_on_open) {
+    file->Hint(RandomAccessFile::RANDOM);
+  }
+  std::unique_ptr<RandomAccessFileReader> reader(new RandomAccessFileReader(
+      std::move(file), fname, ioptions_.env, ioptions_.statistics,
+      BLOB_DB_BLOB_FILE_READ_MICROS));
+  s = cache_->Insert(key, reader.get(), 1, &DeleteBlobFileReader, handle);
+  if (s.ok()) {
+    reader.release();
+  }
+  return s;
+}
+
+Status BlobSource::GetBlob(const ReadOptions& read_options,
+                           const Slice& user_key, const Slice& blob_index,
+                           PinnableSlice* value) {
+  blob_db::BlobIndex index;
+  Status s = index.DecodeFrom(blob_index);
+  if (!s.ok()) {
+    return s;
+  }
+  if (index.HasTTL() || index.IsInlined()) {
+    return Status::Corruption("Unexpected TTL blob index for key ",
+                              user_key);
+  }
+  // The blob CRC, the last field of the record header, is read along with
+  // the key and the value
+  const uint64_t header_tail = sizeof(uint32_t) + user_key.size();
+  if (index.offset() < blob_db::BlobLogHeader::kSize +
+                           blob_db::BlobLogRecord::kHeaderSize +
+                           user_key.size()) {
+    return Status::Corruption("Invalid blob offset for key ", user_key);
+  }
+
+  Cache::Handle* handle = nullptr;
+  s = FindBlobFile(index.file_number(),
+                   read_options.read_tier == kBlockCacheTier, &handle);
+  if (!s.ok()) {
+    return s;
+  }
+  auto* reader = reinterpret_cast<RandomAccessFileReader*>(cache_->Value(handle));
+  const size_t n = static_cast<size_t>(header_tail + index.size());
+  std::unique_ptr<char[]> scratch(new char[n]);
+  Slice record;
+  s = reader->Read(index.offset() - header_tail, n, &record, scratch.get());
+  cache_->Release(handle);
+  if (!s.ok()) {
+    return s;
+  }
+  RecordTick(ioptions_.statistics, BLOB_DB_BLOB_FILE_BYTES_READ,
+             record.size());
+  if (record.size() != n) {
+    return Status::Corruption("Truncated blob file for key ", user_key);
+  }
+  if (Slice(record.data() + sizeof(uint32_t), user_key.size()) != user_key) {
+    return Status::Corruption("Blob index points at another key for key ",
+                              user_key);
+  }
+  if (read_options.verify_checksums) {
+    const uint32_t expected = crc32c::Unmask(DecodeFixed32(record.data()));
+    const uint32_t actual = crc32c::Value(record.data() + sizeof(uint32_t),
+                                          n - sizeof(uint32_t));
+    if (actual != expected) {
+      return Status::Corruption("Blob CRC mismatch for key ", user_key);
+    }
+  }
+
+  const Slice blob(record.data() + header_tail,
+                   static_cast<size_t>(index.size()));
+  if (index.compression() == kNoCompression) {
+    value->PinSelf(blob);
+    return Status::OK();
+  }
+  BlockContents contents;
+  {
+    StopWatch decompression_sw(ioptions_.env, ioptions_.statistics,
+                               BLOB_DB_DECOMPRESSION_MICROS);
+    s = UncompressBlockContentsForCompressionType(
+        blob.data(), blob.size(), &contents, kBlobCompressionFormatVersion,
+        UncompressionDict::GetEmptyDict(), index.compression(), ioptions_);
+  }
+  if (s.ok()) {
+    value->PinSelf(contents.data);
+  }
+  return s;
+}
+
+void BlobSource::Evict(Cache* cache, uint64_t file_number) {
+  cache->Erase(BlobCacheKey(file_number));
+}
+
+#else   // ROCKSDB_LITE
+
+Status BlobSource::FindBlobFile(uint64_t /*file_number*/, bool /*no_io*/,
+                                Cache::Handle** /*handle*/) {
+  return Status::NotSupported("Blob files are not supported in ROCKSDB_LITE");
+}
+
+Status BlobSource::GetBlob(const ReadOptions& /*read_options*/,
+                           const Slice& /*user_key*/,
+                           const Slice& /*blob_index*/,
+                           PinnableSlice* /*value*/) {
+  return Status::NotSupported("Blob files are not supported in ROCKSDB_LITE");
+}
+
+void BlobSource::Evict(Cache* /*cache*/, uint64_t /*file_number*/) {}
+
+#endif  // ROCKSDB_LITE
+
+}  // namespace rocksdb
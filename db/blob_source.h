@@ -0,0 +1,55 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// Thread-safe (provides internal synchronization)
+
+#pragma once
+#include <stdint.h>
+#include <string>
+
+#include "options/cf_options.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/env.h"
+#include "rocksdb/options.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace rocksdb {
+
+class RandomAccessFileReader;
+
+// The compression format version of the values in blob files, the same as
+// BlobDB uses
+constexpr uint32_t kBlobCompressionFormatVersion = 2;
+
+// Reads the values that flushes and compactions moved to blob files (see
+// ColumnFamilyOptions::enable_blob_files), given the kTypeBlobIndex entries
+// found in the table files. The open blob files are kept in the table cache,
+// next to the table readers of the same DB.
+class BlobSource {
+ public:
+  BlobSource(const ImmutableCFOptions& ioptions,
+             const EnvOptions& env_options, Cache* cache);
+  ~BlobSource();
+
+  // Reads the value that blob_index, the value of a kTypeBlobIndex entry for
+  // user_key, points at into *value. Returns Incomplete if the blob file is
+  // not open yet and read_options.read_tier is kBlockCacheTier.
+  Status GetBlob(const ReadOptions& read_options, const Slice& user_key,
+                 const Slice& blob_index, PinnableSlice* value);
+
+  // Evicts the reader of blob file file_number from cache, if it is there
+  static void Evict(Cache* cache, uint64_t file_number);
+
+ private:
+  Status FindBlobFile(uint64_t file_number, bool no_io,
+                      Cache::Handle** handle);
+
+  const ImmutableCFOptions& ioptions_;
+  const EnvOptions& env_options_;
+  Cache* const cache_;
+};
+
+}  // namespace rocksdb
@@ -13,6 +13,7 @@
 #include <deque>
 #include <vector>
 
+#include "db/blob_file_builder.h"
 #include "db/compaction_iterator.h"
 #include "db/dbformat.h"
 #include "db/event_helpers.h"
@@ -75,7 +76,8 @@ Status BuildTable(
     InternalStats* internal_stats, TableFileCreationReason reason,
     EventLogger* event_logger, int job_id, const Env::IOPriority io_priority,
     TableProperties* table_properties, int level, const uint64_t creation_time,
-    const uint64_t oldest_key_time, Env::WriteLifeTimeHint write_hint) {
+    const uint64_t oldest_key_time, Env::WriteLifeTimeHint write_hint,
+    BlobFileBuilder* blob_file_builder) {
   assert((column_family_id ==
           TablePropertiesCollectorFactory::Context::kUnknownColumnFamily) ==
          column_family_name.empty());
@@ -139,8 +141,14 @@ Status BuildTable(
         true /* internal key corruption is not ok */, range_del_agg.get());
     c_iter.SeekToFirst();
     for (; c_iter.Valid(); c_iter.Next()) {
-      const Slice& key = c_iter.key();
-      const Slice& value = c_iter.value();
+      Slice key = c_iter.key();
+      Slice value = c_iter.value();
+      if (blob_file_builder != nullptr) {
+        s = blob_file_builder->Add(&key, &value, meta);
+        if (!s.ok()) {
+          break;
+        }
+      }
       builder->Add(key, value);
       meta->UpdateBoundaries(key, c_iter.ikey().sequence);
 
@@ -157,7 +165,12 @@ Status BuildTable(
 
     // Finish and check for builder errors
     bool empty = builder->NumEntries() == 0;
-    s = c_iter.status();
+    if (s.ok()) {
+      s = c_iter.status();
+    }
+    if (s.ok() && blob_file_builder != nullptr) {
+      s = blob_file_builder->Finish();
+    }
     if (!s.ok() || empty) {
       builder->Abandon();
     } else {
@@ -26,6 +26,7 @@ namespace rocksdb {
 struct Options;
 struct FileMetaData;
 
+class BlobFileBuilder;
 class Env;
 struct EnvOptions;
 class Iterator;
@@ -80,6 +81,7 @@ extern Status BuildTable(
     const Env::IOPriority io_priority = Env::IO_HIGH,
     TableProperties* table_properties = nullptr, int level = -1,
     const uint64_t creation_time = 0, const uint64_t oldest_key_time = 0,
-    Env::WriteLifeTimeHint write_hint = Env::WLTH_NOT_SET);
+    Env::WriteLifeTimeHint write_hint = Env::WLTH_NOT_SET,
+    BlobFileBuilder* blob_file_builder = nullptr);
 
 }  // namespace rocksdb
@@ -155,6 +155,33 @@ Status CheckConcurrentWritesSupported(const ColumnFamilyOptions& cf_options) {
   return Status::OK();
 }
 
+Status CheckBlobFilesSupported(const ColumnFamilyOptions& cf_options) {
+  if (!cf_options.enable_blob_files) {
+    return Status::OK();
+  }
+#ifdef ROCKSDB_LITE
+  return Status::NotSupported("Blob files are not supported in ROCKSDB_LITE");
+#else
+  if (cf_options.merge_operator != nullptr) {
+    return Status::InvalidArgument(
+        "Blob files (enable_blob_files) are not compatible with merge "
+        "operators");
+  }
+  if (!CompressionTypeSupported(cf_options.blob_compression_type)) {
+    return Status::InvalidArgument(
+        "Compression type " +
+        CompressionTypeToString(cf_options.blob_compression_type) +
+        " is not linked with the binary.");
+  }
+  if (cf_options.blob_garbage_collection_age_cutoff < 0.0 ||
+      cf_options.blob_garbage_collection_age_cutoff > 1.0) {
+    return Status::InvalidArgument(
+        "blob_garbage_collection_age_cutoff should be between 0 and 1");
+  }
+  return Status::OK();
+#endif  // ROCKSDB_LITE
+}
+
 ColumnFamilyOptions SanitizeOptions(const ImmutableDBOptions& db_options,
                                     const ColumnFamilyOptions& src) {
   ColumnFamilyOptions result = src;
@@ -284,6 +311,20 @@ ColumnFamilyOptions SanitizeOptions(const ImmutableDBOptions& db_options,
     }
   }
 
+  if (result.level_compaction_tiered_levels != 0) {
+    // At least the last level stays leveled.
+    result.level_compaction_tiered_levels = std::min(
+        result.level_compaction_tiered_levels, result.num_levels - 1);
+    if (result.compaction_style != kCompactionStyleLevel ||
+        result.level_compaction_dynamic_level_bytes ||
+        result.level_compaction_tiered_levels < 2) {
+      // The tiered levels are fixed, so they don't work with a moving base
+      // level, and a single tiered level (L0) is what leveled compaction
+      // already does.
+      result.level_compaction_tiered_levels = 0;
+    }
+  }
+
   if (result.max_compaction_bytes == 0) {
     result.max_compaction_bytes = result.target_file_size_base * 25;
   }
@@ -385,6 +426,8 @@ ColumnFamilyData::ColumnFamilyData(
       pending_flush_(false),
       pending_compaction_(false),
       prev_compaction_needed_bytes_(0),
+      write_stall_condition_(WriteStallCondition::kNormal),
+      write_stall_cause_(WriteStallCause::kNone),
       allow_2pc_(db_options.allow_2pc) {
   Ref();
 
@@ -396,6 +439,7 @@ ColumnFamilyData::ColumnFamilyData(
     internal_stats_.reset(
         new InternalStats(ioptions_.num_levels, db_options.env, this));
     table_cache_.reset(new TableCache(ioptions_, env_options, _table_cache));
+    blob_source_.reset(new BlobSource(ioptions_, env_options, _table_cache));
     if (ioptions_.compaction_style == kCompactionStyleLevel) {
       compaction_picker_.reset(
           new LevelCompactionPicker(ioptions_, &internal_comparator_));
@@ -534,19 +578,29 @@ const double kDelayRecoverSlowdownRatio = 1.4;
 
 namespace {
 // If penalize_stop is true, we further reduce slowdown rate.
+// If per_column_family is true, only the writes to the column family are
+// delayed, under a write rate adjusted from its own.
 std::unique_ptr<WriteControllerToken> SetupDelay(
     WriteController* write_controller, uint64_t compaction_needed_bytes,
     uint64_t prev_compaction_need_bytes, bool penalize_stop,
-    bool auto_comapctions_disabled) {
+    bool auto_comapctions_disabled, bool per_column_family,
+    uint32_t column_family_id) {
   const uint64_t kMinWriteRate = 16 * 1024u;  // Minimum write rate 16KB/s.
 
   uint64_t max_write_rate = write_controller->max_delayed_write_rate();
   uint64_t write_rate = write_controller->delayed_write_rate();
+  bool needs_delay = write_controller->NeedsDelay();
+  if (per_column_family) {
+    needs_delay = write_controller->NeedsDelay(column_family_id);
+    if (needs_delay) {
+      write_rate = write_controller->delayed_write_rate(column_family_id);
+    }
+  }
 
   if (auto_comapctions_disabled) {
     // When auto compaction is disabled, always use the value user gave.
     write_rate = max_write_rate;
-  } else if (write_controller->NeedsDelay() && max_write_rate > kMinWriteRate) {
+  } else if (needs_delay && max_write_rate > kMinWriteRate) {
     // If user gives rate less than kMinWriteRate, don't adjust it.
     //
     // If already delayed, need to adjust based on previous compaction debt.
@@ -594,6 +648,9 @@ std::unique_ptr<WriteControllerToken> SetupDelay(
       }
     }
   }
+  if (per_column_family) {
+    return write_controller->GetDelayToken(column_family_id, write_rate);
+  }
   return write_controller->GetDelayToken(write_rate);
 }
 
@@ -633,19 +690,34 @@ int GetL0ThresholdSpeedupCompaction(int level0_file_num_compaction_trigger,
 WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
       const MutableCFOptions& mutable_cf_options) {
   auto write_stall_condition = WriteStallCondition::kNormal;
+  auto write_stall_cause = WriteStallCause::kNone;
   if (current_ != nullptr) {
     auto* vstorage = current_->storage_info();
     auto write_controller = column_family_set_->write_controller_;
     uint64_t compaction_needed_bytes =
         vstorage->estimated_compaction_needed_bytes();
 
-    bool was_stopped = write_controller->IsStopped();
-    bool needed_delay = write_controller->NeedsDelay();
+    const bool per_column_family =
+        column_family_set_->db_options_->per_column_family_write_stall;
+    bool was_stopped = per_column_family ? write_controller->IsStopped(id_)
+                                         : write_controller->IsStopped();
+    bool needed_delay = per_column_family ? write_controller->NeedsDelay(id_)
+                                          : write_controller->NeedsDelay();
+    auto get_stop_token = [&]() {
+      return per_column_family ? write_controller->GetStopToken(id_)
+                               : write_controller->GetStopToken();
+    };
+    // The delayed write rate that the writes to this column family get
+    auto delayed_write_rate = [&]() {
+      return per_column_family ? write_controller->delayed_write_rate(id_)
+                               : write_controller->delayed_write_rate();
+    };
 
     if (imm()->NumNotFlushed() >= mutable_cf_options.max_write_buffer_number) {
-      write_controller_token_ = write_controller->GetStopToken();
+      write_controller_token_ = get_stop_token();
       internal_stats_->AddCFStats(InternalStats::MEMTABLE_LIMIT_STOPS, 1);
       write_stall_condition = WriteStallCondition::kStopped;
+      write_stall_cause = WriteStallCause::kMemtableLimit;
       ROCKS_LOG_WARN(
           ioptions_.info_log,
           "[%s] Stopping writes because we have %d immutable memtables "
@@ -655,9 +727,10 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
     } else if (!mutable_cf_options.disable_auto_compactions &&
                vstorage->l0_delay_trigger_count() >=
                    mutable_cf_options.level0_stop_writes_trigger) {
-      write_controller_token_ = write_controller->GetStopToken();
+      write_controller_token_ = get_stop_token();
       internal_stats_->AddCFStats(InternalStats::L0_FILE_COUNT_LIMIT_STOPS, 1);
       write_stall_condition = WriteStallCondition::kStopped;
+      write_stall_cause = WriteStallCause::kL0FileCountLimit;
       if (compaction_picker_->IsLevel0CompactionInProgress()) {
         internal_stats_->AddCFStats(
             InternalStats::LOCKED_L0_FILE_COUNT_LIMIT_STOPS, 1);
@@ -669,10 +742,11 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
                mutable_cf_options.hard_pending_compaction_bytes_limit > 0 &&
                compaction_needed_bytes >=
                    mutable_cf_options.hard_pending_compaction_bytes_limit) {
-      write_controller_token_ = write_controller->GetStopToken();
+      write_controller_token_ = get_stop_token();
       internal_stats_->AddCFStats(
           InternalStats::PENDING_COMPACTION_BYTES_LIMIT_STOPS, 1);
       write_stall_condition = WriteStallCondition::kStopped;
+      write_stall_cause = WriteStallCause::kPendingCompactionBytes;
       ROCKS_LOG_WARN(
           ioptions_.info_log,
           "[%s] Stopping writes because of estimated pending compaction "
@@ -684,9 +758,11 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
       write_controller_token_ =
           SetupDelay(write_controller, compaction_needed_bytes,
                      prev_compaction_needed_bytes_, was_stopped,
-                     mutable_cf_options.disable_auto_compactions);
+                     mutable_cf_options.disable_auto_compactions,
+                     per_column_family, id_);
       internal_stats_->AddCFStats(InternalStats::MEMTABLE_LIMIT_SLOWDOWNS, 1);
       write_stall_condition = WriteStallCondition::kDelayed;
+      write_stall_cause = WriteStallCause::kMemtableLimit;
       ROCKS_LOG_WARN(
           ioptions_.info_log,
           "[%s] Stalling writes because we have %d immutable memtables "
@@ -694,7 +770,7 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
           "rate %" PRIu64,
           name_.c_str(), imm()->NumNotFlushed(),
           mutable_cf_options.max_write_buffer_number,
-          write_controller->delayed_write_rate());
+          delayed_write_rate());
     } else if (!mutable_cf_options.disable_auto_compactions &&
                mutable_cf_options.level0_slowdown_writes_trigger >= 0 &&
                vstorage->l0_delay_trigger_count() >=
@@ -705,10 +781,12 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
       write_controller_token_ =
           SetupDelay(write_controller, compaction_needed_bytes,
                      prev_compaction_needed_bytes_, was_stopped || near_stop,
-                     mutable_cf_options.disable_auto_compactions);
+                     mutable_cf_options.disable_auto_compactions,
+                     per_column_family, id_);
       internal_stats_->AddCFStats(InternalStats::L0_FILE_COUNT_LIMIT_SLOWDOWNS,
                                   1);
       write_stall_condition = WriteStallCondition::kDelayed;
+      write_stall_cause = WriteStallCause::kL0FileCountLimit;
       if (compaction_picker_->IsLevel0CompactionInProgress()) {
         internal_stats_->AddCFStats(
             InternalStats::LOCKED_L0_FILE_COUNT_LIMIT_SLOWDOWNS, 1);
@@ -717,7 +795,7 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
                      "[%s] Stalling writes because we have %d level-0 files "
                      "rate %" PRIu64,
                      name_.c_str(), vstorage->l0_delay_trigger_count(),
-                     write_controller->delayed_write_rate());
+                     delayed_write_rate());
     } else if (!mutable_cf_options.disable_auto_compactions &&
                mutable_cf_options.soft_pending_compaction_bytes_limit > 0 &&
                vstorage->estimated_compaction_needed_bytes() >=
@@ -736,16 +814,18 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
       write_controller_token_ =
           SetupDelay(write_controller, compaction_needed_bytes,
                      prev_compaction_needed_bytes_, was_stopped || near_stop,
-                     mutable_cf_options.disable_auto_compactions);
+                     mutable_cf_options.disable_auto_compactions,
+                     per_column_family, id_);
       internal_stats_->AddCFStats(
           InternalStats::PENDING_COMPACTION_BYTES_LIMIT_SLOWDOWNS, 1);
       write_stall_condition = WriteStallCondition::kDelayed;
+      write_stall_cause = WriteStallCause::kPendingCompactionBytes;
       ROCKS_LOG_WARN(
           ioptions_.info_log,
           "[%s] Stalling writes because of estimated pending compaction "
           "bytes %" PRIu64 " rate %" PRIu64,
           name_.c_str(), vstorage->estimated_compaction_needed_bytes(),
-          write_controller->delayed_write_rate());
+          delayed_write_rate());
     } else {
       if (vstorage->l0_delay_trigger_count() >=
           GetL0ThresholdSpeedupCompaction(
@@ -779,8 +859,9 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
       }
       // If the DB recovers from delay conditions, we reward with reducing
       // double the slowdown ratio. This is to balance the long term slowdown
-      // increase signal.
-      if (needed_delay) {
+      // increase signal. The delayed write rate of a column family of its own
+      // is dropped instead.
+      if (needed_delay && !per_column_family) {
         uint64_t write_rate = write_controller->delayed_write_rate();
         write_controller->set_delayed_write_rate(static_cast<uint64_t>(
             static_cast<double>(write_rate) * kDelayRecoverSlowdownRatio));
@@ -794,9 +875,39 @@ WriteStallCondition ColumnFamilyData::RecalculateWriteStallConditions(
     }
     prev_compaction_needed_bytes_ = compaction_needed_bytes;
   }
+  write_stall_condition_ = write_stall_condition;
+  write_stall_cause_ = write_stall_cause;
   return write_stall_condition;
 }
 
+std::string ColumnFamilyData::GetWriteStallReason() const {
+  std::string reason;
+  switch (write_stall_condition_) {
+    case WriteStallCondition::kNormal:
+      return "normal";
+    case WriteStallCondition::kDelayed:
+      reason = "delayed";
+      break;
+    case WriteStallCondition::kStopped:
+      reason = "stopped";
+      break;
+  }
+  switch (write_stall_cause_) {
+    case WriteStallCause::kMemtableLimit:
+      reason.append(": memtable limit");
+      break;
+    case WriteStallCause::kL0FileCountLimit:
+      reason.append(": level-0 file count limit");
+      break;
+    case WriteStallCause::kPendingCompactionBytes:
+      reason.append(": pending compaction bytes limit");
+      break;
+    case WriteStallCause::kNone:
+      break;
+  }
+  return reason;
+}
+
 const EnvOptions* ColumnFamilyData::soptions() const {
   return &(column_family_set_->env_options_);
 }
@@ -813,6 +924,15 @@ uint64_t ColumnFamilyData::GetTotalSstFilesSize() const {
   return VersionSet::GetTotalSstFilesSize(dummy_versions_);
 }
 
+BlobSource* ColumnFamilyData::GetBlobSourceForIterator(
+    const SuperVersion* sv) const {
+  if (ioptions_.enable_blob_files ||
+      sv->current->storage_info()->has_blob_file_references()) {
+    return blob_source_.get();
+  }
+  return nullptr;
+}
+
 MemTable* ColumnFamilyData::ConstructNewMemtable(
     const MutableCFOptions& mutable_cf_options, SequenceNumber earliest_seq) {
   return new MemTable(internal_comparator_, ioptions_, mutable_cf_options,
@@ -14,6 +14,7 @@
 #include <vector>
 #include <atomic>
 
+#include "db/blob_source.h"
 #include "db/memtable_list.h"
 #include "db/table_cache.h"
 #include "db/table_properties_collector.h"
@@ -45,6 +46,14 @@ struct SuperVersionContext;
 
 extern const double kIncSlowdownRatio;
 
+// What a write stall of a column family is caused by
+enum class WriteStallCause {
+  kNone,
+  kMemtableLimit,
+  kL0FileCountLimit,
+  kPendingCompactionBytes,
+};
+
 // ColumnFamilyHandleImpl is the class that clients use to access different
 // column families. It has non-trivial destructor, which gets called when client
 // is done using the column family
@@ -138,6 +147,8 @@ extern Status CheckCompressionSupported(const ColumnFamilyOptions& cf_options);
 extern Status CheckConcurrentWritesSupported(
     const ColumnFamilyOptions& cf_options);
 
+extern Status CheckBlobFilesSupported(const ColumnFamilyOptions& cf_options);
+
 extern ColumnFamilyOptions SanitizeOptions(const ImmutableDBOptions& db_options,
                                            const ColumnFamilyOptions& src);
 // Wrap user defined table proproties collector factories `from cf_options`
@@ -251,6 +262,10 @@ class ColumnFamilyData {
                          SequenceNumber earliest_seq);
 
   TableCache* table_cache() const { return table_cache_.get(); }
+  BlobSource* blob_source() const { return blob_source_.get(); }
+  // Returns the blob source that iterators over sv read blob indexes through,
+  // or nullptr if they come from BlobDB rather than from blob files
+  BlobSource* GetBlobSourceForIterator(const SuperVersion* sv) const;
 
   // See documentation in compaction_picker.h
   // REQUIRES: DB mutex held
@@ -335,6 +350,13 @@ class ColumnFamilyData {
   WriteStallCondition RecalculateWriteStallConditions(
       const MutableCFOptions& mutable_cf_options);
 
+  // The write stall set up by the last RecalculateWriteStallConditions(),
+  // and its reason like "delayed: level-0 file count limit", or "normal"
+  WriteStallCondition write_stall_condition() const {
+    return write_stall_condition_;
+  }
+  std::string GetWriteStallReason() const;
+
   void set_initialized() { initialized_.store(true); }
 
   bool initialized() const { return initialized_.load(); }
@@ -371,6 +393,7 @@ class ColumnFamilyData {
   const bool is_delete_range_supported_;
 
   std::unique_ptr<TableCache> table_cache_;
+  std::unique_ptr<BlobSource> blob_source_;
 
   std::unique_ptr<InternalStats> internal_stats_;
 
@@ -417,6 +440,9 @@ class ColumnFamilyData {
 
   uint64_t prev_compaction_needed_bytes_;
 
+  WriteStallCondition write_stall_condition_;
+  WriteStallCause write_stall_cause_;
+
   // if the database was opened with 2pc enabled
   bool allow_2pc_;
 };
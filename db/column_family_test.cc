@@ -236,6 +236,31 @@ class ColumnFamilyTest : public testing::Test {
 #endif  // !ROCKSDB_LITE
   }
 
+  std::string GetCFWriteStallReason(int cf) {
+#ifndef ROCKSDB_LITE
+    std::string v;
+    EXPECT_TRUE(
+        dbfull()->GetProperty(handles_[cf], "rocksdb.cf-write-stall-reason", &v));
+    return v;
+#else
+    return static_cast<ColumnFamilyHandleImpl*>(handles_[cf])
+        ->cfd()
+        ->GetWriteStallReason();
+#endif  // !ROCKSDB_LITE
+  }
+
+  uint64_t GetCFDelayedWriteRate(int cf) {
+#ifndef ROCKSDB_LITE
+    uint64_t v;
+    EXPECT_TRUE(dbfull()->GetIntProperty(
+        handles_[cf], "rocksdb.cf-delayed-write-rate", &v));
+    return v;
+#else
+    return dbfull()->TEST_write_controler().delayed_write_rate(
+        handles_[cf]->GetID());
+#endif  // !ROCKSDB_LITE
+  }
+
   void Destroy() {
     Close();
     ASSERT_OK(DestroyDB(dbname_, Options(db_options_, column_family_options_)));
@@ -2845,6 +2870,62 @@ TEST_F(ColumnFamilyTest, WriteStallTwoColumnFamilies) {
   ASSERT_EQ(kBaseRate / 1.25, GetDbDelayedWriteRate());
 }
 
+TEST_F(ColumnFamilyTest, WriteStallPerColumnFamily) {
+  const uint64_t kBaseRate = 810000u;
+  db_options_.delayed_write_rate = kBaseRate;
+  db_options_.per_column_family_write_stall = true;
+  Open();
+  CreateColumnFamilies({"one"});
+  ColumnFamilyData* cfd1 =
+      static_cast<ColumnFamilyHandleImpl*>(handles_[1])->cfd();
+  VersionStorageInfo* vstorage1 = cfd1->current()->storage_info();
+  const uint32_t cf1_id = handles_[1]->GetID();
+
+  MutableCFOptions mutable_cf_options(column_family_options_);
+  mutable_cf_options.level0_slowdown_writes_trigger = 20;
+  mutable_cf_options.level0_stop_writes_trigger = 10000;
+  mutable_cf_options.soft_pending_compaction_bytes_limit = 200;
+  mutable_cf_options.hard_pending_compaction_bytes_limit = 2000;
+
+  WriteOptions no_slowdown;
+  no_slowdown.no_slowdown = true;
+
+  vstorage1->TEST_set_estimated_compaction_needed_bytes(300);
+  cfd1->RecalculateWriteStallConditions(mutable_cf_options);
+  // Only the writes to "one" are delayed
+  ASSERT_TRUE(!dbfull()->TEST_write_controler().NeedsDelay());
+  ASSERT_TRUE(dbfull()->TEST_write_controler().NeedsDelay(cf1_id));
+  ASSERT_EQ(0, GetDbDelayedWriteRate());
+  ASSERT_EQ(kBaseRate, GetCFDelayedWriteRate(1));
+  ASSERT_EQ(0, GetCFDelayedWriteRate(0));
+  ASSERT_EQ("delayed: pending compaction bytes limit",
+            GetCFWriteStallReason(1));
+  ASSERT_EQ("normal", GetCFWriteStallReason(0));
+  ASSERT_OK(db_->Put(no_slowdown, handles_[0], "foo", "bar"));
+
+  vstorage1->TEST_set_estimated_compaction_needed_bytes(400);
+  cfd1->RecalculateWriteStallConditions(mutable_cf_options);
+  ASSERT_EQ(kBaseRate / 1.25, GetCFDelayedWriteRate(1));
+  ASSERT_EQ(0, GetDbDelayedWriteRate());
+
+  vstorage1->TEST_set_estimated_compaction_needed_bytes(3000);
+  cfd1->RecalculateWriteStallConditions(mutable_cf_options);
+  ASSERT_TRUE(!IsDbWriteStopped());
+  ASSERT_TRUE(dbfull()->TEST_write_controler().IsStopped(cf1_id));
+  ASSERT_EQ("stopped: pending compaction bytes limit",
+            GetCFWriteStallReason(1));
+  ASSERT_EQ(0, GetCFDelayedWriteRate(1));
+  ASSERT_TRUE(db_->Put(no_slowdown, handles_[1], "foo", "bar").IsIncomplete());
+  ASSERT_OK(db_->Put(no_slowdown, handles_[0], "foo", "bar"));
+
+  vstorage1->TEST_set_estimated_compaction_needed_bytes(50);
+  cfd1->RecalculateWriteStallConditions(mutable_cf_options);
+  ASSERT_TRUE(!dbfull()->TEST_write_controler().IsStopped(cf1_id));
+  ASSERT_TRUE(!dbfull()->TEST_write_controler().HasColumnFamilyStalls());
+  ASSERT_EQ("normal", GetCFWriteStallReason(1));
+  ASSERT_OK(db_->Put(no_slowdown, handles_[1], "foo", "bar"));
+}
+
 TEST_F(ColumnFamilyTest, CompactionSpeedupTwoColumnFamilies) {
   db_options_.max_background_compactions = 6;
   column_family_options_.soft_pending_compaction_bytes_limit = 200;
@@ -434,16 +434,18 @@ std::unique_ptr<CompactionFilter> Compaction::CreateCompactionFilter() const {
       context);
 }
 
-bool Compaction::IsOutputLevelEmpty() const {
-  return inputs_.back().level != output_level_ || inputs_.back().empty();
-}
-
 bool Compaction::ShouldFormSubcompactions() const {
   if (immutable_cf_options_.max_subcompactions <= 1 || cfd_ == nullptr) {
     return false;
   }
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
-    return start_level_ == 0 && output_level_ > 0 && !IsOutputLevelEmpty();
+    // L0 files are not range partitioned, so their compactions are the large
+    // ones. A compaction of a single file could not be moved trivially, and
+    // would otherwise be rewritten by one thread however large it is.
+    // Subcompaction boundaries come from sampling the input files' indexes, so
+    // an empty output level still gets evenly sized key ranges. L0->L0
+    // compactions are excluded since L0 files must not overlap in seqnums.
+    return output_level_ > 0 && (start_level_ == 0 || IsSingleFileInput());
   } else if (cfd_->ioptions()->compaction_style == kCompactionStyleUniversal) {
     return number_levels_ > 1 && output_level_ > 0;
   } else {
@@ -451,6 +453,14 @@ bool Compaction::ShouldFormSubcompactions() const {
   }
 }
 
+bool Compaction::IsSingleFileInput() const {
+  size_t num_files = 0;
+  for (const auto& input : inputs_) {
+    num_files += input.size();
+  }
+  return num_files == 1;
+}
+
 uint64_t Compaction::MaxInputFileCreationTime() const {
   uint64_t max_creation_time = 0;
   for (const auto& file : inputs_[0].files) {
@@ -464,4 +474,15 @@ uint64_t Compaction::MaxInputFileCreationTime() const {
   return max_creation_time;
 }
 
+bool Compaction::HasBlobFileReferences() const {
+  for (const auto& level_files : inputs_) {
+    for (const auto* file : level_files.files) {
+      if (!file->blob_file_numbers.empty()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 }  // namespace rocksdb
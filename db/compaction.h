@@ -209,8 +209,8 @@ class Compaction {
   // Create a CompactionFilter from compaction_filter_factory
   std::unique_ptr<CompactionFilter> CreateCompactionFilter() const;
 
-  // Is the input level corresponding to output_level_ empty?
-  bool IsOutputLevelEmpty() const;
+  // Does the compaction read exactly one file?
+  bool IsSingleFileInput() const;
 
   // Should this compaction be broken up into smaller ones run in parallel?
   bool ShouldFormSubcompactions() const;
@@ -243,6 +243,9 @@ class Compaction {
 
   uint64_t MaxInputFileCreationTime() const;
 
+  // Returns true if any input file refers to a blob file
+  bool HasBlobFileReferences() const;
+
  private:
   // mark (or clear) all files that are being compacted
   void MarkFilesBeingCompacted(bool mark_as_compacted);
@@ -24,6 +24,7 @@
 #include <utility>
 #include <vector>
 
+#include "db/blob_file_builder.h"
 #include "db/builder.h"
 #include "db/db_iter.h"
 #include "db/dbformat.h"
@@ -395,127 +396,92 @@ void CompactionJob::Prepare() {
   }
 }
 
-struct RangeWithSize {
-  Range range;
-  uint64_t size;
-
-  RangeWithSize(const Slice& a, const Slice& b, uint64_t s = 0)
-      : range(a, b), size(s) {}
-};
-
 // Generates a histogram representing potential divisions of key ranges from
-// the input. It adds the starting and/or ending keys of certain input files
-// to the working set and then finds the approximate size of data in between
-// each consecutive pair of slices. Then it divides these ranges into
-// consecutive groups such that each group has a similar size.
+// the input. It samples anchor keys from the index of every input file, each
+// carrying the approximate size of the data between it and the previous anchor
+// of the same file. Sorted by key, the anchors describe how the input data is
+// distributed over the key space, so they are then divided into consecutive
+// groups such that each group has a similar size.
 void CompactionJob::GenSubcompactionBoundaries() {
   auto* c = compact_->compaction;
   auto* cfd = c->column_family_data();
   const Comparator* cfd_comparator = cfd->user_comparator();
-  std::vector<Slice> bounds;
   int start_lvl = c->start_level();
   int out_lvl = c->output_level();
 
-  // Add the starting and/or ending key of certain input files as a potential
-  // boundary
+  ReadOptions read_options;
+  read_options.fill_cache = false;
+  std::vector<TableReader::Anchor> anchors;
   for (size_t lvl_idx = 0; lvl_idx < c->num_input_levels(); lvl_idx++) {
     int lvl = c->level(lvl_idx);
-    if (lvl >= start_lvl && lvl <= out_lvl) {
-      const LevelFilesBrief* flevel = c->input_levels(lvl_idx);
-      size_t num_files = flevel->num_files;
-
-      if (num_files == 0) {
-        continue;
-      }
-
-      if (lvl == 0) {
-        // For level 0 add the starting and ending key of each file since the
-        // files may have greatly differing key ranges (not range-partitioned)
-        for (size_t i = 0; i < num_files; i++) {
-          bounds.emplace_back(flevel->files[i].smallest_key);
-          bounds.emplace_back(flevel->files[i].largest_key);
-        }
-      } else {
-        // For all other levels add the smallest/largest key in the level to
-        // encompass the range covered by that level
-        bounds.emplace_back(flevel->files[0].smallest_key);
-        bounds.emplace_back(flevel->files[num_files - 1].largest_key);
-        if (lvl == out_lvl) {
-          // For the last level include the starting keys of all files since
-          // the last level is the largest and probably has the widest key
-          // range. Since it's range partitioned, the ending key of one file
-          // and the starting key of the next are very close (or identical).
-          for (size_t i = 1; i < num_files; i++) {
-            bounds.emplace_back(flevel->files[i].smallest_key);
-          }
-        }
+    if (lvl < start_lvl || lvl > out_lvl) {
+      continue;
+    }
+    for (const FileMetaData* f : *c->inputs(lvl_idx)) {
+      size_t num_anchors = anchors.size();
+      Status s = cfd->table_cache()->ApproximateKeyAnchors(
+          read_options, env_options_, cfd->internal_comparator(), f->fd,
+          &anchors);
+      if (!s.ok()) {
+        // The table can't be sampled, so fall back to its key range, which
+        // only allows splitting around the file.
+        anchors.erase(anchors.begin() + num_anchors, anchors.end());
+        anchors.emplace_back(f->smallest.user_key(), 0);
+        anchors.emplace_back(f->largest.user_key(), f->fd.GetFileSize());
       }
     }
   }
+  std::sort(anchors.begin(), anchors.end(),
+            [cfd_comparator](const TableReader::Anchor& a,
+                             const TableReader::Anchor& b) -> bool {
+              return cfd_comparator->Compare(a.user_key, b.user_key) < 0;
+            });
 
-  std::sort(bounds.begin(), bounds.end(),
-    [cfd_comparator] (const Slice& a, const Slice& b) -> bool {
-      return cfd_comparator->Compare(ExtractUserKey(a), ExtractUserKey(b)) < 0;
-    });
-  // Remove duplicated entries from bounds
-  bounds.erase(std::unique(bounds.begin(), bounds.end(),
-    [cfd_comparator] (const Slice& a, const Slice& b) -> bool {
-      return cfd_comparator->Compare(ExtractUserKey(a), ExtractUserKey(b)) == 0;
-    }), bounds.end());
-
-  // Combine consecutive pairs of boundaries into ranges with an approximate
-  // size of data covered by keys in that range
   uint64_t sum = 0;
-  std::vector<RangeWithSize> ranges;
-  auto* v = cfd->current();
-  for (auto it = bounds.begin();;) {
-    const Slice a = *it;
-    it++;
-
-    if (it == bounds.end()) {
-      break;
-    }
-
-    const Slice b = *it;
-    uint64_t size = versions_->ApproximateSize(v, a, b, start_lvl, out_lvl + 1);
-    ranges.emplace_back(a, b, size);
-    sum += size;
+  for (const auto& anchor : anchors) {
+    sum += anchor.range_size;
   }
 
-  // Group the ranges into subcompactions
-  const double min_file_fill_percent = 4.0 / 5;
-  uint64_t max_output_files = static_cast<uint64_t>(
-      std::ceil(sum / min_file_fill_percent /
-                c->mutable_cf_options()->MaxFileSizeForLevel(out_lvl)));
+  // Group the anchors into subcompactions. Every subcompaction gets at least
+  // a full output file's worth of input, so that splitting doesn't leave more
+  // under-filled output files than a single-threaded compaction would.
+  uint64_t max_output_files =
+      sum / c->mutable_cf_options()->MaxFileSizeForLevel(out_lvl);
   uint64_t subcompactions =
-      std::min({static_cast<uint64_t>(ranges.size()),
+      std::min({static_cast<uint64_t>(anchors.size()),
                 static_cast<uint64_t>(db_options_.max_subcompactions),
                 max_output_files});
 
   if (subcompactions > 1) {
     double mean = sum * 1.0 / subcompactions;
-    // Greedily add ranges to the subcompaction until the sum of the ranges'
-    // sizes becomes >= the expected mean size of a subcompaction
+    // Greedily add anchors to the subcompaction until the sum of their sizes
+    // becomes >= the expected mean size of a subcompaction
     sum = 0;
-    for (size_t i = 0; i < ranges.size() - 1; i++) {
-      sum += ranges[i].size;
+    for (size_t i = 0; i < anchors.size() - 1; i++) {
+      sum += anchors[i].range_size;
       if (subcompactions == 1) {
         // If there's only one left to schedule then it goes to the end so no
         // need to put an end boundary
         continue;
       }
-      if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
+      // Anchors of different files may share a key, in which case only the
+      // last of them can end a subcompaction.
+      if (sum >= mean && cfd_comparator->Compare(anchors[i].user_key,
+                                                 anchors[i + 1].user_key) < 0) {
+        boundary_keys_.push_back(anchors[i].user_key);
         sizes_.emplace_back(sum);
         subcompactions--;
         sum = 0;
       }
     }
-    sizes_.emplace_back(sum + ranges.back().size);
+    sizes_.emplace_back(sum + anchors.back().range_size);
   } else {
     // Only one range so its size is the total sum of sizes computed above
     sizes_.emplace_back(sum);
   }
+  for (const auto& key : boundary_keys_) {
+    boundaries_.emplace_back(key);
+  }
 }
 
 Status CompactionJob::Run() {
@@ -675,6 +641,20 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
   return status;
 }
 
+Status CompactionJob::Finish(std::vector<FileMetaData>* output_files) {
+  db_mutex_->AssertHeld();
+  Status status = compact_->status;
+  if (status.ok()) {
+    for (const auto& sub_compact : compact_->sub_compact_states) {
+      for (const auto& out : sub_compact.outputs) {
+        output_files->push_back(out.meta);
+      }
+    }
+  }
+  CleanupCompaction();
+  return status;
+}
+
 void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   assert(sub_compact != nullptr);
   ColumnFamilyData* cfd = sub_compact->compaction->column_family_data();
@@ -786,6 +766,21 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
       c_iter->key(), sub_compact->current_output_file_size);
   }
   const auto& c_iter_stats = c_iter->iter_stats();
+
+  // Large values go to blob files, and the blob indexes that the input files
+  // already hold need to be tracked by the outputs
+  std::unique_ptr<BlobFileBuilder> blob_file_builder;
+  if (cfd->ioptions()->enable_blob_files ||
+      sub_compact->compaction->HasBlobFileReferences()) {
+    blob_file_builder.reset(new BlobFileBuilder(
+        versions_, env_, env_options_, *cfd->ioptions(), cfd->GetID(),
+        cfd->blob_source(),
+        BlobFileBuilder::GarbageCollectionCutoff(
+            *cfd->ioptions(),
+            sub_compact->compaction->input_version()->storage_info()),
+        Env::IO_LOW, write_hint_));
+  }
+
   auto sample_begin_offset_iter = sample_begin_offsets.cbegin();
   // data_begin_offset and dict_sample_data are only valid while generating
   // dictionary from the first output file.
@@ -796,8 +791,8 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   while (status.ok() && !cfd->IsDropped() && c_iter->Valid()) {
     // Invariant: c_iter.status() is guaranteed to be OK if c_iter->Valid()
     // returns true.
-    const Slice& key = c_iter->key();
-    const Slice& value = c_iter->value();
+    Slice key = c_iter->key();
+    Slice value = c_iter->value();
 
     // If an end key (exclusive) is specified, check if the current key is
     // >= than it and exit if it is because the iterator is out of its range
@@ -821,6 +816,13 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     }
     assert(sub_compact->builder != nullptr);
     assert(sub_compact->current_output() != nullptr);
+    if (blob_file_builder != nullptr) {
+      status = blob_file_builder->Add(&key, &value,
+                                      &sub_compact->current_output()->meta);
+      if (!status.ok()) {
+        break;
+      }
+    }
     sub_compact->builder->Add(key, value);
     sub_compact->current_output_file_size = sub_compact->builder->FileSize();
     sub_compact->current_output()->meta.UpdateBoundaries(
@@ -980,6 +982,9 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     }
     RecordDroppedKeys(range_del_out_stats, &sub_compact->compaction_job_stats);
   }
+  if (status.ok() && blob_file_builder != nullptr) {
+    status = blob_file_builder->Finish();
+  }
 
   if (measure_io_stats_) {
     sub_compact->compaction_job_stats.file_write_nanos +=
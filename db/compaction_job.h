@@ -87,6 +87,12 @@ class CompactionJob {
   // REQUIRED: mutex held
   Status Install(const MutableCFOptions& mutable_cf_options);
 
+  // Ends the job without installing its results, for compactions run on
+  // behalf of a CompactionService. On success, the metadata of the output
+  // files is stored in *output_files.
+  // REQUIRED: mutex held
+  Status Finish(std::vector<FileMetaData>* output_files);
+
  private:
   struct SubcompactionState;
 
@@ -165,6 +171,8 @@ class CompactionJob {
   bool bottommost_level_;
   bool paranoid_file_checks_;
   bool measure_io_stats_;
+  // Stores the user keys that designate the boundaries for each subcompaction
+  std::vector<std::string> boundary_keys_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<Slice> boundaries_;
   // Stores the approx size of keys covered in the range of each subcompaction
@@ -1010,6 +1010,14 @@ class LevelCompactionBuilder {
   // If there is any file marked for compaction, put put it into inputs.
   void PickFilesMarkedForCompaction();
 
+  // With level_compaction_tiered_levels, picks consecutive sorted runs of the
+  // tiered levels to merge, the way universal compaction does, and sets up
+  // all inputs of the compaction.
+  //
+  // Returns true if `compaction_inputs_` is populated; otherwise, returns
+  // false.
+  bool PickTieredCompaction();
+
   const std::string& cf_name_;
   VersionStorageInfo* vstorage_;
   CompactionPicker* compaction_picker_;
@@ -1020,6 +1028,7 @@ class LevelCompactionBuilder {
   int base_index_ = -1;
   double start_level_score_ = 0;
   bool is_manual_ = false;
+  bool is_tiered_ = false;
   CompactionInputFiles start_level_inputs_;
   std::vector<CompactionInputFiles> compaction_inputs_;
   CompactionInputFiles output_level_inputs_;
@@ -1088,6 +1097,14 @@ void LevelCompactionBuilder::SetupInitialFiles() {
     start_level_ = vstorage_->CompactionScoreLevel(i);
     assert(i == 0 || start_level_score_ <= vstorage_->CompactionScore(i - 1));
     if (start_level_score_ >= 1) {
+      if (start_level_ == 0 && ioptions_.level_compaction_tiered_levels > 0) {
+        // L0 score = `num sorted runs in the tiered levels` /
+        // `level0_file_num_compaction_trigger`
+        if (PickTieredCompaction()) {
+          break;
+        }
+        continue;
+      }
       if (skipped_l0_to_base && start_level_ == vstorage_->base_level()) {
         // If L0->base_level compaction is pending, don't schedule further
         // compaction from base level. Otherwise L0->base_level compaction
@@ -1235,16 +1252,19 @@ Compaction* LevelCompactionBuilder::PickCompaction() {
   }
   assert(start_level_ >= 0 && output_level_ >= 0);
 
-  // If it is a L0 -> base level compaction, we need to set up other L0
-  // files if needed.
-  if (!SetupOtherL0FilesIfNeeded()) {
-    return nullptr;
-  }
+  // A tiered compaction already includes all files of its levels.
+  if (!is_tiered_) {
+    // If it is a L0 -> base level compaction, we need to set up other L0
+    // files if needed.
+    if (!SetupOtherL0FilesIfNeeded()) {
+      return nullptr;
+    }
 
-  // Pick files in the output level and expand more files in the start level
-  // if needed.
-  if (!SetupOtherInputsIfNeeded()) {
-    return nullptr;
+    // Pick files in the output level and expand more files in the start level
+    // if needed.
+    if (!SetupOtherInputsIfNeeded()) {
+      return nullptr;
+    }
   }
 
   // Form a compaction object containing the files we picked.
@@ -1421,6 +1441,124 @@ bool LevelCompactionBuilder::PickIntraL0Compaction() {
   return FindIntraL0Compaction(level_files, kMinFilesForIntraL0Compaction,
                                port::kMaxUint64, &start_level_inputs_);
 }
+
+bool LevelCompactionBuilder::PickTieredCompaction() {
+  const int tiered_levels = ioptions_.level_compaction_tiered_levels;
+  const auto& options = ioptions_.compaction_options_universal;
+
+  // Each L0 file, newest first, and then each non-empty tiered level is a
+  // sorted run. Only the last tiered level may be compacted by size into the
+  // leveled part, so one tiered compaction at a time is allowed elsewhere.
+  struct SortedRun {
+    int level;
+    FileMetaData* file;  // nullptr for a whole level
+    uint64_t size;
+    uint64_t compensated_file_size;
+    bool being_compacted;
+  };
+  std::vector<SortedRun> sorted_runs;
+  for (FileMetaData* f : vstorage_->LevelFiles(0)) {
+    if (f->being_compacted) {
+      return false;
+    }
+    sorted_runs.push_back(
+        {0, f, f->fd.GetFileSize(), f->compensated_file_size, false});
+  }
+  for (int level = 1; level < tiered_levels; level++) {
+    SortedRun sr = {level, nullptr, 0, 0, false};
+    for (FileMetaData* f : vstorage_->LevelFiles(level)) {
+      sr.size += f->fd.GetFileSize();
+      sr.compensated_file_size += f->compensated_file_size;
+      sr.being_compacted |= f->being_compacted;
+    }
+    if (sr.being_compacted && level < tiered_levels - 1) {
+      return false;
+    }
+    if (sr.compensated_file_size > 0) {
+      sorted_runs.push_back(sr);
+    }
+  }
+  const size_t trigger = static_cast<size_t>(
+      mutable_cf_options_.level0_file_num_compaction_trigger);
+  if (sorted_runs.size() < trigger) {
+    return false;
+  }
+
+  // Picks the first span of runs in which each run is no larger than the
+  // runs before it, grown by `ratio` percent.
+  auto pick_span = [&](unsigned int ratio, size_t max_width, size_t* start,
+                       size_t* count) {
+    const size_t min_width = std::max(options.min_merge_width, 2U);
+    max_width =
+        std::min(max_width, static_cast<size_t>(options.max_merge_width));
+    for (size_t i = 0; i < sorted_runs.size(); i++) {
+      if (sorted_runs[i].being_compacted) {
+        continue;
+      }
+      uint64_t candidate_size = sorted_runs[i].compensated_file_size;
+      size_t j = i + 1;
+      for (; j < sorted_runs.size() && j - i < max_width; j++) {
+        if (sorted_runs[j].being_compacted ||
+            candidate_size * (100.0 + ratio) / 100.0 <
+                static_cast<double>(sorted_runs[j].size)) {
+          break;
+        }
+        candidate_size += sorted_runs[j].compensated_file_size;
+      }
+      if (j - i >= min_width) {
+        *start = i;
+        *count = j - i;
+        return true;
+      }
+    }
+    return false;
+  };
+  size_t start = 0;
+  size_t count = 0;
+  if (pick_span(options.size_ratio, sorted_runs.size(), &start, &count)) {
+    compaction_reason_ = CompactionReason::kUniversalSizeRatio;
+  } else if (pick_span(std::numeric_limits<unsigned int>::max(),
+                       sorted_runs.size() - trigger, &start, &count)) {
+    // Too many sorted runs: merge the newest of them regardless of their
+    // sizes, as universal compaction does to bound read amplification.
+    compaction_reason_ = CompactionReason::kUniversalSortedRunNum;
+  } else {
+    return false;
+  }
+
+  // Output to the level right above the next sorted run, or to the last
+  // tiered level if there is none, so that runs move down into empty levels.
+  const size_t first_index_after = start + count;
+  if (first_index_after == sorted_runs.size()) {
+    output_level_ = tiered_levels - 1;
+  } else if (sorted_runs[first_index_after].level == 0) {
+    output_level_ = 0;
+  } else {
+    output_level_ = sorted_runs[first_index_after].level - 1;
+  }
+  start_level_ = sorted_runs[start].level;
+
+  compaction_inputs_.resize(output_level_ - start_level_ + 1);
+  for (size_t i = 0; i < compaction_inputs_.size(); i++) {
+    compaction_inputs_[i].level = start_level_ + static_cast<int>(i);
+  }
+  for (size_t i = start; i < first_index_after; i++) {
+    const SortedRun& sr = sorted_runs[i];
+    auto& files = compaction_inputs_[sr.level - start_level_].files;
+    if (sr.file != nullptr) {
+      files.push_back(sr.file);
+    } else {
+      files = vstorage_->LevelFiles(sr.level);
+    }
+  }
+  start_level_inputs_ = compaction_inputs_[0];
+  is_tiered_ = true;
+  ROCKS_LOG_BUFFER(log_buffer_,
+                   "[%s] Tiered: merging %" ROCKSDB_PRIszt
+                   " sorted runs from level-%d to level-%d\n",
+                   cf_name_.c_str(), count, start_level_, output_level_);
+  return true;
+}
 }  // namespace
 
 Compaction* LevelCompactionPicker::PickCompaction(
@@ -545,6 +545,38 @@ TEST_F(CompactionPickerTest, CompactionPriMinOverlapping1) {
   ASSERT_EQ(8U, compaction->input(0, 0)->fd.GetNumber());
 }
 
+TEST_F(CompactionPickerTest, CompactionPriReadHotDeletions) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.compaction_pri = kReadHotDeletionsFirst;
+  mutable_cf_options_.max_bytes_for_level_base = 10 * 1024 * 1024;
+
+  Add(2, 6U, "150", "179", 60000000U);  // Largest, not read
+  Add(2, 7U, "180", "220", 50000000U);  // Read, half deletions
+  Add(2, 8U, "321", "400", 50000000U);  // Mostly deletions, not read
+  Add(2, 9U, "721", "800", 50000000U);  // Read more, few deletions
+  Add(3, 26U, "150", "900", 260000000U);
+
+  FileMetaData* f = file_map_[7U].first;
+  f->num_entries = 1000;
+  f->num_deletions = 500;
+  f->stats.num_reads_sampled = 10240;
+  f = file_map_[8U].first;
+  f->num_entries = 1000;
+  f->num_deletions = 900;
+  f = file_map_[9U].first;
+  f->num_entries = 1000;
+  f->num_deletions = 100;
+  f->stats.num_reads_sampled = 20480;
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  // Pick file 7 because reads spend the most time on its deletions.
+  ASSERT_EQ(7U, compaction->input(0, 0)->fd.GetNumber());
+}
+
 TEST_F(CompactionPickerTest, CompactionPriMinOverlapping2) {
   NewVersionStorage(6, kCompactionStyleLevel);
   ioptions_.compaction_pri = kMinOverlappingRatio;
@@ -1433,6 +1465,97 @@ TEST_F(CompactionPickerTest, CacheNextCompactionIndex) {
   ASSERT_EQ(4, vstorage_->NextCompactionIndex(1 /* level */));
 }
 
+TEST_F(CompactionPickerTest, TieredLevelsMergeSimilarRuns) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.level_compaction_tiered_levels = 3;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 4;
+  Add(0, 1U, "150", "200", 1000U);
+  Add(0, 2U, "150", "200", 1000U);
+  Add(0, 3U, "150", "200", 1000U);
+  Add(0, 4U, "150", "200", 1000U);
+  Add(1, 5U, "100", "200", 2000U);
+  Add(1, 6U, "201", "300", 1000U);
+  Add(2, 7U, "100", "300", 100000U);
+  UpdateVersionStorageInfo();
+
+  // The four L0 files and L1 are of similar size, but L2 is much larger, so
+  // the output replaces L1.
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(CompactionReason::kUniversalSizeRatio,
+            compaction->compaction_reason());
+  ASSERT_EQ(1, compaction->output_level());
+  ASSERT_EQ(2U, compaction->num_input_levels());
+  ASSERT_EQ(4U, compaction->num_input_files(0));
+  ASSERT_EQ(2U, compaction->num_input_files(1));
+  ASSERT_EQ(5U, compaction->input(1, 0)->fd.GetNumber());
+  ASSERT_EQ(6U, compaction->input(1, 1)->fd.GetNumber());
+}
+
+TEST_F(CompactionPickerTest, TieredLevelsMoveIntoEmptyLevel) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.level_compaction_tiered_levels = 3;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 2;
+  Add(0, 1U, "150", "200", 1000U);
+  Add(0, 2U, "100", "250", 1000U);
+  Add(3, 3U, "100", "300", 100000U);
+  UpdateVersionStorageInfo();
+
+  // Nothing is in the tiered levels below L0, so the merged run goes to the
+  // last tiered level.
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(2, compaction->output_level());
+  ASSERT_EQ(3U, compaction->num_input_levels());
+  ASSERT_EQ(2U, compaction->num_input_files(0));
+  ASSERT_EQ(0U, compaction->num_input_files(1));
+  ASSERT_EQ(0U, compaction->num_input_files(2));
+}
+
+TEST_F(CompactionPickerTest, TieredLevelsNotCompactedBySize) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.level_compaction_tiered_levels = 3;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 4;
+  mutable_cf_options_.max_bytes_for_level_base = 10000;
+  // L1 is far over its leveled target, but it is tiered.
+  Add(1, 1U, "100", "200", 1000000U);
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() == nullptr);
+}
+
+TEST_F(CompactionPickerTest, TieredLevelsLeveledBelow) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.level_compaction_tiered_levels = 3;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 4;
+  mutable_cf_options_.max_bytes_for_level_base = 10000;
+  mutable_cf_options_.max_bytes_for_level_multiplier = 10;
+  mutable_cf_options_.max_compaction_bytes = 100000000000u;
+  Add(1, 1U, "100", "200", 1000000U);
+  Add(2, 2U, "100", "150", 100000U);
+  Add(2, 3U, "151", "200", 200000U);
+  Add(3, 4U, "100", "150", 500000U);
+  Add(3, 5U, "151", "200", 500000U);
+  UpdateVersionStorageInfo();
+
+  // The last tiered level is compacted into the leveled part by size.
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(CompactionReason::kLevelMaxLevelSize,
+            compaction->compaction_reason());
+  ASSERT_EQ(2, compaction->start_level());
+  ASSERT_EQ(3, compaction->output_level());
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(3U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(1U, compaction->num_input_files(1));
+  ASSERT_EQ(5U, compaction->input(1, 0)->fd.GetNumber());
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
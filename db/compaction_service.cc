@@ -0,0 +1,150 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/compaction_service.h"
+
+#include "util/coding.h"
+#include "util/string_util.h"
+
+namespace rocksdb {
+
+namespace {
+
+// Bumped whenever the encoding changes, so that a primary and a worker built
+// from different versions fail cleanly instead of misreading each other.
+const uint32_t kCompactionServiceFormatVersion = 1;
+
+Status CheckFormatVersion(Slice* input) {
+  uint32_t format_version;
+  if (!GetVarint32(input, &format_version)) {
+    return Status::Corruption("CompactionService", "missing format version");
+  }
+  if (format_version != kCompactionServiceFormatVersion) {
+    return Status::NotSupported("CompactionService",
+                                "unknown format version " +
+                                    ToString(format_version));
+  }
+  return Status::OK();
+}
+
+bool GetInternalKey(Slice* input, InternalKey* dst) {
+  Slice str;
+  if (!GetLengthPrefixedSlice(input, &str)) {
+    return false;
+  }
+  dst->DecodeFrom(str);
+  return dst->Valid();
+}
+
+}  // anonymous namespace
+
+void CompactionServiceInput::EncodeTo(std::string* dst) const {
+  PutVarint32(dst, kCompactionServiceFormatVersion);
+  PutLengthPrefixedSlice(dst, column_family_name);
+  PutVarint64(dst, input_file_numbers.size());
+  for (uint64_t file_number : input_file_numbers) {
+    PutVarint64(dst, file_number);
+  }
+  PutVarint32(dst, static_cast<uint32_t>(output_level));
+  dst->push_back(static_cast<char>(output_compression));
+  PutVarint64(dst, max_output_file_size);
+  PutVarint64(dst, snapshots.size());
+  for (SequenceNumber snapshot : snapshots) {
+    PutVarint64(dst, snapshot);
+  }
+  PutVarint64(dst, earliest_write_conflict_snapshot);
+  PutVarint64(dst, preserve_deletes_seqnum);
+}
+
+Status CompactionServiceInput::DecodeFrom(const Slice& src) {
+  Slice input = src;
+  Status s = CheckFormatVersion(&input);
+  if (!s.ok()) {
+    return s;
+  }
+  Slice cf_name;
+  uint64_t num_files = 0;
+  if (!GetLengthPrefixedSlice(&input, &cf_name) ||
+      !GetVarint64(&input, &num_files)) {
+    return Status::Corruption("CompactionServiceInput", "input files");
+  }
+  column_family_name = cf_name.ToString();
+  input_file_numbers.clear();
+  for (uint64_t i = 0; i < num_files; i++) {
+    uint64_t file_number;
+    if (!GetVarint64(&input, &file_number)) {
+      return Status::Corruption("CompactionServiceInput", "input files");
+    }
+    input_file_numbers.push_back(file_number);
+  }
+  uint32_t level;
+  uint64_t num_snapshots = 0;
+  if (!GetVarint32(&input, &level) || input.empty()) {
+    return Status::Corruption("CompactionServiceInput", "output level");
+  }
+  output_level = static_cast<int>(level);
+  output_compression = static_cast<CompressionType>(input[0]);
+  input.remove_prefix(1);
+  if (!GetVarint64(&input, &max_output_file_size) ||
+      !GetVarint64(&input, &num_snapshots)) {
+    return Status::Corruption("CompactionServiceInput", "snapshots");
+  }
+  snapshots.clear();
+  for (uint64_t i = 0; i < num_snapshots; i++) {
+    SequenceNumber snapshot;
+    if (!GetVarint64(&input, &snapshot)) {
+      return Status::Corruption("CompactionServiceInput", "snapshots");
+    }
+    snapshots.push_back(snapshot);
+  }
+  if (!GetVarint64(&input, &earliest_write_conflict_snapshot) ||
+      !GetVarint64(&input, &preserve_deletes_seqnum)) {
+    return Status::Corruption("CompactionServiceInput", "snapshots");
+  }
+  return Status::OK();
+}
+
+void CompactionServiceResult::EncodeTo(std::string* dst) const {
+  PutVarint32(dst, kCompactionServiceFormatVersion);
+  PutVarint64(dst, output_files.size());
+  for (const auto& file : output_files) {
+    PutLengthPrefixedSlice(dst, file.file_path);
+    PutVarint64(dst, file.file_size);
+    PutLengthPrefixedSlice(dst, file.smallest.Encode());
+    PutLengthPrefixedSlice(dst, file.largest.Encode());
+    PutVarint64(dst, file.smallest_seqno);
+    PutVarint64(dst, file.largest_seqno);
+  }
+}
+
+Status CompactionServiceResult::DecodeFrom(const Slice& src) {
+  Slice input = src;
+  Status s = CheckFormatVersion(&input);
+  if (!s.ok()) {
+    return s;
+  }
+  uint64_t num_files = 0;
+  if (!GetVarint64(&input, &num_files)) {
+    return Status::Corruption("CompactionServiceResult", "output files");
+  }
+  output_files.clear();
+  for (uint64_t i = 0; i < num_files; i++) {
+    CompactionServiceOutputFile file;
+    Slice file_path;
+    if (!GetLengthPrefixedSlice(&input, &file_path) ||
+        !GetVarint64(&input, &file.file_size) ||
+        !GetInternalKey(&input, &file.smallest) ||
+        !GetInternalKey(&input, &file.largest) ||
+        !GetVarint64(&input, &file.smallest_seqno) ||
+        !GetVarint64(&input, &file.largest_seqno)) {
+      return Status::Corruption("CompactionServiceResult", "output files");
+    }
+    file.file_path = file_path.ToString();
+    output_files.push_back(std::move(file));
+  }
+  return Status::OK();
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,54 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "rocksdb/options.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace rocksdb {
+
+// A compaction picked by the primary DB, as handed to CompactionService::Run()
+// and decoded by DB::OpenAndCompact() in the worker.
+struct CompactionServiceInput {
+  std::string column_family_name;
+  // Numbers of all input files; the worker looks up their levels in its own
+  // view of the DB.
+  std::vector<uint64_t> input_file_numbers;
+  int output_level = 0;
+  CompressionType output_compression = kNoCompression;
+  uint64_t max_output_file_size = 0;
+  std::vector<SequenceNumber> snapshots;
+  SequenceNumber earliest_write_conflict_snapshot = kMaxSequenceNumber;
+  SequenceNumber preserve_deletes_seqnum = 0;
+
+  void EncodeTo(std::string* dst) const;
+  Status DecodeFrom(const Slice& src);
+};
+
+// An output file written by the worker.
+struct CompactionServiceOutputFile {
+  // Full path of the file in the worker's output directory.
+  std::string file_path;
+  uint64_t file_size = 0;
+  InternalKey smallest;
+  InternalKey largest;
+  SequenceNumber smallest_seqno = 0;
+  SequenceNumber largest_seqno = 0;
+};
+
+struct CompactionServiceResult {
+  std::vector<CompactionServiceOutputFile> output_files;
+
+  void EncodeTo(std::string* dst) const;
+  Status DecodeFrom(const Slice& src);
+};
+
+}  // namespace rocksdb
@@ -789,6 +789,175 @@ TEST_F(DBBasicTest, MultiGetEmpty) {
   } while (ChangeCompactOptions());
 }
 
+#ifndef ROCKSDB_LITE
+TEST_F(DBBasicTest, MultiGetBatchedMultiLevel) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 64;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10, false));
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  // L2: every key, plus a merge base for every 5th key
+  for (int i = 0; i < 128; ++i) {
+    ASSERT_OK(Put(Key(i), "L2_" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  // L1: overwrite every 3rd key and delete every 7th key
+  for (int i = 0; i < 128; i += 3) {
+    ASSERT_OK(Put(Key(i), "L1_" + ToString(i)));
+  }
+  for (int i = 0; i < 128; i += 7) {
+    ASSERT_OK(Delete(Key(i)));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  // L0: two files with merges and a range deletion
+  for (int i = 0; i < 128; i += 5) {
+    ASSERT_OK(Merge(Key(i), "M0_" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(100), Key(110)));
+  for (int i = 0; i < 128; i += 11) {
+    ASSERT_OK(Merge(Key(i), "M1_" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+  // Memtable
+  for (int i = 0; i < 128; i += 13) {
+    ASSERT_OK(Put(Key(i), "mem_" + ToString(i)));
+  }
+  ASSERT_EQ("2,1,1", FilesPerLevel());
+
+  // Look up the keys in a shuffled order with duplicates and missing keys.
+  std::vector<std::string> key_strs;
+  for (int i = 130; i >= 0; i -= 2) {
+    key_strs.push_back(Key(i));
+  }
+  for (int i = 1; i < 130; i += 2) {
+    key_strs.push_back(Key(i));
+  }
+  key_strs.push_back(Key(17));
+  key_strs.push_back("missing");
+
+  std::vector<Slice> keys(key_strs.begin(), key_strs.end());
+  std::vector<ColumnFamilyHandle*> cfs(keys.size(), db_->DefaultColumnFamily());
+  std::vector<std::string> values;
+  std::vector<Status> statuses =
+      db_->MultiGet(ReadOptions(), cfs, keys, &values);
+  ASSERT_EQ(keys.size(), statuses.size());
+  ASSERT_EQ(keys.size(), values.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    std::string value;
+    Status s = db_->Get(ReadOptions(), keys[i], &value);
+    ASSERT_EQ(s.ToString(), statuses[i].ToString()) << key_strs[i];
+    if (s.ok()) {
+      ASSERT_EQ(value, values[i]) << key_strs[i];
+    }
+  }
+  auto mem_key = std::find(key_strs.begin(), key_strs.end(), Key(13));
+  ASSERT_EQ("mem_13", values[mem_key - key_strs.begin()]);
+}
+
+TEST_F(DBBasicTest, MultiGetBatchedMultiRead) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 256;
+  table_options.block_cache = NewLRUCache(1 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  Random rnd(301);
+  std::vector<std::string> expected;
+  for (int i = 0; i < 100; ++i) {
+    expected.push_back(RandomString(&rnd, 100));
+    ASSERT_OK(Put(Key(i), expected[i]));
+  }
+  ASSERT_OK(Flush());
+
+  std::vector<size_t> batch_sizes;
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTable::MultiGet:PrefetchRanges", [&](void* arg) {
+        batch_sizes.push_back(
+            reinterpret_cast<std::vector<std::pair<uint64_t, size_t>>*>(arg)
+                ->size());
+      });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  std::vector<std::string> key_strs;
+  for (int i = 0; i < 100; i += 9) {
+    key_strs.push_back(Key(i));
+  }
+  std::vector<Slice> keys(key_strs.begin(), key_strs.end());
+  std::vector<ColumnFamilyHandle*> cfs(keys.size(), db_->DefaultColumnFamily());
+  for (int round = 0; round < 2; ++round) {
+    std::vector<std::string> values;
+    std::vector<Status> statuses =
+        db_->MultiGet(ReadOptions(), cfs, keys, &values);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      ASSERT_OK(statuses[i]);
+      ASSERT_EQ(expected[i * 9], values[i]);
+    }
+  }
+  // Every key is in its own block. They are all read with one MultiRead()
+  // the first time, and found in the block cache the second time.
+  ASSERT_EQ(1U, batch_sizes.size());
+  ASSERT_EQ(keys.size(), batch_sizes[0]);
+
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+TEST_F(DBBasicTest, MultiGetBatchedMultiCF) {
+  Options options = CurrentOptions();
+  CreateAndReopenWithCF({"pikachu", "ilya"}, options);
+  for (int cf = 0; cf < 3; ++cf) {
+    for (int i = 0; i < 20; ++i) {
+      ASSERT_OK(Put(cf, Key(i), "cf" + ToString(cf) + "_" + ToString(i)));
+    }
+    ASSERT_OK(Flush(cf));
+  }
+  ASSERT_OK(Put(1, Key(3), "new"));
+
+  int retries = 0;
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::MultiGet:RetrySuperVersions",
+      [&](void* /*arg*/) { ++retries; });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  std::vector<Slice> keys;
+  std::vector<ColumnFamilyHandle*> cfs;
+  std::vector<std::string> key_strs;
+  for (int i = 19; i >= 0; --i) {
+    key_strs.push_back(Key(i));
+  }
+  for (int i = 0; i < 20; ++i) {
+    keys.push_back(key_strs[i]);
+    cfs.push_back(handles_[i % 3]);
+  }
+  std::vector<std::string> values;
+  std::vector<Status> statuses =
+      db_->MultiGet(ReadOptions(), cfs, keys, &values);
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_OK(statuses[i]);
+    int k = 19 - i;
+    if (k == 3 && i % 3 == 1) {
+      ASSERT_EQ("new", values[i]);
+    } else {
+      ASSERT_EQ("cf" + ToString(i % 3) + "_" + ToString(k), values[i]);
+    }
+  }
+  // Nothing changed the SuperVersions while the lookup was running.
+  ASSERT_EQ(0, retries);
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+#endif  // ROCKSDB_LITE
+
 TEST_F(DBBasicTest, ChecksumTest) {
   BlockBasedTableOptions table_options;
   Options options = CurrentOptions();
@@ -7,6 +7,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include <algorithm>
 #include <functional>
 #include <string>
 #include <utility>
@@ -401,6 +402,158 @@ TEST_F(DBBlobIndexTest, Iterate) {
   }
 }
 
+#ifndef ROCKSDB_LITE
+// Blob files written by flushes and compactions of the base rocksdb (see
+// ColumnFamilyOptions::enable_blob_files). Reads resolve the blob indexes in
+// the table files to the values they point at.
+class DBBlobFilesTest : public DBTestBase {
+ public:
+  DBBlobFilesTest() : DBTestBase("/db_blob_files_test") {}
+
+  Options GetBlobOptions() {
+    Options options = CurrentOptions();
+    options.enable_blob_files = true;
+    options.min_blob_size = 16;
+    options.disable_auto_compactions = true;
+    return options;
+  }
+
+  std::vector<uint64_t> GetBlobFileNumbers() {
+    std::vector<std::string> filenames;
+    EXPECT_OK(env_->GetChildren(dbname_, &filenames));
+    std::vector<uint64_t> numbers;
+    uint64_t number;
+    FileType type;
+    for (const auto& fname : filenames) {
+      if (ParseFileName(fname, &number, &type) && type == kBlobFile) {
+        numbers.push_back(number);
+      }
+    }
+    std::sort(numbers.begin(), numbers.end());
+    return numbers;
+  }
+
+  static std::string LargeValue(int i, int version) {
+    return std::string(100, static_cast<char>('a' + i % 26)) + ToString(i) +
+           "_" + ToString(version);
+  }
+};
+
+TEST_F(DBBlobFilesTest, FlushAndRead) {
+  Options options = GetBlobOptions();
+  options.statistics = CreateDBStatistics();
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 20;
+  for (int i = 0; i < kNumKeys; i++) {
+    // Every other value is small enough to stay in the table
+    std::string value = (i % 2 == 0) ? LargeValue(i, 0) : "small" + ToString(i);
+    ASSERT_OK(Put(Key(i), value));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ(1, GetBlobFileNumbers().size());
+  ASSERT_GT(options.statistics->getTickerCount(BLOB_DB_BLOB_FILE_BYTES_WRITTEN),
+            0);
+
+  auto verify = [&]() {
+    for (int i = 0; i < kNumKeys; i++) {
+      std::string expected =
+          (i % 2 == 0) ? LargeValue(i, 0) : "small" + ToString(i);
+      ASSERT_EQ(expected, Get(Key(i)));
+    }
+
+    std::vector<Slice> keys;
+    std::vector<std::string> key_strs;
+    for (int i = 0; i < kNumKeys; i++) {
+      key_strs.push_back(Key(i));
+    }
+    for (const auto& k : key_strs) {
+      keys.push_back(k);
+    }
+    std::vector<std::string> values;
+    std::vector<Status> statuses =
+        db_->MultiGet(ReadOptions(), keys, &values);
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_OK(statuses[i]);
+      ASSERT_EQ(Get(Key(i)), values[i]);
+    }
+
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    int i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), i++) {
+      ASSERT_EQ(Key(i), iter->key().ToString());
+      ASSERT_EQ(Get(Key(i)), iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys, i);
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+      i--;
+      ASSERT_EQ(Key(i), iter->key().ToString());
+      ASSERT_EQ(Get(Key(i)), iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(0, i);
+  };
+  verify();
+
+  Reopen(options);
+  verify();
+
+  // The blob files stay readable after they are no longer written to
+  options.enable_blob_files = false;
+  Reopen(options);
+  verify();
+}
+
+TEST_F(DBBlobFilesTest, CompactionCollectsGarbage) {
+  Options options = GetBlobOptions();
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 10;
+  for (int version = 0; version < 2; version++) {
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_OK(Put(Key(i), LargeValue(i, version)));
+    }
+    ASSERT_OK(Flush());
+  }
+  std::vector<uint64_t> flushed = GetBlobFileNumbers();
+  ASSERT_EQ(2, flushed.size());
+
+  // Without garbage collection, the compaction only drops the file that no
+  // longer has live values
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(std::vector<uint64_t>{flushed[1]}, GetBlobFileNumbers());
+
+  options.enable_blob_garbage_collection = true;
+  options.blob_garbage_collection_age_cutoff = 1.0;
+  Reopen(options);
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  std::vector<uint64_t> compacted = GetBlobFileNumbers();
+  ASSERT_EQ(1, compacted.size());
+  ASSERT_GT(compacted[0], flushed[1]);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(LargeValue(i, 1), Get(Key(i)));
+  }
+
+  // Values that got smaller than min_blob_size go back into the tables
+  options.min_blob_size = 1 << 20;
+  Reopen(options);
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  ASSERT_TRUE(GetBlobFileNumbers().empty());
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(LargeValue(i, 1), Get(Key(i)));
+  }
+}
+
+TEST_F(DBBlobFilesTest, MergeOperatorNotSupported) {
+  Options options = GetBlobOptions();
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+}
+#endif  // !ROCKSDB_LITE
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
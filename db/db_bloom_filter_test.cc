@@ -10,6 +10,10 @@
 #include "db/db_test_util.h"
 #include "port/stack_trace.h"
 #include "rocksdb/perf_context.h"
+#include "table/block_based_table_builder.h"
+#include "table/block_based_table_reader.h"
+#include "table/meta_blocks.h"
+#include "util/file_reader_writer.h"
 
 namespace rocksdb {
 
@@ -502,6 +506,152 @@ TEST_F(DBBloomFilterTest, BloomFilterReverseCompatibility) {
   }
 }
 
+TEST_F(DBBloomFilterTest, CacheLocalBloomFilterCompatibility) {
+  for (bool partition_filters : {true, false}) {
+    Options options = CurrentOptions();
+    options.statistics = rocksdb::CreateDBStatistics();
+    BlockBasedTableOptions table_options;
+    if (partition_filters) {
+      table_options.partition_filters = true;
+      table_options.index_type =
+          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+    }
+    table_options.filter_policy.reset(NewBloomFilterPolicy(10, false));
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    // Create one file with the legacy full filter
+    CreateAndReopenWithCF({"pikachu"}, options);
+    const int maxKey = 10000;
+    for (int i = 0; i < maxKey; i++) {
+      ASSERT_OK(Put(1, Key(i), Key(i)));
+    }
+    Flush(1);
+
+    // and one with the cache-local filter
+    table_options.filter_policy.reset(NewCacheLocalBloomFilterPolicy(10));
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    ReopenWithColumnFamilies({"default", "pikachu"}, options);
+    for (int i = maxKey; i < 2 * maxKey; i++) {
+      ASSERT_OK(Put(1, Key(i), Key(i)));
+    }
+    Flush(1);
+    ASSERT_EQ("2", FilesPerLevel(1));
+
+    // Both are read with either policy
+    for (bool cache_local : {true, false}) {
+      table_options.filter_policy.reset(
+          cache_local ? NewCacheLocalBloomFilterPolicy(10)
+                      : NewBloomFilterPolicy(10, false));
+      options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+      ReopenWithColumnFamilies({"default", "pikachu"}, options);
+      options.statistics->Reset();
+
+      for (int i = 0; i < 2 * maxKey; i++) {
+        ASSERT_EQ(Key(i), Get(1, Key(i)));
+      }
+      // With few L0 files each lookup consults the filters of all of them,
+      // so the keys of the older file are filtered out of the newer one
+      uint64_t useful = TestGetTickerCount(options, BLOOM_FILTER_USEFUL);
+      ASSERT_GE(useful, maxKey * 0.98);
+
+      for (int i = 0; i < 2 * maxKey; i++) {
+        ASSERT_EQ("NOT_FOUND", Get(1, Key(i) + ".missing"));
+      }
+      ASSERT_GE(TestGetTickerCount(options, BLOOM_FILTER_USEFUL) - useful,
+                4 * maxKey * 0.98);
+    }
+  }
+}
+
+TEST_F(DBBloomFilterTest, XorFilter) {
+  for (bool partition_filters : {true, false}) {
+    Options options = CurrentOptions();
+    options.statistics = rocksdb::CreateDBStatistics();
+    BlockBasedTableOptions table_options;
+    if (partition_filters) {
+      table_options.partition_filters = true;
+      table_options.index_type =
+          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+      table_options.metadata_block_size = 256;
+    }
+    table_options.filter_policy.reset(NewXorFilterPolicy(10));
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+    CreateAndReopenWithCF({"pikachu"}, options);
+
+    const int maxKey = 10000;
+    for (int i = 0; i < maxKey; i++) {
+      ASSERT_OK(Put(1, Key(i), Key(i)));
+    }
+    Flush(1);
+
+    for (int i = 0; i < maxKey; i++) {
+      ASSERT_EQ(Key(i), Get(1, Key(i)));
+    }
+    ASSERT_EQ(TestGetTickerCount(options, BLOOM_FILTER_USEFUL), 0);
+
+    // 10 Bloom-equivalent bits per key give about 0.8% false positives
+    for (int i = 0; i < maxKey; i++) {
+      ASSERT_EQ("NOT_FOUND", Get(1, Key(i) + ".missing"));
+    }
+    ASSERT_GE(TestGetTickerCount(options, BLOOM_FILTER_USEFUL), maxKey * 0.98);
+
+    // The filters are still read after switching back to a Bloom filter
+    table_options.filter_policy.reset(NewBloomFilterPolicy(10, false));
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    ReopenWithColumnFamilies({"default", "pikachu"}, options);
+    options.statistics->Reset();
+    for (int i = 0; i < maxKey; i++) {
+      ASSERT_EQ("NOT_FOUND", Get(1, Key(i) + ".missing"));
+    }
+    ASSERT_GE(TestGetTickerCount(options, BLOOM_FILTER_USEFUL), maxKey * 0.98);
+  }
+}
+
+TEST_F(DBBloomFilterTest, NewFilterFormatsIgnoredByOlderReleases) {
+  for (bool xor_filter : {true, false}) {
+    Options options = CurrentOptions();
+    BlockBasedTableOptions table_options;
+    table_options.filter_policy.reset(xor_filter
+                                          ? NewXorFilterPolicy(10)
+                                          : NewCacheLocalBloomFilterPolicy(10));
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+    ASSERT_OK(Put("foo", "bar"));
+    ASSERT_OK(Flush());
+
+    std::vector<LiveFileMetaData> files;
+    db_->GetLiveFilesMetaData(&files);
+    ASSERT_EQ(1U, files.size());
+    std::string fname = files[0].db_path + "/" + files[0].name;
+    uint64_t file_size;
+    ASSERT_OK(env_->GetFileSize(fname, &file_size));
+    unique_ptr<RandomAccessFile> file;
+    ASSERT_OK(env_->NewRandomAccessFile(fname, &file, EnvOptions()));
+    unique_ptr<RandomAccessFileReader> file_reader(
+        new RandomAccessFileReader(std::move(file), fname));
+    const ImmutableCFOptions ioptions(options);
+    BlockHandle handle;
+
+    // A release without the format looks the full filter up under the name
+    // of its builtin Bloom policy, doesn't find it and reads without it.
+    std::unique_ptr<const FilterPolicy> legacy_policy(
+        NewBloomFilterPolicy(10, false));
+    ASSERT_FALSE(FindMetaBlock(file_reader.get(), file_size,
+                               kBlockBasedTableMagicNumber, ioptions,
+                               BlockBasedTable::kFullFilterBlockPrefix +
+                                   legacy_policy->Name(),
+                               &handle)
+                     .ok());
+    ASSERT_OK(FindMetaBlock(file_reader.get(), file_size,
+                            kBlockBasedTableMagicNumber, ioptions,
+                            BlockBasedTable::kFullFilterBlockPrefix +
+                                table_options.filter_policy->Name(),
+                            &handle));
+  }
+}
+
 namespace {
 // A wrapped bloom over default FilterPolicy
 class WrappedBloom : public FilterPolicy {
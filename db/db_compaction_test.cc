@@ -7,9 +7,11 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include "db/compaction_service.h"
 #include "db/db_test_util.h"
 #include "port/stack_trace.h"
 #include "port/port.h"
+#include "rocksdb/compaction_service.h"
 #include "rocksdb/experimental.h"
 #include "rocksdb/utilities/convenience.h"
 #include "util/sync_point.h"
@@ -2935,6 +2937,228 @@ TEST_F(DBCompactionTest, CompactBottomLevelFilesWithDeletions) {
   }
 }
 
+TEST_F(DBCompactionTest, SubcompactionsIntoEmptyLevel) {
+  // Overlapping L0 files compacted into an empty L1 used to run as a single
+  // subcompaction. Sampling the input files' indexes splits them evenly.
+  const int kNumKeys = 4096;
+  const int kValueSize = 128;
+  Options options = CurrentOptions();
+  options.compression = kNoCompression;
+  options.level0_file_num_compaction_trigger = 2;
+  options.max_subcompactions = 4;
+  options.target_file_size_base = kNumKeys * kValueSize / 8;
+  options.statistics = rocksdb::CreateDBStatistics();
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  for (int i = 0; i < options.level0_file_num_compaction_trigger; ++i) {
+    for (int j = i; j < kNumKeys; j += 2) {
+      ASSERT_OK(Put(Key(j), RandomString(&rnd, kValueSize)));
+    }
+    Flush();
+  }
+  dbfull()->TEST_WaitForCompact();
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  ASSERT_GT(NumTableFilesAtLevel(1), 0);
+
+  HistogramData subcompactions;
+  options.statistics->histogramData(NUM_SUBCOMPACTIONS_SCHEDULED,
+                                    &subcompactions);
+  ASSERT_EQ(options.max_subcompactions, subcompactions.max);
+
+  for (int j = 0; j < kNumKeys; ++j) {
+    ASSERT_NE("NOT_FOUND", Get(Key(j)));
+  }
+}
+
+// Stands in for a service that ships compactions to a worker process. The
+// worker's side, DB::OpenAndCompact(), runs in-process.
+class LocalCompactionService : public CompactionService {
+ public:
+  LocalCompactionService(const std::string& db_path,
+                         const std::string& output_dir, const Options& options)
+      : db_path_(db_path),
+        output_dir_(output_dir),
+        options_(options),
+        num_runs_(0) {}
+
+  virtual const char* Name() const override {
+    return "LocalCompactionService";
+  }
+
+  virtual Status Run(const std::string& compaction_service_input,
+                     std::string* compaction_service_result) override {
+    num_runs_++;
+    return DB::OpenAndCompact(options_, db_path_, output_dir_,
+                              compaction_service_input,
+                              compaction_service_result);
+  }
+
+  int num_runs() const { return num_runs_.load(); }
+
+ private:
+  std::string db_path_;
+  std::string output_dir_;
+  Options options_;
+  std::atomic<int> num_runs_;
+};
+
+TEST_F(DBCompactionTest, CompactionService) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  const std::string output_dir = dbname_ + "_compaction_service";
+  auto service =
+      std::make_shared<LocalCompactionService>(dbname_, output_dir, options);
+  options.compaction_service = service;
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), "old" + ToString(i)));
+  }
+  Flush();
+  const Snapshot* snapshot = db_->GetSnapshot();
+  for (int i = 0; i < 100; ++i) {
+    if (i % 3 == 0) {
+      ASSERT_OK(Delete(Key(i)));
+    } else {
+      ASSERT_OK(Put(Key(i), "new" + ToString(i)));
+    }
+  }
+  Flush();
+  ASSERT_EQ(2, NumTableFilesAtLevel(0));
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_GT(service->num_runs(), 0);
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+
+  // The worker's output files were moved into the DB.
+  std::vector<std::string> children;
+  ASSERT_OK(env_->GetChildren(output_dir, &children));
+  for (const auto& child : children) {
+    ASSERT_EQ(std::string::npos, child.find(".sst")) << child;
+  }
+
+  // Both versions survive, since the snapshot was sent to the worker.
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(i % 3 == 0 ? "NOT_FOUND" : "new" + ToString(i), Get(Key(i)));
+    ASSERT_EQ("old" + ToString(i), Get(Key(i), snapshot));
+  }
+  db_->ReleaseSnapshot(snapshot);
+
+  // The installed files are part of the DB across reopens.
+  Reopen(options);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(i % 3 == 0 ? "NOT_FOUND" : "new" + ToString(i), Get(Key(i)));
+  }
+
+  for (const auto& child : children) {
+    env_->DeleteFile(output_dir + "/" + child);
+  }
+  env_->DeleteDir(output_dir);
+}
+
+// Fails every compaction, like a service whose workers can't be reached
+class FailingCompactionService : public CompactionService {
+ public:
+  FailingCompactionService() : num_runs_(0) {}
+
+  virtual const char* Name() const override {
+    return "FailingCompactionService";
+  }
+
+  virtual Status Run(const std::string& /*compaction_service_input*/,
+                     std::string* /*compaction_service_result*/) override {
+    num_runs_++;
+    return Status::IOError("Compaction worker unreachable");
+  }
+
+  int num_runs() const { return num_runs_.load(); }
+
+ private:
+  std::atomic<int> num_runs_;
+};
+
+TEST_F(DBCompactionTest, CompactionServiceError) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.paranoid_checks = true;
+  auto service = std::make_shared<FailingCompactionService>();
+  options.compaction_service = service;
+  DestroyAndReopen(options);
+
+  // Overlapping files, so the compaction is not a trivial move
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_OK(Put(Key(0), "v0"));
+    ASSERT_OK(Put(Key(1), "v1"));
+    Flush();
+  }
+  ASSERT_TRUE(
+      db_->CompactRange(CompactRangeOptions(), nullptr, nullptr).IsIOError());
+  ASSERT_EQ(1, service->num_runs());
+  ASSERT_EQ(2, NumTableFilesAtLevel(0));
+
+  // The failure is not a background error, so the DB stays writable
+  ASSERT_OK(Put(Key(2), "v2"));
+  ASSERT_OK(Flush());
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ("v" + ToString(i), Get(Key(i)));
+  }
+  ASSERT_EQ(3, NumTableFilesAtLevel(0));
+}
+
+TEST_F(DBCompactionTest, CompactionServiceSkipsBlobFiles) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.enable_blob_files = true;
+  options.min_blob_size = 16;
+  const std::string output_dir = dbname_ + "_compaction_service";
+  auto service =
+      std::make_shared<LocalCompactionService>(dbname_, output_dir, options);
+  options.compaction_service = service;
+  DestroyAndReopen(options);
+
+  const std::string large_value(100, 'v');
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 50; ++j) {
+      ASSERT_OK(Put(Key(j), large_value + ToString(i)));
+    }
+    Flush();
+  }
+  ASSERT_EQ(2, NumTableFilesAtLevel(0));
+
+  // Blob files are not returned by the service, so the compaction runs here.
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, service->num_runs());
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  for (int j = 0; j < 50; ++j) {
+    ASSERT_EQ(large_value + "1", Get(Key(j)));
+  }
+
+  // Nor does the worker run compactions that would write blob files.
+  CompactionServiceInput input;
+  input.column_family_name = kDefaultColumnFamilyName;
+  input.output_level = 1;
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_FALSE(files.empty());
+  for (const auto& file : files) {
+    input.input_file_numbers.push_back(
+        ParseUint64(file.name.substr(1, file.name.find('.') - 1)));
+  }
+  std::string serialized_input;
+  std::string serialized_result;
+  input.EncodeTo(&serialized_input);
+  ASSERT_TRUE(service->Run(serialized_input, &serialized_result)
+                  .IsNotSupported());
+
+  std::vector<std::string> children;
+  env_->GetChildren(output_dir, &children);
+  for (const auto& child : children) {
+    env_->DeleteFile(output_dir + "/" + child);
+  }
+  env_->DeleteDir(output_dir);
+}
+
 INSTANTIATE_TEST_CASE_P(DBCompactionTestWithParam, DBCompactionTestWithParam,
                         ::testing::Values(std::make_tuple(1, true),
                                           std::make_tuple(1, false),
@@ -111,23 +111,32 @@ Status DBImpl::GetLiveFiles(std::vector<std::string>& ret,
     }
   }
 
-  // Make a set of all of the live *.sst files
+  // Make a set of all of the live *.sst and *.blob files
   std::vector<FileDescriptor> live;
+  std::vector<uint64_t> live_blob_files;
   for (auto cfd : *versions_->GetColumnFamilySet()) {
     if (cfd->IsDropped()) {
       continue;
     }
-    cfd->current()->AddLiveFiles(&live);
+    cfd->current()->AddLiveFiles(&live, &live_blob_files);
   }
+  std::sort(live_blob_files.begin(), live_blob_files.end());
+  live_blob_files.erase(
+      std::unique(live_blob_files.begin(), live_blob_files.end()),
+      live_blob_files.end());
 
   ret.clear();
-  ret.reserve(live.size() + 3);  // *.sst + CURRENT + MANIFEST + OPTIONS
+  // *.sst + *.blob + CURRENT + MANIFEST + OPTIONS
+  ret.reserve(live.size() + live_blob_files.size() + 3);
 
   // create names of the live files. The names are not absolute
   // paths, instead they are relative to dbname_;
   for (auto live_file : live) {
     ret.push_back(MakeTableFileName("", live_file.GetNumber()));
   }
+  for (auto number : live_blob_files) {
+    ret.push_back(BlobFileName("", number));
+  }
 
   ret.push_back(CurrentFileName(""));
   ret.push_back(DescriptorFileName("", versions_->manifest_file_number()));
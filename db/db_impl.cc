@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <deque>
 #include <map>
 #include <set>
 #include <stdexcept>
@@ -152,6 +153,8 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       logfile_number_(0),
       log_dir_synced_(false),
       log_empty_(true),
+      next_wal_stripe_(0),
+      unsynced_wal_stripes_(options.wal_stripes, false),
       default_cf_handle_(nullptr),
       log_sync_cv_(&mutex_),
       total_log_size_(0),
@@ -160,6 +163,10 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       write_buffer_manager_(immutable_db_options_.write_buffer_manager.get()),
       write_thread_(immutable_db_options_),
       nonmem_write_thread_(immutable_db_options_),
+      wal_written_sequence_(0),
+      wal_synced_sequence_(0),
+      wal_unsynced_bytes_(0),
+      wal_syncer_stop_(false),
       write_controller_(mutable_db_options_.delayed_write_rate),
       // Use delayed_write_rate as a base line to determine the initial
       // low pri write rate limit. It may be adjusted later.
@@ -274,6 +281,18 @@ void DBImpl::CancelAllBackgroundWork(bool wait) {
 }
 
 DBImpl::~DBImpl() {
+  if (async_write_pool_ != nullptr) {
+    // The pending async writes still need a fully working DB
+    async_write_pool_->WaitForJobsAndJoinAllThreads();
+  }
+  if (wal_syncer_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(wal_syncer_mutex_);
+      wal_syncer_stop_ = true;
+    }
+    wal_syncer_cv_.notify_one();
+    wal_syncer_thread_.join();
+  }
   // CancelAllBackgroundWork called with false means we just set the shutdown
   // marker. After this we do a variant of the waiting and unschedule work
   // (to consider: moving all the waiting into CancelAllBackgroundWork(true))
@@ -684,8 +703,9 @@ Status DBImpl::SyncWAL() {
     InstrumentedMutexLock l(&mutex_);
     assert(!logs_.empty());
 
-    // This SyncWAL() call only cares about logs up to this number.
-    current_log_number = logfile_number_;
+    // This SyncWAL() call only cares about logs up to this number. With WAL
+    // stripes that is the last stripe of the current WAL.
+    current_log_number = logs_.back().number;
 
     while (logs_.front().number <= current_log_number &&
            logs_.front().getting_synced) {
@@ -741,14 +761,15 @@ void DBImpl::MarkLogsSynced(
     uint64_t up_to, bool synced_dir, const Status& status) {
   mutex_.AssertHeld();
   if (synced_dir &&
-      logfile_number_ == up_to &&
+      logfile_number_ <= up_to &&
       status.ok()) {
     log_dir_synced_ = true;
   }
   for (auto it = logs_.begin(); it != logs_.end() && it->number <= up_to;) {
     auto& log = *it;
     assert(log.getting_synced);
-    if (status.ok() && logs_.size() > 1) {
+    // The logs of the current WAL are kept
+    if (status.ok() && logs_.size() > 1 && log.number < logfile_number_) {
       logs_to_free_.push_back(log.ReleaseWriter());
       it = logs_.erase(it);
     } else {
@@ -757,7 +778,7 @@ void DBImpl::MarkLogsSynced(
     }
   }
   assert(!status.ok() || logs_.empty() || logs_[0].number > up_to ||
-         (logs_.size() == 1 && !logs_[0].getting_synced));
+         (logs_[0].number == logfile_number_ && !logs_[0].getting_synced));
   log_sync_cv_.SignalAll();
 }
 
@@ -1066,111 +1087,180 @@ std::vector<Status> DBImpl::MultiGet(
   struct MultiGetColumnFamilyData {
     ColumnFamilyData* cfd;
     SuperVersion* super_version;
+    // Indexes into "keys" of the lookups in this column family
+    std::vector<size_t> key_indexes;
   };
-  std::unordered_map<uint32_t, MultiGetColumnFamilyData*> multiget_cf_data;
-  // fill up and allocate outside of mutex
-  for (auto cf : column_family) {
-    auto cfh = reinterpret_cast<ColumnFamilyHandleImpl*>(cf);
+  std::unordered_map<uint32_t, MultiGetColumnFamilyData> multiget_cf_data;
+  for (size_t i = 0; i < column_family.size(); ++i) {
+    auto cfh = reinterpret_cast<ColumnFamilyHandleImpl*>(column_family[i]);
     auto cfd = cfh->cfd();
-    if (multiget_cf_data.find(cfd->GetID()) == multiget_cf_data.end()) {
-      auto mgcfd = new MultiGetColumnFamilyData();
-      mgcfd->cfd = cfd;
-      multiget_cf_data.insert({cfd->GetID(), mgcfd});
+    auto& mgcfd = multiget_cf_data[cfd->GetID()];
+    mgcfd.cfd = cfd;
+    mgcfd.key_indexes.push_back(i);
+  }
+
+  // Acquire the SuperVersions through the thread-local cache like GetImpl()
+  // does. Without an explicit snapshot, the sequence number is read after all
+  // of them are referenced. With several column families that is only a
+  // consistent view if none of them installed a new SuperVersion in the
+  // meantime, so retry a few times and fall back to the DB mutex if they keep
+  // changing.
+  const int kMaxSuperVersionAttempts = 3;
+  bool acquired_under_mutex = false;
+  for (int attempt = 1;; ++attempt) {
+    if (attempt == kMaxSuperVersionAttempts) {
+      InstrumentedMutexLock l(&mutex_);
+      for (auto& mgd_iter : multiget_cf_data) {
+        mgd_iter.second.super_version =
+            mgd_iter.second.cfd->GetSuperVersion()->Ref();
+      }
+      snapshot = read_options.snapshot != nullptr
+                     ? reinterpret_cast<const SnapshotImpl*>(
+                           read_options.snapshot)->number_
+                     : (allocate_seq_only_for_data_
+                            ? versions_->LastSequence()
+                            : versions_->LastAllocatedSequence());
+      acquired_under_mutex = true;
+      break;
     }
-  }
 
-  mutex_.Lock();
-  if (read_options.snapshot != nullptr) {
-    snapshot = reinterpret_cast<const SnapshotImpl*>(
-        read_options.snapshot)->number_;
-  } else {
+    for (auto& mgd_iter : multiget_cf_data) {
+      mgd_iter.second.super_version =
+          GetAndRefSuperVersion(mgd_iter.second.cfd);
+    }
+    if (read_options.snapshot != nullptr) {
+      snapshot = reinterpret_cast<const SnapshotImpl*>(
+          read_options.snapshot)->number_;
+      break;
+    }
     snapshot = allocate_seq_only_for_data_ ? versions_->LastSequence()
                                            : versions_->LastAllocatedSequence();
+    if (multiget_cf_data.size() == 1) {
+      // Same reasoning as in GetImpl()
+      break;
+    }
+    bool consistent = true;
+    for (auto& mgd_iter : multiget_cf_data) {
+      if (mgd_iter.second.super_version->version_number !=
+          mgd_iter.second.cfd->GetSuperVersionNumber()) {
+        consistent = false;
+        break;
+      }
+    }
+    if (consistent) {
+      break;
+    }
+    TEST_SYNC_POINT("DBImpl::MultiGet:RetrySuperVersions");
+    for (auto& mgd_iter : multiget_cf_data) {
+      ReturnAndCleanupSuperVersion(mgd_iter.second.cfd,
+                                   mgd_iter.second.super_version);
+    }
   }
-  for (auto mgd_iter : multiget_cf_data) {
-    mgd_iter.second->super_version =
-        mgd_iter.second->cfd->GetSuperVersion()->Ref();
-  }
-  mutex_.Unlock();
-
-  // Contain a list of merge operations if merge occurs.
-  MergeContext merge_context;
 
   // Note: this always resizes the values array
   size_t num_keys = keys.size();
   std::vector<Status> stat_list(num_keys);
   values->resize(num_keys);
 
+  // Per-key lookup state. LookupKey and RangeDelAggregator are neither
+  // copyable nor movable, hence the deques.
+  std::deque<LookupKey> lookup_keys;
+  std::deque<RangeDelAggregator> range_del_aggs;
+  std::deque<PinnableSlice> pinnable_vals;
+  std::vector<MergeContext> merge_contexts(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    auto cfh = reinterpret_cast<ColumnFamilyHandleImpl*>(column_family[i]);
+    lookup_keys.emplace_back(keys[i], snapshot);
+    range_del_aggs.emplace_back(cfh->cfd()->internal_comparator(), snapshot);
+    pinnable_vals.emplace_back(&(*values)[i]);
+  }
+
   // Keep track of bytes that we read for statistics-recording later
   uint64_t bytes_read = 0;
   PERF_TIMER_STOP(get_snapshot_time);
 
-  // For each of the given keys, apply the entire "get" process as follows:
-  // First look in the memtable, then in the immutable memtable (if any).
-  // s is both in/out. When in, s could either be OK or MergeInProgress.
-  // merge_operands will contain the sequence of merges in the latter case.
-  for (size_t i = 0; i < num_keys; ++i) {
-    merge_context.Clear();
-    Status& s = stat_list[i];
-    std::string* value = &(*values)[i];
-
-    LookupKey lkey(keys[i], snapshot);
-    auto cfh = reinterpret_cast<ColumnFamilyHandleImpl*>(column_family[i]);
-    RangeDelAggregator range_del_agg(cfh->cfd()->internal_comparator(),
-                                     snapshot);
-    auto mgd_iter = multiget_cf_data.find(cfh->cfd()->GetID());
-    assert(mgd_iter != multiget_cf_data.end());
-    auto mgd = mgd_iter->second;
-    auto super_version = mgd->super_version;
-    bool skip_memtable =
-        (read_options.read_tier == kPersistedTier &&
-         has_unpersisted_data_.load(std::memory_order_relaxed));
-    bool done = false;
-    if (!skip_memtable) {
-      if (super_version->mem->Get(lkey, value, &s, &merge_context,
-                                  &range_del_agg, read_options)) {
-        done = true;
-        // TODO(?): RecordTick(stats_, MEMTABLE_HIT)?
-      } else if (super_version->imm->Get(lkey, value, &s, &merge_context,
-                                         &range_del_agg, read_options)) {
-        done = true;
-        // TODO(?): RecordTick(stats_, MEMTABLE_HIT)?
+  bool skip_memtable =
+      (read_options.read_tier == kPersistedTier &&
+       has_unpersisted_data_.load(std::memory_order_relaxed));
+  std::vector<MultiGetKey> sst_keys;
+  std::vector<MultiGetKey*> sst_key_ptrs;
+  for (auto& mgd_iter : multiget_cf_data) {
+    auto& mgd = mgd_iter.second;
+    auto super_version = mgd.super_version;
+    const Comparator* ucmp = mgd.cfd->user_comparator();
+    std::sort(mgd.key_indexes.begin(), mgd.key_indexes.end(),
+              [&](size_t a, size_t b) {
+                return ucmp->Compare(keys[a], keys[b]) < 0;
+              });
+
+    // For each of the given keys, first look in the memtable, then in the
+    // immutable memtable (if any). s is both in/out. When in, s could either
+    // be OK or MergeInProgress. merge_operands will contain the sequence of
+    // merges in the latter case. Keys that are not resolved there are looked
+    // up in the SST files as one sorted batch.
+    sst_keys.clear();
+    for (size_t i : mgd.key_indexes) {
+      Status& s = stat_list[i];
+      PinnableSlice* pinnable_val = &pinnable_vals[i];
+      bool done = false;
+      if (!skip_memtable) {
+        if (super_version->mem->Get(lookup_keys[i], pinnable_val->GetSelf(),
+                                    &s, &merge_contexts[i], &range_del_aggs[i],
+                                    read_options)) {
+          done = true;
+          pinnable_val->PinSelf();
+          RecordTick(stats_, MEMTABLE_HIT);
+        } else if ((s.ok() || s.IsMergeInProgress()) &&
+                   super_version->imm->Get(
+                       lookup_keys[i], pinnable_val->GetSelf(), &s,
+                       &merge_contexts[i], &range_del_aggs[i],
+                       read_options)) {
+          done = true;
+          pinnable_val->PinSelf();
+          RecordTick(stats_, MEMTABLE_HIT);
+        }
+        if (!done && !s.ok() && !s.IsMergeInProgress()) {
+          done = true;
+        }
+      }
+      if (!done) {
+        sst_keys.push_back({&lookup_keys[i], pinnable_val, &s,
+                            &merge_contexts[i], &range_del_aggs[i]});
       }
     }
-    if (!done) {
-      PinnableSlice pinnable_val;
+    if (!sst_keys.empty()) {
       PERF_TIMER_GUARD(get_from_output_files_time);
-      super_version->current->Get(read_options, lkey, &pinnable_val, &s,
-                                  &merge_context, &range_del_agg);
-      value->assign(pinnable_val.data(), pinnable_val.size());
-      // TODO(?): RecordTick(stats_, MEMTABLE_MISS)?
-    }
-
-    if (s.ok()) {
-      bytes_read += value->size();
+      sst_key_ptrs.clear();
+      for (auto& sst_key : sst_keys) {
+        sst_key_ptrs.push_back(&sst_key);
+      }
+      super_version->current->MultiGet(read_options, sst_key_ptrs);
+      RecordTick(stats_, MEMTABLE_MISS, sst_keys.size());
     }
   }
 
   // Post processing (decrement reference counts and record statistics)
   PERF_TIMER_GUARD(get_post_process_time);
-  autovector<SuperVersion*> superversions_to_delete;
-
-  // TODO(icanadi) do we need lock here or just around Cleanup()?
-  mutex_.Lock();
-  for (auto mgd_iter : multiget_cf_data) {
-    auto mgd = mgd_iter.second;
-    if (mgd->super_version->Unref()) {
-      mgd->super_version->Cleanup();
-      superversions_to_delete.push_back(mgd->super_version);
+  for (size_t i = 0; i < num_keys; ++i) {
+    PinnableSlice& pinnable_val = pinnable_vals[i];
+    if (pinnable_val.IsPinned()) {
+      // The value points into a block; copy it out before the block is
+      // released.
+      (*values)[i].assign(pinnable_val.data(), pinnable_val.size());
+    }
+    if (stat_list[i].ok()) {
+      bytes_read += pinnable_val.size();
     }
   }
-  mutex_.Unlock();
+  pinnable_vals.clear();
 
-  for (auto td : superversions_to_delete) {
-    delete td;
-  }
-  for (auto mgd : multiget_cf_data) {
-    delete mgd.second;
+  for (auto& mgd_iter : multiget_cf_data) {
+    if (acquired_under_mutex) {
+      CleanupSuperVersion(mgd_iter.second.super_version);
+    } else {
+      ReturnAndCleanupSuperVersion(mgd_iter.second.cfd,
+                                   mgd_iter.second.super_version);
+    }
   }
 
   RecordTick(stats_, NUMBER_MULTIGET_CALLS);
@@ -1262,6 +1352,9 @@ Status DBImpl::CreateColumnFamilyImpl(const ColumnFamilyOptions& cf_options,
   if (s.ok() && immutable_db_options_.allow_concurrent_memtable_write) {
     s = CheckConcurrentWritesSupported(cf_options);
   }
+  if (s.ok()) {
+    s = CheckBlobFilesSupported(cf_options);
+  }
   if (!s.ok()) {
     return s;
   }
@@ -1488,7 +1581,8 @@ Iterator* DBImpl::NewIterator(const ReadOptions& read_options,
         env_, read_options, *cfd->ioptions(), cfd->user_comparator(), iter,
         kMaxSequenceNumber,
         sv->mutable_cf_options.max_sequential_skip_in_iterations,
-        read_callback);
+        read_callback, false /* allow_blob */,
+        cfd->GetBlobSourceForIterator(sv));
 #endif
   } else {
     // Note: no need to consider the special case of
@@ -1555,7 +1649,8 @@ ArenaWrappedDBIter* DBImpl::NewIteratorImpl(const ReadOptions& read_options,
       env_, read_options, *cfd->ioptions(), snapshot,
       sv->mutable_cf_options.max_sequential_skip_in_iterations,
       sv->version_number, read_callback,
-      ((read_options.snapshot != nullptr) ? nullptr : this), cfd, allow_blob);
+      ((read_options.snapshot != nullptr) ? nullptr : this), cfd, allow_blob,
+      cfd->GetBlobSourceForIterator(sv));
 
   InternalIterator* internal_iter =
       NewInternalIterator(read_options, cfd, sv, db_iter->GetArena(),
@@ -1605,7 +1700,8 @@ Status DBImpl::NewIterators(
           env_, read_options, *cfd->ioptions(), cfd->user_comparator(), iter,
           kMaxSequenceNumber,
           sv->mutable_cf_options.max_sequential_skip_in_iterations,
-          read_callback));
+          read_callback, false /* allow_blob */,
+          cfd->GetBlobSourceForIterator(sv)));
     }
 #endif
   } else {
@@ -2021,6 +2117,9 @@ Status DBImpl::GetUpdatesSince(
     const TransactionLogIterator::ReadOptions& read_options) {
 
   RecordTick(stats_, GET_UPDATES_SINCE_CALLS);
+  if (immutable_db_options_.wal_stripes > 1) {
+    return Status::NotSupported("GetUpdatesSince() with WAL stripes");
+  }
   if (seq > versions_->LastSequence()) {
     return Status::NotFound("Requested sequence not yet written in the db");
   }
@@ -9,14 +9,17 @@
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <functional>
 #include <limits>
 #include <list>
 #include <map>
+#include <mutex>
 #include <queue>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -51,6 +54,7 @@
 #include "util/hash.h"
 #include "util/stop_watch.h"
 #include "util/thread_local.h"
+#include "util/threadpool_imp.h"
 
 namespace rocksdb {
 
@@ -63,6 +67,8 @@ class VersionEdit;
 class VersionSet;
 class WriteCallback;
 struct JobContext;
+struct CompactionServiceInput;
+struct CompactionServiceResult;
 struct ExternalSstFileInfo;
 struct MemTableInfo;
 
@@ -92,6 +98,9 @@ class DBImpl : public DB {
   using DB::Write;
   virtual Status Write(const WriteOptions& options,
                        WriteBatch* updates) override;
+  virtual Status WriteAsync(
+      const WriteOptions& options, WriteBatch* updates,
+      std::function<void(const Status&)> callback) override;
 
   using DB::Get;
   virtual Status Get(const ReadOptions& options,
@@ -324,6 +333,14 @@ class DBImpl : public DB {
 
   virtual Status VerifyChecksum() override;
 
+  // Runs the compaction described by `input` in this DB, which is expected
+  // to be a read-only instance opened by DB::OpenAndCompact(), writing the
+  // output files to `output_directory` without installing them.
+  Status CompactForService(ColumnFamilyHandle* column_family,
+                           const CompactionServiceInput& input,
+                           const std::string& output_directory,
+                           CompactionServiceResult* result);
+
 #endif  // ROCKSDB_LITE
 
   // Similar to GetSnapshot(), but also lets the db know that this snapshot
@@ -783,6 +800,26 @@ class DBImpl : public DB {
   Status RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
                          SequenceNumber* next_sequence, bool read_only);
 
+  // Replays the logs of a WAL that is not striped, one after the other.
+  // Helper of RecoverLogFiles().
+  // REQUIRES: log_numbers are sorted in ascending order
+  Status ReplayLogFiles(const std::vector<uint64_t>& log_numbers, int job_id,
+                        std::unordered_map<int, VersionEdit>* version_edits,
+                        SequenceNumber* next_sequence, bool read_only,
+                        bool* flushed, bool* stop_replay_for_corruption,
+                        uint64_t* corrupted_log_number);
+
+  // Replays the logs of a WAL striped over several log files (see
+  // DBOptions::wal_stripes) in sequence number order. Helper of
+  // RecoverLogFiles().
+  // REQUIRES: log_numbers are sorted in ascending order
+  Status RecoverWalStripes(const std::vector<uint64_t>& log_numbers,
+                           int job_id,
+                           std::unordered_map<int, VersionEdit>* version_edits,
+                           SequenceNumber* next_sequence, bool read_only,
+                           bool* flushed, bool* stop_replay_for_corruption,
+                           uint64_t* corrupted_log_number);
+
   // The following two methods are used to flush a memtable to
   // storage. The first one is used at database RecoveryTime (when the
   // database is opened) and is heavyweight because it holds the mutex
@@ -798,6 +835,13 @@ class DBImpl : public DB {
   Status ThrottleLowPriWritesIfNeeded(const WriteOptions& write_options,
                                       WriteBatch* my_batch);
 
+  // Stops or delays the write while a column family that my_batch writes to
+  // has a write stall of its own, see
+  // DBOptions::per_column_family_write_stall.
+  // REQUIRES: mutex_ not held
+  Status DelayColumnFamilyWrites(const WriteOptions& write_options,
+                                 WriteBatch* my_batch);
+
   Status ScheduleFlushes(WriteContext* context);
 
   Status SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context);
@@ -835,6 +879,25 @@ class DBImpl : public DB {
                               uint64_t* log_used, SequenceNumber* last_sequence,
                               size_t seq_inc);
 
+  // With WAL stripes (see DBOptions::wal_stripes), returns the log of the
+  // current WAL that the next write group appends to. If sync is true, the
+  // stripes that the group has to sync once it has appended are added to
+  // *stripes_to_sync.
+  // REQUIRES: mutex locked and this thread is the WAL write group leader
+  log::Writer* SelectWalStripe(bool sync,
+                               autovector<log::Writer*>* stripes_to_sync);
+
+  // Syncs the WAL stripes returned by SelectWalStripe()
+  Status SyncWalStripes(const autovector<log::Writer*>& stripes_to_sync);
+
+  // With DBOptions::wal_sync_interval_micros, the WAL syncer thread syncs the
+  // WAL on behalf of the sync writes, which wait for it in WaitForWalSync().
+  // The WAL write group leaders report the WAL written up to sequence, and
+  // the bytes they appended, with NotifyWalSyncer().
+  void BGWalSyncer();
+  void NotifyWalSyncer(SequenceNumber sequence, uint64_t bytes);
+  Status WaitForWalSync(const WriteThread::Writer& w);
+
   // Used by WriteImpl to update bg_error_ if paranoid check is enabled.
   void WriteCallbackStatusCheck(const Status& status);
 
@@ -849,6 +912,18 @@ class DBImpl : public DB {
                           const int output_level, int output_path_id,
                           JobContext* job_context, LogBuffer* log_buffer);
 
+  // Returns true if `c` is to be executed through
+  // immutable_db_options_.compaction_service rather than locally.
+  bool UseCompactionService(const Compaction* c) const;
+
+  // Executes `c` through immutable_db_options_.compaction_service and
+  // installs the output files it returns. *service_failed is set if the
+  // service fails or its output files can't be moved into the DB, in which
+  // case the DB is left unchanged.
+  // REQUIRES: mutex_ held
+  Status RunCompactionService(Compaction* c, JobContext* job_context,
+                              LogBuffer* log_buffer, bool* service_failed);
+
   // Wait for current IngestExternalFile() calls to finish.
   // REQUIRES: mutex_ held
   void WaitForIngestFile();
@@ -955,6 +1030,13 @@ class DBImpl : public DB {
   // read and writes are protected by log_write_mutex_ instead. This is to avoid
   // expesnive mutex_ lock during WAL write, which update log_empty_.
   bool log_empty_;
+  // With WAL stripes, the current WAL is made of the last wal_stripes logs_,
+  // and logfile_number_ is the number of the first of them. The stripe the
+  // next write group appends to, and whether each stripe has been appended
+  // to since a write group last synced it. Only accessed by the WAL write
+  // group leader.
+  size_t next_wal_stripe_;
+  std::vector<bool> unsynced_wal_stripes_;
   ColumnFamilyHandleImpl* default_cf_handle_;
   InternalStats* default_cf_internal_stats_;
   unique_ptr<ColumnFamilyMemTablesImpl> column_family_memtables_;
@@ -1070,6 +1152,23 @@ class DBImpl : public DB {
   // in 2PC to batch the prepares separately from the serial commit.
   WriteThread nonmem_write_thread_;
 
+  // Threads doing the WriteAsync() writes, created by the first one
+  std::unique_ptr<ThreadPoolImpl> async_write_pool_;
+  std::once_flag async_write_pool_created_;
+
+  // State of the WAL syncer thread (see BGWalSyncer), guarded by
+  // wal_syncer_mutex_. wal_syncer_cv_ wakes up the syncer, and
+  // wal_synced_cv_ the writes waiting for it.
+  port::Thread wal_syncer_thread_;
+  std::mutex wal_syncer_mutex_;
+  std::condition_variable wal_syncer_cv_;
+  std::condition_variable wal_synced_cv_;
+  SequenceNumber wal_written_sequence_;
+  SequenceNumber wal_synced_sequence_;
+  uint64_t wal_unsynced_bytes_;
+  Status wal_syncer_status_;
+  bool wal_syncer_stop_;
+
   WriteController write_controller_;
 
   unique_ptr<RateLimiter> low_pri_write_rate_limiter_;
@@ -764,7 +764,7 @@ Status DBImpl::ReFitLevel(ColumnFamilyData* cfd, int level, int target_level) {
       edit.AddFile(to_level, f->fd.GetNumber(), f->fd.GetPathId(),
                    f->fd.GetFileSize(), f->smallest, f->largest,
                    f->smallest_seqno, f->largest_seqno,
-                   f->marked_for_compaction);
+                   f->marked_for_compaction, f->blob_file_numbers);
     }
     ROCKS_LOG_DEBUG(immutable_db_options_.info_log,
                     "[%s] Apply version edit:\n%s", cfd->GetName().c_str(),
@@ -1456,6 +1456,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
       is_manual && manual_compaction->disallow_trivial_move;
 
   CompactionJobStats compaction_job_stats;
+  bool compaction_service_failed = false;
   Status status = bg_error_;
   if (status.ok() && shutting_down_.load(std::memory_order_acquire)) {
     status = Status::ShutdownInProgress();
@@ -1616,7 +1617,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
         c->edit()->AddFile(c->output_level(), f->fd.GetNumber(),
                            f->fd.GetPathId(), f->fd.GetFileSize(), f->smallest,
                            f->largest, f->smallest_seqno, f->largest_seqno,
-                           f->marked_for_compaction);
+                           f->marked_for_compaction, f->blob_file_numbers);
 
         ROCKS_LOG_BUFFER(log_buffer, "[%s] Moving #%" PRIu64
                                      " to level-%d %" PRIu64 " bytes\n",
@@ -1678,6 +1679,17 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     ++bg_bottom_compaction_scheduled_;
     env_->Schedule(&DBImpl::BGWorkBottomCompaction, ca, Env::Priority::BOTTOM,
                    this, &DBImpl::UnscheduleCallback);
+#ifndef ROCKSDB_LITE
+  } else if (UseCompactionService(c.get())) {
+    status = RunCompactionService(c.get(), job_context, log_buffer,
+                                  &compaction_service_failed);
+    if (status.ok()) {
+      InstallSuperVersionAndScheduleWork(
+          c->column_family_data(), &job_context->superversion_context,
+          *c->mutable_cf_options());
+      *made_progress = true;
+    }
+#endif  // !ROCKSDB_LITE
   } else {
     int output_level  __attribute__((unused));
     output_level = c->output_level();
@@ -1719,7 +1731,9 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
   }
   if (c != nullptr) {
     c->ReleaseCompactionFiles(status);
-    *made_progress = true;
+    if (status.ok()) {
+      *made_progress = true;
+    }
     NotifyOnCompactionCompleted(
         c->column_family_data(), c.get(), status,
         compaction_job_stats, job_context->job_id);
@@ -1731,6 +1745,10 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     // Done
   } else if (status.IsShutdownInProgress()) {
     // Ignore compaction errors found during shutting down
+  } else if (compaction_service_failed) {
+    // The DB is unchanged, so the inputs are just compacted again later
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Compaction service error: %s", status.ToString().c_str());
   } else {
     ROCKS_LOG_WARN(immutable_db_options_.info_log, "Compaction error: %s",
                    status.ToString().c_str());
@@ -0,0 +1,311 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/db_impl.h"
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#include <inttypes.h>
+#include <limits>
+
+#include "db/compaction_job.h"
+#include "db/compaction_service.h"
+#include "rocksdb/compaction_service.h"
+#include "util/cast_util.h"
+#include "util/file_util.h"
+#include "util/filename.h"
+#include "util/sst_file_manager_impl.h"
+#include "util/sync_point.h"
+
+namespace rocksdb {
+
+#ifndef ROCKSDB_LITE
+
+bool DBImpl::UseCompactionService(const Compaction* c) const {
+  if (immutable_db_options_.compaction_service == nullptr) {
+    return false;
+  }
+  // The service returns table files only, so compactions that write or carry
+  // over blob files run locally. So do the ones that need a snapshot checker
+  // to tell which versions are committed, which the worker doesn't have.
+  return !c->column_family_data()->ioptions()->enable_blob_files &&
+         !c->HasBlobFileReferences() && snapshot_checker_ == nullptr &&
+         !use_custom_gc_;
+}
+
+Status DBImpl::RunCompactionService(Compaction* c, JobContext* job_context,
+                                    LogBuffer* log_buffer,
+                                    bool* service_failed) {
+  mutex_.AssertHeld();
+  ColumnFamilyData* cfd = c->column_family_data();
+
+  CompactionServiceInput input;
+  input.column_family_name = cfd->GetName();
+  for (size_t i = 0; i < c->num_input_levels(); i++) {
+    for (size_t j = 0; j < c->num_input_files(i); j++) {
+      input.input_file_numbers.push_back(c->input(i, j)->fd.GetNumber());
+    }
+  }
+  input.output_level = c->output_level();
+  input.output_compression = c->output_compression();
+  input.max_output_file_size = c->max_output_file_size();
+  input.snapshots = snapshots_.GetAll(&input.earliest_write_conflict_snapshot);
+  input.preserve_deletes_seqnum = preserve_deletes_seqnum_.load();
+  std::string serialized_input;
+  input.EncodeTo(&serialized_input);
+
+  ROCKS_LOG_BUFFER(log_buffer,
+                   "[%s] [JOB %d] Sending compaction of %" ROCKSDB_PRIszt
+                   " files to level-%d to compaction service %s",
+                   cfd->GetName().c_str(), job_context->job_id,
+                   input.input_file_numbers.size(), c->output_level(),
+                   immutable_db_options_.compaction_service->Name());
+
+  mutex_.Unlock();
+  TEST_SYNC_POINT("DBImpl::RunCompactionService:BeforeRun");
+  std::string serialized_result;
+  Status s = immutable_db_options_.compaction_service->Run(serialized_input,
+                                                          &serialized_result);
+  CompactionServiceResult result;
+  if (s.ok()) {
+    s = result.DecodeFrom(serialized_result);
+  }
+  mutex_.Lock();
+
+  // File numbers are allocated under the mutex. The caller has captured the
+  // current file number in pending_outputs_, so the moved files can't be
+  // purged as obsolete before the edit is applied.
+  std::vector<std::pair<std::string, uint64_t>> moves;
+  if (s.ok()) {
+    for (const auto& file : result.output_files) {
+      moves.emplace_back(file.file_path, versions_->NewFileNumber());
+    }
+  }
+  mutex_.Unlock();
+
+  auto sfm = static_cast<SstFileManagerImpl*>(
+      immutable_db_options_.sst_file_manager.get());
+  for (size_t i = 0; s.ok() && i < moves.size(); i++) {
+    const auto& file = result.output_files[i];
+    std::string fname = TableFileName(immutable_db_options_.db_paths,
+                                      moves[i].second, c->output_path_id());
+    s = env_->RenameFile(moves[i].first, fname);
+    if (!s.ok()) {
+      // The worker's output directory may be on a different file system.
+      s = CopyFile(env_, moves[i].first, fname, 0,
+                   immutable_db_options_.use_fsync);
+      if (s.ok()) {
+        env_->DeleteFile(moves[i].first);
+      }
+    }
+    if (s.ok()) {
+      c->edit()->AddFile(c->output_level(), moves[i].second,
+                         c->output_path_id(), file.file_size, file.smallest,
+                         file.largest, file.smallest_seqno, file.largest_seqno,
+                         false /* marked_for_compaction */);
+      if (sfm) {
+        sfm->OnAddFile(fname);
+      }
+    }
+  }
+  if (s.ok() && !moves.empty()) {
+    Directory* output_dir = directories_.GetDataDir(c->output_path_id());
+    if (output_dir != nullptr) {
+      s = output_dir->Fsync();
+    }
+  }
+  mutex_.Lock();
+
+  if (!s.ok()) {
+    // Files that were moved already are purged as obsolete once the job
+    // releases its pending outputs.
+    *service_failed = true;
+    ROCKS_LOG_BUFFER(log_buffer, "[%s] [JOB %d] Compaction service failed: %s",
+                     cfd->GetName().c_str(), job_context->job_id,
+                     s.ToString().c_str());
+    return s;
+  }
+
+  if (!versions_->VerifyCompactionFileConsistency(c)) {
+    s = Status::Corruption("Compaction input files inconsistent");
+  }
+  if (s.ok()) {
+    c->AddInputDeletions(c->edit());
+    s = versions_->LogAndApply(cfd, *c->mutable_cf_options(), c->edit(),
+                               &mutex_, directories_.GetDbDir());
+  }
+  ROCKS_LOG_BUFFER(log_buffer,
+                   "[%s] [JOB %d] Compaction service installed %" ROCKSDB_PRIszt
+                   " files to level-%d: %s",
+                   cfd->GetName().c_str(), job_context->job_id,
+                   result.output_files.size(), c->output_level(),
+                   s.ToString().c_str());
+  return s;
+}
+
+Status DBImpl::CompactForService(ColumnFamilyHandle* column_family,
+                                 const CompactionServiceInput& input,
+                                 const std::string& output_directory,
+                                 CompactionServiceResult* result) {
+  auto cfd = reinterpret_cast<ColumnFamilyHandleImpl*>(column_family)->cfd();
+  // The output directory is the last of the worker's db_paths.
+  const uint32_t output_path_id =
+      static_cast<uint32_t>(immutable_db_options_.db_paths.size() - 1);
+  assert(immutable_db_options_.db_paths[output_path_id].path ==
+         output_directory);
+
+  std::unique_ptr<Directory> output_dir;
+  Status s = env_->NewDirectory(output_directory, &output_dir);
+  if (!s.ok()) {
+    return s;
+  }
+
+  LogBuffer log_buffer(InfoLogLevel::INFO_LEVEL,
+                       immutable_db_options_.info_log.get());
+  std::vector<FileMetaData> output_files;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    Version* version = cfd->current();
+    std::unordered_set<uint64_t> input_set(input.input_file_numbers.begin(),
+                                           input.input_file_numbers.end());
+    CompactionOptions compact_options;
+    compact_options.compression = input.output_compression;
+    compact_options.output_file_size_limit = input.max_output_file_size;
+    std::vector<CompactionInputFiles> input_files;
+    s = cfd->compaction_picker()->GetCompactionInputsFromFileNumbers(
+        &input_files, &input_set, version->storage_info(), compact_options);
+    if (!s.ok()) {
+      return s;
+    }
+    std::unique_ptr<Compaction> c(cfd->compaction_picker()->CompactFiles(
+        compact_options, input_files, input.output_level,
+        version->storage_info(), *cfd->GetLatestMutableCFOptions(),
+        output_path_id));
+    assert(c != nullptr);
+    c->SetInputVersion(version);
+    // Blob files written here would be numbered by this read-only DB and
+    // can't be handed back to the primary.
+    if (cfd->ioptions()->enable_blob_files || c->HasBlobFileReferences()) {
+      c->ReleaseCompactionFiles(Status::NotSupported());
+      return Status::NotSupported(
+          "Compaction service does not support blob files");
+    }
+
+    // Snapshots come from the primary; a read-only DB has none of its own.
+    CompactionJob compaction_job(
+        next_job_id_.fetch_add(1), c.get(), immutable_db_options_,
+        env_options_for_compaction_, versions_.get(), &shutting_down_,
+        input.preserve_deletes_seqnum, &log_buffer, nullptr /* db_directory */,
+        output_dir.get(), stats_, &mutex_, &bg_error_, input.snapshots,
+        input.earliest_write_conflict_snapshot, nullptr /* snapshot_checker */,
+        table_cache_, &event_logger_,
+        c->mutable_cf_options()->paranoid_file_checks,
+        c->mutable_cf_options()->report_bg_io_stats, dbname_,
+        nullptr /* compaction_job_stats */);
+    compaction_job.Prepare();
+
+    mutex_.Unlock();
+    compaction_job.Run();
+    mutex_.Lock();
+
+    s = compaction_job.Finish(&output_files);
+    c->ReleaseCompactionFiles(s);
+  }
+  log_buffer.FlushBufferToLog();
+  if (!s.ok()) {
+    return s;
+  }
+
+  result->output_files.clear();
+  for (const auto& meta : output_files) {
+    CompactionServiceOutputFile file;
+    file.file_path = TableFileName(immutable_db_options_.db_paths,
+                                   meta.fd.GetNumber(), meta.fd.GetPathId());
+    file.file_size = meta.fd.GetFileSize();
+    file.smallest = meta.smallest;
+    file.largest = meta.largest;
+    file.smallest_seqno = meta.smallest_seqno;
+    file.largest_seqno = meta.largest_seqno;
+    result->output_files.push_back(std::move(file));
+  }
+  return Status::OK();
+}
+
+Status DB::OpenAndCompact(const Options& options, const std::string& name,
+                          const std::string& output_directory,
+                          const std::string& input, std::string* result) {
+  CompactionServiceInput compaction_input;
+  Status s = compaction_input.DecodeFrom(input);
+  if (!s.ok()) {
+    return s;
+  }
+  s = options.env->CreateDirIfMissing(output_directory);
+  if (!s.ok()) {
+    return s;
+  }
+
+  // Outputs go to an extra db_path, so that the input files can still be
+  // found at the path ids recorded in the primary's manifest.
+  DBOptions db_options(options);
+  if (db_options.db_paths.empty()) {
+    db_options.db_paths.emplace_back(name,
+                                     std::numeric_limits<uint64_t>::max());
+  }
+  db_options.db_paths.emplace_back(output_directory,
+                                   std::numeric_limits<uint64_t>::max());
+  db_options.compaction_service = nullptr;
+  if (db_options.info_log == nullptr) {
+    // Opening the DB would otherwise roll the primary's info log.
+    s = CreateLoggerFromOptions(output_directory, db_options,
+                                &db_options.info_log);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  ColumnFamilyOptions cf_options(options);
+  std::vector<ColumnFamilyDescriptor> column_families;
+  column_families.emplace_back(kDefaultColumnFamilyName, cf_options);
+  if (compaction_input.column_family_name != kDefaultColumnFamilyName) {
+    column_families.emplace_back(compaction_input.column_family_name,
+                                 cf_options);
+  }
+  std::vector<ColumnFamilyHandle*> handles;
+  DB* db = nullptr;
+  s = DB::OpenForReadOnly(db_options, name, column_families, &handles, &db);
+  if (!s.ok()) {
+    return s;
+  }
+
+  CompactionServiceResult compaction_result;
+  auto db_impl = static_cast_with_check<DBImpl, DB>(db->GetRootDB());
+  s = db_impl->CompactForService(handles.back(), compaction_input,
+                                 output_directory, &compaction_result);
+  if (s.ok()) {
+    result->clear();
+    compaction_result.EncodeTo(result);
+  }
+  for (auto handle : handles) {
+    delete handle;
+  }
+  delete db;
+  return s;
+}
+
+#else  // !ROCKSDB_LITE
+
+Status DB::OpenAndCompact(const Options& /*options*/,
+                          const std::string& /*name*/,
+                          const std::string& /*output_directory*/,
+                          const std::string& /*input*/,
+                          std::string* /*result*/) {
+  return Status::NotSupported("Not supported in ROCKSDB_LITE.");
+}
+
+#endif  // !ROCKSDB_LITE
+
+}  // namespace rocksdb
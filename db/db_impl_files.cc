@@ -192,7 +192,7 @@ void DBImpl::FindObsoleteFiles(JobContext* job_context, bool force,
 
   job_context->prev_log_number = versions_->prev_log_number();
 
-  versions_->AddLiveFiles(&job_context->sst_live);
+  versions_->AddLiveFiles(&job_context->sst_live, &job_context->blob_live);
   if (doing_the_full_scan) {
     for (size_t path_id = 0; path_id < immutable_db_options_.db_paths.size();
          path_id++) {
@@ -358,6 +358,8 @@ void DBImpl::PurgeObsoleteFiles(const JobContext& state, bool schedule_only) {
   for (const FileDescriptor& fd : state.sst_live) {
     sst_live_map[fd.GetNumber()] = &fd;
   }
+  std::unordered_set<uint64_t> blob_live_set(state.blob_live.begin(),
+                                             state.blob_live.end());
   std::unordered_set<uint64_t> log_recycle_files_set(
       state.log_recycle_files.begin(), state.log_recycle_files.end());
 
@@ -371,6 +373,11 @@ void DBImpl::PurgeObsoleteFiles(const JobContext& state, bool schedule_only) {
     candidate_files.emplace_back(
         MakeTableFileName(kDumbDbName, file->fd.GetNumber()),
         file->fd.GetPathId());
+    // The blob files only this table referenced are obsolete now too
+    for (uint64_t blob_file_number : file->blob_file_numbers) {
+      candidate_files.emplace_back(
+          BlobFileName(kDumbDbName, blob_file_number), 0);
+    }
     if (file->table_reader_handle) {
       table_cache_->Release(file->table_reader_handle);
     }
@@ -454,12 +461,20 @@ void DBImpl::PurgeObsoleteFiles(const JobContext& state, bool schedule_only) {
           old_info_log_files.push_back(to_delete);
         }
         break;
+      case kBlobFile:
+        // Blob files are written to the first DB path only and are live as
+        // long as a table file references them. Like for table files, the
+        // blob files of running flushes and compactions are protected by
+        // min_pending_output.
+        keep = path_id != 0 ||
+               (blob_live_set.find(number) != blob_live_set.end()) ||
+               number >= state.min_pending_output;
+        break;
       case kCurrentFile:
       case kDBLockFile:
       case kIdentityFile:
       case kMetaDatabase:
       case kOptionsFile:
-      case kBlobFile:
         keep = true;
         break;
     }
@@ -473,6 +488,9 @@ void DBImpl::PurgeObsoleteFiles(const JobContext& state, bool schedule_only) {
       // evict from cache
       TableCache::Evict(table_cache_.get(), number);
       fname = TableFileName(immutable_db_options_.db_paths, number, path_id);
+    } else if (type == kBlobFile) {
+      BlobSource::Evict(table_cache_.get(), number);
+      fname = BlobFileName(immutable_db_options_.db_paths[0].path, number);
     } else {
       fname = ((type == kLogFile) ? immutable_db_options_.wal_dir : dbname_) +
               "/" + to_delete;
@@ -12,13 +12,17 @@
 #define __STDC_FORMAT_MACROS
 #endif
 #include <inttypes.h>
+#include <algorithm>
 
+#include "db/blob_file_builder.h"
 #include "db/builder.h"
 #include "options/options_helper.h"
 #include "rocksdb/wal_filter.h"
 #include "table/block_based_table_factory.h"
+#include "util/compression.h"
 #include "util/rate_limiter.h"
 #include "util/sst_file_manager_impl.h"
+#include "util/string_util.h"
 #include "util/sync_point.h"
 
 namespace rocksdb {
@@ -79,7 +83,8 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src) {
     }
   }
 
-  if (result.WAL_ttl_seconds > 0 || result.WAL_size_limit_MB > 0) {
+  if (result.WAL_ttl_seconds > 0 || result.WAL_size_limit_MB > 0 ||
+      result.wal_stripes > 1) {
     result.recycle_log_file_num = false;
   }
 
@@ -163,6 +168,9 @@ static Status ValidateOptions(
     if (s.ok() && db_options.allow_concurrent_memtable_write) {
       s = CheckConcurrentWritesSupported(cfd.options);
     }
+    if (s.ok()) {
+      s = CheckBlobFilesSupported(cfd.options);
+    }
     if (!s.ok()) {
       return s;
     }
@@ -213,6 +221,54 @@ static Status ValidateOptions(
     return Status::InvalidArgument("keep_log_file_num must be greater than 0");
   }
 
+  if (db_options.wal_stripes == 0) {
+    return Status::InvalidArgument("wal_stripes must be greater than 0");
+  }
+
+  if (db_options.wal_stripes > 1) {
+    if (!db_options.enable_pipelined_write) {
+      return Status::NotSupported(
+          "WAL stripes (wal_stripes > 1) require enable_pipelined_write. ");
+    }
+    if (db_options.allow_2pc || db_options.two_write_queues ||
+        db_options.manual_wal_flush) {
+      return Status::NotSupported(
+          "WAL stripes (wal_stripes > 1) are not compatible with allow_2pc, "
+          "two_write_queues or manual_wal_flush. ");
+    }
+#ifndef ROCKSDB_LITE
+    if (db_options.wal_filter != nullptr) {
+      return Status::NotSupported(
+          "WAL stripes (wal_stripes > 1) are not compatible with wal_filter. ");
+    }
+#endif  // ROCKSDB_LITE
+  }
+
+  if (db_options.wal_sync_interval_micros > 0 &&
+      (db_options.allow_2pc || db_options.two_write_queues ||
+       db_options.manual_wal_flush || db_options.wal_stripes > 1 ||
+       db_options.allow_mmap_writes)) {
+    return Status::NotSupported(
+        "wal_sync_interval_micros is not compatible with allow_2pc, "
+        "two_write_queues, manual_wal_flush, wal_stripes or "
+        "allow_mmap_writes. ");
+  }
+
+  if (db_options.wal_compression != kNoCompression) {
+    if (db_options.wal_compression != kZSTD) {
+      return Status::NotSupported("wal_compression only supports kZSTD. ");
+    }
+    if (!ZSTD_Streaming_Supported()) {
+      return Status::NotSupported(
+          "wal_compression needs ZSTD streaming compression, which is not "
+          "supported by this build. ");
+    }
+    if (db_options.recycle_log_file_num > 0) {
+      return Status::NotSupported(
+          "wal_compression is not compatible with recycle_log_file_num. ");
+    }
+  }
+
   return Status::OK();
 }
 } // namespace
@@ -445,24 +501,49 @@ Status DBImpl::Recover(
   return s;
 }
 
+namespace {
+struct LogReporter : public log::Reader::Reporter {
+  Env* env;
+  Logger* info_log;
+  const char* fname;
+  Status* status;  // nullptr if immutable_db_options_.paranoid_checks==false
+  virtual void Corruption(size_t bytes, const Status& s) override {
+    ROCKS_LOG_WARN(info_log, "%s%s: dropping %d bytes; %s",
+                   (this->status == nullptr ? "(ignoring error) " : ""),
+                   fname, static_cast<int>(bytes), s.ToString().c_str());
+    if (this->status != nullptr && this->status->ok()) {
+      *this->status = s;
+    }
+  }
+};
+
+// A WAL record read from one of the stripes of a WAL
+struct WalStripeRecord {
+  WalStripeRecord(uint64_t _log_number, const Slice& record)
+      : log_number(_log_number), contents(record.data(), record.size()) {
+    WriteBatch batch;
+    WriteBatchInternal::SetContents(&batch, record);
+    sequence = WriteBatchInternal::Sequence(&batch);
+    count = WriteBatchInternal::Count(&batch);
+  }
+
+  // Records of empty write groups share the sequence number of the next
+  // record, so they are replayed first
+  bool operator<(const WalStripeRecord& other) const {
+    return sequence < other.sequence ||
+           (sequence == other.sequence && count < other.count);
+  }
+
+  uint64_t log_number;
+  SequenceNumber sequence;
+  uint32_t count;
+  std::string contents;
+};
+}  // namespace
+
 // REQUIRES: log_numbers are sorted in ascending order
 Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
                                SequenceNumber* next_sequence, bool read_only) {
-  struct LogReporter : public log::Reader::Reporter {
-    Env* env;
-    Logger* info_log;
-    const char* fname;
-    Status* status;  // nullptr if immutable_db_options_.paranoid_checks==false
-    virtual void Corruption(size_t bytes, const Status& s) override {
-      ROCKS_LOG_WARN(info_log, "%s%s: dropping %d bytes; %s",
-                     (this->status == nullptr ? "(ignoring error) " : ""),
-                     fname, static_cast<int>(bytes), s.ToString().c_str());
-      if (this->status != nullptr && this->status->ok()) {
-        *this->status = s;
-      }
-    }
-  };
-
   mutex_.AssertHeld();
   Status status;
   std::unordered_map<int, VersionEdit> version_edits;
@@ -501,10 +582,137 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
   }
 #endif
 
-  bool stop_replay_by_wal_filter = false;
   bool stop_replay_for_corruption = false;
   bool flushed = false;
   uint64_t corrupted_log_number = kMaxSequenceNumber;
+  if (immutable_db_options_.wal_stripes > 1) {
+    // The records of the stripes are merged in sequence number order
+    status = RecoverWalStripes(log_numbers, job_id, &version_edits,
+                               next_sequence, read_only, &flushed,
+                               &stop_replay_for_corruption,
+                               &corrupted_log_number);
+  } else {
+    status = ReplayLogFiles(log_numbers, job_id, &version_edits,
+                            next_sequence, read_only, &flushed,
+                            &stop_replay_for_corruption,
+                            &corrupted_log_number);
+  }
+  if (!status.ok()) {
+    return status;
+  }
+  // Compare the corrupted log number to all columnfamily's current log number.
+  // Abort Open() if any column family's log number is greater than
+  // the corrupted log number, which means CF contains data beyond the point of
+  // corruption. This could during PIT recovery when the WAL is corrupted and
+  // some (but not all) CFs are flushed
+  if (stop_replay_for_corruption == true &&
+      (immutable_db_options_.wal_recovery_mode ==
+           WALRecoveryMode::kPointInTimeRecovery ||
+       immutable_db_options_.wal_recovery_mode ==
+           WALRecoveryMode::kTolerateCorruptedTailRecords)) {
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (cfd->GetLogNumber() > corrupted_log_number) {
+        ROCKS_LOG_ERROR(immutable_db_options_.info_log,
+                        "Column family inconsistency: SST file contains data"
+                        " beyond the point of corruption.");
+        return Status::Corruption("SST file is ahead of WALs");
+      }
+    }
+  }
+
+  // True if there's any data in the WALs; if not, we can skip re-processing
+  // them later
+  bool data_seen = false;
+  if (!read_only) {
+    // no need to refcount since client still doesn't have access
+    // to the DB and can not drop column families while we iterate
+    auto max_log_number = log_numbers.back();
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      auto iter = version_edits.find(cfd->GetID());
+      assert(iter != version_edits.end());
+      VersionEdit* edit = &iter->second;
+
+      if (cfd->GetLogNumber() > max_log_number) {
+        // Column family cfd has already flushed the data
+        // from all logs. Memtable has to be empty because
+        // we filter the updates based on log_number
+        // (in WriteBatch::InsertInto)
+        assert(cfd->mem()->GetFirstSequenceNumber() == 0);
+        assert(edit->NumEntries() == 0);
+        continue;
+      }
+
+      // flush the final memtable (if non-empty)
+      if (cfd->mem()->GetFirstSequenceNumber() != 0) {
+        // If flush happened in the middle of recovery (e.g. due to memtable
+        // being full), we flush at the end. Otherwise we'll need to record
+        // where we were on last flush, which make the logic complicated.
+        if (flushed || !immutable_db_options_.avoid_flush_during_recovery) {
+          status = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
+          if (!status.ok()) {
+            // Recovery failed
+            break;
+          }
+          flushed = true;
+
+          cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
+                                 versions_->LastSequence());
+        }
+        data_seen = true;
+      }
+
+      // write MANIFEST with update
+      // writing log_number in the manifest means that any log file
+      // with number strongly less than (log_number + 1) is already
+      // recovered and should be ignored on next reincarnation.
+      // Since we already recovered max_log_number, we want all logs
+      // with numbers `<= max_log_number` (includes this one) to be ignored
+      if (flushed || cfd->mem()->GetFirstSequenceNumber() == 0) {
+        edit->SetLogNumber(max_log_number + 1);
+      }
+      // we must mark the next log number as used, even though it's
+      // not actually used. that is because VersionSet assumes
+      // VersionSet::next_file_number_ always to be strictly greater than any
+      // log number
+      versions_->MarkFileNumberUsed(max_log_number + 1);
+      status = versions_->LogAndApply(
+          cfd, *cfd->GetLatestMutableCFOptions(), edit, &mutex_);
+      if (!status.ok()) {
+        // Recovery failed
+        break;
+      }
+    }
+  }
+
+  if (data_seen && !flushed) {
+    // Mark these as alive so they'll be considered for deletion later by
+    // FindObsoleteFiles()
+    if (two_write_queues_) {
+      log_write_mutex_.Lock();
+    }
+    for (auto log_number : log_numbers) {
+      alive_log_files_.push_back(LogFileNumberSize(log_number));
+    }
+    if (two_write_queues_) {
+      log_write_mutex_.Unlock();
+    }
+  }
+
+  event_logger_.Log() << "job" << job_id << "event"
+                      << "recovery_finished";
+
+  return status;
+}
+
+// REQUIRES: log_numbers are sorted in ascending order
+Status DBImpl::ReplayLogFiles(
+    const std::vector<uint64_t>& log_numbers, int job_id,
+    std::unordered_map<int, VersionEdit>* version_edits,
+    SequenceNumber* next_sequence, bool read_only, bool* flushed,
+    bool* stop_replay_for_corruption, uint64_t* corrupted_log_number) {
+  mutex_.AssertHeld();
+  Status status;
+  bool stop_replay_by_wal_filter = false;
   for (auto log_number : log_numbers) {
     // The previous incarnation may not have written any MANIFEST
     // records after allocating this log number.  So we manually
@@ -597,14 +805,23 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
             // sequence numbers in the log is expected by the commits without
             // prepares.
             (seq_per_batch_ && sequence >= *next_sequence)) {
-          stop_replay_for_corruption = false;
+          *stop_replay_for_corruption = false;
         }
-        if (stop_replay_for_corruption) {
+        if (*stop_replay_for_corruption) {
           logFileDropped();
           break;
         }
       }
 
+      if (*next_sequence != kMaxSequenceNumber && sequence < *next_sequence) {
+        // The records of a striped WAL (DBOptions::wal_stripes) are spread
+        // over its log files. Replayed one file after the other, the DB
+        // would end up with a last sequence number below the ones it holds.
+        return Status::Corruption(
+            "WAL records out of sequence number order in " + fname +
+            ", logs written with wal_stripes > 1 need wal_stripes > 1");
+      }
+
 #ifndef ROCKSDB_LITE
       if (immutable_db_options_.wal_filter != nullptr) {
         WriteBatch new_batch;
@@ -710,8 +927,8 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
           // If this asserts, it means that InsertInto failed in
           // filtering updates to already-flushed column families
           assert(cfd->GetLogNumber() <= log_number);
-          auto iter = version_edits.find(cfd->GetID());
-          assert(iter != version_edits.end());
+          auto iter = version_edits->find(cfd->GetID());
+          assert(iter != version_edits->end());
           VersionEdit* edit = &iter->second;
           status = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
           if (!status.ok()) {
@@ -719,7 +936,7 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
             // file-systems cause the DB::Open() to fail.
             return status;
           }
-          flushed = true;
+          *flushed = true;
 
           cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
                                  *next_sequence);
@@ -742,8 +959,8 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
                  WALRecoveryMode::kPointInTimeRecovery) {
         // We should ignore the error but not continue replaying
         status = Status::OK();
-        stop_replay_for_corruption = true;
-        corrupted_log_number = log_number;
+        *stop_replay_for_corruption = true;
+        *corrupted_log_number = log_number;
         ROCKS_LOG_INFO(immutable_db_options_.info_log,
                        "Point in time recovered to log #%" PRIu64
                        " seq #%" PRIu64,
@@ -765,107 +982,170 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& log_numbers,
       versions_->SetLastSequence(last_sequence);
     }
   }
-  // Compare the corrupted log number to all columnfamily's current log number.
-  // Abort Open() if any column family's log number is greater than
-  // the corrupted log number, which means CF contains data beyond the point of
-  // corruption. This could during PIT recovery when the WAL is corrupted and
-  // some (but not all) CFs are flushed
-  if (stop_replay_for_corruption == true &&
-      (immutable_db_options_.wal_recovery_mode ==
-           WALRecoveryMode::kPointInTimeRecovery ||
-       immutable_db_options_.wal_recovery_mode ==
-           WALRecoveryMode::kTolerateCorruptedTailRecords)) {
-    for (auto cfd : *versions_->GetColumnFamilySet()) {
-      if (cfd->GetLogNumber() > corrupted_log_number) {
-        ROCKS_LOG_ERROR(immutable_db_options_.info_log,
-                        "Column family inconsistency: SST file contains data"
-                        " beyond the point of corruption.");
-        return Status::Corruption("SST file is ahead of WALs");
-      }
+  return status;
+}
+
+// REQUIRES: log_numbers are sorted in ascending order
+Status DBImpl::RecoverWalStripes(
+    const std::vector<uint64_t>& log_numbers, int job_id,
+    std::unordered_map<int, VersionEdit>* version_edits,
+    SequenceNumber* next_sequence, bool read_only, bool* flushed,
+    bool* stop_replay_for_corruption, uint64_t* corrupted_log_number) {
+  mutex_.AssertHeld();
+  const WALRecoveryMode recovery_mode = immutable_db_options_.wal_recovery_mode;
+  Status status;
+  // Read all the records first. A write group's record can be in any stripe
+  // of its WAL, so the order of the records is only known once all of them
+  // have been read.
+  std::vector<WalStripeRecord> records;
+  const uint64_t min_log_number = versions_->MinLogNumber();
+  for (auto log_number : log_numbers) {
+    // The previous incarnation may not have written any MANIFEST
+    // records after allocating this log number.  So we manually
+    // update the file number allocation counter in VersionSet.
+    versions_->MarkFileNumberUsed(log_number);
+    if (log_number < min_log_number) {
+      // Already recovered; it may hold records past a missing one that were
+      // dropped by the recovery, whose sequence numbers have been reused
+      continue;
     }
-  }
+    std::string fname = LogFileName(immutable_db_options_.wal_dir, log_number);
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "Recovering log stripe #%" PRIu64 " mode %d", log_number,
+                   recovery_mode);
 
-  // True if there's any data in the WALs; if not, we can skip re-processing
-  // them later
-  bool data_seen = false;
-  if (!read_only) {
-    // no need to refcount since client still doesn't have access
-    // to the DB and can not drop column families while we iterate
-    auto max_log_number = log_numbers.back();
-    for (auto cfd : *versions_->GetColumnFamilySet()) {
-      auto iter = version_edits.find(cfd->GetID());
-      assert(iter != version_edits.end());
-      VersionEdit* edit = &iter->second;
+    unique_ptr<SequentialFileReader> file_reader;
+    {
+      unique_ptr<SequentialFile> file;
+      status = env_->NewSequentialFile(fname, &file,
+                                       env_->OptimizeForLogRead(env_options_));
+      if (!status.ok()) {
+        MaybeIgnoreError(&status);
+        if (!status.ok()) {
+          return status;
+        } else {
+          continue;
+        }
+      }
+      file_reader.reset(new SequentialFileReader(std::move(file)));
+    }
 
-      if (cfd->GetLogNumber() > max_log_number) {
-        // Column family cfd has already flushed the data
-        // from all logs. Memtable has to be empty because
-        // we filter the updates based on log_number
-        // (in WriteBatch::InsertInto)
-        assert(cfd->mem()->GetFirstSequenceNumber() == 0);
-        assert(edit->NumEntries() == 0);
+    LogReporter reporter;
+    reporter.env = env_;
+    reporter.info_log = immutable_db_options_.info_log.get();
+    reporter.fname = fname.c_str();
+    if (!immutable_db_options_.paranoid_checks ||
+        recovery_mode == WALRecoveryMode::kSkipAnyCorruptedRecords) {
+      reporter.status = nullptr;
+    } else {
+      reporter.status = &status;
+    }
+    log::Reader reader(immutable_db_options_.info_log, std::move(file_reader),
+                       &reporter, true /*checksum*/, 0 /*initial_offset*/,
+                       log_number);
+    std::string scratch;
+    Slice record;
+    while (reader.ReadRecord(&record, &scratch, recovery_mode) &&
+           status.ok()) {
+      if (record.size() < WriteBatchInternal::kHeader) {
+        reporter.Corruption(record.size(),
+                            Status::Corruption("log record too small"));
         continue;
       }
+      records.emplace_back(log_number, record);
+    }
 
-      // flush the final memtable (if non-empty)
-      if (cfd->mem()->GetFirstSequenceNumber() != 0) {
-        // If flush happened in the middle of recovery (e.g. due to memtable
-        // being full), we flush at the end. Otherwise we'll need to record
-        // where we were on last flush, which make the logic complicated.
-        if (flushed || !immutable_db_options_.avoid_flush_during_recovery) {
-          status = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
-          if (!status.ok()) {
-            // Recovery failed
-            break;
-          }
-          flushed = true;
-
-          cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
-                                 versions_->LastSequence());
-        }
-        data_seen = true;
+    if (!status.ok()) {
+      if (recovery_mode == WALRecoveryMode::kPointInTimeRecovery) {
+        // The records of this stripe past the corruption are missing from
+        // the merged sequence, which stops the replay there
+        status = Status::OK();
+      } else {
+        return status;
       }
+    }
+  }
 
-      // write MANIFEST with update
-      // writing log_number in the manifest means that any log file
-      // with number strongly less than (log_number + 1) is already
-      // recovered and should be ignored on next reincarnation.
-      // Since we already recovered max_log_number, we want all logs
-      // with numbers `<= max_log_number` (includes this one) to be ignored
-      if (flushed || cfd->mem()->GetFirstSequenceNumber() == 0) {
-        edit->SetLogNumber(max_log_number + 1);
-      }
-      // we must mark the next log number as used, even though it's
-      // not actually used. that is because VersionSet assumes
-      // VersionSet::next_file_number_ always to be strictly greater than any
-      // log number
-      versions_->MarkFileNumberUsed(max_log_number + 1);
-      status = versions_->LogAndApply(
-          cfd, *cfd->GetLatestMutableCFOptions(), edit, &mutex_);
-      if (!status.ok()) {
-        // Recovery failed
+  std::sort(records.begin(), records.end());
+  WriteBatch batch;
+  for (size_t i = 0; i < records.size(); i++) {
+    const WalStripeRecord& r = records[i];
+    // The first record has to follow the last sequence number in the
+    // MANIFEST. It may also come before it, as the records of a log can be
+    // flushed for some column families only.
+    const SequenceNumber expected_sequence =
+        i == 0 ? versions_->LastSequence() + 1 : *next_sequence;
+    if (i == 0 ? r.sequence > expected_sequence
+               : r.sequence != expected_sequence) {
+      // A record is missing, e.g. because its stripe was not synced
+      if (recovery_mode == WALRecoveryMode::kAbsoluteConsistency) {
+        return Status::Corruption("Missing record in WAL stripes at seq #",
+                                  ToString(expected_sequence));
+      } else if (recovery_mode != WALRecoveryMode::kSkipAnyCorruptedRecords) {
+        ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                       "WAL stripes recovered to seq #%" PRIu64
+                       ", dropping %" ROCKSDB_PRIszt " records",
+                       expected_sequence - 1, records.size() - i);
+        *stop_replay_for_corruption = true;
+        *corrupted_log_number = r.log_number;
         break;
       }
     }
-  }
 
-  if (data_seen && !flushed) {
-    // Mark these as alive so they'll be considered for deletion later by
-    // FindObsoleteFiles()
-    if (two_write_queues_) {
-      log_write_mutex_.Lock();
-    }
-    for (auto log_number : log_numbers) {
-      alive_log_files_.push_back(LogFileNumberSize(log_number));
+    WriteBatchInternal::SetContents(&batch, r.contents);
+    bool has_valid_writes = false;
+    status = WriteBatchInternal::InsertInto(
+        &batch, column_family_memtables_.get(), &flush_scheduler_, true,
+        r.log_number, this, false /* concurrent_memtable_writes */,
+        next_sequence, &has_valid_writes, seq_per_batch_);
+    MaybeIgnoreError(&status);
+    if (!status.ok()) {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "Dropping record of log stripe #%" PRIu64 "; %s",
+                     r.log_number, status.ToString().c_str());
+      if (!status.IsNotSupported() &&
+          (recovery_mode == WALRecoveryMode::kSkipAnyCorruptedRecords ||
+           recovery_mode == WALRecoveryMode::kPointInTimeRecovery)) {
+        // Like a missing record
+        status = Status::OK();
+        continue;
+      }
+      return status;
     }
-    if (two_write_queues_) {
-      log_write_mutex_.Unlock();
+
+    if (has_valid_writes && !read_only) {
+      ColumnFamilyData* cfd;
+      while ((cfd = flush_scheduler_.TakeNextColumnFamily()) != nullptr) {
+        cfd->Unref();
+        assert(cfd->GetLogNumber() <= r.log_number);
+        auto iter = version_edits->find(cfd->GetID());
+        assert(iter != version_edits->end());
+        VersionEdit* edit = &iter->second;
+        status = WriteLevel0TableForRecovery(job_id, cfd, cfd->mem(), edit);
+        if (!status.ok()) {
+          return status;
+        }
+        *flushed = true;
+
+        cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(),
+                               *next_sequence);
+      }
     }
   }
+  if (*stop_replay_for_corruption && !read_only) {
+    // Flush what was recovered even with avoid_flush_during_recovery, so that
+    // the logs holding the records past the missing one become obsolete
+    // before their sequence numbers are reused
+    *flushed = true;
+  }
 
-  event_logger_.Log() << "job" << job_id << "event"
-                      << "recovery_finished";
-
+  flush_scheduler_.Clear();
+  auto last_sequence = *next_sequence - 1;
+  if ((*next_sequence != kMaxSequenceNumber) &&
+      (versions_->LastSequence() <= last_sequence)) {
+    versions_->SetLastAllocatedSequence(last_sequence);
+    versions_->SetLastSequence(last_sequence);
+  }
   return status;
 }
 
@@ -910,6 +1190,13 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
       if (use_custom_gc_ && snapshot_checker == nullptr) {
         snapshot_checker = DisableGCSnapshotChecker::Instance();
       }
+      std::unique_ptr<BlobFileBuilder> blob_file_builder;
+      if (cfd->ioptions()->enable_blob_files) {
+        blob_file_builder.reset(new BlobFileBuilder(
+            versions_.get(), env_, env_options_for_compaction_,
+            *cfd->ioptions(), cfd->GetID(), cfd->blob_source(),
+            0 /* gc_cutoff_file_number */, Env::IO_HIGH, write_hint));
+      }
       s = BuildTable(
           dbname_, env_, *cfd->ioptions(), mutable_cf_options,
           env_options_for_compaction_, cfd->table_cache(), iter.get(),
@@ -921,7 +1208,8 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
           cfd->ioptions()->compression_opts, paranoid_file_checks,
           cfd->internal_stats(), TableFileCreationReason::kRecovery,
           &event_logger_, job_id, Env::IO_HIGH, nullptr /* table_properties */,
-          -1 /* level */, current_time, write_hint);
+          -1 /* level */, current_time, 0 /* oldest_key_time */, write_hint,
+          blob_file_builder.get());
       LogFlush(immutable_db_options_.info_log);
       ROCKS_LOG_DEBUG(immutable_db_options_.info_log,
                       "[%s] [WriteLevel0TableForRecovery]"
@@ -940,7 +1228,7 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
     edit->AddFile(level, meta.fd.GetNumber(), meta.fd.GetPathId(),
                   meta.fd.GetFileSize(), meta.smallest, meta.largest,
                   meta.smallest_seqno, meta.largest_seqno,
-                  meta.marked_for_compaction);
+                  meta.marked_for_compaction, meta.blob_file_numbers);
   }
 
   InternalStats::CompactionStats stats(1);
@@ -1028,33 +1316,42 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
   // Handles create_if_missing, error_if_exists
   s = impl->Recover(column_families);
   if (s.ok()) {
-    uint64_t new_log_number = impl->versions_->NewFileNumber();
-    unique_ptr<WritableFile> lfile;
     EnvOptions soptions(db_options);
     EnvOptions opt_env_options =
         impl->immutable_db_options_.env->OptimizeForLogWrite(
             soptions, BuildDBOptions(impl->immutable_db_options_,
                                      impl->mutable_db_options_));
-    s = NewWritableFile(
-        impl->immutable_db_options_.env,
-        LogFileName(impl->immutable_db_options_.wal_dir, new_log_number),
-        &lfile, opt_env_options);
-    if (s.ok()) {
-      lfile->SetWriteLifeTimeHint(write_hint);
-      lfile->SetPreallocationBlockSize(
-          impl->GetWalPreallocateBlockSize(max_write_buffer_size));
-      {
+    // With WAL stripes the current WAL consists of several logs, the first
+    // of which is logfile_number_
+    for (size_t stripe = 0;
+         s.ok() && stripe < impl->immutable_db_options_.wal_stripes;
+         stripe++) {
+      uint64_t new_log_number = impl->versions_->NewFileNumber();
+      unique_ptr<WritableFile> lfile;
+      s = NewWritableFile(
+          impl->immutable_db_options_.env,
+          LogFileName(impl->immutable_db_options_.wal_dir, new_log_number),
+          &lfile, opt_env_options);
+      if (s.ok()) {
+        lfile->SetWriteLifeTimeHint(write_hint);
+        lfile->SetPreallocationBlockSize(
+            impl->GetWalPreallocateBlockSize(max_write_buffer_size));
         InstrumentedMutexLock wl(&impl->log_write_mutex_);
-        impl->logfile_number_ = new_log_number;
+        if (stripe == 0) {
+          impl->logfile_number_ = new_log_number;
+        }
         unique_ptr<WritableFileWriter> file_writer(
             new WritableFileWriter(std::move(lfile), opt_env_options));
         impl->logs_.emplace_back(
             new_log_number,
             new log::Writer(
                 std::move(file_writer), new_log_number,
-                impl->immutable_db_options_.recycle_log_file_num > 0));
+                impl->immutable_db_options_.recycle_log_file_num > 0,
+                false /* manual_flush */,
+                impl->immutable_db_options_.wal_compression));
       }
-
+    }
+    if (s.ok()) {
       // set column family handles
       for (auto cf : column_families) {
         auto cfd =
@@ -1092,8 +1389,10 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
       if (impl->two_write_queues_) {
         impl->log_write_mutex_.Lock();
       }
-      impl->alive_log_files_.push_back(
-          DBImpl::LogFileNumberSize(impl->logfile_number_));
+      for (auto& log : impl->logs_) {
+        impl->alive_log_files_.push_back(
+            DBImpl::LogFileNumberSize(log.number));
+      }
       if (impl->two_write_queues_) {
         impl->log_write_mutex_.Unlock();
       }
@@ -1141,6 +1440,14 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
     *dbptr = impl;
     impl->opened_successfully_ = true;
     impl->MaybeScheduleFlushOrCompaction();
+    if (impl->immutable_db_options_.wal_sync_interval_micros > 0) {
+      // What was recovered needs no sync
+      impl->wal_written_sequence_ = impl->versions_->LastSequence();
+      impl->wal_synced_sequence_ = impl->wal_written_sequence_;
+      impl->wal_syncer_thread_ = port::Thread([impl]() {
+        impl->BGWalSyncer();
+      });
+    }
   }
   impl->mutex_.Unlock();
 
@@ -49,6 +49,29 @@ Status DBImpl::Write(const WriteOptions& write_options, WriteBatch* my_batch) {
   return WriteImpl(write_options, my_batch, nullptr, nullptr);
 }
 
+Status DBImpl::WriteAsync(const WriteOptions& write_options,
+                          WriteBatch* my_batch,
+                          std::function<void(const Status&)> callback) {
+  if (my_batch == nullptr) {
+    return Status::Corruption("Batch is nullptr!");
+  }
+  if (immutable_db_options_.async_write_threads <= 0) {
+    return DB::WriteAsync(write_options, my_batch, std::move(callback));
+  }
+  std::call_once(async_write_pool_created_, [this]() {
+    async_write_pool_.reset(new ThreadPoolImpl());
+    async_write_pool_->SetHostEnv(env_);
+    async_write_pool_->SetBackgroundThreads(
+        immutable_db_options_.async_write_threads);
+  });
+  // The writes join write groups like any other write, so that up to
+  // async_write_threads of them are written together
+  async_write_pool_->SubmitJob([this, write_options, my_batch, callback]() {
+    callback(Write(write_options, my_batch));
+  });
+  return Status::OK();
+}
+
 #ifndef ROCKSDB_LITE
 Status DBImpl::WriteWithCallback(const WriteOptions& write_options,
                                  WriteBatch* my_batch,
@@ -92,6 +115,14 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
                             log_ref, seq_used);
   }
 
+  if (UNLIKELY(!disable_memtable &&
+               write_controller_.HasColumnFamilyStalls())) {
+    status = DelayColumnFamilyWrites(write_options, my_batch);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
   if (immutable_db_options_.enable_pipelined_write) {
     return PipelinedWriteImpl(write_options, my_batch, callback, log_used,
                               log_ref, disable_memtable, seq_used);
@@ -141,7 +172,12 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
       *seq_used = w.sequence;
     }
     // write is complete and leader has updated sequence
-    return w.FinalStatus();
+    status = w.FinalStatus();
+    if (status.ok() && w.sync &&
+        immutable_db_options_.wal_sync_interval_micros > 0) {
+      status = WaitForWalSync(w);
+    }
+    return status;
   }
   // else we are the leader of the write batch group
   assert(w.state == WriteThread::STATE_GROUP_LEADER);
@@ -160,7 +196,9 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
 
   mutex_.Lock();
 
-  bool need_log_sync = write_options.sync;
+  // With a WAL syncer the sync writes wait for it instead
+  bool need_log_sync = write_options.sync &&
+                       immutable_db_options_.wal_sync_interval_micros == 0;
   bool need_log_dir_sync = need_log_sync && !log_dir_synced_;
   if (!two_write_queues_ || !disable_memtable) {
     // With concurrent writes we do preprocess only in the write thread that
@@ -177,8 +215,10 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
   // and protects against concurrent loggers and concurrent writes
   // into memtables
 
+  StopWatch group_sw(env_, stats_, DB_WRITE_GROUP_MICROS);
   last_batch_group_size_ =
       write_thread_.EnterAsBatchGroupLeader(&w, &write_group);
+  MeasureTime(stats_, DB_WRITE_GROUP_SIZE, write_group.size);
 
   if (status.ok()) {
     // Rules for when we can update the memtable concurrently
@@ -266,6 +306,10 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     assert(last_sequence != kMaxSequenceNumber);
     const SequenceNumber current_sequence = last_sequence + 1;
     last_sequence += seq_inc;
+    if (status.ok() && !write_options.disableWAL &&
+        immutable_db_options_.wal_sync_interval_micros > 0) {
+      NotifyWalSyncer(last_sequence, total_byte_size);
+    }
 
     if (status.ok()) {
       PERF_TIMER_GUARD(write_memtable_time);
@@ -354,6 +398,10 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
   if (status.ok()) {
     status = w.FinalStatus();
   }
+  if (status.ok() && w.sync &&
+      immutable_db_options_.wal_sync_interval_micros > 0) {
+    status = WaitForWalSync(w);
+  }
   return status;
 }
 
@@ -375,15 +423,25 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
       write_thread_.WaitForMemTableWriters();
     }
     mutex_.Lock();
-    bool need_log_sync = !write_options.disableWAL && write_options.sync;
+    bool need_log_sync = !write_options.disableWAL && write_options.sync &&
+                         immutable_db_options_.wal_sync_interval_micros == 0;
     bool need_log_dir_sync = need_log_sync && !log_dir_synced_;
     w.status = PreprocessWrite(write_options, &need_log_sync, &write_context);
     log::Writer* log_writer = logs_.back().writer;
+    // With WAL stripes, the stripes of the current WAL are synced after
+    // exiting the WAL write group
+    const bool wal_stripes = immutable_db_options_.wal_stripes > 1;
+    autovector<log::Writer*> stripes_to_sync;
+    if (wal_stripes && !write_options.disableWAL) {
+      log_writer = SelectWalStripe(need_log_sync, &stripes_to_sync);
+    }
     mutex_.Unlock();
 
     // This can set non-OK status if callback fail.
+    StopWatch group_sw(env_, stats_, DB_WRITE_GROUP_MICROS);
     last_batch_group_size_ =
         write_thread_.EnterAsBatchGroupLeader(&w, &wal_write_group);
+    MeasureTime(stats_, DB_WRITE_GROUP_SIZE, wal_write_group.size);
     const SequenceNumber current_sequence =
         write_thread_.UpdateLastSequence(versions_->LastSequence()) + 1;
     size_t total_count = 0;
@@ -429,6 +487,22 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
       }
       w.status = WriteToWAL(wal_write_group, log_writer, log_used,
                             need_log_sync, need_log_dir_sync, current_sequence);
+      if (w.status.ok() &&
+          immutable_db_options_.wal_sync_interval_micros > 0) {
+        NotifyWalSyncer(current_sequence + total_count - 1, total_byte_size);
+      }
+    }
+
+    bool sync_after_exit = w.status.ok() && !stripes_to_sync.empty();
+    for (auto* log : stripes_to_sync) {
+      if (!log->file()->writable_file()->IsSyncThreadSafe()) {
+        // The next write groups can't append to the WAL meanwhile
+        sync_after_exit = false;
+        if (w.status.ok()) {
+          w.status = SyncWalStripes(stripes_to_sync);
+        }
+        break;
+      }
     }
 
     if (!w.CallbackFailed()) {
@@ -437,11 +511,31 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
 
     if (need_log_sync) {
       mutex_.Lock();
-      MarkLogsSynced(logfile_number_, need_log_dir_sync, w.status);
+      if (wal_stripes) {
+        // Only the logs of the previous WALs have been synced so far
+        MarkLogsSynced(logfile_number_ - 1, false, w.status);
+        if (need_log_dir_sync && w.status.ok()) {
+          log_dir_synced_ = true;
+        }
+      } else {
+        MarkLogsSynced(logfile_number_, need_log_dir_sync, w.status);
+      }
       mutex_.Unlock();
     }
 
-    write_thread_.ExitAsBatchGroupLeader(wal_write_group, w.status);
+    if (sync_after_exit) {
+      WriteThread::Writer barrier;
+      write_thread_.ExitAsStripedBatchGroupLeader(wal_write_group, w.status,
+                                                  &barrier);
+      Status sync_status = SyncWalStripes(stripes_to_sync);
+      write_thread_.ExitWalStripeSyncBarrier(&w, &barrier, wal_write_group,
+                                             sync_status);
+      if (!sync_status.ok()) {
+        WriteCallbackStatusCheck(sync_status);
+      }
+    } else {
+      write_thread_.ExitAsBatchGroupLeader(wal_write_group, w.status);
+    }
   }
 
   WriteThread::WriteGroup memtable_write_group;
@@ -481,7 +575,12 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
   }
 
   assert(w.state == WriteThread::STATE_COMPLETED);
-  return w.FinalStatus();
+  Status status = w.FinalStatus();
+  if (status.ok() && w.sync &&
+      immutable_db_options_.wal_sync_interval_micros > 0) {
+    status = WaitForWalSync(w);
+  }
+  return status;
 }
 
 Status DBImpl::WriteImplWALOnly(const WriteOptions& write_options,
@@ -514,7 +613,9 @@ Status DBImpl::WriteImplWALOnly(const WriteOptions& write_options,
   WriteContext write_context;
   WriteThread::WriteGroup write_group;
   uint64_t last_sequence;
+  StopWatch group_sw(env_, stats_, DB_WRITE_GROUP_MICROS);
   nonmem_write_thread_.EnterAsBatchGroupLeader(&w, &write_group);
+  MeasureTime(stats_, DB_WRITE_GROUP_SIZE, write_group.size);
   // Note: no need to update last_batch_group_size_ here since the batch writes
   // to WAL only
 
@@ -681,6 +782,11 @@ Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
       log_sync_cv_.Wait();
     }
     for (auto& log : logs_) {
+      if (immutable_db_options_.wal_stripes > 1 &&
+          log.number >= logfile_number_) {
+        // The stripes of the current WAL are synced by SyncWalStripes()
+        break;
+      }
       assert(!log.getting_synced);
       // This is just to prevent the logs to be synced by a parallel SyncWAL
       // call. We will do the actual syncing later after we will write to the
@@ -718,8 +824,7 @@ WriteBatch* DBImpl::MergeBatch(const WriteThread::WriteGroup& write_group,
     *write_with_wal = 1;
   } else {
     // WAL needs all of the batches flattened into a single batch.
-    // We could avoid copying here with an iov-like AddRecord
-    // interface
+    // The values of PutUnowned() are not copied, but still referenced.
     merged_batch = tmp_batch;
     for (auto writer : write_group) {
       if (!writer->CallbackFailed()) {
@@ -742,16 +847,19 @@ Status DBImpl::WriteToWAL(const WriteBatch& merged_batch,
                           log::Writer* log_writer, uint64_t* log_used,
                           uint64_t* log_size) {
   assert(log_size != nullptr);
-  Slice log_entry = WriteBatchInternal::Contents(&merged_batch);
-  *log_size = log_entry.size();
-  Status status = log_writer->AddRecord(log_entry);
+  // The record is gathered from the batch and the values it references
+  std::vector<Slice> log_entry;
+  WriteBatchInternal::GetContents(&merged_batch, &log_entry);
+  *log_size = WriteBatchInternal::ByteSize(&merged_batch);
+  Status status = log_writer->AddRecord(
+      SliceParts(log_entry.data(), static_cast<int>(log_entry.size())));
   if (log_used != nullptr) {
     *log_used = logfile_number_;
   }
-  total_log_size_ += log_entry.size();
+  total_log_size_ += *log_size;
   // TODO(myabandeh): it might be unsafe to access alive_log_files_.back() here
   // since alive_log_files_ might be modified concurrently
-  alive_log_files_.back().AddSize(log_entry.size());
+  alive_log_files_.back().AddSize(*log_size);
   log_empty_ = false;
   return status;
 }
@@ -778,12 +886,21 @@ Status DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
 
   WriteBatchInternal::SetSequence(merged_batch, sequence);
 
+  // The WAL latencies drive DBOptions::adaptive_write_batch_group_size
+  const bool adaptive_group_size =
+      immutable_db_options_.adaptive_write_batch_group_size;
+  uint64_t write_start_micros = adaptive_group_size ? env_->NowMicros() : 0;
   uint64_t log_size;
   status = WriteToWAL(*merged_batch, log_writer, log_used, &log_size);
   if (to_be_cached_state) {
     cached_recoverable_state_ = *to_be_cached_state;
       cached_recoverable_state_empty_ = false;
   }
+  if (adaptive_group_size && status.ok()) {
+    uint64_t now_micros = env_->NowMicros();
+    write_thread_.RecordWalWrite(log_size, now_micros - write_start_micros);
+    write_start_micros = now_micros;
+  }
 
   if (status.ok() && need_log_sync) {
     StopWatch sw(env_, stats_, WAL_FILE_SYNC_MICROS);
@@ -795,6 +912,10 @@ Status DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
     //  - as long as other threads don't modify it, it's safe to read
     //    from std::deque from multiple threads concurrently.
     for (auto& log : logs_) {
+      if (immutable_db_options_.wal_stripes > 1 &&
+          log.number >= logfile_number_) {
+        break;
+      }
       status = log.writer->file()->Sync(immutable_db_options_.use_fsync);
       if (!status.ok()) {
         break;
@@ -806,6 +927,10 @@ Status DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
       // we can avoid the disk I/O in the write code path.
       status = directories_.GetWalDir()->Fsync();
     }
+    if (adaptive_group_size && status.ok() &&
+        immutable_db_options_.wal_stripes <= 1) {
+      write_thread_.RecordWalSync(env_->NowMicros() - write_start_micros);
+    }
   }
 
   if (merged_batch == &tmp_batch_) {
@@ -825,6 +950,115 @@ Status DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
   return status;
 }
 
+log::Writer* DBImpl::SelectWalStripe(
+    bool sync, autovector<log::Writer*>* stripes_to_sync) {
+  mutex_.AssertHeld();
+  const size_t num_stripes = immutable_db_options_.wal_stripes;
+  assert(num_stripes > 1 && logs_.size() >= num_stripes);
+  const size_t first = logs_.size() - num_stripes;
+  assert(logs_[first].number == logfile_number_);
+  size_t stripe = next_wal_stripe_;
+  next_wal_stripe_ = (next_wal_stripe_ + 1) % num_stripes;
+  unsynced_wal_stripes_[stripe] = true;
+  if (sync) {
+    // A synced write has to be preceded by durable copies of all the earlier
+    // writes, wherever they were appended
+    for (size_t i = 0; i < num_stripes; i++) {
+      if (unsynced_wal_stripes_[i]) {
+        stripes_to_sync->push_back(logs_[first + i].writer);
+        unsynced_wal_stripes_[i] = false;
+      }
+    }
+  }
+  return logs_[first + stripe].writer;
+}
+
+Status DBImpl::SyncWalStripes(const autovector<log::Writer*>& stripes_to_sync) {
+  StopWatch sw(env_, stats_, WAL_FILE_SYNC_MICROS);
+  const bool adaptive_group_size =
+      immutable_db_options_.adaptive_write_batch_group_size;
+  uint64_t start_micros = adaptive_group_size ? env_->NowMicros() : 0;
+  Status status;
+  for (auto* log : stripes_to_sync) {
+    if (log->file()->writable_file()->IsSyncThreadSafe()) {
+      status = log->file()->SyncWithoutFlush(immutable_db_options_.use_fsync);
+    } else {
+      status = log->file()->Sync(immutable_db_options_.use_fsync);
+    }
+    if (!status.ok()) {
+      break;
+    }
+  }
+  if (adaptive_group_size && status.ok()) {
+    write_thread_.RecordWalSync(env_->NowMicros() - start_micros);
+  }
+  return status;
+}
+
+void DBImpl::BGWalSyncer() {
+  const auto interval = std::chrono::microseconds(
+      immutable_db_options_.wal_sync_interval_micros);
+  const uint64_t interval_bytes = immutable_db_options_.wal_sync_interval_bytes;
+  std::unique_lock<std::mutex> lock(wal_syncer_mutex_);
+  while (true) {
+    wal_syncer_cv_.wait_for(lock, interval, [&]() {
+      return wal_syncer_stop_ ||
+             (interval_bytes > 0 && wal_unsynced_bytes_ >= interval_bytes);
+    });
+    if (wal_written_sequence_ > wal_synced_sequence_ &&
+        wal_syncer_status_.ok()) {
+      // Everything up to sequence has been appended to the WAL
+      SequenceNumber sequence = wal_written_sequence_;
+      wal_unsynced_bytes_ = 0;
+      lock.unlock();
+      TEST_SYNC_POINT("DBImpl::BGWalSyncer:BeforeSync");
+      Status s = SyncWAL();
+      if (!s.ok()) {
+        WriteCallbackStatusCheck(s);
+      }
+      lock.lock();
+      if (s.ok()) {
+        wal_synced_sequence_ = sequence;
+      } else {
+        // Fail the waiting and future sync writes
+        wal_syncer_status_ = s;
+      }
+      wal_synced_cv_.notify_all();
+    } else if (wal_syncer_stop_) {
+      break;
+    }
+  }
+}
+
+void DBImpl::NotifyWalSyncer(SequenceNumber sequence, uint64_t bytes) {
+  const uint64_t interval_bytes = immutable_db_options_.wal_sync_interval_bytes;
+  bool wake_up = false;
+  {
+    std::lock_guard<std::mutex> lock(wal_syncer_mutex_);
+    wal_written_sequence_ = std::max(wal_written_sequence_, sequence);
+    wal_unsynced_bytes_ += bytes;
+    wake_up = interval_bytes > 0 && wal_unsynced_bytes_ >= interval_bytes;
+  }
+  if (wake_up) {
+    wal_syncer_cv_.notify_one();
+  }
+}
+
+Status DBImpl::WaitForWalSync(const WriteThread::Writer& w) {
+  if (w.sequence == kMaxSequenceNumber) {
+    return Status::OK();
+  }
+  // The last sequence number of w, or the one before w if it is empty
+  SequenceNumber sequence =
+      w.sequence +
+      (seq_per_batch_ ? 1 : WriteBatchInternal::Count(w.batch)) - 1;
+  std::unique_lock<std::mutex> lock(wal_syncer_mutex_);
+  wal_synced_cv_.wait(lock, [&]() {
+    return wal_synced_sequence_ >= sequence || !wal_syncer_status_.ok();
+  });
+  return wal_synced_sequence_ >= sequence ? Status::OK() : wal_syncer_status_;
+}
+
 Status DBImpl::ConcurrentWriteToWAL(const WriteThread::WriteGroup& write_group,
                                     uint64_t* log_used,
                                     SequenceNumber* last_sequence,
@@ -1095,6 +1329,131 @@ Status DBImpl::ThrottleLowPriWritesIfNeeded(const WriteOptions& write_options,
   return Status::OK();
 }
 
+namespace {
+// Collects the column families that a batch writes to
+class ColumnFamilyCollector : public WriteBatch::Handler {
+ public:
+  const autovector<uint32_t>& column_family_ids() const {
+    return column_family_ids_;
+  }
+
+  virtual Status PutCF(uint32_t column_family_id, const Slice& /*key*/,
+                       const Slice& /*value*/) override {
+    return Add(column_family_id);
+  }
+  virtual Status DeleteCF(uint32_t column_family_id,
+                          const Slice& /*key*/) override {
+    return Add(column_family_id);
+  }
+  virtual Status SingleDeleteCF(uint32_t column_family_id,
+                                const Slice& /*key*/) override {
+    return Add(column_family_id);
+  }
+  virtual Status DeleteRangeCF(uint32_t column_family_id,
+                               const Slice& /*begin_key*/,
+                               const Slice& /*end_key*/) override {
+    return Add(column_family_id);
+  }
+  virtual Status MergeCF(uint32_t column_family_id, const Slice& /*key*/,
+                         const Slice& /*value*/) override {
+    return Add(column_family_id);
+  }
+  virtual Status PutBlobIndexCF(uint32_t column_family_id,
+                                const Slice& /*key*/,
+                                const Slice& /*value*/) override {
+    return Add(column_family_id);
+  }
+  virtual Status MarkBeginPrepare() override { return Status::OK(); }
+  virtual Status MarkEndPrepare(const Slice& /*xid*/) override {
+    return Status::OK();
+  }
+  virtual Status MarkNoop(bool /*empty_batch*/) override {
+    return Status::OK();
+  }
+  virtual Status MarkRollback(const Slice& /*xid*/) override {
+    return Status::OK();
+  }
+  virtual Status MarkCommit(const Slice& /*xid*/) override {
+    return Status::OK();
+  }
+
+ private:
+  Status Add(uint32_t column_family_id) {
+    for (uint32_t id : column_family_ids_) {
+      if (id == column_family_id) {
+        return Status::OK();
+      }
+    }
+    column_family_ids_.push_back(column_family_id);
+    return Status::OK();
+  }
+
+  autovector<uint32_t> column_family_ids_;
+};
+}  // namespace
+
+Status DBImpl::DelayColumnFamilyWrites(const WriteOptions& write_options,
+                                       WriteBatch* my_batch) {
+  ColumnFamilyCollector collector;
+  // A batch that can't be iterated fails when it is written
+  my_batch->Iterate(&collector);
+  const uint64_t num_bytes = WriteBatchInternal::ByteSize(my_batch);
+  uint64_t time_delayed = 0;
+  bool delayed = false;
+  {
+    StopWatch sw(env_, stats_, WRITE_STALL, &time_delayed);
+    for (uint32_t column_family_id : collector.column_family_ids()) {
+      uint64_t delay = write_controller_.GetDelay(env_, column_family_id,
+                                                  num_bytes);
+      if (delay > 0) {
+        if (write_options.no_slowdown) {
+          return Status::Incomplete();
+        }
+        delayed = true;
+        TEST_SYNC_POINT("DBImpl::DelayColumnFamilyWrites:Sleep");
+        // The delay ends early if the stall is released
+        const uint64_t kDelayInterval = 1000;
+        uint64_t stall_end = env_->NowMicros() + delay;
+        while (write_controller_.NeedsDelay(column_family_id)) {
+          uint64_t now = env_->NowMicros();
+          if (now >= stall_end) {
+            break;
+          }
+          env_->SleepForMicroseconds(
+              static_cast<int>(std::min(kDelayInterval, stall_end - now)));
+        }
+      }
+      if (write_controller_.IsStopped(column_family_id)) {
+        if (write_options.no_slowdown) {
+          return Status::Incomplete();
+        }
+        delayed = true;
+        InstrumentedMutexLock l(&mutex_);
+        while (bg_error_.ok() &&
+               write_controller_.IsStopped(column_family_id)) {
+          auto* cfd = versions_->GetColumnFamilySet()->GetColumnFamily(
+              column_family_id);
+          if (cfd == nullptr || cfd->IsDropped()) {
+            // The write fails on its own
+            break;
+          }
+          TEST_SYNC_POINT("DBImpl::DelayColumnFamilyWrites:Wait");
+          bg_cv_.Wait();
+        }
+        if (!bg_error_.ok()) {
+          return bg_error_;
+        }
+      }
+    }
+  }
+  if (delayed) {
+    default_cf_internal_stats_->AddDBStats(InternalStats::WRITE_STALL_MICROS,
+                                           time_delayed, true /* concurrent */);
+    RecordTick(stats_, STALL_MICROS, time_delayed);
+  }
+  return Status::OK();
+}
+
 Status DBImpl::ScheduleFlushes(WriteContext* context) {
   ColumnFamilyData* cfd;
   while ((cfd = flush_scheduler_.TakeNextColumnFamily()) != nullptr) {
@@ -1171,6 +1530,13 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
   }
   uint64_t new_log_number =
       creating_new_log ? versions_->NewFileNumber() : logfile_number_;
+  // The other stripes of the new WAL, if the WAL is striped
+  autovector<std::pair<uint64_t, log::Writer*>> new_stripe_logs;
+  if (creating_new_log) {
+    for (size_t i = 1; i < immutable_db_options_.wal_stripes; i++) {
+      new_stripe_logs.emplace_back(versions_->NewFileNumber(), nullptr);
+    }
+  }
   const MutableCFOptions mutable_cf_options = *cfd->GetLatestMutableCFOptions();
 
   // Set memtable_info for memtable sealed callback
@@ -1220,7 +1586,26 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
             new WritableFileWriter(std::move(lfile), opt_env_opt));
         new_log = new log::Writer(
             std::move(file_writer), new_log_number,
-            immutable_db_options_.recycle_log_file_num > 0, manual_wal_flush_);
+            immutable_db_options_.recycle_log_file_num > 0, manual_wal_flush_,
+            immutable_db_options_.wal_compression);
+      }
+      for (auto& stripe : new_stripe_logs) {
+        if (!s.ok()) {
+          break;
+        }
+        s = NewWritableFile(
+            env_, LogFileName(immutable_db_options_.wal_dir, stripe.first),
+            &lfile, opt_env_opt);
+        if (s.ok()) {
+          lfile->SetPreallocationBlockSize(preallocate_block_size);
+          lfile->SetWriteLifeTimeHint(write_hint);
+          unique_ptr<WritableFileWriter> file_writer(
+              new WritableFileWriter(std::move(lfile), opt_env_opt));
+          stripe.second =
+              new log::Writer(std::move(file_writer), stripe.first,
+                              false /* recycle_log_files */, manual_wal_flush_,
+                              immutable_db_options_.wal_compression);
+        }
       }
     }
 
@@ -1246,7 +1631,10 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
     // how do we fail if we're not creating new log?
     assert(creating_new_log);
     assert(!new_mem);
-    assert(!new_log);
+    delete new_log;
+    for (auto& stripe : new_stripe_logs) {
+      delete stripe.second;
+    }
     if (two_write_queues_) {
       nonmem_write_thread_.ExitUnbatched(&nonmem_w);
     }
@@ -1265,6 +1653,14 @@ Status DBImpl::SwitchMemtable(ColumnFamilyData* cfd, WriteContext* context) {
     }
     logs_.emplace_back(logfile_number_, new_log);
     alive_log_files_.push_back(LogFileNumberSize(logfile_number_));
+    for (auto& stripe : new_stripe_logs) {
+      logs_.emplace_back(stripe.first, stripe.second);
+      alive_log_files_.push_back(LogFileNumberSize(stripe.first));
+    }
+    if (!new_stripe_logs.empty()) {
+      next_wal_stripe_ = 0;
+      unsynced_wal_stripes_.assign(unsynced_wal_stripes_.size(), false);
+    }
     log_write_mutex_.Unlock();
   }
   for (auto loop_cfd : *versions_->GetColumnFamilySet()) {
@@ -1353,4 +1749,10 @@ Status DB::Merge(const WriteOptions& opt, ColumnFamilyHandle* column_family,
   batch.Merge(column_family, key, value);
   return Write(opt, &batch);
 }
+
+Status DB::WriteAsync(const WriteOptions& opt, WriteBatch* updates,
+                      std::function<void(const Status&)> callback) {
+  callback(Write(opt, updates));
+  return Status::OK();
+}
 }  // namespace rocksdb
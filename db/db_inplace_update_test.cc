@@ -8,12 +8,26 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include "db/db_test_util.h"
 #include "port/stack_trace.h"
+#include "util/coding.h"
 
 namespace rocksdb {
 
 class DBTestInPlaceUpdate : public DBTestBase {
  public:
   DBTestInPlaceUpdate() : DBTestBase("/db_inplace_update_test") {}
+
+  // Adds the fixed64 delta to a fixed64 counter
+  static UpdateStatus updateCounter(char* prevValue, uint32_t* prevSize,
+                                    Slice delta, std::string* newValue) {
+    if (prevValue == nullptr) {
+      *newValue = delta.ToString();
+      return UpdateStatus::UPDATED;
+    }
+    EXPECT_EQ(sizeof(uint64_t), *prevSize);
+    EncodeFixed64(prevValue,
+                  DecodeFixed64(prevValue) + DecodeFixed64(delta.data()));
+    return UpdateStatus::UPDATED_INPLACE;
+  }
 };
 
 TEST_F(DBTestInPlaceUpdate, InPlaceUpdate) {
@@ -168,6 +182,91 @@ TEST_F(DBTestInPlaceUpdate, InPlaceUpdateCallbackNoAction) {
     ASSERT_EQ(Get(1, "key"), "NOT_FOUND");
   } while (ChangeCompactOptions());
 }
+
+TEST_F(DBTestInPlaceUpdate, InPlaceUpdateAtomic) {
+  do {
+    Options options = CurrentOptions();
+    options.create_if_missing = true;
+    options.inplace_update_atomic = true;
+    options.env = env_;
+    options.write_buffer_size = 100000;
+    Reopen(options);
+    CreateAndReopenWithCF({"pikachu"}, options);
+
+    // Update key with 8-byte values
+    int numValues = 10;
+    for (int i = 0; i < numValues; i++) {
+      std::string value = DummyString(8, static_cast<char>('a' + i));
+      ASSERT_OK(Put(1, "key", value));
+      ASSERT_EQ(value, Get(1, "key"));
+    }
+
+    // Only 1 instance for that key.
+    validateNumberOfEntries(1, 1);
+
+    // Values of other sizes are added
+    ASSERT_OK(Put(1, "key", DummyString(4, 'x')));
+    ASSERT_EQ(DummyString(4, 'x'), Get(1, "key"));
+    ASSERT_OK(Put(1, "key", DummyString(8, 'y')));
+    ASSERT_EQ(DummyString(8, 'y'), Get(1, "key"));
+    ASSERT_OK(Put(1, "key", DummyString(8, 'z')));
+    ASSERT_EQ(DummyString(8, 'z'), Get(1, "key"));
+
+    // The last 8-byte value survives recovery from the WAL
+    ReopenWithColumnFamilies({"default", "pikachu"}, options);
+    ASSERT_EQ(DummyString(8, 'z'), Get(1, "key"));
+  } while (ChangeCompactOptions());
+}
+
+TEST_F(DBTestInPlaceUpdate, InPlaceUpdateAtomicCallbackConcurrently) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.inplace_update_atomic = true;
+  options.inplace_callback = rocksdb::DBTestInPlaceUpdate::updateCounter;
+  options.allow_concurrent_memtable_write = true;
+  options.env = env_;
+  DestroyAndReopen(options);
+
+  const int kNumThreads = 4;
+  const int kNumIncrements = 1000;
+  const int kNumKeys = 3;
+  std::string one;
+  PutFixed64(&one, 1);
+  for (int k = 0; k < kNumKeys; k++) {
+    ASSERT_OK(Put(Key(k), one));
+  }
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < kNumIncrements; i++) {
+        ASSERT_OK(Put(Key(i % kNumKeys), one));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Every key has a single memtable entry holding the sum of the deltas
+  for (int reopen = 0; reopen < 2; reopen++) {
+    uint64_t total = 0;
+    for (int k = 0; k < kNumKeys; k++) {
+      std::string value = Get(Key(k));
+      ASSERT_EQ(sizeof(uint64_t), value.size());
+      total += DecodeFixed64(value.data());
+    }
+    ASSERT_EQ(static_cast<uint64_t>(kNumKeys + kNumThreads * kNumIncrements),
+              total);
+    if (reopen == 0) {
+      uint64_t num_entries = 0;
+      ASSERT_TRUE(dbfull()->GetIntProperty(
+          "rocksdb.num-entries-active-mem-table", &num_entries));
+      ASSERT_EQ(static_cast<uint64_t>(kNumKeys), num_entries);
+    }
+    // The WAL replays the deltas
+    Reopen(options);
+  }
+}
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -12,6 +12,7 @@
 #include <iostream>
 #include <limits>
 
+#include "db/blob_source.h"
 #include "db/dbformat.h"
 #include "db/merge_context.h"
 #include "db/merge_helper.h"
@@ -108,7 +109,8 @@ class DBIter final: public Iterator {
          const ImmutableCFOptions& cf_options, const Comparator* cmp,
          InternalIterator* iter, SequenceNumber s, bool arena_mode,
          uint64_t max_sequential_skip_in_iterations,
-         ReadCallback* read_callback, bool allow_blob)
+         ReadCallback* read_callback, bool allow_blob,
+         BlobSource* blob_source)
       : arena_mode_(arena_mode),
         env_(_env),
         logger_(cf_options.info_log),
@@ -131,6 +133,10 @@ class DBIter final: public Iterator {
         read_callback_(read_callback),
         allow_blob_(allow_blob),
         is_blob_(false),
+        blob_source_(blob_source),
+        has_blob_value_(false),
+        read_tier_(read_options.read_tier),
+        verify_checksums_(read_options.verify_checksums),
         start_seqnum_(read_options.iter_start_seqnum) {
     RecordTick(statistics_, NO_ITERATORS);
     prefix_extractor_ = cf_options.prefix_extractor;
@@ -180,7 +186,9 @@ class DBIter final: public Iterator {
   }
   virtual Slice value() const override {
     assert(valid_);
-    if (current_entry_is_merged_) {
+    if (has_blob_value_) {
+      return blob_value_;
+    } else if (current_entry_is_merged_) {
       // If pinned_value_ is set then the result of merge operator is one of
       // the merge operands and we should return it.
       return pinned_value_.data() ? pinned_value_ : saved_value_;
@@ -238,6 +246,7 @@ class DBIter final: public Iterator {
   void FindParseableKey(ParsedInternalKey* ikey, Direction direction);
   bool FindValueForCurrentKey();
   bool FindValueForCurrentKeyUsingSeek();
+  bool GetBlobValue(const Slice& user_key, const Slice& blob_index);
   void FindPrevUserKey();
   void FindNextUserKey();
   inline void FindNextUserEntry(bool skipping, bool prefix_check);
@@ -321,6 +330,12 @@ class DBIter final: public Iterator {
   ReadCallback* read_callback_;
   bool allow_blob_;
   bool is_blob_;
+  // Reads the values of blob indexes when allow_blob_ is not set
+  BlobSource* blob_source_;
+  PinnableSlice blob_value_;
+  bool has_blob_value_;
+  const ReadTier read_tier_;
+  const bool verify_checksums_;
   // for diff snapshots we want the lower bound on the seqnum;
   // if this value > 0 iterator will return internal keys
   SequenceNumber start_seqnum_;
@@ -414,6 +429,7 @@ void DBIter::FindNextUserEntryInternal(bool skipping, bool prefix_check) {
   uint64_t num_skipped = 0;
 
   is_blob_ = false;
+  has_blob_value_ = false;
 
   do {
     if (!ParseKey(&ikey_)) {
@@ -498,7 +514,9 @@ void DBIter::FindNextUserEntryInternal(bool skipping, bool prefix_check) {
                 num_skipped = 0;
                 PERF_COUNTER_ADD(internal_delete_skipped_count, 1);
               } else if (ikey_.type == kTypeBlobIndex) {
-                if (!allow_blob_) {
+                if (!allow_blob_ && blob_source_ != nullptr) {
+                  valid_ = GetBlobValue(ikey_.user_key, iter_->value());
+                } else if (!allow_blob_) {
                   ROCKS_LOG_ERROR(logger_, "Encounter unexpected blob index.");
                   status_ = Status::NotSupported(
                       "Encounter unexpected blob index. Please open DB with "
@@ -820,6 +838,7 @@ bool DBIter::FindValueForCurrentKey() {
   assert(iter_->Valid());
   merge_context_.Clear();
   current_entry_is_merged_ = false;
+  has_blob_value_ = false;
   // last entry before merge (could be kTypeDeletion, kTypeSingleDeletion or
   // kTypeValue)
   ValueType last_not_merge_type = kTypeDeletion;
@@ -932,6 +951,10 @@ bool DBIter::FindValueForCurrentKey() {
       // do nothing - we've already has value in saved_value_
       break;
     case kTypeBlobIndex:
+      if (!allow_blob_ && blob_source_ != nullptr) {
+        valid_ = GetBlobValue(saved_key_.GetUserKey(), pinned_value_);
+        return true;
+      }
       if (!allow_blob_) {
         ROCKS_LOG_ERROR(logger_, "Encounter unexpected blob index.");
         status_ = Status::NotSupported(
@@ -953,6 +976,24 @@ bool DBIter::FindValueForCurrentKey() {
   return true;
 }
 
+// Reads the value that blob_index points at into blob_value_, which value()
+// returns from then on. Returns false and sets status_ if it fails.
+bool DBIter::GetBlobValue(const Slice& user_key, const Slice& blob_index) {
+  assert(blob_source_ != nullptr);
+  ReadOptions read_options;
+  read_options.read_tier = read_tier_;
+  read_options.verify_checksums = verify_checksums_;
+  blob_value_.Reset();
+  Status s =
+      blob_source_->GetBlob(read_options, user_key, blob_index, &blob_value_);
+  if (!s.ok()) {
+    status_ = s;
+    return false;
+  }
+  has_blob_value_ = true;
+  return true;
+}
+
 // This function is used in FindValueForCurrentKey.
 // We use Seek() function instead of Prev() to find necessary value
 bool DBIter::FindValueForCurrentKeyUsingSeek() {
@@ -975,6 +1016,10 @@ bool DBIter::FindValueForCurrentKeyUsingSeek() {
     valid_ = false;
     return false;
   }
+  if (ikey.type == kTypeBlobIndex && !allow_blob_ && blob_source_ != nullptr) {
+    valid_ = GetBlobValue(ikey.user_key, iter_->value());
+    return true;
+  }
   if (ikey.type == kTypeBlobIndex && !allow_blob_) {
     ROCKS_LOG_ERROR(logger_, "Encounter unexpected blob index.");
     status_ = Status::NotSupported(
@@ -1306,11 +1351,12 @@ Iterator* NewDBIterator(Env* env, const ReadOptions& read_options,
                         InternalIterator* internal_iter,
                         const SequenceNumber& sequence,
                         uint64_t max_sequential_skip_in_iterations,
-                        ReadCallback* read_callback, bool allow_blob) {
-  DBIter* db_iter =
-      new DBIter(env, read_options, cf_options, user_key_comparator,
-                 internal_iter, sequence, false,
-                 max_sequential_skip_in_iterations, read_callback, allow_blob);
+                        ReadCallback* read_callback, bool allow_blob,
+                        BlobSource* blob_source) {
+  DBIter* db_iter = new DBIter(
+      env, read_options, cf_options, user_key_comparator, internal_iter,
+      sequence, false, max_sequential_skip_in_iterations, read_callback,
+      allow_blob, blob_source);
   return db_iter;
 }
 
@@ -1356,12 +1402,13 @@ void ArenaWrappedDBIter::Init(Env* env, const ReadOptions& read_options,
                               const SequenceNumber& sequence,
                               uint64_t max_sequential_skip_in_iteration,
                               uint64_t version_number,
-                              ReadCallback* read_callback, bool allow_blob) {
+                              ReadCallback* read_callback, bool allow_blob,
+                              BlobSource* blob_source) {
   auto mem = arena_.AllocateAligned(sizeof(DBIter));
   db_iter_ = new (mem)
       DBIter(env, read_options, cf_options, cf_options.user_comparator, nullptr,
              sequence, true, max_sequential_skip_in_iteration, read_callback,
-             allow_blob);
+             allow_blob, blob_source);
   sv_number_ = version_number;
 }
 
@@ -1384,7 +1431,8 @@ Status ArenaWrappedDBIter::Refresh() {
     SuperVersion* sv = cfd_->GetReferencedSuperVersion(db_impl_->mutex());
     Init(env, read_options_, *(cfd_->ioptions()), latest_seq,
          sv->mutable_cf_options.max_sequential_skip_in_iterations,
-         cur_sv_number, read_callback_, allow_blob_);
+         cur_sv_number, read_callback_, allow_blob_,
+         cfd_->GetBlobSourceForIterator(sv));
 
     InternalIterator* internal_iter = db_impl_->NewInternalIterator(
         read_options_, cfd_, sv, &arena_, db_iter_->GetRangeDelAggregator());
@@ -1401,11 +1449,11 @@ ArenaWrappedDBIter* NewArenaWrappedDbIterator(
     const ImmutableCFOptions& cf_options, const SequenceNumber& sequence,
     uint64_t max_sequential_skip_in_iterations, uint64_t version_number,
     ReadCallback* read_callback, DBImpl* db_impl, ColumnFamilyData* cfd,
-    bool allow_blob) {
+    bool allow_blob, BlobSource* blob_source) {
   ArenaWrappedDBIter* iter = new ArenaWrappedDBIter();
   iter->Init(env, read_options, cf_options, sequence,
              max_sequential_skip_in_iterations, version_number, read_callback,
-             allow_blob);
+             allow_blob, blob_source);
   if (db_impl != nullptr && cfd != nullptr) {
     iter->StoreRefreshInfo(read_options, db_impl, cfd, read_callback,
                            allow_blob);
@@ -22,12 +22,15 @@
 namespace rocksdb {
 
 class Arena;
+class BlobSource;
 class DBIter;
 class InternalIterator;
 
 // Return a new iterator that converts internal keys (yielded by
 // "*internal_iter") that were live at the specified "sequence" number
 // into appropriate user keys.
+// Unless allow_blob is set, the values of blob indexes are read through
+// blob_source, if it is not null.
 extern Iterator* NewDBIterator(Env* env, const ReadOptions& read_options,
                                const ImmutableCFOptions& cf_options,
                                const Comparator* user_key_comparator,
@@ -35,7 +38,8 @@ extern Iterator* NewDBIterator(Env* env, const ReadOptions& read_options,
                                const SequenceNumber& sequence,
                                uint64_t max_sequential_skip_in_iterations,
                                ReadCallback* read_callback,
-                               bool allow_blob = false);
+                               bool allow_blob = false,
+                               BlobSource* blob_source = nullptr);
 
 // A wrapper iterator which wraps DB Iterator and the arena, with which the DB
 // iterator is supposed be allocated. This class is used as an entry point of
@@ -73,7 +77,8 @@ class ArenaWrappedDBIter : public Iterator {
             const ImmutableCFOptions& cf_options,
             const SequenceNumber& sequence,
             uint64_t max_sequential_skip_in_iterations, uint64_t version_number,
-            ReadCallback* read_callback, bool allow_blob);
+            ReadCallback* read_callback, bool allow_blob,
+            BlobSource* blob_source);
 
   void StoreRefreshInfo(const ReadOptions& read_options, DBImpl* db_impl,
                         ColumnFamilyData* cfd, ReadCallback* read_callback,
@@ -104,6 +109,7 @@ extern ArenaWrappedDBIter* NewArenaWrappedDbIterator(
     const ImmutableCFOptions& cf_options, const SequenceNumber& sequence,
     uint64_t max_sequential_skip_in_iterations, uint64_t version_number,
     ReadCallback* read_callback, DBImpl* db_impl = nullptr,
-    ColumnFamilyData* cfd = nullptr, bool allow_blob = false);
+    ColumnFamilyData* cfd = nullptr, bool allow_blob = false,
+    BlobSource* blob_source = nullptr);
 
 }  // namespace rocksdb
@@ -1882,6 +1882,127 @@ TEST_F(DBIteratorTest, ReadAhead) {
   delete iter;
 }
 
+TEST_F(DBIteratorTest, AutoReadAhead) {
+  Options options;
+  env_->count_random_reads_ = true;
+  options.env = env_;
+  options.disable_auto_compactions = true;
+  options.write_buffer_size = 4 << 20;
+  options.statistics = rocksdb::CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  table_options.no_block_cache = true;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  const int kNumKeys = 200;
+  std::string value(1024, 'a');
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), value));
+  }
+  ASSERT_OK(Flush());
+
+  // Warm up the table cache so that only data blocks are read below
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  iter->Seek(Key(kNumKeys - 1));
+  ASSERT_TRUE(iter->Valid());
+  iter.reset();
+
+  // A scan reads one block per key without readahead
+  env_->random_read_counter_.Reset();
+  iter.reset(db_->NewIterator(ReadOptions()));
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ASSERT_EQ(value, iter->value());
+    count++;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(kNumKeys, count);
+  ASSERT_LT(env_->random_read_counter_.Read(), kNumKeys / 4);
+  uint64_t prefetched = TestGetTickerCount(options, PREFETCH_BYTES);
+  ASSERT_GT(prefetched, kNumKeys * value.size() / 2);
+  ASSERT_LT(TestGetTickerCount(options, PREFETCH_BYTES_WASTED), prefetched);
+
+  // Seeking backwards never reads ahead
+  env_->random_read_counter_.Reset();
+  for (int i = kNumKeys - 1; i >= 0; i -= 3) {
+    iter->Seek(Key(i));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(value, iter->value());
+  }
+  ASSERT_EQ(prefetched, TestGetTickerCount(options, PREFETCH_BYTES));
+  ASSERT_GE(env_->random_read_counter_.Read(), kNumKeys / 3);
+}
+
+TEST_F(DBIteratorTest, AsyncReadAhead) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.async_readahead = true;
+  options.compaction_readahead_size = 16 * 1024;
+  options.new_table_reader_for_compaction_inputs = true;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  table_options.no_block_cache = true;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  std::atomic<int> background_reads(0);
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "AsyncReadahead::Run:BeforeRead",
+      [&](void* /*arg*/) { background_reads++; });
+  // Give the readahead threads a chance to run before the reader takes back
+  // the queued chunk, even on a single core
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "ReadaheadRandomAccessFile::TakeAsyncReadahead",
+      [&](void* /*arg*/) { env_->SleepForMicroseconds(1000); });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  const int kNumKeys = 1000;
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumKeys; i++) {
+    values.push_back(RandomString(&rnd, 1000));
+    ASSERT_OK(Put(Key(i), values[i]));
+    if (i % 300 == 299) {
+      ASSERT_OK(Flush());
+    }
+  }
+  // Make the last file overlap the others so that they are not trivially
+  // moved by the compaction below
+  ASSERT_OK(Put(Key(0), values[0]));
+  ASSERT_OK(Flush());
+
+  auto verify = [&]() {
+    ReadOptions read_options;
+    read_options.readahead_size = 16 * 1024;
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_EQ(Key(count), iter->key().ToString());
+      ASSERT_EQ(values[count], iter->value().ToString());
+      count++;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys, count);
+    for (int i = kNumKeys - 1; i >= 0; i -= 7) {
+      iter->Seek(Key(i));
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(values[i], iter->value().ToString());
+    }
+  };
+  verify();
+  ASSERT_GT(background_reads.load(), 0);
+
+  // Compaction inputs are read ahead asynchronously as well
+  background_reads = 0;
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_GT(background_reads.load(), 0);
+  verify();
+
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 // Insert a key, create a snapshot iterator, overwrite key lots of times,
 // seek to a smaller key. Expect DBIter to fall back to a seek instead of
 // going through all the overwrites linearly.
@@ -186,6 +186,165 @@ TEST_F(DBMemTableTest, ColumnFamilyId) {
   }
 }
 
+TEST_F(DBMemTableTest, SortedBatchInsert) {
+  for (bool concurrent : {false, true}) {
+    Options options = CurrentOptions();
+    options.create_if_missing = true;
+    options.memtable_sorted_batch_insert = true;
+    options.allow_concurrent_memtable_write = concurrent;
+    options.merge_operator = MergeOperators::CreateStringAppendOperator();
+    DestroyAndReopen(options);
+
+    // Keys are written in reverse order so the batch has to be sorted
+    // before it is spliced into the memtable.
+    std::map<std::string, std::string> expected;
+    for (int round = 0; round < 10; ++round) {
+      WriteBatch batch;
+      for (int i = 99; i >= 0; --i) {
+        std::string key = Key(i);
+        if (i % 7 == 0) {
+          ASSERT_OK(batch.Delete(key));
+          expected.erase(key);
+        } else if (i % 5 == 0) {
+          ASSERT_OK(batch.Merge(key, ToString(round)));
+          auto iter = expected.find(key);
+          if (iter == expected.end()) {
+            expected[key] = ToString(round);
+          } else {
+            iter->second += "," + ToString(round);
+          }
+        } else {
+          ASSERT_OK(batch.Put(key, "v" + ToString(round)));
+          // The same key twice within one batch: the later one wins.
+          ASSERT_OK(batch.Put(key, "w" + ToString(round)));
+          expected[key] = "w" + ToString(round);
+        }
+      }
+      ASSERT_OK(db_->Write(WriteOptions(), &batch));
+    }
+
+    for (int i = 0; i < 100; ++i) {
+      auto iter = expected.find(Key(i));
+      ASSERT_EQ(iter == expected.end() ? "NOT_FOUND" : iter->second,
+                Get(Key(i)));
+    }
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    auto expected_iter = expected.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++expected_iter) {
+      ASSERT_TRUE(expected_iter != expected.end());
+      ASSERT_EQ(expected_iter->first, iter->key().ToString());
+      ASSERT_EQ(expected_iter->second, iter->value().ToString());
+    }
+    ASSERT_TRUE(expected_iter == expected.end());
+    ASSERT_OK(iter->status());
+  }
+}
+
+TEST_F(DBMemTableTest, SortedBatchInsertConcurrently) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.memtable_sorted_batch_insert = true;
+  options.allow_concurrent_memtable_write = true;
+  DestroyAndReopen(options);
+
+  // Batches of interleaved keys written by several threads, so that write
+  // groups insert them into the memtable in parallel.
+  const int kNumThreads = 4;
+  const int kNumBatches = 50;
+  const int kBatchSize = 40;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int b = 0; b < kNumBatches; ++b) {
+        WriteBatch batch;
+        for (int i = kBatchSize - 1; i >= 0; --i) {
+          int k = (b * kBatchSize + i) * kNumThreads + t;
+          batch.Put(Key(k), ToString(k));
+        }
+        ASSERT_OK(db_->Write(WriteOptions(), &batch));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+  int k = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++k) {
+    ASSERT_EQ(Key(k), iter->key().ToString());
+    ASSERT_EQ(ToString(k), iter->value().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(kNumThreads * kNumBatches * kBatchSize, k);
+}
+
+#ifndef ROCKSDB_LITE
+TEST_F(DBMemTableTest, ConcurrentInsertIntoHashMemTable) {
+  const int kNumThreads = 4;
+  const int kNumBatches = 50;
+  const int kBatchSize = 20;
+  for (int rep = 0; rep < 2; ++rep) {
+    Options options = CurrentOptions();
+    options.create_if_missing = true;
+    options.allow_concurrent_memtable_write = true;
+    options.enable_write_thread_adaptive_yield = true;
+    options.prefix_extractor.reset(NewFixedPrefixTransform(3));
+    if (rep == 0) {
+      options.memtable_factory.reset(NewHashSkipListRepFactory(16));
+    } else {
+      // A low threshold turns the busier buckets into skip lists
+      options.memtable_factory.reset(
+          NewHashLinkListRepFactory(16, 0, 0, true, 8));
+    }
+    DestroyAndReopen(options);
+
+    // Each batch puts keys into every prefix, so that concurrently inserted
+    // write groups keep hitting the same buckets.
+    std::vector<port::Thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+      threads.emplace_back([&, t]() {
+        for (int b = 0; b < kNumBatches; ++b) {
+          WriteBatch batch;
+          for (int i = 0; i < kBatchSize; ++i) {
+            char key[32];
+            snprintf(key, sizeof(key), "p%02d-%d-%04d", i, t, b);
+            batch.Put(key, ToString(b));
+          }
+          ASSERT_OK(db_->Write(WriteOptions(), &batch));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    ReadOptions read_options;
+    for (int i = 0; i < kBatchSize; ++i) {
+      char prefix[16];
+      snprintf(prefix, sizeof(prefix), "p%02d", i);
+      std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+      int count = 0;
+      std::string last_key;
+      for (iter->Seek(prefix); iter->Valid() && iter->key().starts_with(prefix);
+           iter->Next(), ++count) {
+        ASSERT_LT(last_key, iter->key().ToString());
+        last_key = iter->key().ToString();
+      }
+      ASSERT_OK(iter->status());
+      ASSERT_EQ(kNumThreads * kNumBatches, count);
+    }
+    for (int t = 0; t < kNumThreads; ++t) {
+      for (int b = 0; b < kNumBatches; ++b) {
+        char key[32];
+        snprintf(key, sizeof(key), "p%02d-%d-%04d", b % kBatchSize, t, b);
+        ASSERT_EQ(ToString(b), Get(key));
+      }
+    }
+  }
+}
+#endif  // ROCKSDB_LITE
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -3229,7 +3229,8 @@ TEST_F(DBTest, ConcurrentMemtableNotSupported) {
   options.create_if_missing = true;
 
   DestroyDB(dbname_, options);
-  options.memtable_factory.reset(NewHashLinkListRepFactory(4, 0, 3, true, 4));
+  options.memtable_factory.reset(
+      NewHashCuckooRepFactory(options.write_buffer_size));
   ASSERT_NOK(TryReopen(options));
 
   options.memtable_factory.reset(new SkipListFactory);
@@ -3237,7 +3238,7 @@ TEST_F(DBTest, ConcurrentMemtableNotSupported) {
 
   ColumnFamilyOptions cf_options(options);
   cf_options.memtable_factory.reset(
-      NewHashLinkListRepFactory(4, 0, 3, true, 4));
+      NewHashCuckooRepFactory(options.write_buffer_size));
   ColumnFamilyHandle* handle;
   ASSERT_NOK(db_->CreateColumnFamily(cf_options, "name", &handle));
 }
@@ -2073,6 +2073,52 @@ TEST_F(DBTest2, OptimizeForPointLookup) {
 
 #endif  // ROCKSDB_LITE
 
+TEST_F(DBTest2, DataBlockHashIndex) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  table_options.block_restart_interval = 4;
+  table_options.data_block_index_type =
+      BlockBasedTableOptions::kDataBlockBinaryAndHash;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  // Several versions per key, spread over restart intervals and blocks, with
+  // a snapshot in between.
+  const int kNumKeys = 1000;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), "v1_" + ToString(i)));
+  }
+  const Snapshot* snapshot = db_->GetSnapshot();
+  for (int i = 0; i < kNumKeys; i++) {
+    if (i % 3 == 0) {
+      ASSERT_OK(Put(Key(i), "v2_" + ToString(i)));
+    } else if (i % 3 == 1) {
+      ASSERT_OK(Delete(Key(i)));
+    }
+  }
+  ASSERT_OK(Flush());
+
+  for (int i = 0; i < kNumKeys; i++) {
+    std::string expected;
+    if (i % 3 == 0) {
+      expected = "v2_" + ToString(i);
+    } else if (i % 3 == 1) {
+      expected = "NOT_FOUND";
+    } else {
+      expected = "v1_" + ToString(i);
+    }
+    ASSERT_EQ(expected, Get(Key(i)));
+    ASSERT_EQ("v1_" + ToString(i), Get(Key(i), snapshot));
+  }
+  // Keys that were never written
+  ASSERT_EQ("NOT_FOUND", Get(Key(-1)));
+  ASSERT_EQ("NOT_FOUND", Get(Key(kNumKeys)));
+  ASSERT_EQ("NOT_FOUND", Get(Key(5) + "x"));
+  db_->ReleaseSnapshot(snapshot);
+}
+
 TEST_F(DBTest2, GetRaceFlush1) {
   ASSERT_OK(Put("foo", "v1"));
 
@@ -365,6 +365,7 @@ Options DBTestBase::GetOptions(
           BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
       options.new_table_reader_for_compaction_inputs = true;
       options.compaction_readahead_size = 10 * 1024 * 1024;
+      options.async_readahead = true;
       break;
     case kUncompressed:
       options.compression = kNoCompression;
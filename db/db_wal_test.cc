@@ -11,6 +11,7 @@
 #include "options/options_helper.h"
 #include "port/port.h"
 #include "port/stack_trace.h"
+#include "util/compression.h"
 #include "util/fault_injection_test_env.h"
 #include "util/sync_point.h"
 
@@ -672,6 +673,70 @@ TEST_F(DBWALTest, PartOfWritesWithWALDisabled) {
   Destroy(options);
 }
 
+TEST_F(DBWALTest, WalSyncInterval) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumWrites = 50;
+  for (bool pipelined : {false, true}) {
+    std::unique_ptr<FaultInjectionTestEnv> fault_env(
+        new FaultInjectionTestEnv(env_));
+    Options options = CurrentOptions();
+    options.env = fault_env.get();
+    options.statistics = rocksdb::CreateDBStatistics();
+    options.enable_pipelined_write = pipelined;
+    options.wal_sync_interval_micros = 2000;
+    DestroyAndReopen(options);
+
+    // The sync writes only wait for the WAL syncer, which syncs the WAL for
+    // many of them at once
+    std::vector<port::Thread> threads;
+    for (int t = 0; t < kNumThreads; t++) {
+      threads.emplace_back([&, t]() {
+        WriteOptions write_options;
+        write_options.sync = true;
+        for (int i = 0; i < kNumWrites; i++) {
+          ASSERT_OK(Put(Key(t * kNumWrites + i), "value", write_options));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    ASSERT_LT(TestGetTickerCount(options, WAL_FILE_SYNCED),
+              static_cast<uint64_t>(kNumThreads * kNumWrites));
+
+    // Simulate a crash. All the acknowledged sync writes survive it.
+    fault_env->SetFilesystemActive(false);
+    Close();
+    ASSERT_OK(fault_env->DropUnsyncedFileData());
+    fault_env->ResetState();
+    Reopen(options);
+    for (int i = 0; i < kNumThreads * kNumWrites; i++) {
+      ASSERT_EQ("value", Get(Key(i)));
+    }
+    Destroy(options);
+  }
+}
+
+TEST_F(DBWALTest, WalSyncIntervalBytes) {
+  Options options = CurrentOptions();
+  options.statistics = rocksdb::CreateDBStatistics();
+  // An interval that is never reached: only the byte threshold triggers syncs
+  options.wal_sync_interval_micros = 3600 * 1000000ull;
+  options.wal_sync_interval_bytes = 1 << 10;
+  DestroyAndReopen(options);
+
+  WriteOptions write_options;
+  write_options.sync = true;
+  ASSERT_OK(Put("small", "value"));
+  ASSERT_OK(Put("big", std::string(2 << 10, 'v'), write_options));
+  ASSERT_GE(TestGetTickerCount(options, WAL_FILE_SYNCED), 1U);
+  ASSERT_EQ("value", Get("small"));
+
+  options.wal_sync_interval_micros = 1000;
+  options.two_write_queues = true;
+  ASSERT_TRUE(TryReopen(options).IsNotSupported());
+}
+
 //
 // Test WAL recovery for the various modes available
 //
@@ -1253,6 +1318,261 @@ TEST_F(DBWALTest, WalTermTest) {
   ASSERT_EQ("bar", Get(1, "foo"));
   ASSERT_EQ("NOT_FOUND", Get(1, "foo2"));
 }
+
+TEST_F(DBWALTest, WalStripesOptions) {
+  Options options = CurrentOptions();
+  options.wal_stripes = 0;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+  options.wal_stripes = 2;
+  options.enable_pipelined_write = false;
+  ASSERT_TRUE(TryReopen(options).IsNotSupported());
+  options.enable_pipelined_write = true;
+  options.manual_wal_flush = true;
+  ASSERT_TRUE(TryReopen(options).IsNotSupported());
+  options.manual_wal_flush = false;
+  ASSERT_OK(TryReopen(options));
+}
+
+TEST_F(DBWALTest, WalStripes) {
+  Options options = CurrentOptions();
+  options.enable_pipelined_write = true;
+  options.wal_stripes = 4;
+  options.write_buffer_size = 64 << 10;
+  options.avoid_flush_during_recovery = true;
+  options.avoid_flush_during_shutdown = true;
+  DestroyAndReopen(options);
+
+  const int kNumThreads = 8;
+  const int kNumKeysPerThread = 500;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      WriteOptions wo;
+      for (int i = 0; i < kNumKeysPerThread; i++) {
+        wo.sync = (i % 10 == 0);
+        ASSERT_OK(db_->Put(wo, Key(t * kNumKeysPerThread + i),
+                           "v" + ToString(i)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const SequenceNumber last_sequence = db_->GetLatestSequenceNumber();
+
+  for (int reopen = 0; reopen < 2; reopen++) {
+    Reopen(options);
+    ASSERT_EQ(last_sequence, db_->GetLatestSequenceNumber());
+    for (int t = 0; t < kNumThreads; t++) {
+      for (int i = 0; i < kNumKeysPerThread; i++) {
+        ASSERT_EQ("v" + ToString(i), Get(Key(t * kNumKeysPerThread + i)));
+      }
+    }
+  }
+#ifndef ROCKSDB_LITE
+  VectorLogPtr log_files;
+  ASSERT_OK(dbfull()->GetSortedWalFiles(log_files));
+  ASSERT_GE(log_files.size(), 4U);
+
+  std::unique_ptr<TransactionLogIterator> iter;
+  ASSERT_TRUE(db_->GetUpdatesSince(1, &iter).IsNotSupported());
+#endif  // ROCKSDB_LITE
+}
+
+TEST_F(DBWALTest, WalStripesNeedStripedRecovery) {
+  Options options = CurrentOptions();
+  options.enable_pipelined_write = true;
+  options.wal_stripes = 3;
+  options.avoid_flush_during_recovery = true;
+  options.avoid_flush_during_shutdown = true;
+  DestroyAndReopen(options);
+
+  // Every write group appends to the next stripe, so k4 follows k1
+  ASSERT_OK(Put("k1", "v1"));
+  ASSERT_OK(Put("k2", "v2"));
+  ASSERT_OK(Put("k3", "v3"));
+  ASSERT_OK(Put("k4", "v4"));
+  Close();
+
+  options.wal_stripes = 1;
+  ASSERT_TRUE(TryReopen(options).IsCorruption());
+
+  options.wal_stripes = 3;
+  Reopen(options);
+  ASSERT_EQ(4U, db_->GetLatestSequenceNumber());
+  for (int i = 1; i <= 4; i++) {
+    ASSERT_EQ("v" + ToString(i), Get("k" + ToString(i)));
+  }
+}
+
+TEST_F(DBWALTest, WalStripesRecoverToMissingRecord) {
+  Options options = CurrentOptions();
+  options.enable_pipelined_write = true;
+  options.wal_stripes = 3;
+  options.avoid_flush_during_recovery = true;
+  options.avoid_flush_during_shutdown = true;
+  DestroyAndReopen(options);
+
+  // Every write group appends to the next stripe
+  ASSERT_OK(Put("k1", "v1"));
+  ASSERT_OK(Put("k2", "v2"));
+  ASSERT_OK(Put("k3", "v3"));
+  Close();
+
+  // Lose the record of k2
+  std::vector<std::string> files;
+  std::vector<uint64_t> log_numbers;
+  ASSERT_OK(env_->GetChildren(dbname_, &files));
+  for (auto& file : files) {
+    uint64_t number;
+    FileType type;
+    if (ParseFileName(file, &number, &type) && type == kLogFile) {
+      log_numbers.push_back(number);
+    }
+  }
+  ASSERT_EQ(3U, log_numbers.size());
+  std::sort(log_numbers.begin(), log_numbers.end());
+  {
+    unique_ptr<WritableFile> file;
+    ASSERT_OK(env_->NewWritableFile(LogFileName(dbname_, log_numbers[1]),
+                                    &file, EnvOptions()));
+    ASSERT_OK(file->Close());
+  }
+
+  options.wal_recovery_mode = WALRecoveryMode::kAbsoluteConsistency;
+  ASSERT_TRUE(TryReopen(options).IsCorruption());
+
+  options.wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
+  Reopen(options);
+  ASSERT_EQ("v1", Get("k1"));
+  ASSERT_EQ("NOT_FOUND", Get("k2"));
+  ASSERT_EQ("NOT_FOUND", Get("k3"));
+
+  // The sequence numbers of the dropped records are reused
+  ASSERT_OK(Put("k4", "v4"));
+  ASSERT_OK(Put("k5", "v5"));
+  Reopen(options);
+  ASSERT_EQ("v1", Get("k1"));
+  ASSERT_EQ("NOT_FOUND", Get("k2"));
+  ASSERT_EQ("NOT_FOUND", Get("k3"));
+  ASSERT_EQ("v4", Get("k4"));
+  ASSERT_EQ("v5", Get("k5"));
+}
+
+TEST_F(DBWALTest, WalStripesRecoverToMissingFirstRecord) {
+  Options options = CurrentOptions();
+  options.enable_pipelined_write = true;
+  options.wal_stripes = 3;
+  options.avoid_flush_during_recovery = true;
+  options.avoid_flush_during_shutdown = true;
+  DestroyAndReopen(options);
+
+  // Every write group appends to the next stripe
+  ASSERT_OK(Put("k1", "v1"));
+  ASSERT_OK(Put("k2", "v2"));
+  ASSERT_OK(Put("k3", "v3"));
+  Close();
+
+  // Lose the record of k1
+  std::vector<std::string> files;
+  std::vector<uint64_t> log_numbers;
+  ASSERT_OK(env_->GetChildren(dbname_, &files));
+  for (auto& file : files) {
+    uint64_t number;
+    FileType type;
+    if (ParseFileName(file, &number, &type) && type == kLogFile) {
+      log_numbers.push_back(number);
+    }
+  }
+  ASSERT_EQ(3U, log_numbers.size());
+  std::sort(log_numbers.begin(), log_numbers.end());
+  {
+    unique_ptr<WritableFile> file;
+    ASSERT_OK(env_->NewWritableFile(LogFileName(dbname_, log_numbers[0]),
+                                    &file, EnvOptions()));
+    ASSERT_OK(file->Close());
+  }
+
+  options.wal_recovery_mode = WALRecoveryMode::kAbsoluteConsistency;
+  ASSERT_TRUE(TryReopen(options).IsCorruption());
+
+  // Nothing follows the last sequence number of the MANIFEST
+  options.wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
+  Reopen(options);
+  ASSERT_EQ("NOT_FOUND", Get("k1"));
+  ASSERT_EQ("NOT_FOUND", Get("k2"));
+  ASSERT_EQ("NOT_FOUND", Get("k3"));
+
+  ASSERT_OK(Put("k4", "v4"));
+  Reopen(options);
+  ASSERT_EQ("NOT_FOUND", Get("k2"));
+  ASSERT_EQ("NOT_FOUND", Get("k3"));
+  ASSERT_EQ("v4", Get("k4"));
+}
+
+TEST_F(DBWALTest, WalCompression) {
+  Options options = CurrentOptions();
+  options.wal_compression = kZSTD;
+  if (!ZSTD_Streaming_Supported()) {
+    ASSERT_TRUE(TryReopen(options).IsNotSupported());
+    return;
+  }
+  options.recycle_log_file_num = 1;
+  ASSERT_TRUE(TryReopen(options).IsNotSupported());
+  options.recycle_log_file_num = 0;
+  options.wal_compression = kSnappyCompression;
+  ASSERT_TRUE(TryReopen(options).IsNotSupported());
+  options.wal_compression = kZSTD;
+  options.avoid_flush_during_recovery = true;
+  options.avoid_flush_during_shutdown = true;
+  DestroyAndReopen(options);
+
+  // Similar values compress well against the earlier records of the file,
+  // and some are big enough to be fragmented
+  const int kNumKeys = 1000;
+  auto value = [](int i) {
+    return "{\"id\": " + ToString(i) + ", \"name\": \"user" + ToString(i) +
+           "\", \"tags\": [\"a\", \"b\"], \"payload\": \"" +
+           std::string(i % 100 == 0 ? 100000 : 100, 'x') + "\"}";
+  };
+  uint64_t raw_bytes = 0;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), value(i)));
+    raw_bytes += Key(i).size() + value(i).size();
+  }
+#ifndef ROCKSDB_LITE
+  VectorLogPtr log_files;
+  ASSERT_OK(dbfull()->GetSortedWalFiles(log_files));
+  uint64_t log_bytes = 0;
+  for (auto& log_file : log_files) {
+    log_bytes += log_file->SizeFileBytes();
+  }
+  ASSERT_LT(log_bytes, raw_bytes / 4);
+
+  // Compressed files are also read by transaction log iterators
+  std::unique_ptr<TransactionLogIterator> iter;
+  ASSERT_OK(db_->GetUpdatesSince(1, &iter));
+  int num_batches = 0;
+  for (; iter->Valid(); iter->Next()) {
+    ASSERT_EQ(static_cast<SequenceNumber>(num_batches + 1),
+              iter->GetBatch().sequence);
+    num_batches++;
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(kNumKeys, num_batches);
+  iter.reset();
+#endif  // ROCKSDB_LITE
+
+  // Recover from the compressed WAL, also after switching back to
+  // uncompressed WAL files
+  for (auto compression : {kZSTD, kNoCompression}) {
+    options.wal_compression = compression;
+    Reopen(options);
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ(value(i), Get(Key(i)));
+    }
+  }
+}
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
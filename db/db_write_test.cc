@@ -126,6 +126,168 @@ TEST_P(DBWriteTest, IOErrorOnWALWritePropagateToWriteThreadFollower) {
   Close();
 }
 
+TEST_P(DBWriteTest, AdaptiveWriteGroupSize) {
+  constexpr int kNumFollowers = 4;
+  for (bool adaptive : {false, true}) {
+    Options options = GetOptions();
+    options.statistics = rocksdb::CreateDBStatistics();
+    options.max_write_batch_group_size_bytes = 64 << 10;
+    options.adaptive_write_batch_group_size = adaptive;
+    Reopen(options);
+
+    // A small sync write leads a group, which the bigger writes queued
+    // behind it only fit into if its size is adapted to the sync.
+    std::atomic<bool> leader_waiting{false};
+    std::atomic<int> ready_count{0};
+    SyncPoint::GetInstance()->SetCallBack(
+        "WriteThread::JoinBatchGroup:Wait", [&](void* arg) {
+          auto* w = reinterpret_cast<WriteThread::Writer*>(arg);
+          if (w->state == WriteThread::STATE_GROUP_LEADER &&
+              !leader_waiting.load()) {
+            leader_waiting = true;
+            while (ready_count.load() < kNumFollowers) {
+              // busy waiting
+            }
+          } else {
+            ready_count++;
+          }
+        });
+    SyncPoint::GetInstance()->EnableProcessing();
+
+    WriteOptions write_options;
+    write_options.sync = true;
+    std::vector<port::Thread> threads;
+    threads.emplace_back([&]() {
+      ASSERT_OK(dbfull()->Put(write_options, "leader", std::string(1000, 'l')));
+    });
+    while (!leader_waiting.load()) {
+      std::this_thread::yield();
+    }
+    for (int i = 0; i < kNumFollowers; i++) {
+      threads.emplace_back([&, i]() {
+        ASSERT_OK(dbfull()->Put(write_options, "follower" + ToString(i),
+                                std::string(4000, 'f')));
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    SyncPoint::GetInstance()->DisableProcessing();
+    SyncPoint::GetInstance()->ClearAllCallBacks();
+
+    HistogramData group_size;
+    options.statistics->histogramData(DB_WRITE_GROUP_SIZE, &group_size);
+    if (adaptive) {
+      ASSERT_EQ(kNumFollowers + 1, group_size.max);
+    } else {
+      ASSERT_LT(group_size.max, kNumFollowers + 1);
+    }
+    for (int i = 0; i < kNumFollowers; i++) {
+      ASSERT_EQ(std::string(4000, 'f'), Get("follower" + ToString(i)));
+    }
+    Close();
+  }
+}
+
+TEST_P(DBWriteTest, WriteAsync) {
+  constexpr int kNumWrites = 200;
+  for (int async_write_threads : {0, 4}) {
+    Options options = GetOptions();
+    options.async_write_threads = async_write_threads;
+    Reopen(options);
+
+    std::vector<WriteBatch> batches(kNumWrites);
+    std::atomic<int> num_done{0};
+    for (int i = 0; i < kNumWrites; i++) {
+      ASSERT_OK(batches[i].Put(Key(i), ToString(async_write_threads)));
+      WriteOptions write_options;
+      write_options.sync = i % 10 == 0;
+      ASSERT_OK(dbfull()->WriteAsync(write_options, &batches[i],
+                                     [&](const Status& s) {
+                                       ASSERT_OK(s);
+                                       num_done++;
+                                     }));
+    }
+    // An invalid write is reported through the callback
+    WriteBatch invalid_batch;
+    ASSERT_OK(invalid_batch.Put("invalid", "value"));
+    WriteOptions invalid_options;
+    invalid_options.sync = true;
+    invalid_options.disableWAL = true;
+    std::atomic<bool> invalid_done{false};
+    ASSERT_OK(dbfull()->WriteAsync(invalid_options, &invalid_batch,
+                                   [&](const Status& s) {
+                                     ASSERT_TRUE(s.IsInvalidArgument());
+                                     invalid_done = true;
+                                   }));
+    while (num_done.load() < kNumWrites || !invalid_done.load()) {
+      std::this_thread::yield();
+    }
+    for (int i = 0; i < kNumWrites; i++) {
+      ASSERT_EQ(ToString(async_write_threads), Get(Key(i)));
+    }
+    ASSERT_EQ("NOT_FOUND", Get("invalid"));
+  }
+}
+
+TEST_P(DBWriteTest, WriteAsyncCompletesOnClose) {
+  constexpr int kNumWrites = 100;
+  Options options = GetOptions();
+  options.async_write_threads = 2;
+  Reopen(options);
+
+  std::vector<WriteBatch> batches(kNumWrites);
+  std::atomic<int> num_done{0};
+  for (int i = 0; i < kNumWrites; i++) {
+    ASSERT_OK(batches[i].Put(Key(i), "value"));
+    ASSERT_OK(dbfull()->WriteAsync(WriteOptions(), &batches[i],
+                                   [&](const Status& s) {
+                                     ASSERT_OK(s);
+                                     num_done++;
+                                   }));
+  }
+  Close();
+  ASSERT_EQ(kNumWrites, num_done.load());
+
+  Reopen(options);
+  for (int i = 0; i < kNumWrites; i++) {
+    ASSERT_EQ("value", Get(Key(i)));
+  }
+}
+
+TEST_P(DBWriteTest, PutUnowned) {
+  Options options = GetOptions();
+  Reopen(options);
+  Random rnd(301);
+  // Large values span several blocks of the WAL
+  std::vector<std::string> values;
+  for (int i = 0; i < 10; i++) {
+    values.push_back(RandomString(&rnd, 10000 * (i + 1)));
+  }
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t]() {
+      WriteBatch batch;
+      for (int i = t; i < 10; i += 4) {
+        ASSERT_OK(batch.PutUnowned(Key(i), values[i]));
+        ASSERT_OK(batch.Put(Key(i + 10), ToString(i)));
+      }
+      ASSERT_OK(dbfull()->Write(WriteOptions(), &batch));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int reopen = 0; reopen < 2; reopen++) {
+    for (int i = 0; i < 10; i++) {
+      ASSERT_EQ(values[i], Get(Key(i)));
+      ASSERT_EQ(ToString(i), Get(Key(i + 10)));
+    }
+    // Recovered from the WAL
+    Reopen(options);
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(DBWriteTestInstance, DBWriteTest,
                         testing::Values(DBTestBase::kDefault,
                                         DBTestBase::kConcurrentWALWrites,
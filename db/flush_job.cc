@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <vector>
 
+#include "db/blob_file_builder.h"
 #include "db/builder.h"
 #include "db/db_iter.h"
 #include "db/dbformat.h"
@@ -305,6 +306,14 @@ Status FlushJob::WriteLevel0Table() {
       uint64_t oldest_key_time =
           mems_.front()->ApproximateOldestKeyTime();
 
+      std::unique_ptr<BlobFileBuilder> blob_file_builder;
+      if (cfd_->ioptions()->enable_blob_files) {
+        blob_file_builder.reset(new BlobFileBuilder(
+            versions_, db_options_.env, env_options_, *cfd_->ioptions(),
+            cfd_->GetID(), cfd_->blob_source(), 0 /* gc_cutoff_file_number */,
+            Env::IO_HIGH, write_hint));
+      }
+
       s = BuildTable(
           dbname_, db_options_.env, *cfd_->ioptions(), mutable_cf_options_,
           env_options_, cfd_->table_cache(), iter.get(),
@@ -316,7 +325,7 @@ Status FlushJob::WriteLevel0Table() {
           mutable_cf_options_.paranoid_file_checks, cfd_->internal_stats(),
           TableFileCreationReason::kFlush, event_logger_, job_context_->job_id,
           Env::IO_HIGH, &table_properties_, 0 /* level */, current_time,
-          oldest_key_time, write_hint);
+          oldest_key_time, write_hint, blob_file_builder.get());
       LogFlush(db_options_.info_log);
     }
     ROCKS_LOG_INFO(db_options_.info_log,
@@ -347,7 +356,7 @@ Status FlushJob::WriteLevel0Table() {
     edit_->AddFile(0 /* level */, meta_.fd.GetNumber(), meta_.fd.GetPathId(),
                    meta_.fd.GetFileSize(), meta_.smallest, meta_.largest,
                    meta_.smallest_seqno, meta_.largest_seqno,
-                   meta_.marked_for_compaction);
+                   meta_.marked_for_compaction, meta_.blob_file_numbers);
   }
 
   // Note that here we treat flush as level 0 compaction in internal stats
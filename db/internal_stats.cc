@@ -244,6 +244,8 @@ static const std::string num_running_flushes = "num-running-flushes";
 static const std::string actual_delayed_write_rate =
     "actual-delayed-write-rate";
 static const std::string is_write_stopped = "is-write-stopped";
+static const std::string cf_write_stall_reason = "cf-write-stall-reason";
+static const std::string cf_delayed_write_rate = "cf-delayed-write-rate";
 static const std::string estimate_oldest_key_time = "estimate-oldest-key-time";
 
 const std::string DB::Properties::kNumFilesAtLevelPrefix =
@@ -318,6 +320,10 @@ const std::string DB::Properties::kActualDelayedWriteRate =
     rocksdb_prefix + actual_delayed_write_rate;
 const std::string DB::Properties::kIsWriteStopped =
     rocksdb_prefix + is_write_stopped;
+const std::string DB::Properties::kCFWriteStallReason =
+    rocksdb_prefix + cf_write_stall_reason;
+const std::string DB::Properties::kCFDelayedWriteRate =
+    rocksdb_prefix + cf_delayed_write_rate;
 const std::string DB::Properties::kEstimateOldestKeyTime =
     rocksdb_prefix + estimate_oldest_key_time;
 
@@ -350,6 +356,8 @@ const std::unordered_map<std::string, DBPropertyInfo>
         {DB::Properties::kAggregatedTablePropertiesAtLevel,
          {false, &InternalStats::HandleAggregatedTablePropertiesAtLevel,
           nullptr, nullptr}},
+        {DB::Properties::kCFWriteStallReason,
+         {false, &InternalStats::HandleCFWriteStallReason, nullptr, nullptr}},
         {DB::Properties::kNumImmutableMemTable,
          {false, nullptr, &InternalStats::HandleNumImmutableMemTable, nullptr}},
         {DB::Properties::kNumImmutableMemTableFlushed,
@@ -418,6 +426,8 @@ const std::unordered_map<std::string, DBPropertyInfo>
           nullptr}},
         {DB::Properties::kIsWriteStopped,
          {false, nullptr, &InternalStats::HandleIsWriteStopped, nullptr}},
+        {DB::Properties::kCFDelayedWriteRate,
+         {false, nullptr, &InternalStats::HandleCFDelayedWriteRate, nullptr}},
         {DB::Properties::kEstimateOldestKeyTime,
          {false, nullptr, &InternalStats::HandleEstimateOldestKeyTime,
           nullptr}},
@@ -582,6 +592,12 @@ bool InternalStats::HandleAggregatedTablePropertiesAtLevel(std::string* value,
   return true;
 }
 
+bool InternalStats::HandleCFWriteStallReason(std::string* value,
+                                             Slice /*suffix*/) {
+  *value = cfd_->GetWriteStallReason();
+  return true;
+}
+
 bool InternalStats::HandleNumImmutableMemTable(uint64_t* value, DBImpl* db,
                                                Version* version) {
   *value = cfd_->imm()->NumNotFlushed();
@@ -783,6 +799,20 @@ bool InternalStats::HandleIsWriteStopped(uint64_t* value, DBImpl* db,
   return true;
 }
 
+bool InternalStats::HandleCFDelayedWriteRate(uint64_t* value, DBImpl* db,
+                                             Version* version) {
+  const WriteController& wc = db->write_controller();
+  if (db->immutable_db_options().per_column_family_write_stall) {
+    *value = wc.delayed_write_rate(cfd_->GetID());
+  } else if (cfd_->write_stall_condition() == WriteStallCondition::kDelayed) {
+    // The writes to the column family are delayed with all the others
+    *value = wc.delayed_write_rate();
+  } else {
+    *value = 0;
+  }
+  return true;
+}
+
 bool InternalStats::HandleEstimateOldestKeyTime(uint64_t* value, DBImpl* /*db*/,
                                                 Version* /*version*/) {
   // TODO(yiwu): The property is currently available for fifo compaction
@@ -112,6 +112,10 @@ struct JobContext {
   // a list of sst files that we need to delete
   std::vector<FileMetaData*> sst_delete_files;
 
+  // the numbers of the blob files referenced by live sst files, which cannot
+  // be deleted. May contain duplicates.
+  std::vector<uint64_t> blob_live;
+
   // a list of log files that we need to delete
   std::vector<uint64_t> log_delete_files;
 
@@ -12,6 +12,7 @@
 #include <stdio.h>
 #include "rocksdb/env.h"
 #include "util/coding.h"
+#include "util/compression.h"
 #include "util/crc32c.h"
 #include "util/file_reader_writer.h"
 
@@ -105,7 +106,12 @@ bool Reader::ReadRecord(Slice* record, std::string* scratch,
         }
         prospective_record_offset = physical_record_offset;
         scratch->clear();
+        in_fragmented_record = false;
         *record = fragment;
+        if (uncompress_ != nullptr && !UncompressRecord(record)) {
+          ReportCorruption(fragment.size(), "could not uncompress record");
+          break;
+        }
         last_record_offset_ = prospective_record_offset;
         return true;
 
@@ -141,11 +147,31 @@ bool Reader::ReadRecord(Slice* record, std::string* scratch,
         } else {
           scratch->append(fragment.data(), fragment.size());
           *record = Slice(*scratch);
+          if (uncompress_ != nullptr && !UncompressRecord(record)) {
+            ReportCorruption(scratch->size(), "could not uncompress record");
+            in_fragmented_record = false;
+            scratch->clear();
+            break;
+          }
           last_record_offset_ = prospective_record_offset;
           return true;
         }
         break;
 
+      case kSetCompressionType:
+        if (in_fragmented_record || uncompress_ != nullptr) {
+          ReportCorruption(fragment.size(),
+                           "unexpected compression type record");
+        } else if (fragment.size() != 1 ||
+                   static_cast<CompressionType>(fragment[0]) != kZSTD ||
+                   !ZSTD_Streaming_Supported()) {
+          // The records after it can't be read
+          ReportCorruption(fragment.size(), "unsupported compression type");
+        } else {
+          uncompress_.reset(new ZSTDStreamingUncompress());
+        }
+        break;
+
       case kBadHeader:
         if (wal_recovery_mode == WALRecoveryMode::kAbsoluteConsistency) {
           // in clean shutdown we don't expect any error in the log files
@@ -226,6 +252,15 @@ bool Reader::ReadRecord(Slice* record, std::string* scratch,
   return false;
 }
 
+bool Reader::UncompressRecord(Slice* record) {
+  uncompressed_record_.clear();
+  if (!uncompress_->Uncompress(*record, &uncompressed_record_)) {
+    return false;
+  }
+  *record = Slice(uncompressed_record_);
+  return true;
+}
+
 uint64_t Reader::LastRecordOffset() {
   return last_record_offset_;
 }
@@ -20,6 +20,7 @@ namespace rocksdb {
 
 class SequentialFileReader;
 class Logger;
+class ZSTDStreamingUncompress;
 using std::unique_ptr;
 
 namespace log {
@@ -52,7 +53,8 @@ class Reader {
   // If "checksum" is true, verify checksums if available.
   //
   // The Reader will start reading at the first record located at physical
-  // position >= initial_offset within the file.
+  // position >= initial_offset within the file. The records of compressed
+  // files can only be read from the start of the file.
   Reader(std::shared_ptr<Logger> info_log,
 	 unique_ptr<SequentialFileReader>&& file,
          Reporter* reporter, bool checksum, uint64_t initial_offset,
@@ -116,6 +118,10 @@ class Reader {
   // Whether this is a recycled log file
   bool recycled_;
 
+  // Set up by the kSetCompressionType record of a compressed file
+  std::unique_ptr<ZSTDStreamingUncompress> uncompress_;
+  std::string uncompressed_record_;
+
   // Extend record types with the following special values
   enum {
     kEof = kMaxRecordType + 1,
@@ -146,6 +152,10 @@ class Reader {
   // Read some more
   bool ReadMore(size_t* drop_size, int *error);
 
+  // Replaces *record by its uncompressed contents. Returns false if the
+  // record could not be uncompressed.
+  bool UncompressRecord(Slice* record);
+
   // Reports dropped bytes to the reporter.
   // buffer_ must be updated to remove the dropped bytes prior to invocation.
   void ReportCorruption(size_t bytes, const char* reason);
@@ -11,6 +11,7 @@
 #include "db/log_writer.h"
 #include "rocksdb/env.h"
 #include "util/coding.h"
+#include "util/compression.h"
 #include "util/crc32c.h"
 #include "util/file_reader_writer.h"
 #include "util/random.h"
@@ -180,6 +181,8 @@ class LogTest : public ::testing::TestWithParam<int> {
     writer_.AddRecord(Slice(msg));
   }
 
+  void Write(const SliceParts& msg) { writer_.AddRecord(msg); }
+
   size_t WrittenBytes() const {
     return dest_contents().size();
   }
@@ -339,6 +342,21 @@ TEST_P(LogTest, Fragmentation) {
   ASSERT_EQ("EOF", Read());
 }
 
+TEST_P(LogTest, GatheredFragmentation) {
+  // Records whose parts are split across fragments, and empty parts
+  std::string small = "small";
+  std::string medium = BigString("medium", 50000);
+  std::string large = BigString("large", 100000);
+  Slice parts[] = {small, Slice(), medium, large, Slice()};
+  Write(SliceParts(parts, 5));
+  Write(SliceParts(parts + 4, 1));
+  Write(SliceParts(parts + 3, 2));
+  ASSERT_EQ(small + medium + large, Read());
+  ASSERT_EQ("", Read());
+  ASSERT_EQ(large, Read());
+  ASSERT_EQ("EOF", Read());
+}
+
 TEST_P(LogTest, MarginalTrailer) {
   // Make a trailer that is exactly the same length as an empty record.
   int header_size = GetParam() ? kRecyclableHeaderSize : kHeaderSize;
@@ -728,6 +746,37 @@ TEST_P(LogTest, Recycle) {
   ASSERT_EQ("EOF", Read());
 }
 
+TEST_P(LogTest, CompressedRecords) {
+  if (GetParam() || !ZSTD_Streaming_Supported()) {
+    return;  // test is only valid for compressed, non-recycled logs
+  }
+  unique_ptr<WritableFileWriter> dest_holder(test::GetWritableFileWriter(
+      new test::StringSink(get_reader_contents())));
+  Writer compressed_writer(std::move(dest_holder), 123, false,
+                           false /* manual_flush */, kZSTD);
+  std::vector<std::string> records;
+  size_t raw_bytes = 0;
+  for (int i = 0; i < 1000; i++) {
+    records.push_back(BigString(NumberString(i % 10), 100 + i % 50));
+    raw_bytes += records.back().size();
+  }
+  // Fragmented in the file
+  Random rnd(301);
+  records.push_back(test::RandomHumanReadableString(&rnd, 3 * kBlockSize));
+  records.push_back("");
+  records.push_back(BigString("foo", 10000));
+  for (auto& record : records) {
+    ASSERT_OK(compressed_writer.AddRecord(Slice(record)));
+  }
+  ASSERT_LT(get_reader_contents()->size(), raw_bytes / 4 + 3 * kBlockSize);
+
+  for (auto& record : records) {
+    ASSERT_EQ(record, Read());
+  }
+  ASSERT_EQ("EOF", Read());
+  ASSERT_EQ(0U, DroppedBytes());
+}
+
 INSTANTIATE_TEST_CASE_P(bool, LogTest, ::testing::Values(0, 2));
 
 }  // namespace log
@@ -10,8 +10,10 @@
 #include "db/log_writer.h"
 
 #include <stdint.h>
+#include <algorithm>
 #include "rocksdb/env.h"
 #include "util/coding.h"
+#include "util/compression.h"
 #include "util/crc32c.h"
 #include "util/file_reader_writer.h"
 
@@ -19,12 +21,16 @@ namespace rocksdb {
 namespace log {
 
 Writer::Writer(unique_ptr<WritableFileWriter>&& dest, uint64_t log_number,
-               bool recycle_log_files, bool manual_flush)
+               bool recycle_log_files, bool manual_flush,
+               CompressionType compression_type)
     : dest_(std::move(dest)),
       block_offset_(0),
       log_number_(log_number),
       recycle_log_files_(recycle_log_files),
-      manual_flush_(manual_flush) {
+      manual_flush_(manual_flush),
+      compression_type_(compression_type) {
+  assert(compression_type_ == kNoCompression || compression_type_ == kZSTD);
+  assert(compression_type_ == kNoCompression || !recycle_log_files_);
   for (int i = 0; i <= kMaxRecordType; i++) {
     char t = static_cast<char>(i);
     type_crc_[i] = crc32c::Value(&t, 1);
@@ -36,8 +42,52 @@ Writer::~Writer() { WriteBuffer(); }
 Status Writer::WriteBuffer() { return dest_->Flush(); }
 
 Status Writer::AddRecord(const Slice& slice) {
-  const char* ptr = slice.data();
-  size_t left = slice.size();
+  return AddRecord(SliceParts(&slice, 1));
+}
+
+Status Writer::AddRecord(const SliceParts& record) {
+  if (compression_type_ == kNoCompression) {
+    return EmitRecord(record);
+  }
+  if (!compress_) {
+    // The file starts with the compression type of the records, so that
+    // readers know how to uncompress them
+    assert(block_offset_ == 0);
+    const char type = static_cast<char>(compression_type_);
+    const Slice payload(&type, 1);
+    Status s = EmitPhysicalRecord(kSetCompressionType, SliceParts(&payload, 1),
+                                  payload.size());
+    if (!s.ok()) {
+      return s;
+    }
+    // WAL writes are latency sensitive, so use the fastest level
+    compress_.reset(new ZSTDStreamingCompress(1 /* level */));
+  }
+  Slice input = record.parts[0];
+  if (record.num_parts > 1) {
+    uncompressed_record_.clear();
+    for (int i = 0; i < record.num_parts; i++) {
+      uncompressed_record_.append(record.parts[i].data(),
+                                  record.parts[i].size());
+    }
+    input = uncompressed_record_;
+  }
+  compressed_record_.clear();
+  if (!compress_->Compress(input, &compressed_record_)) {
+    return Status::IOError("Could not compress log record");
+  }
+  const Slice compressed(compressed_record_);
+  return EmitRecord(SliceParts(&compressed, 1));
+}
+
+Status Writer::EmitRecord(const SliceParts& record) {
+  size_t left = 0;
+  for (int i = 0; i < record.num_parts; i++) {
+    left += record.parts[i].size();
+  }
+  // Position in record of the next fragment
+  int part = 0;
+  size_t part_offset = 0;
 
   // Header size varies depending on whether we are recycling or not.
   const int header_size =
@@ -81,15 +131,29 @@ Status Writer::AddRecord(const Slice& slice) {
       type = recycle_log_files_ ? kRecyclableMiddleType : kMiddleType;
     }
 
-    s = EmitPhysicalRecord(type, ptr, fragment_length);
-    ptr += fragment_length;
+    fragment_.clear();
+    for (size_t n = fragment_length; n > 0;) {
+      if (part_offset == record.parts[part].size()) {
+        part++;
+        part_offset = 0;
+        continue;
+      }
+      const size_t len = std::min(n, record.parts[part].size() - part_offset);
+      fragment_.push_back(Slice(record.parts[part].data() + part_offset, len));
+      part_offset += len;
+      n -= len;
+    }
+    s = EmitPhysicalRecord(
+        type, SliceParts(fragment_.data(), static_cast<int>(fragment_.size())),
+        fragment_length);
     left -= fragment_length;
     begin = false;
   } while (s.ok() && left > 0);
   return s;
 }
 
-Status Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n) {
+Status Writer::EmitPhysicalRecord(RecordType t, const SliceParts& payload,
+                                  size_t n) {
   assert(n <= 0xffff);  // Must fit in two bytes
 
   size_t header_size;
@@ -101,7 +165,7 @@ Status Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n) {
   buf[6] = static_cast<char>(t);
 
   uint32_t crc = type_crc_[t];
-  if (t < kRecyclableFullType) {
+  if (t < kRecyclableFullType || t == kSetCompressionType) {
     // Legacy record format
     assert(block_offset_ + kHeaderSize + n <= kBlockSize);
     header_size = kHeaderSize;
@@ -120,18 +184,20 @@ Status Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n) {
   }
 
   // Compute the crc of the record type and the payload.
-  crc = crc32c::Extend(crc, ptr, n);
+  for (int i = 0; i < payload.num_parts; i++) {
+    crc = crc32c::Extend(crc, payload.parts[i].data(), payload.parts[i].size());
+  }
   crc = crc32c::Mask(crc);  // Adjust for storage
   EncodeFixed32(buf, crc);
 
   // Write the header and the payload
   Status s = dest_->Append(Slice(buf, header_size));
+  for (int i = 0; s.ok() && i < payload.num_parts; i++) {
+    s = dest_->Append(payload.parts[i]);
+  }
   if (s.ok()) {
-    s = dest_->Append(Slice(ptr, n));
-    if (s.ok()) {
-      if (!manual_flush_) {
-        s = dest_->Flush();
-      }
+    if (!manual_flush_) {
+      s = dest_->Flush();
     }
   }
   block_offset_ += header_size + n;
@@ -11,14 +11,18 @@
 #include <stdint.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "db/log_format.h"
+#include "rocksdb/options.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/status.h"
 
 namespace rocksdb {
 
 class WritableFileWriter;
+class ZSTDStreamingCompress;
 
 using std::unique_ptr;
 
@@ -66,17 +70,28 @@ namespace log {
  * Same as above, with the addition of
  * Log number = 32bit log file number, so that we can distinguish between
  * records written by the most recent log writer vs a previous one.
+ *
+ * Compressed log files start with a kSetCompressionType record in the legacy
+ * format, whose payload is the CompressionType (1B) of all records after it.
+ * These are then compressed, as one stream per file, before they are
+ * fragmented.
  */
 class Writer {
  public:
   // Create a writer that will append data to "*dest".
   // "*dest" must be initially empty.
   // "*dest" must remain live while this Writer is in use.
+  // If compression_type is not kNoCompression (only kZSTD is supported),
+  // the records are compressed and recycle_log_files must be false.
   explicit Writer(unique_ptr<WritableFileWriter>&& dest, uint64_t log_number,
-                  bool recycle_log_files, bool manual_flush = false);
+                  bool recycle_log_files, bool manual_flush = false,
+                  CompressionType compression_type = kNoCompression);
   ~Writer();
 
   Status AddRecord(const Slice& slice);
+  // Add a record made of the concatenation of the parts, which are written
+  // to the file without being copied together first.
+  Status AddRecord(const SliceParts& record);
 
   WritableFileWriter* file() { return dest_.get(); }
   const WritableFileWriter* file() const { return dest_.get(); }
@@ -96,12 +111,25 @@ class Writer {
   // record type stored in the header.
   uint32_t type_crc_[kMaxRecordType + 1];
 
-  Status EmitPhysicalRecord(RecordType type, const char* ptr, size_t length);
+  // The payload parts add up to length bytes
+  Status EmitPhysicalRecord(RecordType type, const SliceParts& payload,
+                            size_t length);
 
   // If true, it does not flush after each write. Instead it relies on the upper
   // layer to manually does the flush by calling ::WriteBuffer()
   bool manual_flush_;
 
+  // Compression of the records, which is set up with the first one
+  CompressionType compression_type_;
+  std::unique_ptr<ZSTDStreamingCompress> compress_;
+  std::string compressed_record_;
+  std::string uncompressed_record_;
+
+  // Parts of the record in the fragment being emitted
+  std::vector<Slice> fragment_;
+
+  Status EmitRecord(const SliceParts& record);
+
   // No copying allowed
   Writer(const Writer&);
   void operator=(const Writer&);
@@ -10,6 +10,7 @@
 #include "db/memtable.h"
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
 #include <memory>
 
@@ -39,6 +40,61 @@
 
 namespace rocksdb {
 
+namespace {
+
+// The size of the values that inplace_update_atomic updates in place
+const uint32_t kAtomicValueSize = sizeof(uint64_t);
+static_assert(sizeof(std::atomic<uint64_t>) == kAtomicValueSize,
+              "std::atomic<uint64_t> must have the layout of uint64_t");
+
+// Encodes v as a varint32 of exactly len bytes, which must be at least
+// VarintLength(v). Longer varints carry leading continuation bytes, which
+// decode like the shortest encoding.
+char* EncodeVarint32Padded(char* dst, uint32_t v, uint32_t len) {
+  assert(len >= static_cast<uint32_t>(VarintLength(v)) && len <= 5);
+  for (uint32_t i = 1; i < len; i++) {
+    *(dst++) = static_cast<char>((v & 127) | 128);
+    v >>= 7;
+  }
+  *(dst++) = static_cast<char>(v);
+  return dst;
+}
+
+// Pads the key and value size varints of an entry at buf, so that its
+// kAtomicValueSize bytes value is aligned for atomic access. Returns false
+// if no padding aligns it, and then leaves the varint lengths unchanged.
+bool AlignAtomicValue(const char* buf, uint32_t internal_key_size,
+                      uint32_t* key_varint_len, uint32_t* val_varint_len) {
+  for (uint32_t padding = 0; padding < kAtomicValueSize; padding++) {
+    uint32_t key_len = std::min(*key_varint_len + padding, 5u);
+    uint32_t val_len = *val_varint_len + padding - (key_len - *key_varint_len);
+    if (val_len > 5) {
+      break;
+    }
+    uintptr_t value_addr = reinterpret_cast<uintptr_t>(buf) + key_len +
+                           internal_key_size + val_len;
+    if (value_addr % kAtomicValueSize == 0) {
+      *key_varint_len = key_len;
+      *val_varint_len = val_len;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the value as an atomic word if it can be updated in place by
+// inplace_update_atomic, otherwise nullptr.
+std::atomic<uint64_t>* GetAtomicValue(const Slice& value) {
+  if (value.size() != kAtomicValueSize ||
+      reinterpret_cast<uintptr_t>(value.data()) % kAtomicValueSize != 0) {
+    return nullptr;
+  }
+  return reinterpret_cast<std::atomic<uint64_t>*>(
+      const_cast<char*>(value.data()));
+}
+
+}  // namespace
+
 ImmutableMemTableOptions::ImmutableMemTableOptions(
     const ImmutableCFOptions& ioptions,
     const MutableCFOptions& mutable_cf_options)
@@ -52,7 +108,10 @@ ImmutableMemTableOptions::ImmutableMemTableOptions(
       inplace_update_support(ioptions.inplace_update_support),
       inplace_update_num_locks(mutable_cf_options.inplace_update_num_locks),
       inplace_callback(ioptions.inplace_callback),
+      inplace_update_atomic(ioptions.inplace_update_atomic &&
+                            !ioptions.inplace_update_support),
       max_successive_merges(mutable_cf_options.max_successive_merges),
+      sorted_batch_insert(ioptions.memtable_sorted_batch_insert),
       statistics(ioptions.statistics),
       merge_operator(ioptions.merge_operator),
       info_log(ioptions.info_log) {}
@@ -80,6 +139,7 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
           comparator_, &arena_, nullptr /* transform */, ioptions.info_log,
           column_family_id)),
       is_range_del_table_empty_(true),
+      immutable_(false),
       data_size_(0),
       num_entries_(0),
       num_deletes_(0),
@@ -266,7 +326,8 @@ class MemTableIterator : public InternalIterator {
         valid_(false),
         arena_mode_(arena != nullptr),
         value_pinned_(
-            !mem.GetImmutableMemTableOptions()->inplace_update_support) {
+            !mem.GetImmutableMemTableOptions()->inplace_update_support &&
+            !mem.GetImmutableMemTableOptions()->inplace_update_atomic) {
     if (use_range_del_table) {
       iter_ = mem.range_del_table_->GetIterator(arena);
     } else if (prefix_extractor_ != nullptr && !read_options.total_order_seek) {
@@ -410,6 +471,27 @@ InternalIterator* MemTable::NewRangeTombstoneIterator(
                               true /* use_range_del_table */);
 }
 
+Status MemTable::AddRangeTombstones(const ReadOptions& read_options,
+                                    RangeDelAggregator* range_del_agg) {
+  if (read_options.ignore_range_deletions || is_range_del_table_empty_) {
+    return Status::OK();
+  }
+  if (immutable_.load(std::memory_order_acquire) &&
+      range_del_agg->SupportsFragmentedTombstones()) {
+    std::call_once(fragmented_range_tombstones_once_, [this]() {
+      std::unique_ptr<InternalIterator> range_del_iter(
+          NewRangeTombstoneIterator(ReadOptions()));
+      fragmented_range_tombstones_.reset(new FragmentedRangeTombstoneList(
+          std::move(range_del_iter), comparator_.comparator));
+    });
+    return range_del_agg->AddFragmentedTombstones(
+        fragmented_range_tombstones_);
+  }
+  std::unique_ptr<InternalIterator> range_del_iter(
+      NewRangeTombstoneIterator(read_options));
+  return range_del_agg->AddTombstones(std::move(range_del_iter));
+}
+
 port::RWMutex* MemTable::GetLock(const Slice& key) {
   static murmur_hash hash;
   return &locks_[hash(key) % locks_.size()];
@@ -439,37 +521,57 @@ MemTable::MemTableStats MemTable::ApproximateStats(const Slice& start_ikey,
 void MemTable::Add(SequenceNumber s, ValueType type,
                    const Slice& key, /* user key */
                    const Slice& value, bool allow_concurrent,
-                   MemTablePostProcessInfo* post_process_info) {
+                   MemTablePostProcessInfo* post_process_info,
+                   MemTableSortedBatch* sorted_batch) {
   // Format of an entry is concatenation of:
   //  key_size     : varint32 of internal_key.size()
   //  key bytes    : char[internal_key.size()]
   //  value_size   : varint32 of value.size()
   //  value bytes  : char[value.size()]
+  //
+  // With inplace_update_atomic, the size varints of an 8-byte value can be
+  // padded to align the value for atomic updates.
   uint32_t key_size = static_cast<uint32_t>(key.size());
   uint32_t val_size = static_cast<uint32_t>(value.size());
   uint32_t internal_key_size = key_size + 8;
-  const uint32_t encoded_len = VarintLength(internal_key_size) +
-                               internal_key_size + VarintLength(val_size) +
-                               val_size;
+  uint32_t key_varint_len = VarintLength(internal_key_size);
+  uint32_t val_varint_len = VarintLength(val_size);
+  const bool align_value = moptions_.inplace_update_atomic &&
+                           type == kTypeValue && val_size == kAtomicValueSize;
+  const uint32_t max_padding = align_value ? kAtomicValueSize - 1 : 0;
   char* buf = nullptr;
   std::unique_ptr<MemTableRep>& table =
       type == kTypeRangeDeletion ? range_del_table_ : table_;
-  KeyHandle handle = table->Allocate(encoded_len, &buf);
+  KeyHandle handle = table->Allocate(key_varint_len + internal_key_size +
+                                         val_varint_len + val_size +
+                                         max_padding,
+                                     &buf);
+  if (align_value) {
+    AlignAtomicValue(buf, internal_key_size, &key_varint_len,
+                     &val_varint_len);
+  }
+  const uint32_t encoded_len =
+      key_varint_len + internal_key_size + val_varint_len + val_size;
 
-  char* p = EncodeVarint32(buf, internal_key_size);
+  char* p = EncodeVarint32Padded(buf, internal_key_size, key_varint_len);
   memcpy(p, key.data(), key_size);
   Slice key_slice(p, key_size);
   p += key_size;
   uint64_t packed = PackSequenceAndType(s, type);
   EncodeFixed64(p, packed);
   p += 8;
-  p = EncodeVarint32(p, val_size);
+  p = EncodeVarint32Padded(p, val_size, val_varint_len);
   memcpy(p, value.data(), val_size);
   assert((unsigned)(p + val_size - buf) == (unsigned)encoded_len);
+  if (type == kTypeRangeDeletion) {
+    sorted_batch = nullptr;
+  }
   if (!allow_concurrent) {
-    // Extract prefix for insert with hint.
-    if (insert_with_hint_prefix_extractor_ != nullptr &&
-        insert_with_hint_prefix_extractor_->InDomain(key_slice)) {
+    if (sorted_batch != nullptr) {
+      sorted_batch->entries.emplace_back(buf, handle);
+    } else if (insert_with_hint_prefix_extractor_ != nullptr &&
+               insert_with_hint_prefix_extractor_->InDomain(key_slice)) {
+      // Extract prefix for insert with hint.
       Slice prefix = insert_with_hint_prefix_extractor_->Transform(key_slice);
       table->InsertWithHint(handle, &insert_hints_[prefix]);
     } else {
@@ -506,7 +608,11 @@ void MemTable::Add(SequenceNumber s, ValueType type,
     assert(post_process_info == nullptr);
     UpdateFlushState();
   } else {
-    table->InsertConcurrently(handle);
+    if (sorted_batch != nullptr) {
+      sorted_batch->entries.emplace_back(buf, handle);
+    } else {
+      table->InsertConcurrently(handle);
+    }
 
     assert(post_process_info != nullptr);
     post_process_info->num_entries++;
@@ -538,6 +644,26 @@ void MemTable::Add(SequenceNumber s, ValueType type,
   UpdateOldestKeyTime();
 }
 
+void MemTable::InsertSortedBatch(MemTableSortedBatch* sorted_batch,
+                                 bool allow_concurrent) {
+  auto& entries = sorted_batch->entries;
+  if (entries.empty()) {
+    return;
+  }
+  std::sort(entries.begin(), entries.end(),
+            [this](const std::pair<const char*, KeyHandle>& a,
+                   const std::pair<const char*, KeyHandle>& b) {
+              return comparator_(a.first, b.first) < 0;
+            });
+  auto& handles = sorted_batch->handles;
+  handles.clear();
+  for (auto& entry : entries) {
+    handles.push_back(entry.second);
+  }
+  table_->InsertSorted(handles.data(), handles.size(), allow_concurrent);
+  entries.clear();
+}
+
 // Callback from MemTable::Get()
 namespace {
 
@@ -556,6 +682,7 @@ struct Saver {
   Logger* logger;
   Statistics* statistics;
   bool inplace_update_support;
+  bool inplace_update_atomic;
   Env* env_;
   ReadCallback* callback_;
   bool* is_blob_index;
@@ -627,6 +754,16 @@ static bool SaveValue(void* arg, const char* entry) {
           s->mem->GetLock(s->key->user_key())->ReadLock();
         }
         Slice v = GetLengthPrefixedSlice(key_ptr + key_length);
+        uint64_t atomic_value_copy;
+        if (s->inplace_update_atomic) {
+          // Copy a value that concurrent writers may update in place
+          auto* atomic_value = GetAtomicValue(v);
+          if (atomic_value != nullptr) {
+            atomic_value_copy = atomic_value->load(std::memory_order_acquire);
+            v = Slice(reinterpret_cast<const char*>(&atomic_value_copy),
+                      sizeof(atomic_value_copy));
+          }
+        }
         *(s->status) = Status::OK();
         if (*(s->merge_in_progress)) {
           if (s->value != nullptr) {
@@ -710,9 +847,7 @@ bool MemTable::Get(const LookupKey& key, std::string* value, Status* s,
   }
   PERF_TIMER_GUARD(get_from_memtable_time);
 
-  std::unique_ptr<InternalIterator> range_del_iter(
-      NewRangeTombstoneIterator(read_opts));
-  Status status = range_del_agg->AddTombstones(std::move(range_del_iter));
+  Status status = AddRangeTombstones(read_opts, range_del_agg);
   if (!status.ok()) {
     *s = status;
     return false;
@@ -746,6 +881,7 @@ bool MemTable::Get(const LookupKey& key, std::string* value, Status* s,
     saver.merge_operator = moptions_.merge_operator;
     saver.logger = moptions_.info_log;
     saver.inplace_update_support = moptions_.inplace_update_support;
+    saver.inplace_update_atomic = moptions_.inplace_update_atomic;
     saver.statistics = moptions_.statistics;
     saver.env_ = env_;
     saver.callback_ = callback;
@@ -765,7 +901,8 @@ bool MemTable::Get(const LookupKey& key, std::string* value, Status* s,
 
 void MemTable::Update(SequenceNumber seq,
                       const Slice& key,
-                      const Slice& value) {
+                      const Slice& value, bool allow_concurrent,
+                      MemTablePostProcessInfo* post_process_info) {
   LookupKey lkey(key, seq);
   Slice mem_key = lkey.memtable_key();
 
@@ -798,8 +935,17 @@ void MemTable::Update(SequenceNumber seq,
         uint32_t prev_size = static_cast<uint32_t>(prev_value.size());
         uint32_t new_size = static_cast<uint32_t>(value.size());
 
-        // Update value, if new value size  <= previous value size
-        if (new_size <= prev_size) {
+        if (moptions_.inplace_update_atomic) {
+          auto* atomic_value = GetAtomicValue(prev_value);
+          if (atomic_value != nullptr && new_size == prev_size) {
+            uint64_t new_value;
+            memcpy(&new_value, value.data(), sizeof(new_value));
+            atomic_value->store(new_value, std::memory_order_release);
+            RecordTick(moptions_.statistics, NUMBER_KEYS_UPDATED);
+            return;
+          }
+        } else if (new_size <= prev_size) {
+          // Update value, if new value size  <= previous value size
           char* p =
               EncodeVarint32(const_cast<char*>(key_ptr) + key_length, new_size);
           WriteLock wl(GetLock(lkey.user_key()));
@@ -815,12 +961,13 @@ void MemTable::Update(SequenceNumber seq,
   }
 
   // key doesn't exist
-  Add(seq, kTypeValue, key, value);
+  Add(seq, kTypeValue, key, value, allow_concurrent, post_process_info);
 }
 
 bool MemTable::UpdateCallback(SequenceNumber seq,
                               const Slice& key,
-                              const Slice& delta) {
+                              const Slice& delta, bool allow_concurrent,
+                              MemTablePostProcessInfo* post_process_info) {
   LookupKey lkey(key, seq);
   Slice memkey = lkey.memtable_key();
 
@@ -851,6 +998,11 @@ bool MemTable::UpdateCallback(SequenceNumber seq,
       switch (type) {
         case kTypeValue: {
           Slice prev_value = GetLengthPrefixedSlice(key_ptr + key_length);
+          if (moptions_.inplace_update_atomic) {
+            UpdateCallbackAtomic(seq, key, delta, prev_value, allow_concurrent,
+                                 post_process_info);
+            return true;
+          }
           uint32_t prev_size = static_cast<uint32_t>(prev_value.size());
 
           char* prev_buffer = const_cast<char*>(prev_value.data());
@@ -896,6 +1048,55 @@ bool MemTable::UpdateCallback(SequenceNumber seq,
   return false;
 }
 
+void MemTable::UpdateCallbackAtomic(
+    SequenceNumber seq, const Slice& key, const Slice& delta,
+    const Slice& prev_value, bool allow_concurrent,
+    MemTablePostProcessInfo* post_process_info) {
+  // The callback works on a copy, as other writers may update the value at
+  // the same time. Only an 8-byte prev_value is then swapped in place.
+  auto* atomic_value = GetAtomicValue(prev_value);
+  std::string prev_copy;
+  while (true) {
+    uint64_t expected = 0;
+    if (atomic_value != nullptr) {
+      expected = atomic_value->load(std::memory_order_acquire);
+      prev_copy.assign(reinterpret_cast<const char*>(&expected),
+                       sizeof(expected));
+    } else {
+      prev_copy.assign(prev_value.data(), prev_value.size());
+    }
+    uint32_t new_prev_size = static_cast<uint32_t>(prev_copy.size());
+    std::string str_value;
+    auto status = moptions_.inplace_callback(&prev_copy[0], &new_prev_size,
+                                             delta, &str_value);
+    if (status == UpdateStatus::UPDATED_INPLACE) {
+      assert(new_prev_size <= prev_copy.size());
+      if (atomic_value != nullptr && new_prev_size == kAtomicValueSize) {
+        uint64_t desired;
+        memcpy(&desired, prev_copy.data(), sizeof(desired));
+        if (!atomic_value->compare_exchange_strong(expected, desired,
+                                                   std::memory_order_acq_rel)) {
+          // Another writer updated the value, apply the delta to its value
+          continue;
+        }
+        RecordTick(moptions_.statistics, NUMBER_KEYS_UPDATED);
+      } else {
+        Add(seq, kTypeValue, key, Slice(prev_copy.data(), new_prev_size),
+            allow_concurrent, post_process_info);
+        RecordTick(moptions_.statistics, NUMBER_KEYS_WRITTEN);
+      }
+    } else if (status == UpdateStatus::UPDATED) {
+      Add(seq, kTypeValue, key, Slice(str_value), allow_concurrent,
+          post_process_info);
+      RecordTick(moptions_.statistics, NUMBER_KEYS_WRITTEN);
+    }
+    break;
+  }
+  if (!allow_concurrent) {
+    UpdateFlushState();
+  }
+}
+
 size_t MemTable::CountSuccessiveMergeEntries(const LookupKey& key) {
   Slice memkey = key.memtable_key();
 
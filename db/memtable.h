@@ -12,11 +12,14 @@
 #include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include "db/dbformat.h"
 #include "db/range_del_aggregator.h"
+#include "db/range_tombstone_fragmenter.h"
 #include "db/read_callback.h"
 #include "db/version_edit.h"
 #include "monitoring/instrumented_mutex.h"
@@ -48,12 +51,24 @@ struct ImmutableMemTableOptions {
                                    uint32_t* existing_value_size,
                                    Slice delta_value,
                                    std::string* merged_value);
+  bool inplace_update_atomic;
   size_t max_successive_merges;
+  bool sorted_batch_insert;
   Statistics* statistics;
   MergeOperator* merge_operator;
   Logger* info_log;
 };
 
+// Entries of a write batch, or of a whole write group, that MemTable::Add()
+// has encoded in the memtable's arena but not yet inserted into the memtable
+// rep. MemTable::InsertSortedBatch() inserts them in key order.
+// Only used with memtable_sorted_batch_insert.
+struct MemTableSortedBatch {
+  // Encoded entry and its handle in the memtable rep
+  std::vector<std::pair<const char*, KeyHandle>> entries;
+  std::vector<KeyHandle> handles;
+};
+
 // Batched counters to updated when inserting keys in one write batch.
 // In post process of the write batch, these can be updated together.
 // Only used in concurrent memtable insert case.
@@ -161,15 +176,34 @@ class MemTable {
 
   InternalIterator* NewRangeTombstoneIterator(const ReadOptions& read_options);
 
+  // Adds this memtable's range tombstones to range_del_agg. Once the memtable
+  // is immutable, aggregators serving reads share a fragmented copy of the
+  // tombstones that is built on first use.
+  Status AddRangeTombstones(const ReadOptions& read_options,
+                            RangeDelAggregator* range_del_agg);
+
   // Add an entry into memtable that maps key to value at the
   // specified sequence number and with the specified type.
   // Typically value will be empty if type==kTypeDeletion.
   //
+  // If sorted_batch is not null, the entry is only inserted into the
+  // memtable rep by InsertSortedBatch(sorted_batch, ...), unless it is a range
+  // deletion. It is not visible to reads of this memtable before that.
+  //
   // REQUIRES: if allow_concurrent = false, external synchronization to prevent
   // simultaneous operations on the same MemTable.
   void Add(SequenceNumber seq, ValueType type, const Slice& key,
            const Slice& value, bool allow_concurrent = false,
-           MemTablePostProcessInfo* post_process_info = nullptr);
+           MemTablePostProcessInfo* post_process_info = nullptr,
+           MemTableSortedBatch* sorted_batch = nullptr);
+
+  // Sorts the entries of sorted_batch by key and inserts them into the
+  // memtable rep in one pass, then clears sorted_batch.
+  //
+  // REQUIRES: if allow_concurrent = false, external synchronization to prevent
+  // simultaneous operations on the same MemTable.
+  void InsertSortedBatch(MemTableSortedBatch* sorted_batch,
+                         bool allow_concurrent);
 
   // If memtable contains a value for key, store it in *value and return true.
   // If memtable contains a deletion for key, store a NotFound() error
@@ -205,12 +239,17 @@ class MemTable {
   //       update inplace
   //     else add(key, new_value)
   //   else add(key, new_value)
+  // With inplace_update_atomic, only 8-byte values are updated in place, by
+  // 8-byte values, and the update is an atomic store.
   //
   // REQUIRES: external synchronization to prevent simultaneous
-  // operations on the same MemTable.
+  // operations on the same MemTable, unless inplace_update_atomic is set
+  // and allow_concurrent is true.
   void Update(SequenceNumber seq,
               const Slice& key,
-              const Slice& value);
+              const Slice& value,
+              bool allow_concurrent = false,
+              MemTablePostProcessInfo* post_process_info = nullptr);
 
   // If prev_value for key exists, attempts to update it inplace.
   // else returns false
@@ -221,12 +260,18 @@ class MemTable {
   //       update inplace
   //     else add(key, new_value)
   //   else return false
+  // With inplace_update_atomic, the delta is applied to a copy of prev_value,
+  // and only an 8-byte new_value of an 8-byte prev_value is swapped in with
+  // a compare-and-swap, which is retried if prev_value changed meanwhile.
   //
   // REQUIRES: external synchronization to prevent simultaneous
-  // operations on the same MemTable.
+  // operations on the same MemTable, unless inplace_update_atomic is set
+  // and allow_concurrent is true.
   bool UpdateCallback(SequenceNumber seq,
                       const Slice& key,
-                      const Slice& delta);
+                      const Slice& delta,
+                      bool allow_concurrent = false,
+                      MemTablePostProcessInfo* post_process_info = nullptr);
 
   // Returns the number of successive merge entries starting from the newest
   // entry for the key up to the last non-merge entry or last entry for the
@@ -332,6 +377,7 @@ class MemTable {
   void MarkImmutable() {
     table_->MarkReadOnly();
     mem_tracker_.DoneAllocating();
+    immutable_.store(true, std::memory_order_release);
   }
 
   // return true if the current MemTableRep supports merge operator.
@@ -342,7 +388,8 @@ class MemTable {
   // return true if the current MemTableRep supports snapshots.
   // inplace update prevents snapshots,
   bool IsSnapshotSupported() const {
-    return table_->IsSnapshotSupported() && !moptions_.inplace_update_support;
+    return table_->IsSnapshotSupported() && !moptions_.inplace_update_support &&
+           !moptions_.inplace_update_atomic;
   }
 
   struct MemTableStats {
@@ -384,6 +431,11 @@ class MemTable {
   unique_ptr<MemTableRep> table_;
   unique_ptr<MemTableRep> range_del_table_;
   bool is_range_del_table_empty_;
+  std::atomic<bool> immutable_;
+  // Built from range_del_table_ by the first reader after MarkImmutable().
+  std::once_flag fragmented_range_tombstones_once_;
+  std::shared_ptr<const FragmentedRangeTombstoneList>
+      fragmented_range_tombstones_;
 
   // Total data size of all data inserted
   std::atomic<uint64_t> data_size_;
@@ -443,6 +495,12 @@ class MemTable {
   // Updates flush_state_ using ShouldFlushNow()
   void UpdateFlushState();
 
+  // UpdateCallback() of a kTypeValue entry with inplace_update_atomic
+  void UpdateCallbackAtomic(SequenceNumber seq, const Slice& key,
+                            const Slice& delta, const Slice& prev_value,
+                            bool allow_concurrent,
+                            MemTablePostProcessInfo* post_process_info);
+
   void UpdateOldestKeyTime();
 
   // No copying allowed
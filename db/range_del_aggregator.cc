@@ -15,7 +15,8 @@ RangeDelAggregator::RangeDelAggregator(
     bool collapse_deletions /* = true */)
     : upper_bound_(kMaxSequenceNumber),
       icmp_(icmp),
-      collapse_deletions_(collapse_deletions) {
+      collapse_deletions_(collapse_deletions),
+      for_reads_(false) {
   InitRep(snapshots);
 }
 
@@ -24,7 +25,8 @@ RangeDelAggregator::RangeDelAggregator(const InternalKeyComparator& icmp,
                                        bool collapse_deletions /* = false */)
     : upper_bound_(snapshot),
       icmp_(icmp),
-      collapse_deletions_(collapse_deletions) {}
+      collapse_deletions_(collapse_deletions),
+      for_reads_(true) {}
 
 void RangeDelAggregator::InitRep(const std::vector<SequenceNumber>& snapshots) {
   assert(rep_ == nullptr);
@@ -45,7 +47,6 @@ void RangeDelAggregator::InitRep(const std::vector<SequenceNumber>& snapshots) {
 
 bool RangeDelAggregator::ShouldDeleteImpl(
     const Slice& internal_key, RangeDelAggregator::RangePositioningMode mode) {
-  assert(rep_ != nullptr);
   ParsedInternalKey parsed;
   if (!ParseInternalKey(internal_key, &parsed)) {
     assert(false);
@@ -53,11 +54,31 @@ bool RangeDelAggregator::ShouldDeleteImpl(
   return ShouldDelete(parsed, mode);
 }
 
+bool RangeDelAggregator::ShouldDeleteFragmented(
+    const ParsedInternalKey& parsed) const {
+  // Keys at or below upper_bound_ may only be deleted by tombstones in the
+  // same (older) stripe, i.e., ones no newer than upper_bound_.
+  SequenceNumber max_visible_seq =
+      parsed.sequence <= upper_bound_ ? upper_bound_ : kMaxSequenceNumber;
+  for (const auto& fragmented : fragmented_tombstones_) {
+    if (fragmented->MaxCoveringTombstoneSeqnum(
+            parsed.user_key, max_visible_seq) > parsed.sequence) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool RangeDelAggregator::ShouldDeleteImpl(
     const ParsedInternalKey& parsed,
     RangeDelAggregator::RangePositioningMode mode) {
   assert(IsValueType(parsed.type));
-  assert(rep_ != nullptr);
+  if (!fragmented_tombstones_.empty() && ShouldDeleteFragmented(parsed)) {
+    return true;
+  }
+  if (rep_ == nullptr) {
+    return false;
+  }
   auto& positional_tombstone_map = GetPositionalTombstoneMap(parsed.sequence);
   const auto& tombstone_map = positional_tombstone_map.raw_map;
   if (tombstone_map.empty()) {
@@ -145,6 +166,11 @@ bool RangeDelAggregator::IsRangeOverlapped(const Slice& start,
   // so far only implemented for non-collapsed mode since file ingestion (only
   //  client) doesn't use collapsing
   assert(!collapse_deletions_);
+  for (const auto& fragmented : fragmented_tombstones_) {
+    if (fragmented->IsRangeOverlapped(start, end)) {
+      return true;
+    }
+  }
   if (rep_ == nullptr) {
     return false;
   }
@@ -217,6 +243,21 @@ Status RangeDelAggregator::AddTombstones(
   return Status::OK();
 }
 
+Status RangeDelAggregator::AddFragmentedTombstones(
+    std::shared_ptr<const FragmentedRangeTombstoneList> fragmented) {
+  assert(for_reads_);
+  if (fragmented == nullptr) {
+    return Status::OK();
+  }
+  if (!fragmented->status().ok()) {
+    return fragmented->status();
+  }
+  if (!fragmented->empty()) {
+    fragmented_tombstones_.push_back(std::move(fragmented));
+  }
+  return Status::OK();
+}
+
 void RangeDelAggregator::InvalidateTombstoneMapPositions() {
   if (rep_ == nullptr) {
     return;
@@ -524,6 +565,9 @@ void RangeDelAggregator::AddToBuilder(
 }
 
 bool RangeDelAggregator::IsEmpty() {
+  if (!fragmented_tombstones_.empty()) {
+    return false;
+  }
   if (rep_ == nullptr) {
     return true;
   }
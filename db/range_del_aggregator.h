@@ -6,18 +6,21 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "db/compaction_iteration_stats.h"
 #include "db/dbformat.h"
 #include "db/pinned_iterators_manager.h"
+#include "db/range_tombstone_fragmenter.h"
 #include "db/version_edit.h"
 #include "include/rocksdb/comparator.h"
 #include "include/rocksdb/types.h"
 #include "table/internal_iterator.h"
 #include "table/scoped_arena_iterator.h"
 #include "table/table_builder.h"
+#include "util/autovector.h"
 #include "util/kv_map.h"
 
 namespace rocksdb {
@@ -75,14 +78,14 @@ class RangeDelAggregator {
   //             value must be kFullScan indicating linear scan from beginning..
   bool ShouldDelete(const ParsedInternalKey& parsed,
                     RangePositioningMode mode = kFullScan) {
-    if (rep_ == nullptr) {
+    if (rep_ == nullptr && fragmented_tombstones_.empty()) {
       return false;
     }
     return ShouldDeleteImpl(parsed, mode);
   }
   bool ShouldDelete(const Slice& internal_key,
                     RangePositioningMode mode = kFullScan) {
-    if (rep_ == nullptr) {
+    if (rep_ == nullptr && fragmented_tombstones_.empty()) {
       return false;
     }
     return ShouldDeleteImpl(internal_key, mode);
@@ -108,6 +111,18 @@ class RangeDelAggregator {
   // @return non-OK status if any of the tombstone keys are corrupted.
   Status AddTombstones(std::unique_ptr<InternalIterator> input);
 
+  // Adds tombstones that were already fragmented, e.g., by the table reader
+  // when the file was opened. The list is shared rather than copied, so
+  // ShouldDelete() binary searches it directly. Only supported by aggregators
+  // constructed for reads, since the fragments cannot be written back to a
+  // TableBuilder.
+  // @return non-OK status if the list failed to read its tombstones.
+  Status AddFragmentedTombstones(
+      std::shared_ptr<const FragmentedRangeTombstoneList> fragmented);
+
+  // Whether AddFragmentedTombstones() may be used with this aggregator.
+  bool SupportsFragmentedTombstones() const { return for_reads_; }
+
   // Resets iterators maintained across calls to ShouldDelete(). This may be
   // called when the tombstones change, or the owner may call explicitly, e.g.,
   // if it's an iterator that just seeked to an arbitrary position. The effect
@@ -175,11 +190,19 @@ class RangeDelAggregator {
   PositionalTombstoneMap& GetPositionalTombstoneMap(SequenceNumber seq);
   Status AddTombstone(RangeTombstone tombstone);
 
+  bool ShouldDeleteFragmented(const ParsedInternalKey& parsed) const;
+
   SequenceNumber upper_bound_;
   std::unique_ptr<Rep> rep_;
+  // Tombstone lists shared with table readers and immutable memtables. These
+  // are consulted in addition to rep_ and never allocate on lookup.
+  autovector<std::shared_ptr<const FragmentedRangeTombstoneList>>
+      fragmented_tombstones_;
   const InternalKeyComparator& icmp_;
   // collapse range deletions so they're binary searchable
   const bool collapse_deletions_;
+  // true if constructed with a single upper_bound snapshot
+  const bool for_reads_;
 };
 
 }  // namespace rocksdb
@@ -46,6 +46,16 @@ void VerifyRangeDels(const std::vector<RangeTombstone>& range_dels,
         new test::VectorIterator(keys, values));
     range_del_agg.AddTombstones(std::move(range_del_iter));
 
+    // The fragmented list must give the same answers when shared with a read
+    // aggregator.
+    RangeDelAggregator fragmented_range_del_agg(icmp, kMaxSequenceNumber);
+    std::shared_ptr<const FragmentedRangeTombstoneList> fragmented(
+        new FragmentedRangeTombstoneList(
+            std::unique_ptr<InternalIterator>(
+                new test::VectorIterator(keys, values)),
+            icmp));
+    ASSERT_OK(fragmented_range_del_agg.AddFragmentedTombstones(fragmented));
+
     for (const auto expected_point : expected_points) {
       ParsedInternalKey parsed_key;
       parsed_key.user_key = expected_point.begin;
@@ -54,11 +64,16 @@ void VerifyRangeDels(const std::vector<RangeTombstone>& range_dels,
       ASSERT_FALSE(range_del_agg.ShouldDelete(
           parsed_key,
           RangeDelAggregator::RangePositioningMode::kForwardTraversal));
+      ASSERT_FALSE(fragmented_range_del_agg.ShouldDelete(parsed_key));
+      ASSERT_EQ(expected_point.seq,
+                fragmented->MaxCoveringTombstoneSeqnum(expected_point.begin,
+                                                       kMaxSequenceNumber));
       if (parsed_key.sequence > 0) {
         --parsed_key.sequence;
         ASSERT_TRUE(range_del_agg.ShouldDelete(
             parsed_key,
             RangeDelAggregator::RangePositioningMode::kForwardTraversal));
+        ASSERT_TRUE(fragmented_range_del_agg.ShouldDelete(parsed_key));
       }
     }
   }
@@ -74,6 +89,9 @@ void VerifyRangeDels(const std::vector<RangeTombstone>& range_dels,
   std::unique_ptr<test::VectorIterator> range_del_iter(
       new test::VectorIterator(keys, values));
   range_del_agg.AddTombstones(std::move(range_del_iter));
+  FragmentedRangeTombstoneList fragmented(
+      std::unique_ptr<InternalIterator>(new test::VectorIterator(keys, values)),
+      icmp);
   for (size_t i = 1; i < expected_points.size(); ++i) {
     bool overlapped = range_del_agg.IsRangeOverlapped(
         expected_points[i - 1].begin, expected_points[i].begin);
@@ -82,6 +100,9 @@ void VerifyRangeDels(const std::vector<RangeTombstone>& range_dels,
     } else {
       ASSERT_FALSE(overlapped);
     }
+    ASSERT_EQ(overlapped,
+              fragmented.IsRangeOverlapped(expected_points[i - 1].begin,
+                                           expected_points[i].begin));
   }
 }
 
@@ -175,6 +196,42 @@ TEST_F(RangeDelAggregatorTest, AlternateMultipleAboveBelow) {
        {"h", 0}});
 }
 
+TEST_F(RangeDelAggregatorTest, FragmentedReadSnapshot) {
+  auto icmp = InternalKeyComparator(BytewiseComparator());
+  std::vector<std::string> keys, values;
+  for (const auto& range_del : std::vector<RangeTombstone>{
+           {"a", "e", 4}, {"c", "g", 10}, {"f", "h", 7}}) {
+    auto key_and_value = range_del.Serialize();
+    keys.push_back(key_and_value.first.Encode().ToString());
+    values.push_back(key_and_value.second.ToString());
+  }
+  std::shared_ptr<const FragmentedRangeTombstoneList> fragmented(
+      new FragmentedRangeTombstoneList(
+          std::unique_ptr<InternalIterator>(
+              new test::VectorIterator(keys, values)),
+          icmp));
+  ASSERT_OK(fragmented->status());
+  // [a, c) {4}, [c, e) {10, 4}, [e, f) {10}, [f, g) {10, 7}, [g, h) {7}
+  ASSERT_EQ(5U, fragmented->num_fragments());
+  ASSERT_EQ(4U, fragmented->MaxCoveringTombstoneSeqnum("d", 9));
+  ASSERT_EQ(0U, fragmented->MaxCoveringTombstoneSeqnum("e", 9));
+  ASSERT_EQ(7U, fragmented->MaxCoveringTombstoneSeqnum("f", 9));
+  ASSERT_EQ(0U, fragmented->MaxCoveringTombstoneSeqnum("h", 9));
+
+  // Tombstones newer than the read's snapshot must not delete older keys.
+  RangeDelAggregator range_del_agg(icmp, 9 /* upper_bound */);
+  ASSERT_OK(range_del_agg.AddFragmentedTombstones(fragmented));
+  ASSERT_FALSE(range_del_agg.IsEmpty());
+  ASSERT_TRUE(
+      range_del_agg.ShouldDelete(ParsedInternalKey("d", 3, kTypeValue)));
+  ASSERT_FALSE(
+      range_del_agg.ShouldDelete(ParsedInternalKey("d", 5, kTypeValue)));
+  ASSERT_FALSE(
+      range_del_agg.ShouldDelete(ParsedInternalKey("e", 5, kTypeValue)));
+  ASSERT_TRUE(
+      range_del_agg.ShouldDelete(ParsedInternalKey("g", 6, kTypeValue)));
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -0,0 +1,165 @@
+//  Copyright (c) 2018-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/range_tombstone_fragmenter.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace rocksdb {
+
+namespace {
+
+struct UnfragmentedTombstone {
+  std::string start_key;
+  std::string end_key;
+  SequenceNumber seq;
+};
+
+}  // anonymous namespace
+
+FragmentedRangeTombstoneList::FragmentedRangeTombstoneList(
+    std::unique_ptr<InternalIterator> unfragmented_tombstones,
+    const InternalKeyComparator& icmp)
+    : ucmp_(icmp.user_comparator()) {
+  if (unfragmented_tombstones == nullptr) {
+    return;
+  }
+  // Copy the tombstones out so the fragments don't depend on the input
+  // iterator's key pinning.
+  std::vector<UnfragmentedTombstone> tombstones;
+  std::vector<Slice> boundaries;
+  for (unfragmented_tombstones->SeekToFirst(); unfragmented_tombstones->Valid();
+       unfragmented_tombstones->Next()) {
+    ParsedInternalKey parsed_key;
+    if (!ParseInternalKey(unfragmented_tombstones->key(), &parsed_key)) {
+      status_ =
+          Status::Corruption("Unable to parse range tombstone InternalKey");
+      return;
+    }
+    if (ucmp_->Compare(parsed_key.user_key, unfragmented_tombstones->value()) >=
+        0) {
+      // Empty range, covers nothing.
+      continue;
+    }
+    tombstones.push_back({parsed_key.user_key.ToString(),
+                          unfragmented_tombstones->value().ToString(),
+                          parsed_key.sequence});
+  }
+  if (!unfragmented_tombstones->status().ok()) {
+    status_ = unfragmented_tombstones->status();
+    return;
+  }
+  if (tombstones.empty()) {
+    return;
+  }
+
+  const Comparator* ucmp = ucmp_;
+  std::sort(tombstones.begin(), tombstones.end(),
+            [ucmp](const UnfragmentedTombstone& a,
+                   const UnfragmentedTombstone& b) {
+              return ucmp->Compare(a.start_key, b.start_key) < 0;
+            });
+  boundaries.reserve(tombstones.size() * 2);
+  for (const auto& tombstone : tombstones) {
+    boundaries.emplace_back(tombstone.start_key);
+    boundaries.emplace_back(tombstone.end_key);
+  }
+  std::sort(boundaries.begin(), boundaries.end(),
+            [ucmp](const Slice& a, const Slice& b) {
+              return ucmp->Compare(a, b) < 0;
+            });
+  boundaries.erase(std::unique(boundaries.begin(), boundaries.end(),
+                               [ucmp](const Slice& a, const Slice& b) {
+                                 return ucmp->Compare(a, b) == 0;
+                               }),
+                   boundaries.end());
+
+  // Sweep the boundaries left to right, keeping the set of tombstones that
+  // cover the gap between the current boundary and the next one. Every start
+  // key is a boundary, so a tombstone becomes active exactly at its start.
+  std::vector<const UnfragmentedTombstone*> active;
+  std::vector<SequenceNumber> seqs;
+  size_t next_tombstone = 0;
+  for (size_t i = 0; i + 1 < boundaries.size(); ++i) {
+    const Slice& boundary = boundaries[i];
+    active.erase(std::remove_if(active.begin(), active.end(),
+                                [ucmp, &boundary](
+                                    const UnfragmentedTombstone* t) {
+                                  return ucmp->Compare(t->end_key,
+                                                       boundary) <= 0;
+                                }),
+                 active.end());
+    while (next_tombstone < tombstones.size() &&
+           ucmp_->Compare(tombstones[next_tombstone].start_key, boundary) ==
+               0) {
+      active.push_back(&tombstones[next_tombstone]);
+      ++next_tombstone;
+    }
+    if (active.empty()) {
+      continue;
+    }
+    seqs.clear();
+    for (const auto* tombstone : active) {
+      seqs.push_back(tombstone->seq);
+    }
+    std::sort(seqs.begin(), seqs.end(), std::greater<SequenceNumber>());
+    seqs.erase(std::unique(seqs.begin(), seqs.end()), seqs.end());
+
+    if (!fragments_.empty() &&
+        ucmp_->Compare(fragments_.back().end_key, boundary) == 0 &&
+        fragments_.back().seq_end_idx - fragments_.back().seq_start_idx ==
+            seqs.size() &&
+        std::equal(seqs.begin(), seqs.end(),
+                   tombstone_seqs_.begin() + fragments_.back().seq_start_idx)) {
+      // Same tombstones as the adjacent fragment, so just extend it.
+      fragments_.back().end_key = boundaries[i + 1].ToString();
+      continue;
+    }
+    size_t seq_start_idx = tombstone_seqs_.size();
+    tombstone_seqs_.insert(tombstone_seqs_.end(), seqs.begin(), seqs.end());
+    fragments_.emplace_back(boundary.ToString(), boundaries[i + 1].ToString(),
+                            seq_start_idx, tombstone_seqs_.size());
+  }
+}
+
+SequenceNumber FragmentedRangeTombstoneList::MaxCoveringTombstoneSeqnum(
+    const Slice& user_key, SequenceNumber upper_bound) const {
+  const Comparator* ucmp = ucmp_;
+  auto fragment_iter = std::upper_bound(
+      fragments_.begin(), fragments_.end(), user_key,
+      [ucmp](const Slice& key, const Fragment& fragment) {
+        return ucmp->Compare(key, fragment.start_key) < 0;
+      });
+  if (fragment_iter == fragments_.begin()) {
+    return 0;
+  }
+  --fragment_iter;
+  if (ucmp_->Compare(user_key, fragment_iter->end_key) >= 0) {
+    return 0;
+  }
+  auto seqs_begin = tombstone_seqs_.begin() + fragment_iter->seq_start_idx;
+  auto seqs_end = tombstone_seqs_.begin() + fragment_iter->seq_end_idx;
+  // Seqnums are sorted in descending order, so this finds the newest one that
+  // is visible at upper_bound.
+  auto seq_iter = std::lower_bound(seqs_begin, seqs_end, upper_bound,
+                                   std::greater<SequenceNumber>());
+  return seq_iter == seqs_end ? 0 : *seq_iter;
+}
+
+bool FragmentedRangeTombstoneList::IsRangeOverlapped(const Slice& start,
+                                                     const Slice& end) const {
+  const Comparator* ucmp = ucmp_;
+  // Fragments don't overlap, so their end keys are sorted as well.
+  auto fragment_iter = std::upper_bound(
+      fragments_.begin(), fragments_.end(), start,
+      [ucmp](const Slice& key, const Fragment& fragment) {
+        return ucmp->Compare(key, fragment.end_key) < 0;
+      });
+  return fragment_iter != fragments_.end() &&
+         ucmp_->Compare(fragment_iter->start_key, end) <= 0;
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,70 @@
+//  Copyright (c) 2018-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "rocksdb/types.h"
+#include "table/internal_iterator.h"
+
+namespace rocksdb {
+
+// An immutable, binary-searchable view of a set of range tombstones. The input
+// tombstones are split at every start and end key into non-overlapping
+// fragments sorted by user key, and each fragment records the seqnums of all
+// tombstones covering it, newest first.
+//
+// The list is built once per SST file (and per immutable memtable) and shared
+// by all readers of that file, so looking up whether a key is covered takes
+// two binary searches and does not allocate.
+class FragmentedRangeTombstoneList {
+ public:
+  // Reads all tombstones from `unfragmented_tombstones`. On a corrupted
+  // tombstone key status() is set and the list is left empty.
+  FragmentedRangeTombstoneList(
+      std::unique_ptr<InternalIterator> unfragmented_tombstones,
+      const InternalKeyComparator& icmp);
+
+  // Returns the largest seqnum among the tombstones covering `user_key` that
+  // is not greater than `upper_bound`, or zero if there is none.
+  SequenceNumber MaxCoveringTombstoneSeqnum(const Slice& user_key,
+                                            SequenceNumber upper_bound) const;
+
+  // Returns whether any fragment overlaps the user key range [start, end].
+  bool IsRangeOverlapped(const Slice& start, const Slice& end) const;
+
+  bool empty() const { return fragments_.empty(); }
+  size_t num_fragments() const { return fragments_.size(); }
+  const Status& status() const { return status_; }
+
+ private:
+  struct Fragment {
+    Fragment(std::string _start_key, std::string _end_key,
+             size_t _seq_start_idx, size_t _seq_end_idx)
+        : start_key(std::move(_start_key)),
+          end_key(std::move(_end_key)),
+          seq_start_idx(_seq_start_idx),
+          seq_end_idx(_seq_end_idx) {}
+
+    std::string start_key;
+    std::string end_key;
+    // [seq_start_idx, seq_end_idx) indexes tombstone_seqs_, sorted descending.
+    size_t seq_start_idx;
+    size_t seq_end_idx;
+  };
+
+  const Comparator* ucmp_;
+  std::vector<Fragment> fragments_;
+  std::vector<SequenceNumber> tombstone_seqs_;
+  Status status_;
+};
+
+}  // namespace rocksdb
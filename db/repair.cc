@@ -65,6 +65,8 @@
 #endif
 
 #include <inttypes.h>
+#include <algorithm>
+#include <set>
 #include "db/builder.h"
 #include "db/db_impl.h"
 #include "db/dbformat.h"
@@ -84,6 +86,7 @@
 #include "util/file_reader_writer.h"
 #include "util/filename.h"
 #include "util/string_util.h"
+#include "utilities/blob_db/blob_index.h"
 
 namespace rocksdb {
 
@@ -241,6 +244,8 @@ class Repairer {
   std::vector<std::string> manifests_;
   std::vector<FileDescriptor> table_fds_;
   std::vector<uint64_t> logs_;
+  // Blob files found in db_paths[0], where flushes and compactions put them
+  std::set<uint64_t> blob_files_;
   std::vector<TableInfo> tables_;
   uint64_t next_file_number_;
 
@@ -291,6 +296,8 @@ class Repairer {
             } else if (type == kTableFile) {
               table_fds_.emplace_back(number, static_cast<uint32_t>(path_id),
                                       0);
+            } else if (type == kBlobFile && path_id == 0) {
+              blob_files_.insert(number);
             } else {
               // Ignore other files
             }
@@ -526,6 +533,20 @@ class Repairer {
         if (parsed.sequence > t->max_sequence) {
           t->max_sequence = parsed.sequence;
         }
+        if (parsed.type == kTypeBlobIndex) {
+          // Keep the blob files that the table refers to alive. Blob indexes
+          // into files elsewhere belong to BlobDB, which tracks them itself.
+          blob_db::BlobIndex index;
+          if (index.DecodeFrom(iter->value()).ok() && !index.IsInlined() &&
+              blob_files_.count(index.file_number()) > 0) {
+            auto& numbers = t->meta.blob_file_numbers;
+            auto it = std::lower_bound(numbers.begin(), numbers.end(),
+                                       index.file_number());
+            if (it == numbers.end() || *it != index.file_number()) {
+              numbers.insert(it, index.file_number());
+            }
+          }
+        }
       }
       if (!iter->status().ok()) {
         status = iter->status();
@@ -565,7 +586,8 @@ class Repairer {
         edit.AddFile(0, table->meta.fd.GetNumber(), table->meta.fd.GetPathId(),
                      table->meta.fd.GetFileSize(), table->meta.smallest,
                      table->meta.largest, table->min_sequence,
-                     table->max_sequence, table->meta.marked_for_compaction);
+                     table->max_sequence, table->meta.marked_for_compaction,
+                     table->meta.blob_file_numbers);
       }
       assert(next_file_number_ > 0);
       vset_.MarkFileNumberUsed(next_file_number_ - 1);
@@ -46,6 +46,30 @@ static void DeleteTableReader(void* arg1, void* arg2) {
   delete table_reader;
 }
 
+// Adds the table's range tombstones to range_del_agg. Aggregators serving
+// reads share the table reader's fragmented tombstones instead of re-reading
+// them into their own map.
+static Status AddRangeTombstones(TableReader* table_reader,
+                                 const ReadOptions& options,
+                                 RangeDelAggregator* range_del_agg) {
+  if (range_del_agg->SupportsFragmentedTombstones()) {
+    auto fragmented = table_reader->GetFragmentedRangeTombstones();
+    if (fragmented != nullptr) {
+      return range_del_agg->AddFragmentedTombstones(std::move(fragmented));
+    }
+  }
+  std::unique_ptr<InternalIterator> range_del_iter(
+      table_reader->NewRangeTombstoneIterator(options));
+  Status s;
+  if (range_del_iter != nullptr) {
+    s = range_del_iter->status();
+  }
+  if (s.ok()) {
+    s = range_del_agg->AddTombstones(std::move(range_del_iter));
+  }
+  return s;
+}
+
 static Slice GetSliceForFileNumber(const uint64_t* file_number) {
   return Slice(reinterpret_cast<const char*>(file_number),
                sizeof(*file_number));
@@ -99,7 +123,8 @@ Status TableCache::GetTableReader(
   RecordTick(ioptions_.statistics, NO_FILE_OPENS);
   if (s.ok()) {
     if (readahead > 0) {
-      file = NewReadaheadRandomAccessFile(std::move(file), readahead);
+      file = NewReadaheadRandomAccessFile(std::move(file), readahead,
+                                          ioptions_.async_readahead);
     }
     if (!sequential_mode && ioptions_.advise_random_on_open) {
       file->Hint(RandomAccessFile::RANDOM);
@@ -247,14 +272,7 @@ InternalIterator* TableCache::NewIterator(
     }
   }
   if (s.ok() && range_del_agg != nullptr && !options.ignore_range_deletions) {
-    std::unique_ptr<InternalIterator> range_del_iter(
-        table_reader->NewRangeTombstoneIterator(options));
-    if (range_del_iter != nullptr) {
-      s = range_del_iter->status();
-    }
-    if (s.ok()) {
-      s = range_del_agg->AddTombstones(std::move(range_del_iter));
-    }
+    s = AddRangeTombstones(table_reader, options, range_del_agg);
   }
 
   if (handle != nullptr) {
@@ -383,15 +401,7 @@ Status TableCache::Get(const ReadOptions& options,
     }
     if (s.ok() && get_context->range_del_agg() != nullptr &&
         !options.ignore_range_deletions) {
-      std::unique_ptr<InternalIterator> range_del_iter(
-          t->NewRangeTombstoneIterator(options));
-      if (range_del_iter != nullptr) {
-        s = range_del_iter->status();
-      }
-      if (s.ok()) {
-        s = get_context->range_del_agg()->AddTombstones(
-            std::move(range_del_iter));
-      }
+      s = AddRangeTombstones(t, options, get_context->range_del_agg());
     }
     if (s.ok()) {
       get_context->SetReplayLog(row_cache_entry);  // nullptr if no cache.
@@ -422,6 +432,63 @@ Status TableCache::Get(const ReadOptions& options,
   return s;
 }
 
+void TableCache::MultiGet(const ReadOptions& options,
+                          const InternalKeyComparator& internal_comparator,
+                          const FileDescriptor& fd, size_t num_keys,
+                          const Slice* keys, GetContext** get_contexts,
+                          Status* statuses, HistogramImpl* file_read_hist,
+                          bool skip_filters, int level) {
+#ifndef ROCKSDB_LITE
+  if (ioptions_.row_cache) {
+    // Row cache entries are per key, so go through the single key path which
+    // knows how to look them up and populate them.
+    for (size_t i = 0; i < num_keys; ++i) {
+      statuses[i] = Get(options, internal_comparator, fd, keys[i],
+                        get_contexts[i], file_read_hist, skip_filters, level);
+    }
+    return;
+  }
+#endif  // ROCKSDB_LITE
+  Status s;
+  TableReader* t = fd.table_reader;
+  Cache::Handle* handle = nullptr;
+  if (t == nullptr) {
+    s = FindTable(env_options_, internal_comparator, fd, &handle,
+                  options.read_tier == kBlockCacheTier /* no_io */,
+                  true /* record_read_stats */, file_read_hist, skip_filters,
+                  level);
+    if (s.ok()) {
+      t = GetTableReaderFromHandle(handle);
+    }
+  }
+  if (s.ok() && !options.ignore_range_deletions) {
+    for (size_t i = 0; i < num_keys && s.ok(); ++i) {
+      if (get_contexts[i]->range_del_agg() == nullptr) {
+        continue;
+      }
+      s = AddRangeTombstones(t, options, get_contexts[i]->range_del_agg());
+    }
+  }
+  if (s.ok()) {
+    t->MultiGet(options, num_keys, keys, get_contexts, statuses,
+                skip_filters);
+  } else if (options.read_tier == kBlockCacheTier && s.IsIncomplete()) {
+    // Couldn't find Table in cache but treat as kFound if no_io set
+    for (size_t i = 0; i < num_keys; ++i) {
+      get_contexts[i]->MarkKeyMayExist();
+      statuses[i] = Status::OK();
+    }
+  } else {
+    for (size_t i = 0; i < num_keys; ++i) {
+      statuses[i] = s;
+    }
+  }
+
+  if (handle != nullptr) {
+    ReleaseHandle(handle);
+  }
+}
+
 Status TableCache::GetTableProperties(
     const EnvOptions& env_options,
     const InternalKeyComparator& internal_comparator, const FileDescriptor& fd,
@@ -447,6 +514,28 @@ Status TableCache::GetTableProperties(
   return s;
 }
 
+Status TableCache::ApproximateKeyAnchors(
+    const ReadOptions& read_options, const EnvOptions& env_options,
+    const InternalKeyComparator& internal_comparator, const FileDescriptor& fd,
+    std::vector<TableReader::Anchor>* anchors) {
+  auto table_reader = fd.table_reader;
+  // table already been pre-loaded?
+  if (table_reader) {
+    return table_reader->ApproximateKeyAnchors(read_options, anchors);
+  }
+
+  Cache::Handle* table_handle = nullptr;
+  Status s = FindTable(env_options, internal_comparator, fd, &table_handle);
+  if (!s.ok()) {
+    return s;
+  }
+  assert(table_handle);
+  s = GetTableReaderFromHandle(table_handle)
+          ->ApproximateKeyAnchors(read_options, anchors);
+  ReleaseHandle(table_handle);
+  return s;
+}
+
 size_t TableCache::GetMemoryUsageByTableReader(
     const EnvOptions& env_options,
     const InternalKeyComparator& internal_comparator,
@@ -78,6 +78,17 @@ class TableCache {
              GetContext* get_context, HistogramImpl* file_read_hist = nullptr,
              bool skip_filters = false, int level = -1);
 
+  // Batched version of Get() for keys[0, num_keys) that all may be in the
+  // specified file. Keys must be sorted in ascending internal key order, and
+  // get_contexts[i] / statuses[i] belong to keys[i]. The table is looked up
+  // in the cache once for the whole batch.
+  void MultiGet(const ReadOptions& options,
+                const InternalKeyComparator& internal_comparator,
+                const FileDescriptor& file_fd, size_t num_keys,
+                const Slice* keys, GetContext** get_contexts, Status* statuses,
+                HistogramImpl* file_read_hist = nullptr,
+                bool skip_filters = false, int level = -1);
+
   // Evict any entry for the specified file number
   static void Evict(Cache* cache, uint64_t file_number);
 
@@ -111,6 +122,14 @@ class TableCache {
                             std::shared_ptr<const TableProperties>* properties,
                             bool no_io = false);
 
+  // Appends the table reader's anchors of the file to `anchors`, see
+  // TableReader::ApproximateKeyAnchors().
+  Status ApproximateKeyAnchors(const ReadOptions& read_options,
+                               const EnvOptions& toptions,
+                               const InternalKeyComparator& internal_comparator,
+                               const FileDescriptor& fd,
+                               std::vector<TableReader::Anchor>* anchors);
+
   // Return total memory usage of the table reader of the file.
   // 0 if table reader of the file is not loaded.
   size_t GetMemoryUsageByTableReader(
@@ -45,6 +45,7 @@ enum CustomTag {
   kTerminate = 1,  // The end of customized fields
   kNeedCompaction = 2,
   kPathId = 65,
+  kBlobFileNumbers = 66,
 };
 // If this bit for the custom tag is set, opening DB should fail if
 // we don't know this field.
@@ -109,7 +110,7 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
       return false;
     }
     bool has_customized_fields = false;
-    if (f.marked_for_compaction) {
+    if (f.marked_for_compaction || !f.blob_file_numbers.empty()) {
       PutVarint32(dst, kNewFile4);
       has_customized_fields = true;
     } else if (f.fd.GetPathId() == 0) {
@@ -154,6 +155,8 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
       //   tag kPathId: 1 byte as path_id
       //   tag kNeedCompaction:
       //        now only can take one char value 1 indicating need-compaction
+      //   tag kBlobFileNumbers: varint64 numbers of the referenced blob
+      //        files, in increasing order
       //
       if (f.fd.GetPathId() != 0) {
         PutVarint32(dst, CustomTag::kPathId);
@@ -165,6 +168,14 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
         char p = static_cast<char>(1);
         PutLengthPrefixedSlice(dst, Slice(&p, 1));
       }
+      if (!f.blob_file_numbers.empty()) {
+        PutVarint32(dst, CustomTag::kBlobFileNumbers);
+        std::string numbers;
+        for (uint64_t number : f.blob_file_numbers) {
+          PutVarint64(&numbers, number);
+        }
+        PutLengthPrefixedSlice(dst, Slice(numbers));
+      }
       TEST_SYNC_POINT_CALLBACK("VersionEdit::EncodeTo:NewFile4:CustomizeFields",
                                dst);
 
@@ -252,6 +263,15 @@ const char* VersionEdit::DecodeNewFile4From(Slice* input) {
           }
           f.marked_for_compaction = (field[0] == 1);
           break;
+        case kBlobFileNumbers:
+          while (!field.empty()) {
+            uint64_t blob_file_number;
+            if (!GetVarint64(&field, &blob_file_number)) {
+              return "blob_file_numbers field";
+            }
+            f.blob_file_numbers.push_back(blob_file_number);
+          }
+          break;
         default:
           if ((custom_tag & kCustomTagNonSafeIgnoreMask) != 0) {
             // Should not proceed if cannot understand it
@@ -499,6 +519,10 @@ std::string VersionEdit::DebugString(bool hex_key) const {
     r.append(f.smallest.DebugString(hex_key));
     r.append(" .. ");
     r.append(f.largest.DebugString(hex_key));
+    for (uint64_t blob_file_number : f.blob_file_numbers) {
+      r.append(" blob:");
+      AppendNumberTo(&r, blob_file_number);
+    }
   }
   r.append("\n  ColumnFamily: ");
   AppendNumberTo(&r, column_family_);
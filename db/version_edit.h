@@ -107,6 +107,10 @@ struct FileMetaData {
   bool marked_for_compaction;  // True if client asked us nicely to compact this
                                // file.
 
+  // Sorted numbers of the blob files that entries of this file point into.
+  // A blob file is live as long as a live table file references it.
+  std::vector<uint64_t> blob_file_numbers;
+
   FileMetaData()
       : smallest_seqno(kMaxSequenceNumber),
         largest_seqno(0),
@@ -206,7 +210,9 @@ class VersionEdit {
                uint64_t file_size, const InternalKey& smallest,
                const InternalKey& largest, const SequenceNumber& smallest_seqno,
                const SequenceNumber& largest_seqno,
-               bool marked_for_compaction) {
+               bool marked_for_compaction,
+               const std::vector<uint64_t>& blob_file_numbers =
+                   std::vector<uint64_t>()) {
     assert(smallest_seqno <= largest_seqno);
     FileMetaData f;
     f.fd = FileDescriptor(file, file_path_id, file_size);
@@ -215,6 +221,7 @@ class VersionEdit {
     f.smallest_seqno = smallest_seqno;
     f.largest_seqno = largest_seqno;
     f.marked_for_compaction = marked_for_compaction;
+    f.blob_file_numbers = blob_file_numbers;
     new_files_.emplace_back(level, std::move(f));
   }
 
@@ -82,6 +82,30 @@ TEST_F(VersionEditTest, EncodeDecodeNewFile4) {
   ASSERT_EQ(0, new_files[2].second.fd.GetPathId());
 }
 
+TEST_F(VersionEditTest, EncodeDecodeBlobFileNumbers) {
+  static const uint64_t kBig = 1ull << 50;
+
+  VersionEdit edit;
+  edit.AddFile(3, 300, 0, 100, InternalKey("foo", kBig + 500, kTypeBlobIndex),
+               InternalKey("zoo", kBig + 600, kTypeValue), kBig + 500,
+               kBig + 600, false, {7, 9, kBig + 11});
+  edit.AddFile(4, 301, 0, 100, InternalKey("foo", kBig + 501, kTypeValue),
+               InternalKey("zoo", kBig + 601, kTypeDeletion), kBig + 501,
+               kBig + 601, false);
+  TestEncodeDecode(edit);
+
+  std::string encoded;
+  edit.EncodeTo(&encoded);
+  VersionEdit parsed;
+  Status s = parsed.DecodeFrom(encoded);
+  ASSERT_TRUE(s.ok()) << s.ToString();
+  auto& new_files = parsed.GetNewFiles();
+  ASSERT_EQ(std::vector<uint64_t>({7, 9, kBig + 11}),
+            new_files[0].second.blob_file_numbers);
+  ASSERT_TRUE(!new_files[0].second.marked_for_compaction);
+  ASSERT_TRUE(new_files[1].second.blob_file_numbers.empty());
+}
+
 TEST_F(VersionEditTest, ForwardCompatibleNewFile4) {
   static const uint64_t kBig = 1ull << 50;
   VersionEdit edit;
@@ -904,7 +904,8 @@ VersionStorageInfo::VersionStorageInfo(
       current_num_samples_(0),
       estimated_compaction_needed_bytes_(0),
       finalized_(false),
-      force_consistency_checks_(_force_consistency_checks) {
+      force_consistency_checks_(_force_consistency_checks),
+      has_blob_file_references_(false) {
   if (ref_vstorage != nullptr) {
     accumulated_file_size_ = ref_vstorage->accumulated_file_size_;
     accumulated_raw_key_size_ = ref_vstorage->accumulated_raw_key_size_;
@@ -962,12 +963,17 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
     *key_exists = true;
   }
 
+  // Blob indexes are resolved here unless the caller asked for them
+  bool found_blob_index = false;
+  const bool get_blob = is_blob == nullptr && value != nullptr &&
+                        storage_info_.has_blob_file_references();
   PinnedIteratorsManager pinned_iters_mgr;
   GetContext get_context(
       user_comparator(), merge_operator_, info_log_, db_statistics_,
       status->ok() ? GetContext::kNotFound : GetContext::kMerge, user_key,
       value, value_found, merge_context, range_del_agg, this->env_, seq,
-      merge_operator_ ? &pinned_iters_mgr : nullptr, callback, is_blob);
+      merge_operator_ ? &pinned_iters_mgr : nullptr, callback,
+      get_blob ? &found_blob_index : is_blob);
 
   // Pin blocks that we read to hold merge operands
   if (merge_operator_) {
@@ -1006,6 +1012,9 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
         } else if (fp.GetHitFileLevel() >= 2) {
           RecordTick(db_statistics_, GET_HIT_L2_AND_UP);
         }
+        if (found_blob_index) {
+          *status = GetBlob(read_options, user_key, f->file_metadata, value);
+        }
         return;
       case GetContext::kDeleted:
         // Use empty error message for speed
@@ -1050,6 +1059,265 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
   }
 }
 
+Status Version::GetBlob(const ReadOptions& read_options,
+                        const Slice& user_key, const FileMetaData* file,
+                        PinnableSlice* value) {
+  // Blob indexes in table files that do not refer to any blob file were
+  // written through BlobDB
+  if (file->blob_file_numbers.empty()) {
+    ROCKS_LOG_ERROR(info_log_, "Encounter unexpected blob index.");
+    return Status::NotSupported(
+        "Encounter unexpected blob index. Please open DB with "
+        "rocksdb::blob_db::BlobDB instead.");
+  }
+  // The index may be pinned in a block, so it is copied out before *value
+  // is reset to hold the blob
+  const std::string blob_index = value->ToString();
+  value->Reset();
+  return cfd_->blob_source()->GetBlob(read_options, user_key, blob_index,
+                                      value);
+}
+
+void Version::MultiGet(const ReadOptions& read_options,
+                       const std::vector<MultiGetKey*>& keys) {
+  const size_t num_keys = keys.size();
+  if (num_keys == 0) {
+    return;
+  }
+  const Comparator* ucmp = user_comparator();
+
+  // One pinning manager for the whole batch; merge operands stay pinned
+  // until all keys are resolved.
+  PinnedIteratorsManager pinned_iters_mgr;
+  std::vector<GetContext> get_contexts;
+  get_contexts.reserve(num_keys);
+  // Blob indexes are resolved here if any file refers to a blob file
+  const bool get_blob = storage_info_.has_blob_file_references();
+  std::unique_ptr<bool[]> found_blob_index(new bool[num_keys]);
+  for (size_t i = 0; i < num_keys; ++i) {
+    auto* k = keys[i];
+    assert(k->status->ok() || k->status->IsMergeInProgress());
+    found_blob_index[i] = false;
+    get_contexts.emplace_back(
+        ucmp, merge_operator_, info_log_, db_statistics_,
+        k->status->ok() ? GetContext::kNotFound : GetContext::kMerge,
+        k->lkey->user_key(), k->value, nullptr /* value_found */,
+        k->merge_context, k->range_del_agg, this->env_, nullptr /* seq */,
+        merge_operator_ ? &pinned_iters_mgr : nullptr, nullptr /* callback */,
+        get_blob ? &found_blob_index[i] : nullptr);
+  }
+  if (merge_operator_) {
+    pinned_iters_mgr.StartPinning();
+  }
+
+  // Indexes into "keys" of lookups that still need to search more files,
+  // in user key order.
+  std::vector<size_t> pending(num_keys);
+  for (size_t i = 0; i < num_keys; ++i) {
+    pending[i] = i;
+  }
+  std::vector<bool> done(num_keys, false);
+
+  // Scratch space for the keys looked up in one file.
+  std::vector<size_t> batch;
+  std::vector<Slice> batch_ikeys;
+  std::vector<GetContext*> batch_contexts;
+  std::vector<Status> batch_statuses;
+
+  // Looks up every key in "batch" in file "f" and marks the keys that reached
+  // a final state as done.
+  auto lookup_batch = [&](FdWithKeyRange* f, int level, bool last_in_level) {
+    batch_ikeys.clear();
+    batch_contexts.clear();
+    for (size_t idx : batch) {
+      batch_ikeys.push_back(keys[idx]->lkey->internal_key());
+      batch_contexts.push_back(&get_contexts[idx]);
+      if (get_contexts[idx].sample()) {
+        sample_file_read_inc(f->file_metadata);
+      }
+    }
+    batch_statuses.assign(batch.size(), Status());
+    table_cache_->MultiGet(
+        read_options, *internal_comparator(), f->fd, batch.size(),
+        batch_ikeys.data(), batch_contexts.data(), batch_statuses.data(),
+        cfd_->internal_stats()->GetFileReadHist(level),
+        IsFilterSkipped(level, last_in_level), level);
+
+    for (size_t b = 0; b < batch.size(); ++b) {
+      size_t idx = batch[b];
+      Status* status = keys[idx]->status;
+      *status = batch_statuses[b];
+      if (!status->ok()) {
+        done[idx] = true;
+        continue;
+      }
+      switch (get_contexts[idx].State()) {
+        case GetContext::kNotFound:
+        case GetContext::kMerge:
+          // Keep searching in other files
+          break;
+        case GetContext::kFound:
+          if (level == 0) {
+            RecordTick(db_statistics_, GET_HIT_L0);
+          } else if (level == 1) {
+            RecordTick(db_statistics_, GET_HIT_L1);
+          } else {
+            RecordTick(db_statistics_, GET_HIT_L2_AND_UP);
+          }
+          if (found_blob_index[idx]) {
+            *status = GetBlob(read_options, keys[idx]->lkey->user_key(),
+                              f->file_metadata, keys[idx]->value);
+          }
+          done[idx] = true;
+          break;
+        case GetContext::kDeleted:
+          // Use empty error message for speed
+          *status = Status::NotFound();
+          done[idx] = true;
+          break;
+        case GetContext::kCorrupt:
+          *status = Status::Corruption("corrupted key for ",
+                                       keys[idx]->lkey->user_key());
+          done[idx] = true;
+          break;
+        case GetContext::kBlobIndex:
+          ROCKS_LOG_ERROR(info_log_, "Encounter unexpected blob index.");
+          *status = Status::NotSupported(
+              "Encounter unexpected blob index. Please open DB with "
+              "rocksdb::blob_db::BlobDB instead.");
+          done[idx] = true;
+          break;
+      }
+    }
+  };
+  auto remove_done = [&](std::vector<size_t>* v) {
+    v->erase(std::remove_if(v->begin(), v->end(),
+                            [&](size_t idx) { return done[idx]; }),
+             v->end());
+  };
+
+  // Per level (n > 0) state: the keys still searching this level together
+  // with the index of the next file to look them up in. Both vectors stay
+  // sorted since the keys are.
+  std::vector<size_t> level_keys;
+  std::vector<uint32_t> level_files;
+
+  for (int level = 0;
+       level < storage_info_.num_non_empty_levels_ && !pending.empty();
+       ++level) {
+    const LevelFilesBrief& file_level = storage_info_.level_files_brief_[level];
+    const uint32_t num_files = static_cast<uint32_t>(file_level.num_files);
+    if (num_files == 0) {
+      continue;
+    }
+
+    if (level == 0) {
+      // Level-0 files may overlap each other, so every pending key is checked
+      // against every file, newest first.
+      for (uint32_t i = 0; i < num_files && !pending.empty(); ++i) {
+        FdWithKeyRange* f = &file_level.files[i];
+        batch.clear();
+        for (size_t idx : pending) {
+          const Slice user_key = keys[idx]->lkey->user_key();
+          if (ucmp->Compare(user_key, ExtractUserKey(f->smallest_key)) >= 0 &&
+              ucmp->Compare(user_key, ExtractUserKey(f->largest_key)) <= 0) {
+            batch.push_back(idx);
+          }
+        }
+        if (!batch.empty()) {
+          lookup_batch(f, level, i == num_files - 1);
+          remove_done(&pending);
+        }
+      }
+      continue;
+    }
+
+    // On Level-n (n>=1) files are sorted and non-overlapping. Since the keys
+    // are sorted too, each binary search can start at the file the previous
+    // key landed in.
+    level_keys.clear();
+    level_files.clear();
+    uint32_t left = 0;
+    for (size_t idx : pending) {
+      uint32_t fidx = static_cast<uint32_t>(
+          FindFileInRange(*internal_comparator(), file_level,
+                          keys[idx]->lkey->internal_key(), left, num_files));
+      left = fidx;
+      if (fidx < num_files &&
+          ucmp->Compare(keys[idx]->lkey->user_key(),
+                        ExtractUserKey(file_level.files[fidx].smallest_key)) >=
+              0) {
+        level_keys.push_back(idx);
+        level_files.push_back(fidx);
+      }
+    }
+
+    while (!level_keys.empty()) {
+      const uint32_t fidx = level_files[0];
+      FdWithKeyRange* f = &file_level.files[fidx];
+      size_t n = 0;
+      batch.clear();
+      while (n < level_keys.size() && level_files[n] == fidx) {
+        batch.push_back(level_keys[n]);
+        ++n;
+      }
+      lookup_batch(f, level, fidx == num_files - 1);
+
+      // With merge operands, a user key equal to the largest key of this
+      // file may continue in the next file of the same level. Those keys
+      // come first in the batch order and go before the remaining keys,
+      // which all map to later files.
+      std::vector<size_t> next_keys;
+      std::vector<uint32_t> next_files;
+      for (size_t idx : batch) {
+        if (done[idx]) {
+          continue;
+        }
+        const Slice user_key = keys[idx]->lkey->user_key();
+        if (fidx + 1 < num_files &&
+            ucmp->Compare(user_key, ExtractUserKey(f->largest_key)) == 0 &&
+            ucmp->Compare(user_key, ExtractUserKey(
+                                        file_level.files[fidx + 1].smallest_key)) >=
+                0) {
+          next_keys.push_back(idx);
+          next_files.push_back(fidx + 1);
+        }
+      }
+      next_keys.insert(next_keys.end(), level_keys.begin() + n,
+                       level_keys.end());
+      next_files.insert(next_files.end(), level_files.begin() + n,
+                        level_files.end());
+      level_keys.swap(next_keys);
+      level_files.swap(next_files);
+    }
+    remove_done(&pending);
+  }
+
+  for (size_t idx : pending) {
+    Status* status = keys[idx]->status;
+    if (GetContext::kMerge == get_contexts[idx].State()) {
+      if (!merge_operator_) {
+        *status = Status::InvalidArgument(
+            "merge_operator is not properly initialized.");
+        continue;
+      }
+      // merge_operands are in saver and we hit the beginning of the key
+      // history do a final merge of nullptr and operands;
+      PinnableSlice* value = keys[idx]->value;
+      std::string* str_value = value != nullptr ? value->GetSelf() : nullptr;
+      *status = MergeHelper::TimedFullMerge(
+          merge_operator_, keys[idx]->lkey->user_key(), nullptr,
+          keys[idx]->merge_context->GetOperands(), str_value, info_log_,
+          db_statistics_, env_, nullptr /* result_operand */, true);
+      if (LIKELY(value != nullptr)) {
+        value->PinSelf();
+      }
+    } else {
+      *status = Status::NotFound();  // Use an empty error message for speed
+    }
+  }
+}
+
 bool Version::IsFilterSkipped(int level, bool is_file_last_in_level) {
   // Reaching the bottom level implies misses at all upper levels, so we'll
   // skip checking the filters when we predict a hit.
@@ -1343,6 +1611,11 @@ uint32_t GetExpiredTtlFilesCount(const ImmutableCFOptions& ioptions,
 void VersionStorageInfo::ComputeCompactionScore(
     const ImmutableCFOptions& immutable_cf_options,
     const MutableCFOptions& mutable_cf_options) {
+  // Levels 1..tiered_levels-1 are compacted as sorted runs together with L0.
+  const int tiered_levels =
+      compaction_style_ == kCompactionStyleLevel
+          ? immutable_cf_options.level_compaction_tiered_levels
+          : 0;
   for (int level = 0; level <= MaxInputLevel(); level++) {
     double score;
     if (level == 0) {
@@ -1374,6 +1647,13 @@ void VersionStorageInfo::ComputeCompactionScore(
             num_sorted_runs++;
           }
         }
+      } else if (tiered_levels > 0) {
+        // Likewise for the tiered levels of level compaction.
+        for (int i = 1; i < tiered_levels; i++) {
+          if (!files_[i].empty() && !files_[i][0]->being_compacted) {
+            num_sorted_runs++;
+          }
+        }
       }
 
       if (compaction_style_ == kCompactionStyleFIFO) {
@@ -1395,7 +1675,8 @@ void VersionStorageInfo::ComputeCompactionScore(
       } else {
         score = static_cast<double>(num_sorted_runs) /
                 mutable_cf_options.level0_file_num_compaction_trigger;
-        if (compaction_style_ == kCompactionStyleLevel && num_levels() > 1) {
+        if (compaction_style_ == kCompactionStyleLevel && num_levels() > 1 &&
+            tiered_levels == 0) {
           // Level-based involves L0->L0 compactions that can lead to oversized
           // L0 files. Take into account size as well to avoid later giant
           // compactions to the base level.
@@ -1404,6 +1685,10 @@ void VersionStorageInfo::ComputeCompactionScore(
                      mutable_cf_options.max_bytes_for_level_base);
         }
       }
+    } else if (level < tiered_levels - 1) {
+      // Only merged with other sorted runs, as decided by the L0 score. The
+      // last tiered level is compacted into the leveled part by size.
+      score = 0;
     } else {
       // Compute the ratio of current size to size limit.
       uint64_t level_bytes_no_compacting = 0;
@@ -1500,6 +1785,9 @@ void VersionStorageInfo::AddFile(int level, FileMetaData* f, Logger* info_log) {
 #endif
   f->refs++;
   level_files->push_back(f);
+  if (!f->blob_file_numbers.empty()) {
+    has_blob_file_references_ = true;
+  }
 }
 
 // Version::PrepareApply() need to be called before calling the function, or
@@ -1598,6 +1886,34 @@ void SortFileByOverlappingRatio(
                      file_to_order[f2.file->fd.GetNumber()];
             });
 }
+
+// Sort `temp` based on the sampled reads of each file, weighted by the ratio
+// of deletion entries in it, largest first. Ties, including all files that
+// haven't been read, are broken by compensated size.
+void SortFileByReadHotDeletions(std::vector<Fsize>* temp) {
+  // The read counters keep changing, so take a snapshot to sort by.
+  std::unordered_map<uint64_t, double> file_to_order;
+  for (const auto& f : *temp) {
+    const FileMetaData* file = f.file;
+    double order = 0;
+    if (file->num_entries > 0) {
+      order = static_cast<double>(file->stats.num_reads_sampled.load(
+                  std::memory_order_relaxed)) *
+              file->num_deletions / file->num_entries;
+    }
+    file_to_order[file->fd.GetNumber()] = order;
+  }
+
+  std::sort(temp->begin(), temp->end(),
+            [&](const Fsize& f1, const Fsize& f2) -> bool {
+              double order1 = file_to_order[f1.file->fd.GetNumber()];
+              double order2 = file_to_order[f2.file->fd.GetNumber()];
+              if (order1 != order2) {
+                return order1 > order2;
+              }
+              return CompareCompensatedSizeDescending(f1, f2);
+            });
+}
 }  // namespace
 
 void VersionStorageInfo::UpdateFilesByCompactionPri(
@@ -1646,6 +1962,9 @@ void VersionStorageInfo::UpdateFilesByCompactionPri(
         SortFileByOverlappingRatio(*internal_comparator_, files_[level],
                                    files_[level + 1], &temp);
         break;
+      case kReadHotDeletionsFirst:
+        SortFileByReadHotDeletions(&temp);
+        break;
       default:
         assert(false);
     }
@@ -2323,11 +2642,17 @@ bool VersionStorageInfo::RangeMightExistAfterSortedRun(
   return false;
 }
 
-void Version::AddLiveFiles(std::vector<FileDescriptor>* live) {
+void Version::AddLiveFiles(std::vector<FileDescriptor>* live,
+                           std::vector<uint64_t>* live_blob_files) {
   for (int level = 0; level < storage_info_.num_levels(); level++) {
     const std::vector<FileMetaData*>& files = storage_info_.files_[level];
     for (const auto& file : files) {
       live->push_back(file->fd);
+      if (live_blob_files != nullptr) {
+        live_blob_files->insert(live_blob_files->end(),
+                                file->blob_file_numbers.begin(),
+                                file->blob_file_numbers.end());
+      }
     }
   }
 }
@@ -3498,7 +3823,7 @@ Status VersionSet::WriteSnapshot(log::Writer* log) {
           edit.AddFile(level, f->fd.GetNumber(), f->fd.GetPathId(),
                        f->fd.GetFileSize(), f->smallest, f->largest,
                        f->smallest_seqno, f->largest_seqno,
-                       f->marked_for_compaction);
+                       f->marked_for_compaction, f->blob_file_numbers);
         }
       }
       edit.SetLogNumber(cfd->GetLogNumber());
@@ -3627,7 +3952,8 @@ uint64_t VersionSet::ApproximateSize(Version* v, const FdWithKeyRange& f,
   return result;
 }
 
-void VersionSet::AddLiveFiles(std::vector<FileDescriptor>* live_list) {
+void VersionSet::AddLiveFiles(std::vector<FileDescriptor>* live_list,
+                              std::vector<uint64_t>* live_blob_files) {
   // pre-calculate space requirement
   int64_t total_files = 0;
   for (auto cfd : *column_family_set_) {
@@ -3656,7 +3982,7 @@ void VersionSet::AddLiveFiles(std::vector<FileDescriptor>* live_list) {
     Version* dummy_versions = cfd->dummy_versions();
     for (Version* v = dummy_versions->next_; v != dummy_versions;
          v = v->next_) {
-      v->AddLiveFiles(live_list);
+      v->AddLiveFiles(live_list, live_blob_files);
       if (v == current) {
         found_current = true;
       }
@@ -3664,7 +3990,7 @@ void VersionSet::AddLiveFiles(std::vector<FileDescriptor>* live_list) {
     if (!found_current && current != nullptr) {
       // Should never happen unless it is a bug.
       assert(false);
-      current->AddLiveFiles(live_list);
+      current->AddLiveFiles(live_list, live_blob_files);
     }
   }
 }
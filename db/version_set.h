@@ -64,6 +64,17 @@ class ColumnFamilySet;
 class TableCache;
 class MergeIteratorBuilder;
 
+// State of a single key in a batched Version::MultiGet() lookup. All pointed
+// to objects are owned by the caller. *status must be OK or MergeInProgress
+// on entry, e.g. after the key was looked up in the memtables.
+struct MultiGetKey {
+  const LookupKey* lkey;
+  PinnableSlice* value;
+  Status* status;
+  MergeContext* merge_context;
+  RangeDelAggregator* range_del_agg;
+};
+
 // Return the smallest index i such that file_level.files[i]->largest >= key.
 // Return file_level.num_files if there is no such file.
 // REQUIRES: "file_level.files" contains a sorted list of
@@ -239,6 +250,10 @@ class VersionStorageInfo {
 
   int num_levels() const { return num_levels_; }
 
+  // Returns true if any file refers to a blob file written by a flush or a
+  // compaction
+  bool has_blob_file_references() const { return has_blob_file_references_; }
+
   // REQUIRES: This version has been saved (see VersionSet::SaveTo)
   int num_non_empty_levels() const {
     assert(finalized_);
@@ -505,6 +520,8 @@ class VersionStorageInfo {
   // is compiled in release mode
   bool force_consistency_checks_;
 
+  bool has_blob_file_references_;
+
   friend class Version;
   friend class VersionSet;
   // No copying allowed
@@ -540,6 +557,10 @@ class Version {
   // If seq is non-null, *seq will be set to the sequence number found
   // for the key if a key was found.
   //
+  // If is_blob is null, values that a flush or compaction moved to a blob
+  // file are read from it. Otherwise the blob index is returned in *value and
+  // *is_blob is set to true.
+  //
   // REQUIRES: lock is not held
   void Get(const ReadOptions&, const LookupKey& key, PinnableSlice* value,
            Status* status, MergeContext* merge_context,
@@ -547,6 +568,14 @@ class Version {
            bool* key_exists = nullptr, SequenceNumber* seq = nullptr,
            ReadCallback* callback = nullptr, bool* is_blob = nullptr);
 
+  // Batched version of Get() for keys that share the same snapshot. "keys"
+  // must be sorted by user key. Every level is visited once for the whole
+  // batch, and keys that fall into the same table file are looked up in it
+  // with a single TableCache::MultiGet() call.
+  //
+  // REQUIRES: lock is not held
+  void MultiGet(const ReadOptions&, const std::vector<MultiGetKey*>& keys);
+
   // Loads some stats information from files. Call without mutex held. It needs
   // to be called before applying the version to the version set.
   void PrepareApply(const MutableCFOptions& mutable_cf_options,
@@ -559,8 +588,10 @@ class Version {
   // and return true. Otherwise, return false.
   bool Unref();
 
-  // Add all files listed in the current version to *live.
-  void AddLiveFiles(std::vector<FileDescriptor>* live);
+  // Add all files listed in the current version to *live, and the numbers of
+  // the blob files they reference to *live_blob_files if it is not null.
+  void AddLiveFiles(std::vector<FileDescriptor>* live,
+                    std::vector<uint64_t>* live_blob_files = nullptr);
 
   // Return a human readable string that describes this version's contents.
   std::string DebugString(bool hex = false, bool print_stats = false) const;
@@ -634,6 +665,11 @@ class Version {
   // that it eventually expires from the cache.
   bool IsFilterSkipped(int level, bool is_file_last_in_level = false);
 
+  // Replaces *value, the blob index found for user_key in file, with the
+  // value it points at in a blob file.
+  Status GetBlob(const ReadOptions& read_options, const Slice& user_key,
+                 const FileMetaData* file, PinnableSlice* value);
+
   // The helper function of UpdateAccumulatedStats, which may fill the missing
   // fields of file_mata from its associated TableProperties.
   // Returns true if it does initialize FileMetaData.
@@ -812,8 +848,10 @@ class VersionSet {
       const Compaction* c, RangeDelAggregator* range_del_agg,
       const EnvOptions& env_options_compactions);
 
-  // Add all files listed in any live version to *live.
-  void AddLiveFiles(std::vector<FileDescriptor>* live_list);
+  // Add all files listed in any live version to *live, and the numbers of
+  // the blob files they reference to *live_blob_files if it is not null.
+  void AddLiveFiles(std::vector<FileDescriptor>* live_list,
+                    std::vector<uint64_t>* live_blob_files = nullptr);
 
   // Return the approximate size of data to be scanned for range [start, end)
   // in levels [start_level, end_level). If end_level == 0 it will search
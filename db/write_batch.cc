@@ -29,6 +29,9 @@
 // varstring :=
 //    len: varint32
 //    data: uint8[len]
+//
+// The data of the values of PutUnowned() is left out of rep_ and referenced
+// by UnownedValues instead, so that rep_ alone is not the serialized batch.
 
 #include "rocksdb/write_batch.h"
 
@@ -131,8 +134,26 @@ struct SavePoints {
   std::stack<SavePoint> stack;
 };
 
+struct UnownedValues {
+  struct Value {
+    // Offset of the record in rep_
+    size_t record_offset;
+    // The data belongs right after rep_[0, offset) in the serialized batch
+    size_t offset;
+    Slice data;
+  };
+  // In the order of rep_
+  std::vector<Value> values;
+  // Total size of the values
+  size_t bytes = 0;
+};
+
 WriteBatch::WriteBatch(size_t reserved_bytes, size_t max_bytes)
-    : save_points_(nullptr), content_flags_(0), max_bytes_(max_bytes), rep_() {
+    : save_points_(nullptr),
+      unowned_values_(nullptr),
+      content_flags_(0),
+      max_bytes_(max_bytes),
+      rep_() {
   rep_.reserve((reserved_bytes > WriteBatchInternal::kHeader) ?
     reserved_bytes : WriteBatchInternal::kHeader);
   rep_.resize(WriteBatchInternal::kHeader);
@@ -140,12 +161,16 @@ WriteBatch::WriteBatch(size_t reserved_bytes, size_t max_bytes)
 
 WriteBatch::WriteBatch(const std::string& rep)
     : save_points_(nullptr),
+      unowned_values_(nullptr),
       content_flags_(ContentFlags::DEFERRED),
       max_bytes_(0),
       rep_(rep) {}
 
 WriteBatch::WriteBatch(const WriteBatch& src)
     : save_points_(src.save_points_),
+      unowned_values_(src.unowned_values_ != nullptr
+                          ? new UnownedValues(*src.unowned_values_)
+                          : nullptr),
       wal_term_point_(src.wal_term_point_),
       content_flags_(src.content_flags_.load(std::memory_order_relaxed)),
       max_bytes_(src.max_bytes_),
@@ -153,10 +178,13 @@ WriteBatch::WriteBatch(const WriteBatch& src)
 
 WriteBatch::WriteBatch(WriteBatch&& src) noexcept
     : save_points_(std::move(src.save_points_)),
+      unowned_values_(src.unowned_values_),
       wal_term_point_(std::move(src.wal_term_point_)),
       content_flags_(src.content_flags_.load(std::memory_order_relaxed)),
       max_bytes_(src.max_bytes_),
-      rep_(std::move(src.rep_)) {}
+      rep_(std::move(src.rep_)) {
+  src.unowned_values_ = nullptr;
+}
 
 WriteBatch& WriteBatch::operator=(const WriteBatch& src) {
   if (&src != this) {
@@ -174,7 +202,10 @@ WriteBatch& WriteBatch::operator=(WriteBatch&& src) {
   return *this;
 }
 
-WriteBatch::~WriteBatch() { delete save_points_; }
+WriteBatch::~WriteBatch() {
+  delete save_points_;
+  delete unowned_values_;
+}
 
 WriteBatch::Handler::~Handler() { }
 
@@ -190,6 +221,7 @@ bool WriteBatch::Handler::Continue() {
 void WriteBatch::Clear() {
   rep_.clear();
   rep_.resize(WriteBatchInternal::kHeader);
+  WriteBatchInternal::TruncateUnownedValues(this, rep_.size());
 
   content_flags_.store(0, std::memory_order_relaxed);
 
@@ -202,6 +234,16 @@ void WriteBatch::Clear() {
   wal_term_point_.clear();
 }
 
+const std::string& WriteBatch::Data() const {
+  // rep_ lacks the values of PutUnowned(), see MaterializeUnownedValues()
+  assert(unowned_values_ == nullptr || unowned_values_->values.empty());
+  return rep_;
+}
+
+size_t WriteBatch::GetDataSize() const {
+  return WriteBatchInternal::ByteSize(this);
+}
+
 int WriteBatch::Count() const {
   return WriteBatchInternal::Count(this);
 }
@@ -223,7 +265,7 @@ uint32_t WriteBatch::ComputeContentFlags() const {
 }
 
 void WriteBatch::MarkWalTerminationPoint() {
-  wal_term_point_.size = GetDataSize();
+  wal_term_point_.size = rep_.size();
   wal_term_point_.count = Count();
   wal_term_point_.content_flags = content_flags_;
 }
@@ -393,15 +435,39 @@ Status WriteBatch::Iterate(Handler* handler) const {
   // before seeing the next Noop.
   bool empty_batch = true;
   int found = 0;
+  // The next value of PutUnowned()
+  size_t unowned = 0;
   Status s;
   while (s.ok() && !input.empty() && handler->Continue()) {
     char tag = 0;
     uint32_t column_family = 0;  // default
 
-    s = ReadRecordFromWriteBatch(&input, &tag, &column_family, &key, &value,
-                                 &blob, &xid);
-    if (!s.ok()) {
-      return s;
+    if (unowned_values_ != nullptr &&
+        unowned < unowned_values_->values.size() &&
+        unowned_values_->values[unowned].record_offset ==
+            static_cast<size_t>(input.data() - rep_.data())) {
+      // rep_ only has the record up to the length of the value
+      const auto& unowned_value = unowned_values_->values[unowned++];
+      Slice record(input.data(),
+                   unowned_value.offset - unowned_value.record_offset);
+      input.remove_prefix(record.size());
+      tag = record[0];
+      record.remove_prefix(1);
+      uint32_t value_size;
+      if ((tag == kTypeColumnFamilyValue &&
+           !GetVarint32(&record, &column_family)) ||
+          !GetLengthPrefixedSlice(&record, &key) ||
+          !GetVarint32(&record, &value_size) || !record.empty()) {
+        return Status::Corruption("bad WriteBatch Put");
+      }
+      value = unowned_value.data;
+      assert(value.size() == value_size);
+    } else {
+      s = ReadRecordFromWriteBatch(&input, &tag, &column_family, &key, &value,
+                                   &blob, &xid);
+      if (!s.ok()) {
+        return s;
+      }
     }
 
     switch (tag) {
@@ -592,6 +658,78 @@ Status WriteBatch::Put(ColumnFamilyHandle* column_family, const SliceParts& key,
                                  value);
 }
 
+Status WriteBatchInternal::PutUnowned(WriteBatch* b, uint32_t column_family_id,
+                                      const Slice& key, const Slice& value) {
+  LocalSavePoint save(b);
+  WriteBatchInternal::SetCount(b, WriteBatchInternal::Count(b) + 1);
+  const size_t record_offset = b->rep_.size();
+  if (column_family_id == 0) {
+    b->rep_.push_back(static_cast<char>(kTypeValue));
+  } else {
+    b->rep_.push_back(static_cast<char>(kTypeColumnFamilyValue));
+    PutVarint32(&b->rep_, column_family_id);
+  }
+  PutLengthPrefixedSlice(&b->rep_, key);
+  PutVarint32(&b->rep_, static_cast<uint32_t>(value.size()));
+  if (b->unowned_values_ == nullptr) {
+    b->unowned_values_ = new UnownedValues();
+  }
+  b->unowned_values_->values.push_back({record_offset, b->rep_.size(), value});
+  b->unowned_values_->bytes += value.size();
+  b->content_flags_.store(
+      b->content_flags_.load(std::memory_order_relaxed) | ContentFlags::HAS_PUT,
+      std::memory_order_relaxed);
+  return save.commit();
+}
+
+Status WriteBatch::PutUnowned(ColumnFamilyHandle* column_family,
+                              const Slice& key, const Slice& value) {
+  return WriteBatchInternal::PutUnowned(this, GetColumnFamilyID(column_family),
+                                        key, value);
+}
+
+void WriteBatch::MaterializeUnownedValues() {
+  if (unowned_values_ == nullptr || unowned_values_->values.empty()) {
+    return;
+  }
+  // The sizes of rep_ recorded before grow by the values they include
+  const auto& values = unowned_values_->values;
+  auto materialized_size = [&values](size_t size) {
+    size_t result = size;
+    for (const auto& value : values) {
+      if (value.offset > size) {
+        break;
+      }
+      result += value.data.size();
+    }
+    return result;
+  };
+  if (save_points_ != nullptr) {
+    std::vector<SavePoint> save_points;
+    for (; !save_points_->stack.empty(); save_points_->stack.pop()) {
+      save_points.push_back(save_points_->stack.top());
+    }
+    for (auto it = save_points.rbegin(); it != save_points.rend(); ++it) {
+      it->size = materialized_size(it->size);
+      save_points_->stack.push(*it);
+    }
+  }
+  if (!wal_term_point_.is_cleared()) {
+    wal_term_point_.size = materialized_size(wal_term_point_.size);
+  }
+
+  std::vector<Slice> contents;
+  WriteBatchInternal::GetContents(this, &contents);
+  std::string rep;
+  rep.reserve(WriteBatchInternal::ByteSize(this));
+  for (const auto& slice : contents) {
+    rep.append(slice.data(), slice.size());
+  }
+  rep_.swap(rep);
+  delete unowned_values_;
+  unowned_values_ = nullptr;
+}
+
 Status WriteBatchInternal::InsertNoop(WriteBatch* b) {
   b->rep_.push_back(static_cast<char>(kTypeNoop));
   return Status::OK();
@@ -865,7 +1003,7 @@ void WriteBatch::SetSavePoint() {
   }
   // Record length and count of current batch of writes.
   save_points_->stack.push(SavePoint(
-      GetDataSize(), Count(), content_flags_.load(std::memory_order_relaxed)));
+      rep_.size(), Count(), content_flags_.load(std::memory_order_relaxed)));
 }
 
 Status WriteBatch::RollbackToSavePoint() {
@@ -887,6 +1025,7 @@ Status WriteBatch::RollbackToSavePoint() {
     Clear();
   } else {
     rep_.resize(savepoint.size);
+    WriteBatchInternal::TruncateUnownedValues(this, savepoint.size);
     WriteBatchInternal::SetCount(this, savepoint.count);
     content_flags_.store(savepoint.content_flags, std::memory_order_relaxed);
   }
@@ -927,6 +1066,13 @@ class MemTableInserter : public WriteBatch::Handler {
   using MemPostInfoMap = std::map<MemTable*, MemTablePostProcessInfo>;
   using PostMapType = std::aligned_storage<sizeof(MemPostInfoMap)>::type;
   PostMapType mem_post_info_map_;
+  // Entries waiting to be inserted into memtables that use
+  // memtable_sorted_batch_insert. Created on demand as well.
+  using MemSortedBatchMap = std::map<MemTable*, MemTableSortedBatch>;
+  using SortedBatchMapType =
+      std::aligned_storage<sizeof(MemSortedBatchMap)>::type;
+  SortedBatchMapType mem_sorted_batch_map_;
+  bool sorted_batch_created_;
   // current recovered transaction we are rebuilding (recovery)
   WriteBatch* rebuilding_trx_;
   SequenceNumber rebuilding_trx_seq_;
@@ -945,6 +1091,14 @@ class MemTableInserter : public WriteBatch::Handler {
     return *reinterpret_cast<MemPostInfoMap*>(&mem_post_info_map_);
   }
 
+  MemSortedBatchMap& GetSortedBatchMap() {
+    if (!sorted_batch_created_) {
+      new (&mem_sorted_batch_map_) MemSortedBatchMap();
+      sorted_batch_created_ = true;
+    }
+    return *reinterpret_cast<MemSortedBatchMap*>(&mem_sorted_batch_map_);
+  }
+
  protected:
   virtual bool WriteAfterCommit() const override { return write_after_commit_; }
 
@@ -966,6 +1120,7 @@ class MemTableInserter : public WriteBatch::Handler {
         concurrent_memtable_writes_(concurrent_memtable_writes),
         post_info_created_(false),
         has_valid_writes_(has_valid_writes),
+        sorted_batch_created_(false),
         rebuilding_trx_(nullptr),
         seq_per_batch_(seq_per_batch),
         // Write after commit currently uses one seq per key (instead of per
@@ -980,6 +1135,10 @@ class MemTableInserter : public WriteBatch::Handler {
       reinterpret_cast<MemPostInfoMap*>
         (&mem_post_info_map_)->~MemPostInfoMap();
     }
+    if (sorted_batch_created_) {
+      reinterpret_cast<MemSortedBatchMap*>(&mem_sorted_batch_map_)
+          ->~MemSortedBatchMap();
+    }
     delete rebuilding_trx_;
   }
 
@@ -1019,6 +1178,18 @@ class MemTableInserter : public WriteBatch::Handler {
     }
   }
 
+  // Inserts the entries deferred by memtable_sorted_batch_insert into their
+  // memtables, in key order. Has to be called before the writes are made
+  // visible, and before reading from the memtables.
+  void InsertSortedBatches() {
+    if (sorted_batch_created_) {
+      for (auto& pair : GetSortedBatchMap()) {
+        pair.first->InsertSortedBatch(&pair.second,
+                                      concurrent_memtable_writes_);
+      }
+    }
+  }
+
   bool SeekToColumnFamily(uint32_t column_family_id, Status* s) {
     // If we are in a concurrent mode, it is the caller's responsibility
     // to clone the original ColumnFamilyMemTables so that each thread
@@ -1077,15 +1248,21 @@ class MemTableInserter : public WriteBatch::Handler {
 
     MemTable* mem = cf_mems_->GetMemTable();
     auto* moptions = mem->GetImmutableMemTableOptions();
-    if (!moptions->inplace_update_support) {
+    const bool inplace_update =
+        moptions->inplace_update_support ||
+        (moptions->inplace_update_atomic && value_type == kTypeValue);
+    if (!inplace_update) {
       mem->Add(sequence_, value_type, key, value, concurrent_memtable_writes_,
-               get_post_process_info(mem));
+               get_post_process_info(mem), get_sorted_batch(mem));
     } else if (moptions->inplace_callback == nullptr) {
-      assert(!concurrent_memtable_writes_);
-      mem->Update(sequence_, key, value);
+      assert(!concurrent_memtable_writes_ || moptions->inplace_update_atomic);
+      mem->Update(sequence_, key, value, concurrent_memtable_writes_,
+                  get_post_process_info(mem));
     } else {
-      assert(!concurrent_memtable_writes_);
-      if (mem->UpdateCallback(sequence_, key, value)) {
+      assert(!concurrent_memtable_writes_ || moptions->inplace_update_atomic);
+      if (mem->UpdateCallback(sequence_, key, value,
+                              concurrent_memtable_writes_,
+                              get_post_process_info(mem))) {
       } else {
         // key not found in memtable. Do sst get, update, add
         SnapshotImpl read_from_snapshot;
@@ -1115,11 +1292,13 @@ class MemTableInserter : public WriteBatch::Handler {
                                                  value, &merged_value);
         if (status == UpdateStatus::UPDATED_INPLACE) {
           // prev_value is updated in-place with final value.
-          mem->Add(sequence_, value_type, key, Slice(prev_buffer, prev_size));
+          mem->Add(sequence_, value_type, key, Slice(prev_buffer, prev_size),
+                   concurrent_memtable_writes_, get_post_process_info(mem));
           RecordTick(moptions->statistics, NUMBER_KEYS_WRITTEN);
         } else if (status == UpdateStatus::UPDATED) {
           // merged_value contains the final value.
-          mem->Add(sequence_, value_type, key, Slice(merged_value));
+          mem->Add(sequence_, value_type, key, Slice(merged_value),
+                   concurrent_memtable_writes_, get_post_process_info(mem));
           RecordTick(moptions->statistics, NUMBER_KEYS_WRITTEN);
         }
       }
@@ -1141,7 +1320,7 @@ class MemTableInserter : public WriteBatch::Handler {
                     const Slice& value, ValueType delete_type) {
     MemTable* mem = cf_mems_->GetMemTable();
     mem->Add(sequence_, delete_type, key, value, concurrent_memtable_writes_,
-             get_post_process_info(mem));
+             get_post_process_info(mem), get_sorted_batch(mem));
     MaybeAdvanceSeq();
     CheckMemtableFull();
     return Status::OK();
@@ -1246,6 +1425,8 @@ class MemTableInserter : public WriteBatch::Handler {
     // So we disable merge in recovery
     if (moptions->max_successive_merges > 0 && db_ != nullptr &&
         recovering_log_number_ == 0) {
+      // The earlier entries of the batch have to be readable
+      InsertSortedBatches();
       LookupKey lkey(key, sequence_);
 
       // Count the number of successive merges at the head
@@ -1297,7 +1478,8 @@ class MemTableInserter : public WriteBatch::Handler {
 
     if (!perform_merge) {
       // Add merge operator to memtable
-      mem->Add(sequence_, kTypeMerge, key, value);
+      mem->Add(sequence_, kTypeMerge, key, value, false /* allow_concurrent */,
+               nullptr /* post_process_info */, get_sorted_batch(mem));
     }
 
     MaybeAdvanceSeq();
@@ -1454,6 +1636,15 @@ class MemTableInserter : public WriteBatch::Handler {
     }
     return &GetPostMap()[mem];
   }
+
+  MemTableSortedBatch* get_sorted_batch(MemTable* mem) {
+    auto* moptions = mem->GetImmutableMemTableOptions();
+    if (!moptions->sorted_batch_insert || moptions->inplace_update_support ||
+        moptions->inplace_update_atomic) {
+      return nullptr;
+    }
+    return &GetSortedBatchMap()[mem];
+  }
 };
 
 // This function can only be called in these conditions:
@@ -1484,9 +1675,11 @@ Status WriteBatchInternal::InsertInto(
     inserter.set_log_number_ref(w->log_ref);
     w->status = w->batch->Iterate(&inserter);
     if (!w->status.ok()) {
+      inserter.InsertSortedBatches();
       return w->status;
     }
   }
+  inserter.InsertSortedBatches();
   return Status::OK();
 }
 
@@ -1503,6 +1696,7 @@ Status WriteBatchInternal::InsertInto(
   SetSequence(writer->batch, sequence);
   inserter.set_log_number_ref(writer->log_ref);
   Status s = writer->batch->Iterate(&inserter);
+  inserter.InsertSortedBatches();
   if (concurrent_memtable_writes) {
     inserter.PostProcess();
   }
@@ -1519,6 +1713,7 @@ Status WriteBatchInternal::InsertInto(
                             concurrent_memtable_writes, has_valid_writes,
                             seq_per_batch);
   Status s = batch->Iterate(&inserter);
+  inserter.InsertSortedBatches();
   if (next_seq != nullptr) {
     *next_seq = inserter.sequence();
   }
@@ -1531,6 +1726,7 @@ Status WriteBatchInternal::InsertInto(
 Status WriteBatchInternal::SetContents(WriteBatch* b, const Slice& contents) {
   assert(contents.size() >= WriteBatchInternal::kHeader);
   b->rep_.assign(contents.data(), contents.size());
+  TruncateUnownedValues(b, 0);
   b->content_flags_.store(ContentFlags::DEFERRED, std::memory_order_relaxed);
   return Status::OK();
 }
@@ -1555,13 +1751,64 @@ Status WriteBatchInternal::Append(WriteBatch* dst, const WriteBatch* src,
 
   SetCount(dst, Count(dst) + src_count);
   assert(src->rep_.size() >= WriteBatchInternal::kHeader);
+  const size_t dst_offset = dst->rep_.size() - WriteBatchInternal::kHeader;
   dst->rep_.append(src->rep_.data() + WriteBatchInternal::kHeader, src_len);
+  if (src->unowned_values_ != nullptr) {
+    // The values stay referenced
+    for (const auto& value : src->unowned_values_->values) {
+      if (value.offset > WriteBatchInternal::kHeader + src_len) {
+        break;
+      }
+      if (dst->unowned_values_ == nullptr) {
+        dst->unowned_values_ = new UnownedValues();
+      }
+      dst->unowned_values_->values.push_back({value.record_offset + dst_offset,
+                                              value.offset + dst_offset,
+                                              value.data});
+      dst->unowned_values_->bytes += value.data.size();
+    }
+  }
   dst->content_flags_.store(
       dst->content_flags_.load(std::memory_order_relaxed) | src_flags,
       std::memory_order_relaxed);
   return Status::OK();
 }
 
+size_t WriteBatchInternal::ByteSize(const WriteBatch* batch) {
+  return batch->rep_.size() + (batch->unowned_values_ != nullptr
+                                   ? batch->unowned_values_->bytes
+                                   : 0);
+}
+
+void WriteBatchInternal::GetContents(const WriteBatch* batch,
+                                     std::vector<Slice>* contents) {
+  contents->clear();
+  size_t offset = 0;
+  if (batch->unowned_values_ != nullptr) {
+    for (const auto& value : batch->unowned_values_->values) {
+      contents->push_back(
+          Slice(batch->rep_.data() + offset, value.offset - offset));
+      contents->push_back(value.data);
+      offset = value.offset;
+    }
+  }
+  contents->push_back(
+      Slice(batch->rep_.data() + offset, batch->rep_.size() - offset));
+}
+
+void WriteBatchInternal::TruncateUnownedValues(WriteBatch* b,
+                                               size_t rep_size) {
+  if (b->unowned_values_ == nullptr) {
+    return;
+  }
+  // A value belongs to the record before it
+  auto& values = b->unowned_values_->values;
+  while (!values.empty() && values.back().offset > rep_size) {
+    b->unowned_values_->bytes -= values.back().data.size();
+    values.pop_back();
+  }
+}
+
 size_t WriteBatchInternal::AppendedByteSize(size_t leftByteSize,
                                             size_t rightByteSize) {
   if (leftByteSize == 0 || rightByteSize == 0) {
@@ -74,6 +74,9 @@ class WriteBatchInternal {
   static Status Put(WriteBatch* batch, uint32_t column_family_id,
                     const SliceParts& key, const SliceParts& value);
 
+  static Status PutUnowned(WriteBatch* batch, uint32_t column_family_id,
+                           const Slice& key, const Slice& value);
+
   static Status Delete(WriteBatch* batch, uint32_t column_family_id,
                        const SliceParts& key);
 
@@ -128,13 +131,20 @@ class WriteBatchInternal {
   // This offset is only valid if the batch is not empty.
   static size_t GetFirstOffset(WriteBatch* batch);
 
+  // Only for batches without values of PutUnowned(), see GetContents().
   static Slice Contents(const WriteBatch* batch) {
     return Slice(batch->rep_);
   }
 
-  static size_t ByteSize(const WriteBatch* batch) {
-    return batch->rep_.size();
-  }
+  // The serialized batch is the concatenation of *contents, which reference
+  // the values of PutUnowned() instead of copying them.
+  static void GetContents(const WriteBatch* batch,
+                          std::vector<Slice>* contents);
+
+  static size_t ByteSize(const WriteBatch* batch);
+
+  // Drops the values of PutUnowned() that don't belong to rep_[0, rep_size).
+  static void TruncateUnownedValues(WriteBatch* batch, size_t rep_size);
 
   static Status SetContents(WriteBatch* batch, const Slice& contents);
 
@@ -202,7 +212,7 @@ class LocalSavePoint {
  public:
   explicit LocalSavePoint(WriteBatch* batch)
       : batch_(batch),
-        savepoint_(batch->GetDataSize(), batch->Count(),
+        savepoint_(batch->rep_.size(), batch->Count(),
                    batch->content_flags_.load(std::memory_order_relaxed))
 #ifndef NDEBUG
         ,
@@ -218,8 +228,10 @@ class LocalSavePoint {
 #ifndef NDEBUG
     committed_ = true;
 #endif
-    if (batch_->max_bytes_ && batch_->rep_.size() > batch_->max_bytes_) {
+    if (batch_->max_bytes_ &&
+        WriteBatchInternal::ByteSize(batch_) > batch_->max_bytes_) {
       batch_->rep_.resize(savepoint_.size);
+      WriteBatchInternal::TruncateUnownedValues(batch_, savepoint_.size);
       WriteBatchInternal::SetCount(batch_, savepoint_.count);
       batch_->content_flags_.store(savepoint_.content_flags,
                                    std::memory_order_relaxed);
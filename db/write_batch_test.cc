@@ -603,6 +603,92 @@ TEST_F(WriteBatchTest, PutGatherSlices) {
   ASSERT_EQ(3, batch.Count());
 }
 
+TEST_F(WriteBatchTest, PutUnowned) {
+  std::string value1 = "value1";
+  std::string value2 = "value2";
+  WriteBatch batch;
+  ASSERT_OK(batch.Put("foo", "bar"));
+  ASSERT_OK(batch.PutUnowned("k1", value1));
+  ASSERT_OK(batch.Delete("foo"));
+  ASSERT_OK(batch.PutUnowned("k2", value2));
+
+  // Serialized the same way as a batch of copied values
+  WriteBatch copied;
+  ASSERT_OK(copied.Put("foo", "bar"));
+  ASSERT_OK(copied.Put("k1", value1));
+  ASSERT_OK(copied.Delete("foo"));
+  ASSERT_OK(copied.Put("k2", value2));
+  ASSERT_EQ(copied.GetDataSize(), batch.GetDataSize());
+  WriteBatch materialized(batch);
+  materialized.MaterializeUnownedValues();
+  ASSERT_EQ(copied.Data(), materialized.Data());
+  std::vector<Slice> contents;
+  WriteBatchInternal::GetContents(&batch, &contents);
+  ASSERT_EQ(5U, contents.size());
+  ASSERT_EQ(value1.data(), contents[1].data());
+  ASSERT_EQ(value2.data(), contents[3].data());
+
+  WriteBatchInternal::SetSequence(&batch, 100);
+  ASSERT_EQ("Delete(foo)@102"
+            "Put(foo, bar)@100"
+            "Put(k1, value1)@101"
+            "Put(k2, value2)@103",
+            PrintContents(&batch));
+
+  // The values are referenced, not copied
+  value1[5] = '9';
+  ASSERT_EQ("Delete(foo)@102"
+            "Put(foo, bar)@100"
+            "Put(k1, value9)@101"
+            "Put(k2, value2)@103",
+            PrintContents(&batch));
+
+  // Appending keeps the references
+  WriteBatch appended;
+  ASSERT_OK(appended.Put("first", "value"));
+  WriteBatchInternal::Append(&appended, &batch);
+  ASSERT_EQ(batch.GetDataSize() + 13, appended.GetDataSize());
+  WriteBatchInternal::SetSequence(&appended, 200);
+  ASSERT_EQ("Put(first, value)@200"
+            "Delete(foo)@203"
+            "Put(foo, bar)@201"
+            "Put(k1, value9)@202"
+            "Put(k2, value2)@204",
+            PrintContents(&appended));
+
+  // Rolling back drops the values of the records after the save point
+  batch.Clear();
+  ASSERT_OK(batch.PutUnowned("k1", value1));
+  batch.SetSavePoint();
+  ASSERT_OK(batch.PutUnowned(Slice("k2"), value2));
+  ASSERT_OK(batch.Put("k3", "v3"));
+  ASSERT_OK(batch.RollbackToSavePoint());
+  ASSERT_EQ("Put(k1, value9)@0", PrintContents(&batch));
+  ASSERT_EQ(WriteBatchInternal::kHeader + 11, batch.GetDataSize());
+
+  // Materializing copies the values, and keeps the save points in place
+  batch.SetSavePoint();
+  ASSERT_OK(batch.PutUnowned(Slice("k2"), value2));
+  batch.SetSavePoint();
+  batch.MaterializeUnownedValues();
+  value1[5] = '1';
+  ASSERT_EQ("Put(k1, value9)@0"
+            "Put(k2, value2)@1",
+            PrintContents(&batch));
+  ASSERT_OK(batch.Put("k3", "v3"));
+  ASSERT_OK(batch.RollbackToSavePoint());
+  ASSERT_EQ(WriteBatchInternal::kHeader + 22, batch.Data().size());
+  ASSERT_OK(batch.RollbackToSavePoint());
+  ASSERT_EQ("Put(k1, value9)@0", PrintContents(&batch));
+  ASSERT_EQ(WriteBatchInternal::kHeader + 11, batch.Data().size());
+
+  // The limit on the size of the batch counts the values
+  WriteBatch limited(0, WriteBatchInternal::kHeader + 20);
+  ASSERT_OK(limited.PutUnowned("k1", value1));
+  ASSERT_TRUE(limited.PutUnowned("k2", value2).IsMemoryLimit());
+  ASSERT_EQ("Put(k1, value1)@0", PrintContents(&limited));
+}
+
 namespace {
 class ColumnFamilyHandleImplDummy : public ColumnFamilyHandleImpl {
  public:
@@ -9,9 +9,15 @@
 #include <cassert>
 #include <ratio>
 #include "rocksdb/env.h"
+#include "util/mutexlock.h"
 
 namespace rocksdb {
 
+namespace {
+const uint64_t kMicrosPerSecond = 1000000;
+const uint64_t kRefillInterval = 1024U;
+}  // namespace
+
 std::unique_ptr<WriteControllerToken> WriteController::GetStopToken() {
   ++total_stopped_;
   return std::unique_ptr<WriteControllerToken>(new StopWriteToken(this));
@@ -34,9 +40,56 @@ WriteController::GetCompactionPressureToken() {
       new CompactionPressureToken(this));
 }
 
+std::unique_ptr<WriteControllerToken> WriteController::GetStopToken(
+    uint32_t column_family_id) {
+  MutexLock l(&column_family_stalls_mutex_);
+  column_family_stalls_[column_family_id].stopped++;
+  ++total_column_family_stalls_;
+  return std::unique_ptr<WriteControllerToken>(
+      new ColumnFamilyStallToken(this, column_family_id, true /* stop */));
+}
+
+std::unique_ptr<WriteControllerToken> WriteController::GetDelayToken(
+    uint32_t column_family_id, uint64_t write_rate) {
+  MutexLock l(&column_family_stalls_mutex_);
+  auto& stall = column_family_stalls_[column_family_id];
+  stall.delayed++;
+  // Unlike the DB-wide delay, the token bucket isn't reset, so that the
+  // writes already delayed keep being accounted for
+  stall.delayed_write_rate = ClampDelayedWriteRate(write_rate);
+  ++total_column_family_stalls_;
+  return std::unique_ptr<WriteControllerToken>(
+      new ColumnFamilyStallToken(this, column_family_id, false /* stop */));
+}
+
 bool WriteController::IsStopped() const {
   return total_stopped_.load(std::memory_order_relaxed) > 0;
 }
+
+bool WriteController::IsStopped(uint32_t column_family_id) const {
+  if (!HasColumnFamilyStalls()) {
+    return false;
+  }
+  MutexLock l(&column_family_stalls_mutex_);
+  auto iter = column_family_stalls_.find(column_family_id);
+  return iter != column_family_stalls_.end() && iter->second.stopped > 0;
+}
+
+bool WriteController::NeedsDelay(uint32_t column_family_id) const {
+  return delayed_write_rate(column_family_id) > 0;
+}
+
+uint64_t WriteController::delayed_write_rate(uint32_t column_family_id) const {
+  if (!HasColumnFamilyStalls()) {
+    return 0;
+  }
+  MutexLock l(&column_family_stalls_mutex_);
+  auto iter = column_family_stalls_.find(column_family_id);
+  if (iter == column_family_stalls_.end() || iter->second.delayed == 0) {
+    return 0;
+  }
+  return iter->second.delayed_write_rate;
+}
 // This is inside DB mutex, so we can't sleep and need to minimize
 // frequency to get time.
 // If it turns out to be a performance issue, we can redesign the thread
@@ -50,9 +103,6 @@ uint64_t WriteController::GetDelay(Env* env, uint64_t num_bytes) {
     return 0;
   }
 
-  const uint64_t kMicrosPerSecond = 1000000;
-  const uint64_t kRefillInterval = 1024U;
-
   if (bytes_left_ >= num_bytes) {
     bytes_left_ -= num_bytes;
     return 0;
@@ -106,6 +156,50 @@ uint64_t WriteController::GetDelay(Env* env, uint64_t num_bytes) {
   return sleep_amount;
 }
 
+uint64_t WriteController::GetDelay(Env* env, uint32_t column_family_id,
+                                   uint64_t num_bytes) {
+  if (!HasColumnFamilyStalls()) {
+    return 0;
+  }
+  MutexLock l(&column_family_stalls_mutex_);
+  auto iter = column_family_stalls_.find(column_family_id);
+  if (iter == column_family_stalls_.end() || iter->second.stopped > 0 ||
+      iter->second.delayed == 0) {
+    return 0;
+  }
+  auto& stall = iter->second;
+  const double rate = static_cast<double>(stall.delayed_write_rate);
+  auto time_now = NowMicrosMonotonic(env);
+  if (stall.last_refill_time != 0 && time_now > stall.last_refill_time) {
+    stall.bytes_left += static_cast<double>(time_now - stall.last_refill_time) *
+                        rate / kMicrosPerSecond;
+    // Idle time only builds up a burst of one refill interval
+    const double max_bytes_left = rate * kRefillInterval / kMicrosPerSecond;
+    if (stall.bytes_left > max_bytes_left) {
+      stall.bytes_left = max_bytes_left;
+    }
+  }
+  if (time_now > stall.last_refill_time) {
+    stall.last_refill_time = time_now;
+  }
+  stall.bytes_left -= static_cast<double>(num_bytes);
+  if (stall.bytes_left >= 0) {
+    return 0;
+  }
+  // Sleep until the debt, including the writes before, is paid off
+  return static_cast<uint64_t>(-stall.bytes_left * kMicrosPerSecond / rate);
+}
+
+uint64_t WriteController::ClampDelayedWriteRate(uint64_t write_rate) const {
+  // avoid divide 0
+  if (write_rate == 0) {
+    write_rate = 1u;
+  } else if (write_rate > max_delayed_write_rate()) {
+    write_rate = max_delayed_write_rate();
+  }
+  return write_rate;
+}
+
 uint64_t WriteController::NowMicrosMonotonic(Env* env) {
   return env->NowNanos() / std::milli::den;
 }
@@ -125,4 +219,23 @@ CompactionPressureToken::~CompactionPressureToken() {
   assert(controller_->total_compaction_pressure_ >= 0);
 }
 
+ColumnFamilyStallToken::~ColumnFamilyStallToken() {
+  MutexLock l(&controller_->column_family_stalls_mutex_);
+  auto iter = controller_->column_family_stalls_.find(column_family_id_);
+  assert(iter != controller_->column_family_stalls_.end());
+  auto& stall = iter->second;
+  if (stop_) {
+    assert(stall.stopped >= 1);
+    stall.stopped--;
+  } else {
+    assert(stall.delayed >= 1);
+    stall.delayed--;
+  }
+  if (stall.stopped == 0 && stall.delayed == 0) {
+    controller_->column_family_stalls_.erase(iter);
+  }
+  controller_->total_column_family_stalls_--;
+  assert(controller_->total_column_family_stalls_.load() >= 0);
+}
+
 }  // namespace rocksdb
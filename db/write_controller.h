@@ -9,6 +9,8 @@
 
 #include <atomic>
 #include <memory>
+#include <unordered_map>
+#include "port/port.h"
 #include "rocksdb/rate_limiter.h"
 
 namespace rocksdb {
@@ -27,6 +29,7 @@ class WriteController {
       : total_stopped_(0),
         total_delayed_(0),
         total_compaction_pressure_(0),
+        total_column_family_stalls_(0),
         bytes_left_(0),
         last_refill_time_(0),
         low_pri_rate_limiter_(
@@ -48,24 +51,43 @@ class WriteController {
   // threads will be increased
   std::unique_ptr<WriteControllerToken> GetCompactionPressureToken();
 
+  // Tokens of a single column family, which only stop or delay the writes
+  // to that column family. Each delayed column family has its own delayed
+  // write rate. See DBOptions::per_column_family_write_stall.
+  std::unique_ptr<WriteControllerToken> GetStopToken(
+      uint32_t column_family_id);
+  std::unique_ptr<WriteControllerToken> GetDelayToken(
+      uint32_t column_family_id, uint64_t delayed_write_rate);
+
   // these three metods are querying the state of the WriteController
   bool IsStopped() const;
   bool NeedsDelay() const { return total_delayed_.load() > 0; }
   bool NeedSpeedupCompaction() const {
-    return IsStopped() || NeedsDelay() || total_compaction_pressure_ > 0;
+    return IsStopped() || NeedsDelay() || total_compaction_pressure_ > 0 ||
+           HasColumnFamilyStalls();
   }
+
+  // Querying the stalls of single column families. Unlike the rest of
+  // WriteController, these and GetDelay(env, column_family_id, num_bytes) are
+  // thread-safe and don't need the DB mutex.
+  bool HasColumnFamilyStalls() const {
+    return total_column_family_stalls_.load(std::memory_order_relaxed) > 0;
+  }
+  bool IsStopped(uint32_t column_family_id) const;
+  bool NeedsDelay(uint32_t column_family_id) const;
+  // 0 if the column family isn't delayed
+  uint64_t delayed_write_rate(uint32_t column_family_id) const;
+
   // return how many microseconds the caller needs to sleep after the call
   // num_bytes: how many number of bytes to put into the DB.
   // Prerequisite: DB mutex held.
   uint64_t GetDelay(Env* env, uint64_t num_bytes);
+  // Same as above for the writes to a column family. The bytes are taken
+  // out of a token bucket that refills continuously and goes into debt, so
+  // that the delays of concurrent writers are spread out evenly.
+  uint64_t GetDelay(Env* env, uint32_t column_family_id, uint64_t num_bytes);
   void set_delayed_write_rate(uint64_t write_rate) {
-    // avoid divide 0
-    if (write_rate == 0) {
-      write_rate = 1u;
-    } else if (write_rate > max_delayed_write_rate()) {
-      write_rate = max_delayed_write_rate();
-    }
-    delayed_write_rate_ = write_rate;
+    delayed_write_rate_ = ClampDelayedWriteRate(write_rate);
   }
 
   void set_max_delayed_write_rate(uint64_t write_rate) {
@@ -91,10 +113,23 @@ class WriteController {
   friend class StopWriteToken;
   friend class DelayWriteToken;
   friend class CompactionPressureToken;
+  friend class ColumnFamilyStallToken;
+
+  struct ColumnFamilyStall {
+    int stopped = 0;
+    int delayed = 0;
+    uint64_t delayed_write_rate = 0;
+    // Bytes left in the token bucket, negative when in debt
+    double bytes_left = 0;
+    uint64_t last_refill_time = 0;
+  };
+
+  uint64_t ClampDelayedWriteRate(uint64_t write_rate) const;
 
   std::atomic<int> total_stopped_;
   std::atomic<int> total_delayed_;
   std::atomic<int> total_compaction_pressure_;
+  std::atomic<int> total_column_family_stalls_;
   uint64_t bytes_left_;
   uint64_t last_refill_time_;
   // write rate set when initialization or by `DBImpl::SetDBOptions`
@@ -103,6 +138,11 @@ class WriteController {
   uint64_t delayed_write_rate_;
 
   std::unique_ptr<RateLimiter> low_pri_rate_limiter_;
+
+  // Protects column_family_stalls_, which has an entry for each column family
+  // with a stop or delay token of its own
+  mutable port::Mutex column_family_stalls_mutex_;
+  std::unordered_map<uint32_t, ColumnFamilyStall> column_family_stalls_;
 };
 
 class WriteControllerToken {
@@ -141,4 +181,18 @@ class CompactionPressureToken : public WriteControllerToken {
   virtual ~CompactionPressureToken();
 };
 
+class ColumnFamilyStallToken : public WriteControllerToken {
+ public:
+  ColumnFamilyStallToken(WriteController* controller,
+                         uint32_t column_family_id, bool stop)
+      : WriteControllerToken(controller),
+        column_family_id_(column_family_id),
+        stop_(stop) {}
+  virtual ~ColumnFamilyStallToken();
+
+ private:
+  uint32_t column_family_id_;
+  bool stop_;
+};
+
 }  // namespace rocksdb
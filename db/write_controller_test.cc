@@ -127,6 +127,52 @@ TEST_F(WriteControllerTest, SanityTest) {
   ASSERT_FALSE(controller.IsStopped());
 }
 
+TEST_F(WriteControllerTest, ColumnFamilyStallTest) {
+  TimeSetEnv env;
+  WriteController controller(10000000u);
+  auto stop_token = controller.GetStopToken(1);
+  ASSERT_TRUE(controller.HasColumnFamilyStalls());
+  ASSERT_TRUE(controller.IsStopped(1));
+  ASSERT_FALSE(controller.IsStopped(2));
+  ASSERT_FALSE(controller.IsStopped());
+  ASSERT_EQ(static_cast<uint64_t>(0), controller.GetDelay(&env, 1, 1000u));
+
+  auto delay_token_1 = controller.GetDelayToken(2, 1000000u);
+  // More than the max rate
+  auto delay_token_2 = controller.GetDelayToken(3, 20000000u);
+  ASSERT_FALSE(controller.NeedsDelay());
+  ASSERT_TRUE(controller.NeedsDelay(2));
+  ASSERT_EQ(static_cast<uint64_t>(1000000u), controller.delayed_write_rate(2));
+  ASSERT_EQ(static_cast<uint64_t>(10000000u),
+            controller.delayed_write_rate(3));
+  ASSERT_EQ(static_cast<uint64_t>(0), controller.delayed_write_rate(4));
+  ASSERT_EQ(static_cast<uint64_t>(0), controller.GetDelay(&env, 4, 1000u));
+
+  // The writes of one column family go into debt, which the writes after
+  // them wait for as well
+  ASSERT_EQ(static_cast<uint64_t>(1000u), controller.GetDelay(&env, 2, 1000u));
+  ASSERT_EQ(static_cast<uint64_t>(2000u), controller.GetDelay(&env, 2, 1000u));
+  ASSERT_EQ(static_cast<uint64_t>(100u), controller.GetDelay(&env, 3, 1000u));
+  env.now_micros_ += 1500u;
+  ASSERT_EQ(static_cast<uint64_t>(1500u), controller.GetDelay(&env, 2, 1000u));
+  // Idle time builds up at most one refill interval of credit
+  env.now_micros_ += 1000000u;
+  ASSERT_EQ(static_cast<uint64_t>(0), controller.GetDelay(&env, 2, 1000u));
+  ASSERT_EQ(static_cast<uint64_t>(976u), controller.GetDelay(&env, 2, 1000u));
+
+  // A new token changes the rate, without resetting the bucket
+  auto delay_token_3 = controller.GetDelayToken(2, 500000u);
+  delay_token_1.reset();
+  ASSERT_EQ(static_cast<uint64_t>(3952u), controller.GetDelay(&env, 2, 1000u));
+
+  stop_token.reset();
+  delay_token_2.reset();
+  delay_token_3.reset();
+  ASSERT_FALSE(controller.HasColumnFamilyStalls());
+  ASSERT_FALSE(controller.NeedsDelay(2));
+  ASSERT_EQ(static_cast<uint64_t>(0), controller.GetDelay(&env, 2, 1000u));
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
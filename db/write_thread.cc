@@ -4,6 +4,7 @@
 //  (found in the LICENSE.Apache file in the root directory).
 
 #include "db/write_thread.h"
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include "db/column_family.h"
@@ -21,6 +22,12 @@ WriteThread::WriteThread(const ImmutableDBOptions& db_options)
       allow_concurrent_memtable_write_(
           db_options.allow_concurrent_memtable_write),
       enable_pipelined_write_(db_options.enable_pipelined_write),
+      max_write_batch_group_size_bytes_(static_cast<size_t>(
+          db_options.max_write_batch_group_size_bytes)),
+      adaptive_write_batch_group_size_(
+          db_options.adaptive_write_batch_group_size),
+      avg_wal_write_bytes_per_sec_(0),
+      avg_wal_sync_micros_(0),
       newest_writer_(nullptr),
       newest_memtable_writer_(nullptr),
       last_sequence_(0) {}
@@ -320,6 +327,56 @@ void WriteThread::JoinBatchGroup(Writer* w) {
   }
 }
 
+size_t WriteThread::MaxWriteGroupSize(const Writer* leader,
+                                      size_t leader_size) const {
+  // Allow the group to grow up to a maximum size, but if the
+  // original write is small, limit the growth so we do not slow
+  // down the small write too much.
+  const size_t max_size = max_write_batch_group_size_bytes_;
+  size_t small_write_growth = max_size / 8;
+  if (adaptive_write_batch_group_size_) {
+    if (leader->sync) {
+      // The group is synced at once, so the leader pays little for the
+      // followers it takes
+      return max_size;
+    }
+    uint64_t bytes_per_sec =
+        avg_wal_write_bytes_per_sec_.load(std::memory_order_relaxed);
+    uint64_t sync_micros = avg_wal_sync_micros_.load(std::memory_order_relaxed);
+    if (bytes_per_sec > 0 && sync_micros > 0) {
+      // Writes already wait for WAL syncs of that length, so taking what the
+      // WAL appends in that time does not stand out in their latency
+      uint64_t growth = bytes_per_sec * sync_micros / 1000000;
+      growth = std::max<uint64_t>(growth, max_size / 64);
+      small_write_growth =
+          static_cast<size_t>(std::min<uint64_t>(growth, max_size / 2));
+    }
+  }
+  if (leader_size <= small_write_growth) {
+    return leader_size + small_write_growth;
+  }
+  return max_size;
+}
+
+namespace {
+// Exponential moving average giving 1/8 of the weight to the new sample
+void UpdateMovingAverage(std::atomic<uint64_t>* avg, uint64_t sample) {
+  uint64_t old_avg = avg->load(std::memory_order_relaxed);
+  avg->store(old_avg == 0 ? sample : old_avg - old_avg / 8 + sample / 8,
+             std::memory_order_relaxed);
+}
+}  // namespace
+
+void WriteThread::RecordWalWrite(size_t bytes, uint64_t micros) {
+  UpdateMovingAverage(
+      &avg_wal_write_bytes_per_sec_,
+      static_cast<uint64_t>(bytes) * 1000000 / std::max<uint64_t>(micros, 1));
+}
+
+void WriteThread::RecordWalSync(uint64_t micros) {
+  UpdateMovingAverage(&avg_wal_sync_micros_, std::max<uint64_t>(micros, 1));
+}
+
 size_t WriteThread::EnterAsBatchGroupLeader(Writer* leader,
                                             WriteGroup* write_group) {
   assert(leader->link_older == nullptr);
@@ -327,14 +384,7 @@ size_t WriteThread::EnterAsBatchGroupLeader(Writer* leader,
   assert(write_group != nullptr);
 
   size_t size = WriteBatchInternal::ByteSize(leader->batch);
-
-  // Allow the group to grow up to a maximum size, but if the
-  // original write is small, limit the growth so we do not slow
-  // down the small write too much.
-  size_t max_size = 1 << 20;
-  if (size <= (128 << 10)) {
-    max_size = size + (128 << 10);
-  }
+  size_t max_size = MaxWriteGroupSize(leader, size);
 
   leader->write_group = write_group;
   write_group->leader = leader;
@@ -410,9 +460,9 @@ void WriteThread::EnterAsMemTableWriter(Writer* leader,
   // Allow the group to grow up to a maximum size, but if the
   // original write is small, limit the growth so we do not slow
   // down the small write too much.
-  size_t max_size = 1 << 20;
-  if (size <= (128 << 10)) {
-    max_size = size + (128 << 10);
+  size_t max_size = max_write_batch_group_size_bytes_;
+  if (size <= max_size / 8) {
+    max_size = size + max_size / 8;
   }
 
   leader->write_group = write_group;
@@ -539,36 +589,7 @@ void WriteThread::ExitAsBatchGroupLeader(WriteGroup& write_group,
   }
 
   if (enable_pipelined_write_) {
-    // Notify writers don't write to memtable to exit.
-    for (Writer* w = last_writer; w != leader;) {
-      Writer* next = w->link_older;
-      w->status = status;
-      if (!w->ShouldWriteToMemtable()) {
-        CompleteFollower(w, write_group);
-      }
-      w = next;
-    }
-    if (!leader->ShouldWriteToMemtable()) {
-      CompleteLeader(write_group);
-    }
-    // Link the ramaining of the group to memtable writer list.
-    if (write_group.size > 0) {
-      if (LinkGroup(write_group, &newest_memtable_writer_)) {
-        // The leader can now be different from current writer.
-        SetState(write_group.leader, STATE_MEMTABLE_WRITER_LEADER);
-      }
-    }
-    // Reset newest_writer_ and wake up the next leader.
-    Writer* newest_writer = last_writer;
-    if (!newest_writer_.compare_exchange_strong(newest_writer, nullptr)) {
-      Writer* next_leader = newest_writer;
-      while (next_leader->link_older != last_writer) {
-        next_leader = next_leader->link_older;
-        assert(next_leader != nullptr);
-      }
-      next_leader->link_older = nullptr;
-      SetState(next_leader, STATE_GROUP_LEADER);
-    }
+    LinkToMemTableWriters(write_group, status, nullptr /* barrier */);
     AwaitState(leader, STATE_MEMTABLE_WRITER_LEADER |
                            STATE_PARALLEL_MEMTABLE_WRITER | STATE_COMPLETED,
                &eabgl_ctx);
@@ -619,6 +640,104 @@ void WriteThread::ExitAsBatchGroupLeader(WriteGroup& write_group,
 }
 
 static WriteThread::AdaptationContext eu_ctx("EnterUnbatched");
+void WriteThread::LinkToMemTableWriters(WriteGroup& write_group, Status status,
+                                        Writer* barrier) {
+  Writer* leader = write_group.leader;
+  Writer* last_writer = write_group.last_writer;
+
+  // Notify writers don't write to memtable to exit.
+  for (Writer* w = last_writer; w != leader;) {
+    Writer* next = w->link_older;
+    w->status = status;
+    if (!w->ShouldWriteToMemtable()) {
+      CompleteFollower(w, write_group);
+    }
+    w = next;
+  }
+  if (!leader->ShouldWriteToMemtable()) {
+    CompleteLeader(write_group);
+  }
+  // Link the ramaining of the group to memtable writer list.
+  if (write_group.size > 0) {
+    // Memtable writer groups stop at the barrier, since its batch is nullptr
+    if (barrier != nullptr &&
+        LinkOne(barrier, &newest_memtable_writer_)) {
+      SetState(barrier, STATE_MEMTABLE_WRITER_LEADER);
+    }
+    if (LinkGroup(write_group, &newest_memtable_writer_)) {
+      // The leader can now be different from current writer.
+      SetState(write_group.leader, STATE_MEMTABLE_WRITER_LEADER);
+    }
+  }
+  // Reset newest_writer_ and wake up the next leader.
+  Writer* newest_writer = last_writer;
+  if (!newest_writer_.compare_exchange_strong(newest_writer, nullptr)) {
+    Writer* next_leader = newest_writer;
+    while (next_leader->link_older != last_writer) {
+      next_leader = next_leader->link_older;
+      assert(next_leader != nullptr);
+    }
+    next_leader->link_older = nullptr;
+    SetState(next_leader, STATE_GROUP_LEADER);
+  }
+}
+
+void WriteThread::ExitAsStripedBatchGroupLeader(WriteGroup& write_group,
+                                                Status status,
+                                                Writer* barrier) {
+  assert(enable_pipelined_write_);
+  assert(barrier != nullptr && barrier->batch == nullptr);
+  assert(write_group.leader->link_older == nullptr);
+
+  // Propagate memtable write error to the whole group.
+  if (status.ok() && !write_group.status.ok()) {
+    status = write_group.status;
+  }
+  LinkToMemTableWriters(write_group, status, barrier);
+}
+
+static WriteThread::AdaptationContext ewssb_ctx("ExitWalStripeSyncBarrier");
+void WriteThread::ExitWalStripeSyncBarrier(Writer* w, Writer* barrier,
+                                           WriteGroup& write_group,
+                                           Status status) {
+  // Nothing but the barrier is linked if the whole group has completed
+  if (write_group.size > 0) {
+    AwaitState(barrier, STATE_MEMTABLE_WRITER_LEADER, &ewssb_ctx);
+    Writer* leader = write_group.leader;
+    Writer* last_writer = write_group.last_writer;
+    assert(leader->link_older == barrier);
+    if (status.ok()) {
+      leader->link_older = nullptr;
+      SetState(leader, STATE_MEMTABLE_WRITER_LEADER);
+    } else {
+      // Skip the memtable writes of the group
+      Writer* newest_writer = last_writer;
+      if (!newest_memtable_writer_.compare_exchange_strong(newest_writer,
+                                                           nullptr)) {
+        CreateMissingNewerLinks(newest_writer);
+        Writer* next_leader = last_writer->link_newer;
+        assert(next_leader != nullptr);
+        next_leader->link_older = nullptr;
+        SetState(next_leader, STATE_MEMTABLE_WRITER_LEADER);
+      }
+      Writer* writer = last_writer;
+      while (true) {
+        // Read link_older before the writer can be deallocated
+        Writer* next = writer->link_older;
+        writer->status = status;
+        SetState(writer, STATE_COMPLETED);
+        if (writer == leader) {
+          break;
+        }
+        writer = next;
+      }
+    }
+  }
+  AwaitState(w, STATE_MEMTABLE_WRITER_LEADER |
+                    STATE_PARALLEL_MEMTABLE_WRITER | STATE_COMPLETED,
+             &eabgl_ctx);
+}
+
 void WriteThread::EnterUnbatched(Writer* w, InstrumentedMutex* mu) {
   assert(w != nullptr && w->batch == nullptr);
   mu->Unlock();
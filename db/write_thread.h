@@ -284,6 +284,26 @@ class WriteThread {
   // Exit batch group on behalf of batch group leader.
   void ExitAsBatchGroupFollower(Writer* w);
 
+  // With WAL stripes (see DBOptions::wal_stripes), exits as the pipelined
+  // WAL writer group leader without waiting for the memtable writes, so that
+  // the group can sync its stripes while the next leader appends to the WAL.
+  // barrier is linked to the memtable writer list ahead of the group, which
+  // keeps the group from being written to memtable until
+  // ExitWalStripeSyncBarrier() is called.
+  //
+  // WriteGroup* write_group: the write group
+  // Status status:           Status of write operation
+  // Writer* barrier:         A default constructed Writer
+  void ExitAsStripedBatchGroupLeader(WriteGroup& write_group, Status status,
+                                     Writer* barrier);
+
+  // Waits for the writers ahead of barrier to be written to memtable, then
+  // lets the group write to memtable, or completes it with status if status
+  // is not OK. Then waits for w, the former WAL writer group leader, as
+  // ExitAsBatchGroupLeader does.
+  void ExitWalStripeSyncBarrier(Writer* w, Writer* barrier,
+                                WriteGroup& write_group, Status status);
+
   // Constructs a write batch group led by leader from newest_memtable_writers_
   // list. The leader should either write memtable for the whole group and
   // call ExitAsMemTableWriter, or launch parallel memtable write through
@@ -325,6 +345,12 @@ class WriteThread {
   // write is enabled.
   void WaitForMemTableWriters();
 
+  // Report how long appending bytes bytes of a write group to the WAL took,
+  // and how long a WAL sync took, to adapt the size of the next write
+  // groups. Concurrent calls may lose a sample, which is harmless.
+  void RecordWalWrite(size_t bytes, uint64_t micros);
+  void RecordWalSync(uint64_t micros);
+
   SequenceNumber UpdateLastSequence(SequenceNumber sequence) {
     if (sequence > last_sequence_) {
       last_sequence_ = sequence;
@@ -343,6 +369,16 @@ class WriteThread {
   // Enable pipelined write to WAL and memtable.
   const bool enable_pipelined_write_;
 
+  // See DBOptions::max_write_batch_group_size_bytes and
+  // DBOptions::adaptive_write_batch_group_size.
+  const size_t max_write_batch_group_size_bytes_;
+  const bool adaptive_write_batch_group_size_;
+
+  // Moving averages of the WAL throughput of write groups, and of the WAL
+  // sync latency, updated by RecordWalWrite(). 0 until measured.
+  std::atomic<uint64_t> avg_wal_write_bytes_per_sec_;
+  std::atomic<uint64_t> avg_wal_sync_micros_;
+
   // Points to the newest pending writer. Only leader can remove
   // elements, adding can be done lock-free by anybody.
   std::atomic<Writer*> newest_writer_;
@@ -378,6 +414,10 @@ class WriteThread {
   // directly into the leader position.
   bool LinkGroup(WriteGroup& write_group, std::atomic<Writer*>* newest_writer);
 
+  // Returns the maximum total byte size of the write group led by leader,
+  // whose batch is leader_size bytes.
+  size_t MaxWriteGroupSize(const Writer* leader, size_t leader_size) const;
+
   // Computes any missing link_newer links.  Should not be called
   // concurrently with itself.
   void CreateMissingNewerLinks(Writer* head);
@@ -389,6 +429,12 @@ class WriteThread {
   // Set a follower in write_group to completed state and remove it from the
   // write group.
   void CompleteFollower(Writer* w, WriteGroup& write_group);
+
+  // Links the memtable writers of a pipelined WAL write group to the memtable
+  // writer list, behind barrier if not nullptr, completes the others, and
+  // wakes up the next WAL writer group leader.
+  void LinkToMemTableWriters(WriteGroup& write_group, Status status,
+                             Writer* barrier);
 };
 
 }  // namespace rocksdb
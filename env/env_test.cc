@@ -731,6 +731,52 @@ TEST_F(EnvPosixTest, PositionedAppend) {
 }
 #endif  // !ROCKSDB_LITE
 
+TEST_F(EnvPosixTest, MultiRead) {
+  EnvOptions soptions;
+  std::string fname = test::TmpDir(env_) + "/testfile";
+  const size_t kFileSize = 64 * 1024;
+  Random rnd(301);
+  std::string data;
+  test::RandomString(&rnd, static_cast<int>(kFileSize), &data);
+  {
+    unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+    ASSERT_OK(wfile->Append(data));
+    ASSERT_OK(wfile->Close());
+  }
+
+  unique_ptr<RandomAccessFile> file;
+  ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+  // Out of order, with adjacent ranges, gaps, and ranges across and past
+  // the end of the file
+  const std::vector<std::pair<uint64_t, size_t>> ranges = {
+      {8192, 100},           {0, 4096},
+      {4096, 4096},          {kFileSize + 10, 10},
+      {kFileSize - 50, 100}, {kFileSize - 150, 100},
+      {12000, 1000},         {30000, 1}};
+  std::vector<ReadRequest> reqs(ranges.size());
+  std::vector<std::unique_ptr<char[]>> scratches;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    scratches.emplace_back(new char[ranges[i].second]);
+    reqs[i].offset = ranges[i].first;
+    reqs[i].len = ranges[i].second;
+    reqs[i].scratch = scratches.back().get();
+  }
+  ASSERT_OK(file->MultiRead(reqs.data(), reqs.size()));
+  for (const ReadRequest& req : reqs) {
+    ASSERT_OK(req.status);
+    size_t expected_len = 0;
+    if (req.offset < kFileSize) {
+      expected_len = std::min(req.len, kFileSize - req.offset);
+    }
+    ASSERT_EQ(expected_len, req.result.size()) << req.offset;
+    if (expected_len > 0) {
+      ASSERT_EQ(data.substr(req.offset, expected_len), req.result.ToString());
+    }
+  }
+  ASSERT_OK(env_->DeleteFile(fname));
+}
+
 // Only works in linux platforms
 TEST_P(EnvPosixTestWithParam, RandomAccessUniqueID) {
   // Create file.
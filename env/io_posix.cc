@@ -11,7 +11,10 @@
 #include "env/io_posix.h"
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <algorithm>
+#include <numeric>
+#include <vector>
 #if defined(OS_LINUX)
 #include <linux/fs.h>
 #endif
@@ -26,6 +29,7 @@
 #include <sys/statfs.h>
 #include <sys/syscall.h>
 #include <sys/sysmacros.h>
+#include <sys/uio.h>
 #endif
 #include "env/posix_logger.h"
 #include "monitoring/iostats_context_imp.h"
@@ -351,6 +355,110 @@ Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+#ifdef OS_LINUX
+namespace {
+// Reads the requests, which cover one contiguous range of the file in
+// order, with as few preadv() calls as possible.
+void PreadvContiguous(int fd, const std::string& filename,
+                      const std::vector<ReadRequest*>& reqs) {
+  std::vector<struct iovec> iovs(reqs.size());
+  size_t total = 0;
+  for (size_t i = 0; i < reqs.size(); ++i) {
+    iovs[i].iov_base = reqs[i]->scratch;
+    iovs[i].iov_len = reqs[i]->len;
+    total += reqs[i]->len;
+  }
+  const uint64_t offset = reqs[0]->offset;
+  Status s;
+  size_t done = 0;
+  size_t iov_idx = 0;
+  while (done < total) {
+    ssize_t r =
+        preadv(fd, &iovs[iov_idx], static_cast<int>(iovs.size() - iov_idx),
+               static_cast<off_t>(offset + done));
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      s = IOError("While preadv offset " + ToString(offset + done) + " len " +
+                      ToString(total - done),
+                  filename, errno);
+      break;
+    }
+    if (r == 0) {
+      // End of file
+      break;
+    }
+    done += r;
+    // Skip the buffers that were filled
+    size_t left = static_cast<size_t>(r);
+    while (left > 0) {
+      if (left >= iovs[iov_idx].iov_len) {
+        left -= iovs[iov_idx].iov_len;
+        iov_idx++;
+      } else {
+        iovs[iov_idx].iov_base =
+            static_cast<char*>(iovs[iov_idx].iov_base) + left;
+        iovs[iov_idx].iov_len -= left;
+        left = 0;
+      }
+    }
+  }
+  size_t pos = 0;
+  for (ReadRequest* req : reqs) {
+    req->status = s;
+    size_t len = 0;
+    if (s.ok() && done > pos) {
+      len = std::min(req->len, done - pos);
+    }
+    req->result = Slice(req->scratch, len);
+    pos += req->len;
+  }
+}
+}  // namespace
+#endif
+
+Status PosixRandomAccessFile::MultiRead(ReadRequest* reqs, size_t num_reqs) {
+  if (use_direct_io() || num_reqs < 2) {
+    return RandomAccessFile::MultiRead(reqs, num_reqs);
+  }
+  // Have the kernel start reading all ranges at once, so that the reads
+  // below mostly wait for I/O that is already in flight
+  for (size_t i = 0; i < num_reqs; ++i) {
+    Fadvise(fd_, static_cast<off_t>(reqs[i].offset), reqs[i].len,
+            POSIX_FADV_WILLNEED);
+  }
+#ifdef OS_LINUX
+  // Requests that are adjacent in the file are read with one system call
+  std::vector<size_t> order(num_reqs);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [reqs](size_t a, size_t b) {
+    return reqs[a].offset < reqs[b].offset;
+  });
+  std::vector<ReadRequest*> run;
+  for (size_t i = 0; i < num_reqs;) {
+    run.clear();
+    run.push_back(&reqs[order[i]]);
+    uint64_t next_offset = reqs[order[i]].offset + reqs[order[i]].len;
+    for (i++; i < num_reqs && run.size() < IOV_MAX &&
+              reqs[order[i]].offset == next_offset;
+         i++) {
+      run.push_back(&reqs[order[i]]);
+      next_offset += reqs[order[i]].len;
+    }
+    if (run.size() == 1) {
+      run[0]->status =
+          Read(run[0]->offset, run[0]->len, &run[0]->result, run[0]->scratch);
+    } else {
+      PreadvContiguous(fd_, filename_, run);
+    }
+  }
+  return Status::OK();
+#else
+  return RandomAccessFile::MultiRead(reqs, num_reqs);
+#endif
+}
+
 Status PosixRandomAccessFile::Prefetch(uint64_t offset, size_t n) {
   Status s;
   if (!use_direct_io()) {
@@ -54,6 +54,13 @@ enum CompactionPri : char {
   // and its size is the smallest. It in many cases can optimize write
   // amplification.
   kMinOverlappingRatio = 0x3,
+  // First compact files that are both read often and made up largely of
+  // deletion entries, i.e. the files in which reads spend the most time
+  // skipping obsolete data. Reads are counted from the sampled Get() and
+  // iterator reads of each file. Files that have not been read are picked
+  // as with kByCompensatedSize. Try this if range scans are slowed down by
+  // deleted keys in a few hot key ranges.
+  kReadHotDeletionsFirst = 0x4,
 };
 
 struct CompactionOptionsFIFO {
@@ -118,19 +125,34 @@ struct CompressionOptions {
   // Default: 0.
   uint32_t zstd_max_train_bytes;
 
+  // Number of threads used to compress the data blocks of a single SST file.
+  // With a value greater than 1, finished data blocks are compressed and
+  // checksummed by that many background threads owned by the table builder,
+  // while the thread adding keys writes the results in their original order.
+  // The resulting file is identical to one built with a single thread.
+  //
+  // Only takes effect for block-based tables using the kBinarySearch index
+  // and either no filter or a full (not block-based) filter. Otherwise
+  // blocks are compressed serially.
+  //
+  // Default: 1.
+  uint32_t parallel_threads;
+
   CompressionOptions()
       : window_bits(-14),
         level(-1),
         strategy(0),
         max_dict_bytes(0),
-        zstd_max_train_bytes(0) {}
+        zstd_max_train_bytes(0),
+        parallel_threads(1) {}
   CompressionOptions(int wbits, int _lev, int _strategy, int _max_dict_bytes,
                      int _zstd_max_train_bytes)
       : window_bits(wbits),
         level(_lev),
         strategy(_strategy),
         max_dict_bytes(_max_dict_bytes),
-        zstd_max_train_bytes(_zstd_max_train_bytes) {}
+        zstd_max_train_bytes(_zstd_max_train_bytes),
+        parallel_threads(1) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -216,8 +238,8 @@ struct AdvancedColumnFamilyOptions {
   //               Stored in transaction logs.
   // merged_value - Set when delta is applied on the previous value.
 
-  // Applicable only when inplace_update_support is true,
-  // this callback function is called at the time of updating the memtable
+  // Applicable only when inplace_update_support or inplace_update_atomic is
+  // true, this callback function is called at the time of updating the memtable
   // as part of a Put operation, lets say Put(key, delta_value). It allows the
   // 'delta_value' specified as part of the Put operation to be merged with
   // an 'existing_value' of the key in the database.
@@ -250,6 +272,27 @@ struct AdvancedColumnFamilyOptions {
                                    Slice delta_value,
                                    std::string* merged_value) = nullptr;
 
+  // Allows lock-free inplace updates of 8-byte values, such as counters.
+  // If this is true, Put(key, new_value) of an 8-byte new_value overwrites
+  // the existing_value with an atomic store iff
+  //   * key exists in current memtable
+  //   * existing_value for that key is a put of an 8-byte value
+  // With inplace_callback set, the callback is applied to a copy of such an
+  // existing_value, which is then swapped in with a compare-and-swap. The
+  // callback is retried on a fresh copy whenever another writer updated the
+  // value in the meantime, so it may run more than once for one Put().
+  // Other Puts are added to the memtable as usual.
+  //
+  // Unlike inplace_update_support, no locks are taken, and the option can be
+  // used with allow_concurrent_memtable_write. When several writers update
+  // the same key concurrently, the value left in the memtable may not be
+  // the one with the highest sequence number, unlike after recovering the
+  // writes from the WAL. The same caveats on point-in-time consistency as
+  // for inplace_update_support apply. The option is ignored with
+  // inplace_update_support.
+  // Default: false.
+  bool inplace_update_atomic = false;
+
   // if prefix_extractor is set and memtable_prefix_bloom_size_ratio is not 0,
   // create prefix bloom for memtable with the size of
   // write_buffer_size * memtable_prefix_bloom_size_ratio.
@@ -294,6 +337,18 @@ struct AdvancedColumnFamilyOptions {
   std::shared_ptr<const SliceTransform>
       memtable_insert_with_hint_prefix_extractor = nullptr;
 
+  // If true, the keys a write batch (or a write group, if the group is
+  // written to the memtable by a single thread) adds to a memtable are
+  // sorted and inserted in one pass, each insert starting from the position
+  // of the previous key rather than from the head of the memtable. This cuts
+  // the cost of inserting batches of many keys that are close to each other.
+  //
+  // Currently only the default skiplist based memtable takes advantage of
+  // the sorted insert. The option is ignored with inplace_update_support.
+  //
+  // Default: false
+  bool memtable_sorted_batch_insert = false;
+
   // Control locality of bloom filter probes to improve cache miss rate.
   // This option only applies to memtable prefix bloom and plaintable
   // prefix bloom. It essentially limits every bloom checking to one cache line.
@@ -438,6 +493,24 @@ struct AdvancedColumnFamilyOptions {
   // Default: false
   bool level_compaction_dynamic_level_bytes = false;
 
+  // Only for level compaction. If set to K > 1, the first K levels, counting
+  // L0, are compacted size-tiered as in universal compaction, while the
+  // levels below them stay leveled. Every L0 file and every non-empty level
+  // in 1..K-1 is one sorted run. Runs of similar size are merged, as decided
+  // by compaction_options_universal.size_ratio, min_merge_width and
+  // max_merge_width, once there are level0_file_num_compaction_trigger of
+  // them. Level K-1 is compacted into level K by size like any other level.
+  //
+  // This saves the write amplification of repeatedly merging small L0
+  // compactions into large upper levels on ingest-heavy column families,
+  // while the leveled bulk of the data keeps space amplification bounded.
+  //
+  // Ignored (set to 0) with level_compaction_dynamic_level_bytes, and
+  // limited to num_levels - 1.
+  //
+  // Default: 0 (all levels below L0 are leveled)
+  int level_compaction_tiered_levels = 0;
+
   // Default: 10.
   //
   // Dynamically changeable through SetOptions() API
@@ -570,6 +643,49 @@ struct AdvancedColumnFamilyOptions {
   // Default: false
   bool report_bg_io_stats = false;
 
+  // If true, values of at least min_blob_size bytes are moved out of the
+  // table files into blob files when memtables are flushed, and the table
+  // files keep a small index entry pointing into the blob file instead.
+  // Compactions then only rewrite the index entries, which cuts the write
+  // amplification of large values. Blob files live in the first of db_paths
+  // and are deleted once no table file references them anymore.
+  //
+  // Not supported together with a merge_operator, or in ROCKSDB_LITE.
+  // Compaction filters are not called on values stored in blob files.
+  //
+  // Default: false
+  bool enable_blob_files = false;
+
+  // Values smaller than this are kept in the table files.
+  //
+  // Default: 4KB
+  uint64_t min_blob_size = 4 << 10;
+
+  // A blob file is closed and a new one is started once it grows past this
+  // size.
+  //
+  // Default: 256MB
+  uint64_t blob_file_size = 256 << 20;
+
+  // Compression applied to each value stored in a blob file.
+  //
+  // Default: kNoCompression
+  CompressionType blob_compression_type;
+
+  // If true, compactions move the values still referenced in the oldest blob
+  // files to new blob files, so that the old files become unreferenced and
+  // can be deleted. Without it, a blob file is only deleted once every value
+  // in it has been overwritten or deleted and compacted away.
+  //
+  // Default: false
+  bool enable_blob_garbage_collection = false;
+
+  // The fraction of blob files, oldest first, whose values are moved by
+  // compactions when enable_blob_garbage_collection is set.
+  //
+  // Default: 0.25
+  double blob_garbage_collection_age_cutoff = 0.25;
+
   // Create ColumnFamilyOptions with default values for all fields
   AdvancedColumnFamilyOptions();
   // Create ColumnFamilyOptions from Options
@@ -0,0 +1,42 @@
+// Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <string>
+
+#include "rocksdb/status.h"
+
+namespace rocksdb {
+
+// CompactionService lets a DB hand the compactions it picks to another
+// process, e.g. on a different host, so that their CPU and IO are not spent
+// next to latency sensitive reads and writes.
+//
+// The DB serializes each compaction (input files, output level, compression,
+// snapshots) and passes it to Run(). The implementation is expected to ship
+// the input to a worker that can read the DB's files and calls
+// DB::OpenAndCompact() with it, then return the worker's serialized result.
+// The DB moves the output files named in the result into its own directory
+// and installs them in place of the inputs. Trivial moves, deletion-only
+// (FIFO) compactions, and compactions of column families with blob files or
+// of WritePrepared transaction DBs are still done locally.
+class CompactionService {
+ public:
+  virtual ~CompactionService() {}
+
+  // Returns a name that identifies this compaction service.
+  virtual const char* Name() const = 0;
+
+  // Executes the compaction described by `compaction_service_input` and
+  // stores the output of the worker's DB::OpenAndCompact() call in
+  // `compaction_service_result`. Called from a DB background thread, which
+  // blocks until Run() returns. A non-OK status fails the compaction, and its
+  // input files stay in the DB to be compacted again later.
+  virtual Status Run(const std::string& compaction_service_input,
+                     std::string* compaction_service_result) = 0;
+};
+
+}  // namespace rocksdb
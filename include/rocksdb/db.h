@@ -11,6 +11,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -145,6 +146,20 @@ class DB {
       std::vector<ColumnFamilyHandle*>* handles, DB** dbptr,
       bool error_if_log_file_exist = false);
 
+  // Runs a compaction on behalf of the CompactionService of the DB at `name`.
+  // `input` is the serialized compaction passed to CompactionService::Run(),
+  // and on success `*result` is set to what Run() should return. The DB is
+  // opened read-only, so this may run in any process that can read the DB's
+  // files; `options` should match the options the DB was opened with. Output
+  // files are written to `output_directory`, from where the DB moves them
+  // into its own directory.
+  //
+  // Not supported in ROCKSDB_LITE, in which case the function will
+  // return Status::NotSupported.
+  static Status OpenAndCompact(const Options& options, const std::string& name,
+                               const std::string& output_directory,
+                               const std::string& input, std::string* result);
+
   // Open DB with column families.
   // db_options specify database specific options
   // column_families is the vector of all column families in the database,
@@ -301,6 +316,21 @@ class DB {
   // Note: consider setting options.sync = true.
   virtual Status Write(const WriteOptions& options, WriteBatch* updates) = 0;
 
+  // Like Write(), but returns as soon as the write is queued. callback is
+  // then called with the status Write() would have returned, once the
+  // updates are in the memtable and, with options.sync, durable in the WAL.
+  // It is called from one of the DB's async write threads (see
+  // DBOptions::async_write_threads), or from the calling thread if there
+  // are none, and should not block. A StackableDB writes in the calling
+  // thread, through its own Write(). updates must be kept alive and
+  // unchanged until callback is called.
+  // The pending writes are completed, and their callbacks called, before
+  // the DB is destroyed.
+  // Returns OK if the write is queued, in which case callback is called
+  // exactly once.
+  virtual Status WriteAsync(const WriteOptions& options, WriteBatch* updates,
+                            std::function<void(const Status&)> callback);
+
   // If the database contains an entry for "key" store the
   // corresponding value in *value and return OK.
   //
@@ -584,6 +614,16 @@ class DB {
     //  "rocksdb.is-write-stopped" - Return 1 if write has been stopped.
     static const std::string kIsWriteStopped;
 
+    //  "rocksdb.cf-write-stall-reason" - returns "normal" if the column
+    //      family doesn't need its writes to be stalled, or the stall and
+    //      what it's caused by, like "delayed: level-0 file count limit" or
+    //      "stopped: memtable limit".
+    static const std::string kCFWriteStallReason;
+
+    //  "rocksdb.cf-delayed-write-rate" - returns the delayed write rate that
+    //      the writes to the column family are held to. 0 means no delay.
+    static const std::string kCFDelayedWriteRate;
+
     //  "rocksdb.estimate-oldest-key-time" - returns an estimation of
     //      oldest key timestamp in the DB. Currently only available for
     //      FIFO compaction with
@@ -639,6 +679,7 @@ class DB {
   //  "rocksdb.num-running-flushes"
   //  "rocksdb.actual-delayed-write-rate"
   //  "rocksdb.is-write-stopped"
+  //  "rocksdb.cf-delayed-write-rate"
   //  "rocksdb.estimate-oldest-key-time"
   virtual bool GetIntProperty(ColumnFamilyHandle* column_family,
                               const Slice& property, uint64_t* value) = 0;
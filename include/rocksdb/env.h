@@ -510,6 +510,27 @@ class SequentialFile {
   }
 };
 
+// A request for RandomAccessFile::MultiRead()
+struct ReadRequest {
+  // File offset in bytes
+  uint64_t offset;
+
+  // Length to read in bytes
+  size_t len;
+
+  // A buffer of at least len bytes that MultiRead() can read data into
+  char* scratch;
+
+  // Output parameter set by MultiRead() to the data read, as Read() sets
+  // its result
+  Slice result;
+
+  // Output parameter set by MultiRead() to the status of this read
+  Status status;
+
+  ReadRequest() : offset(0), len(0), scratch(nullptr) {}
+};
+
 // A file abstraction for randomly reading the contents of a file.
 class RandomAccessFile {
  public:
@@ -530,6 +551,24 @@ class RandomAccessFile {
   virtual Status Read(uint64_t offset, size_t n, Slice* result,
                       char* scratch) const = 0;
 
+  // Reads a batch of non-overlapping ranges, each described by one of
+  // reqs[0..num_reqs-1], and sets the result and status of every request.
+  // Implementations may issue the reads in parallel and in any order, but
+  // return only once all of them are done. The returned status is for
+  // errors that prevented processing the batch at all, in which case the
+  // status of the individual requests is not meaningful.
+  //
+  // Safe for concurrent use by multiple threads.
+  // If Direct I/O enabled, offset, len, and scratch of every request should
+  // be aligned properly.
+  virtual Status MultiRead(ReadRequest* reqs, size_t num_reqs) {
+    for (size_t i = 0; i < num_reqs; ++i) {
+      ReadRequest& req = reqs[i];
+      req.status = Read(req.offset, req.len, &req.result, req.scratch);
+    }
+    return Status::OK();
+  }
+
   // Readahead the file starting from offset by n bytes for caching.
   virtual Status Prefetch(uint64_t offset, size_t n) {
     return Status::OK();
@@ -147,6 +147,47 @@ class FilterPolicy {
 // trailing spaces in keys.
 extern const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
     bool use_block_based_builder = true);
+
+// Return a new filter policy that builds full filters in a cache-local
+// format: every key is mapped to a single 64-byte cache line that holds all
+// of its probe bits, and the probes are checked together with SIMD
+// instructions where available (AVX2). Compared to NewBloomFilterPolicy(),
+// a filter query touches only one cache line, and the false positive rate
+// is a bit lower at the same memory.
+//
+// bits_per_key: bits per key in the filter, which need not be an integer.
+// It is sanitized to [1, 100]. 10 yields a false positive rate of about
+// 0.95%.
+//
+// The policy only affects full filters (including partitioned ones);
+// block-based filters are built as by NewBloomFilterPolicy(). Filters of
+// both formats can be read by either policy, so switching between them does
+// not require rewriting existing files. The filters are stored under the
+// name "rocksdb.CacheLocalBloomFilter", so releases without this format read
+// its tables without using the filters.
+//
+// The same restrictions on custom comparators as for NewBloomFilterPolicy()
+// apply.
+extern const FilterPolicy* NewCacheLocalBloomFilterPolicy(double bits_per_key);
+
+// Return a new filter policy that builds full filters as static xor filters
+// instead of Bloom filters. Such a filter can only be built once all of its
+// keys are known, which is the case for the full and partitioned filters of
+// block-based tables, and takes less space for the same false positive rate.
+//
+// bloom_equivalent_bits_per_key: the false positive rate is about the one of
+// a Bloom filter with this many bits per key, e.g. 0.8% for 10, while the
+// filter takes about 14% less space than NewBloomFilterPolicy() and
+// NewCacheLocalBloomFilterPolicy() with the same setting (8.6 instead of 10
+// bits per key). Building a filter takes more CPU and temporary memory than
+// building a Bloom filter, and a query touches three cache lines.
+//
+// Block-based filters are built as by NewBloomFilterPolicy(). As with
+// NewCacheLocalBloomFilterPolicy(), all formats can be read by any of these
+// policies. The filters are stored under the name "rocksdb.XorFilter", so
+// releases without this format read its tables without using the filters.
+extern const FilterPolicy* NewXorFilterPolicy(
+    double bloom_equivalent_bits_per_key);
 }
 
 #endif  // STORAGE_ROCKSDB_INCLUDE_FILTER_POLICY_H_
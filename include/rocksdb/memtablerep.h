@@ -104,6 +104,23 @@ class MemTableRep {
 #endif
   }
 
+  // Inserts count handles, which are sorted in increasing key order, as if
+  // by calling Insert() (or InsertConcurrently() if concurrently is true) for
+  // each of them. Implementations can use the order to insert a batch of
+  // nearby keys faster.
+  //
+  // Currently only the skip-list based memtable takes advantage of the order.
+  virtual void InsertSorted(KeyHandle* handles, size_t count,
+                            bool concurrently) {
+    for (size_t i = 0; i < count; i++) {
+      if (concurrently) {
+        InsertConcurrently(handles[i]);
+      } else {
+        Insert(handles[i]);
+      }
+    }
+  }
+
   // Returns true iff an entry that compares equal to key is in the collection.
   virtual bool Contains(const char* key) const = 0;
 
@@ -34,6 +34,7 @@ namespace rocksdb {
 class Cache;
 class CompactionFilter;
 class CompactionFilterFactory;
+class CompactionService;
 class Comparator;
 class Env;
 enum InfoLogLevel : unsigned char;
@@ -678,6 +679,17 @@ struct DBOptions {
   // Default: 0
   size_t compaction_readahead_size = 0;
 
+  // If true, the readahead of iterators with ReadOptions::readahead_size set
+  // and of compaction inputs with compaction_readahead_size set is
+  // asynchronous: once about half of a readahead buffer has been consumed,
+  // the next chunk is read into a second buffer by a background thread, so
+  // that sequential scans and compactions do not stall on every chunk.
+  // Uses a small pool of threads shared by all DBs in the process, and
+  // twice the readahead buffer memory.
+  //
+  // Default: false
+  bool async_readahead = false;
+
   // This is a maximum buffer size that is used by WinMmapReadableFile in
   // unbuffered disk I/O mode. We need to maintain an aligned buffer for
   // reads. We allow the buffer to grow until the specified value and then
@@ -763,6 +775,17 @@ struct DBOptions {
   // Default: 0
   uint64_t delayed_write_rate = 0;
 
+  // If true, a column family that needs its writes to be stopped or delayed
+  // only stalls the writes to itself, instead of all the writes to the DB.
+  // Each delayed column family gets its own write rate, starting from
+  // delayed_write_rate, which its writes are smoothly spread out under.
+  // The stall of a column family can be queried with the
+  // "rocksdb.cf-write-stall-reason" and "rocksdb.cf-delayed-write-rate"
+  // properties.
+  //
+  // Default: false
+  bool per_column_family_write_stall = false;
+
   // By default, a single write thread queue is maintained. The thread gets
   // to the head of the queue becomes write batch group leader and responsible
   // for writing to WAL and memtable for the batch group.
@@ -778,9 +801,59 @@ struct DBOptions {
   // Default: false
   bool enable_pipelined_write = false;
 
+  // If greater than 1, the WAL is striped over this many log files, which
+  // are written concurrently. Each pipelined WAL write group appends to one
+  // of them and syncs it after the next group has taken over, so that sync
+  // writes from different groups can be synced in parallel. A write is still
+  // only acknowledged and visible after all the writes with smaller sequence
+  // numbers. On recovery the records of the log files are merged in
+  // sequence number order, up to the first missing or corrupted one.
+  //
+  // Requires enable_pipelined_write and is not compatible with allow_2pc,
+  // two_write_queues, manual_wal_flush or wal_filter; recycle_log_file_num
+  // is ignored. The logs written with more than one stripe are only
+  // recovered by a DB opened with more than one stripe; opening them with a
+  // single one fails with Status::Corruption.
+  // GetUpdatesSince() is not supported.
+  //
+  // Default: 1
+  size_t wal_stripes = 1;
+
+  // If non-zero, a dedicated thread syncs the WAL every
+  // wal_sync_interval_micros microseconds if it has been written to, and
+  // sooner once wal_sync_interval_bytes bytes have been written since the
+  // last sync. Writes with WriteOptions::sync then no longer sync the WAL
+  // themselves: they are written to the WAL and the memtable like other
+  // writes, which makes them visible to reads before they are durable, and
+  // return once that thread has synced the WAL past them. This bounds the
+  // latency of sync writes by about wal_sync_interval_micros plus a sync,
+  // with at most one sync per interval.
+  //
+  // Not compatible with allow_2pc, two_write_queues, manual_wal_flush,
+  // wal_stripes or allow_mmap_writes.
+  //
+  // Default: 0, turned off
+  uint64_t wal_sync_interval_micros = 0;
+
+  // See wal_sync_interval_micros. 0 means no byte threshold.
+  //
+  // Default: 0
+  uint64_t wal_sync_interval_bytes = 0;
+
+  // Compression of the records of new WAL files. The records of a file are
+  // compressed as one stream, so that records also compress well against the
+  // records before them. Only kZSTD is supported. Not compatible with
+  // recycle_log_file_num > 0. Older versions of RocksDB can't read compressed
+  // WAL files.
+  //
+  // Default: kNoCompression
+  CompressionType wal_compression = kNoCompression;
+
   // If true, allow multi-writers to update mem tables in parallel.
   // Only some memtable_factory-s support concurrent writes; currently it
-  // is implemented only for SkipListFactory.  Concurrent memtable writes
+  // is implemented for SkipListFactory, and for the prefix hash memtables
+  // created by NewHashSkipListRepFactory() and NewHashLinkListRepFactory(),
+  // which latch their buckets.  Concurrent memtable writes
   // are not compatible with inplace_update_support or filter_deletes.
   // It is strongly recommended to set enable_write_thread_adaptive_yield
   // if you are going to use this feature.
@@ -815,6 +888,35 @@ struct DBOptions {
   // Default: 3
   uint64_t write_thread_slow_yield_usec = 3;
 
+  // The maximum total size of the write batches that a write group leader
+  // writes to the WAL at once. Unless adaptive_write_batch_group_size is
+  // set, a leader whose own batch is at most 1/8 of this limit only takes
+  // followers up to 1/8 of the limit on top of its own batch, so that a
+  // small write is not delayed much by the writes it carries.
+  //
+  // Default: 1MB
+  uint64_t max_write_batch_group_size_bytes = 1 << 20;
+
+  // If true, the write group size limit is adapted to the observed WAL
+  // latencies instead of being fixed:
+  // - A group led by a sync write takes followers up to
+  //   max_write_batch_group_size_bytes whatever the size of the leader's
+  //   batch, since the whole group is synced at the cost of a single sync.
+  // - A small group leader that does not sync takes followers up to as many
+  //   bytes as the WAL appends, on average, in the time of a WAL sync. When
+  //   no WAL sync has been seen yet, the fixed limit above applies.
+  //
+  // Default: false
+  bool adaptive_write_batch_group_size = false;
+
+  // Number of threads of the DB doing the writes queued by DB::WriteAsync().
+  // They are started by the first WriteAsync() call. As many async writes
+  // as there are threads can be in a write group together. If 0,
+  // WriteAsync() writes in the calling thread.
+  //
+  // Default: 4
+  int async_write_threads = 4;
+
   // If true, then DB::Open() will not update the statistics used to optimize
   // compaction decision by loading table properties from many files.
   // Turning off this feature will improve DBOpen time especially in
@@ -910,6 +1012,15 @@ struct DBOptions {
   // relies on manual invocation of FlushWAL to write the WAL buffer to its
   // file.
   bool manual_wal_flush = false;
+
+  // If non-null, compactions that rewrite data are handed to this service to
+  // be executed outside of the DB, e.g. by another process that calls
+  // DB::OpenAndCompact(). The output files are then moved into the DB and
+  // installed. See rocksdb/compaction_service.h for the compactions that
+  // still run locally.
+  //
+  // Default: nullptr
+  std::shared_ptr<CompactionService> compaction_service = nullptr;
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -997,6 +1108,10 @@ struct ReadOptions {
   // If non-zero, NewIterator will create a new table reader which
   // performs reads of the given size. Using a large size (> 2MB) can
   // improve the performance of forward iteration on spinning disks.
+  // If zero, block-based table iterators read ahead on their own once they
+  // have read a few data blocks in file order, starting with 8KB and
+  // doubling the size on every further readahead up to 256KB. Seeking
+  // elsewhere in the file starts over.
   // Default: 0
   size_t readahead_size;
 
@@ -293,6 +293,12 @@ enum Tickers : uint32_t {
   // # of bytes in the blob files evicted because of BlobDB is full.
   BLOB_DB_FIFO_BYTES_EVICTED,
 
+  // # of bytes read ahead by table iterators that detected sequential access
+  // to data blocks (see ReadOptions::readahead_size).
+  PREFETCH_BYTES,
+  // # of those bytes that were dropped before the iterator read them.
+  PREFETCH_BYTES_WASTED,
+
   TICKER_ENUM_MAX
 };
 
@@ -430,6 +436,8 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {BLOB_DB_FIFO_NUM_FILES_EVICTED, "rocksdb.blobdb.fifo.num.files.evicted"},
     {BLOB_DB_FIFO_NUM_KEYS_EVICTED, "rocksdb.blobdb.fifo.num.keys.evicted"},
     {BLOB_DB_FIFO_BYTES_EVICTED, "rocksdb.blobdb.fifo.bytes.evicted"},
+    {PREFETCH_BYTES, "rocksdb.prefetch.bytes"},
+    {PREFETCH_BYTES_WASTED, "rocksdb.prefetch.bytes.wasted"},
 };
 
 /**
@@ -511,6 +519,12 @@ enum Histograms : uint32_t {
   // BlobDB decompression time.
   BLOB_DB_DECOMPRESSION_MICROS,
 
+  // Number of writes in a write group.
+  DB_WRITE_GROUP_SIZE,
+  // Time a write group leader takes to write its group, from forming the
+  // group to handing over to the next leader.
+  DB_WRITE_GROUP_MICROS,
+
   HISTOGRAM_ENUM_MAX,  // TODO(ldemailly): enforce HistogramsNameMap match
 };
 
@@ -560,6 +574,8 @@ const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
     {BLOB_DB_GC_MICROS, "rocksdb.blobdb.gc.micros"},
     {BLOB_DB_COMPRESSION_MICROS, "rocksdb.blobdb.compression.micros"},
     {BLOB_DB_DECOMPRESSION_MICROS, "rocksdb.blobdb.decompression.micros"},
+    {DB_WRITE_GROUP_SIZE, "rocksdb.db.write.group.size"},
+    {DB_WRITE_GROUP_MICROS, "rocksdb.db.write.group.micros"},
 };
 
 struct HistogramData {
@@ -93,6 +93,27 @@ struct BlockBasedTableOptions {
 
   IndexType index_type = kBinarySearch;
 
+  // The index type that will be used for the data blocks.
+  enum DataBlockIndexType : char {
+    // Binary search over the restart points of the block.
+    kDataBlockBinarySearch = 0,
+
+    // Additionally append a hash map from user key to restart interval to
+    // each data block. Get() then jumps straight to the restart interval
+    // holding the key and falls back to binary search on hash collisions.
+    // Requires a comparator that only treats byte-wise equal user keys as
+    // equal. Files written with this option cannot be read by versions
+    // without the data block hash index.
+    kDataBlockBinaryAndHash = 1,
+  };
+
+  DataBlockIndexType data_block_index_type = kDataBlockBinarySearch;
+
+  // #entries/#buckets of the data block hash index. Only used when
+  // data_block_index_type is kDataBlockBinaryAndHash. A lower ratio means
+  // fewer collisions but more space.
+  double data_block_hash_table_util_ratio = 0.75;
+
   // This option is now deprecated. No matter what value it is set to,
   // it will behave as if hash_index_allow_collision=true.
   bool hash_index_allow_collision = true;
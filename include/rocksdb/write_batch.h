@@ -38,6 +38,7 @@ class Slice;
 class ColumnFamilyHandle;
 struct SavePoints;
 struct SliceParts;
+struct UnownedValues;
 
 struct SavePoint {
   size_t size;  // size of rep_
@@ -80,6 +81,24 @@ class WriteBatch : public WriteBatchBase {
     return Put(nullptr, key, value);
   }
 
+  // Variant of Put() that only references the value instead of copying it
+  // into the batch. The value is written to the WAL and copied into the
+  // memtable straight from the caller's buffer, which saves a copy of large
+  // values. The buffer must stay alive and unchanged until the batch has
+  // been written to the DB, cleared or destroyed, which also holds for the
+  // copies of the batch. Data() is only available once the values have
+  // been copied with MaterializeUnownedValues().
+  Status PutUnowned(ColumnFamilyHandle* column_family, const Slice& key,
+                    const Slice& value);
+  Status PutUnowned(const Slice& key, const Slice& value) {
+    return PutUnowned(nullptr, key, value);
+  }
+
+  // Copies the values of PutUnowned() into the batch, which no longer
+  // references them afterwards. Must be called before Data() on a batch with
+  // such values, and before the batch is shared with other threads.
+  void MaterializeUnownedValues();
+
   using WriteBatchBase::Delete;
   // If the database contains a mapping for "key", erase it.  Else do nothing.
   Status Delete(ColumnFamilyHandle* column_family, const Slice& key) override;
@@ -274,11 +293,12 @@ class WriteBatch : public WriteBatchBase {
   };
   Status Iterate(Handler* handler) const;
 
-  // Retrieve the serialized version of this batch.
-  const std::string& Data() const { return rep_; }
+  // Retrieve the serialized version of this batch. Requires the values of
+  // PutUnowned() to be materialized, see MaterializeUnownedValues().
+  const std::string& Data() const;
 
   // Retrieve data size of the batch.
-  size_t GetDataSize() const { return rep_.size(); }
+  size_t GetDataSize() const;
 
   // Returns the number of updates in the batch
   int Count() const;
@@ -337,6 +357,9 @@ class WriteBatch : public WriteBatchBase {
   friend class WriteBatchWithIndex;
   SavePoints* save_points_;
 
+  // The values of PutUnowned(), which are not in rep_. Created on demand.
+  UnownedValues* unowned_values_;
+
   // When sending a WriteBatch through WriteImpl we might want to
   // specify that only the first x records of the batch be written to
   // the WAL.
@@ -2222,6 +2222,8 @@ class CompactionPriorityJni {
         return 0x2;
       case rocksdb::CompactionPri::kMinOverlappingRatio:
         return 0x3;
+      case rocksdb::CompactionPri::kReadHotDeletionsFirst:
+        return 0x4;
       default:
         return 0x0;  // undefined
     }
@@ -2240,6 +2242,8 @@ class CompactionPriorityJni {
         return rocksdb::CompactionPri::kOldestSmallestSeqFirst;
       case 0x3:
         return rocksdb::CompactionPri::kMinOverlappingRatio;
+      case 0x4:
+        return rocksdb::CompactionPri::kReadHotDeletionsFirst;
       default:
         // undefined/default
         return rocksdb::CompactionPri::kByCompensatedSize;
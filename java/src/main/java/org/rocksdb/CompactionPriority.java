@@ -33,7 +33,14 @@ public enum CompactionPriority {
    * and its size is the smallest. It in many cases can optimize write
    * amplification.
    */
-  MinOverlappingRatio((byte)0x3);
+  MinOverlappingRatio((byte)0x3),
+
+  /**
+   * First compact files that are both read often and made up largely of
+   * deletion entries. Files that have not been read are picked as with
+   * {@link #ByCompensatedSize}.
+   */
+  ReadHotDeletionsFirst((byte)0x4);
 
 
   private final byte value;
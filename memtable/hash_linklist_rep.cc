@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <mutex>
 #include "db/memtable.h"
 #include "memtable/skiplist.h"
 #include "monitoring/histogram.h"
@@ -18,10 +19,14 @@
 #include "rocksdb/slice_transform.h"
 #include "util/arena.h"
 #include "util/murmurhash.h"
+#include "util/mutexlock.h"
 
 namespace rocksdb {
 namespace {
 
+// Buckets beyond this many share their latches for concurrent inserts
+const size_t kMaxBucketLocks = 64;
+
 typedef const char* Key;
 typedef SkipList<Key, const MemTableRep::KeyComparator&> MemtableSkipList;
 typedef std::atomic<void*> Pointer;
@@ -42,7 +47,7 @@ struct BucketHeader {
     return num_entries.load(std::memory_order_relaxed);
   }
 
-  // REQUIRES: called from single-threaded Insert()
+  // REQUIRES: called from Insert(), which is single-threaded per bucket
   void IncNumEntries() {
     // Only one thread can do write at one time. No need to do atomic
     // incremental. Update it with relaxed load and store.
@@ -172,6 +177,8 @@ class HashLinkListRep : public MemTableRep {
 
   virtual void Insert(KeyHandle handle) override;
 
+  virtual void InsertConcurrently(KeyHandle handle) override;
+
   virtual bool Contains(const char* key) const override;
 
   virtual size_t ApproximateMemoryUsage() override;
@@ -207,6 +214,10 @@ class HashLinkListRep : public MemTableRep {
   int bucket_entries_logging_threshold_;
   bool if_log_bucket_dist_when_flash_;
 
+  // Latches the buckets, which only take a single writer at a time, for
+  // InsertConcurrently()
+  StripedSpinMutex bucket_locks_;
+
   bool LinkListContains(Node* head, const Slice& key) const;
 
   SkipListBucketHeader* GetSkipListBucketHeader(Pointer* first_next_pointer)
@@ -508,7 +519,8 @@ HashLinkListRep::HashLinkListRep(
       compare_(compare),
       logger_(logger),
       bucket_entries_logging_threshold_(bucket_entries_logging_threshold),
-      if_log_bucket_dist_when_flash_(if_log_bucket_dist_when_flash) {
+      if_log_bucket_dist_when_flash_(if_log_bucket_dist_when_flash),
+      bucket_locks_(std::min(bucket_size, kMaxBucketLocks)) {
   char* mem = allocator_->AllocateAligned(sizeof(Pointer) * bucket_size,
                                       huge_page_tlb_size, logger);
 
@@ -609,8 +621,8 @@ void HashLinkListRep::Insert(KeyHandle handle) {
       assert(header->GetNumEntries() > threshold_use_skiplist_);
       auto* skip_list_bucket_header =
           reinterpret_cast<SkipListBucketHeader*>(header);
-      // Only one thread can execute Insert() at one time. No need to do atomic
-      // incremental.
+      // Only one thread can execute Insert() on a bucket at one time. No need
+      // to do atomic incremental.
       skip_list_bucket_header->Counting_header.IncNumEntries();
       skip_list_bucket_header->skip_list.Insert(x->key);
       return;
@@ -693,6 +705,13 @@ void HashLinkListRep::Insert(KeyHandle handle) {
   }
 }
 
+void HashLinkListRep::InsertConcurrently(KeyHandle handle) {
+  Node* x = static_cast<Node*>(handle);
+  auto transformed = GetPrefix(GetLengthPrefixedSlice(x->key));
+  std::lock_guard<SpinMutex> guard(bucket_locks_.Get(GetHash(transformed)));
+  Insert(handle);
+}
+
 bool HashLinkListRep::Contains(const char* key) const {
   Slice internal_key = GetLengthPrefixedSlice(key);
 
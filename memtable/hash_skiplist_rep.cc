@@ -7,7 +7,9 @@
 #ifndef ROCKSDB_LITE
 #include "memtable/hash_skiplist_rep.h"
 
+#include <algorithm>
 #include <atomic>
+#include <mutex>
 
 #include "rocksdb/memtablerep.h"
 #include "util/arena.h"
@@ -15,12 +17,16 @@
 #include "rocksdb/slice_transform.h"
 #include "port/port.h"
 #include "util/murmurhash.h"
+#include "util/mutexlock.h"
 #include "db/memtable.h"
 #include "memtable/skiplist.h"
 
 namespace rocksdb {
 namespace {
 
+// Buckets beyond this many share their latches for concurrent inserts
+const size_t kMaxBucketLocks = 64;
+
 class HashSkipListRep : public MemTableRep {
  public:
   HashSkipListRep(const MemTableRep::KeyComparator& compare,
@@ -30,6 +36,8 @@ class HashSkipListRep : public MemTableRep {
 
   virtual void Insert(KeyHandle handle) override;
 
+  virtual void InsertConcurrently(KeyHandle handle) override;
+
   virtual bool Contains(const char* key) const override;
 
   virtual size_t ApproximateMemoryUsage() override;
@@ -65,6 +73,10 @@ class HashSkipListRep : public MemTableRep {
   // immutable after construction
   Allocator* const allocator_;
 
+  // Latches the buckets, which only take a single writer at a time, for
+  // InsertConcurrently()
+  StripedSpinMutex bucket_locks_;
+
   inline size_t GetHash(const Slice& slice) const {
     return MurmurHash(slice.data(), static_cast<int>(slice.size()), 0) %
            bucket_size_;
@@ -241,7 +253,8 @@ HashSkipListRep::HashSkipListRep(const MemTableRep::KeyComparator& compare,
       skiplist_branching_factor_(skiplist_branching_factor),
       transform_(transform),
       compare_(compare),
-      allocator_(allocator) {
+      allocator_(allocator),
+      bucket_locks_(std::min(bucket_size, kMaxBucketLocks)) {
   auto mem = allocator->AllocateAligned(
                sizeof(std::atomic<void*>) * bucket_size);
   buckets_ = new (mem) std::atomic<Bucket*>[bucket_size];
@@ -275,6 +288,13 @@ void HashSkipListRep::Insert(KeyHandle handle) {
   bucket->Insert(key);
 }
 
+void HashSkipListRep::InsertConcurrently(KeyHandle handle) {
+  auto* key = static_cast<char*>(handle);
+  auto transformed = transform_->Transform(UserKey(key));
+  std::lock_guard<SpinMutex> guard(bucket_locks_.Get(GetHash(transformed)));
+  Insert(handle);
+}
+
 bool HashSkipListRep::Contains(const char* key) const {
   auto transformed = transform_->Transform(UserKey(key));
   auto bucket = GetBucket(transformed);
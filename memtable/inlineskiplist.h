@@ -98,6 +98,17 @@ class InlineSkipList {
   // Like Insert, but external synchronization is not required.
   void InsertConcurrently(const char* key);
 
+  // Inserts n keys allocated by AllocateKey, sorted in increasing order.
+  // The search path found for each key is reused as the starting point for
+  // the next one, so a run of nearby keys costs O(log D) per key instead of
+  // O(log N), D being the number of nodes between consecutive keys. If
+  // UseCAS is true, external synchronization is not required.
+  //
+  // REQUIRES: nothing that compares equal to any of the keys is currently in
+  // the list.
+  template <bool UseCAS>
+  void InsertSorted(const char* const* keys, size_t n);
+
   // Inserts a node into the skip list.  key must have been allocated by
   // AllocateKey and then filled in by the caller.  If UseCAS is true,
   // then external synchronization is not required, otherwise this method
@@ -640,6 +651,21 @@ void InlineSkipList<Comparator>::InsertConcurrently(const char* key) {
   Insert<true>(key, &splice, false);
 }
 
+template <class Comparator>
+template <bool UseCAS>
+void InlineSkipList<Comparator>::InsertSorted(const char* const* keys,
+                                              size_t n) {
+  Node* prev[kMaxPossibleHeight];
+  Node* next[kMaxPossibleHeight];
+  Splice splice;
+  splice.prev_ = prev;
+  splice.next_ = next;
+  for (size_t i = 0; i < n; i++) {
+    assert(i == 0 || compare_(keys[i - 1], keys[i]) < 0);
+    Insert<UseCAS>(keys[i], &splice, true /* allow_partial_splice_fix */);
+  }
+}
+
 template <class Comparator>
 void InlineSkipList<Comparator>::InsertWithHint(const char* key, void** hint) {
   assert(hint != nullptr);
@@ -8,8 +8,11 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #include "memtable/inlineskiplist.h"
+#include <algorithm>
 #include <set>
 #include <unordered_set>
+#include <vector>
+#include "port/port.h"
 #include "rocksdb/env.h"
 #include "util/concurrent_arena.h"
 #include "util/hash.h"
@@ -61,6 +64,19 @@ class InlineSkipTest : public testing::Test {
     keys_.insert(key);
   }
 
+  template <bool UseCAS>
+  void InsertSorted(TestInlineSkipList* list, std::vector<Key> keys) {
+    std::sort(keys.begin(), keys.end());
+    std::vector<const char*> bufs;
+    for (Key key : keys) {
+      char* buf = list->AllocateKey(sizeof(Key));
+      memcpy(buf, &key, sizeof(Key));
+      bufs.push_back(buf);
+    }
+    list->InsertSorted<UseCAS>(bufs.data(), bufs.size());
+    keys_.insert(keys.begin(), keys.end());
+  }
+
   void Validate(TestInlineSkipList* list) {
     // Check keys exist.
     for (Key key : keys_) {
@@ -292,6 +308,76 @@ TEST_F(InlineSkipTest, InsertWithHint_CompatibleWithInsertWithoutHint) {
   Validate(&list);
 }
 
+TEST_F(InlineSkipTest, InsertSorted) {
+  const int kNumBatches = 500;
+  Random rnd(301);
+  Arena arena;
+  TestComparator cmp;
+  TestInlineSkipList list(cmp, &arena);
+  std::unordered_set<Key> used;
+  for (int i = 0; i < kNumBatches; i++) {
+    // Batches of nearby keys, of random keys, and single inserts in between
+    Key base = static_cast<Key>(rnd.Next()) << 20;
+    std::vector<Key> batch;
+    int batch_size = static_cast<int>(rnd.Uniform(100));
+    for (int j = 0; j < batch_size; j++) {
+      Key key = (i % 2 == 0) ? base + rnd.Uniform(1 << 20) : rnd.Next();
+      if (used.insert(key).second) {
+        batch.push_back(key);
+      }
+    }
+    InsertSorted<false>(&list, batch);
+    Key key = rnd.Next();
+    if (used.insert(key).second) {
+      Insert(&list, key);
+    }
+  }
+  Validate(&list);
+}
+
+TEST_F(InlineSkipTest, InsertSortedConcurrently) {
+  const int kNumThreads = 4;
+  const int kNumBatches = 200;
+  const int kBatchSize = 50;
+  ConcurrentArena arena;
+  TestComparator cmp;
+  TestInlineSkipList list(cmp, &arena);
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      Random rnd(t + 1);
+      for (int i = 0; i < kNumBatches; i++) {
+        // The threads insert interleaved keys of the same ranges
+        Key base = static_cast<Key>(rnd.Uniform(1000)) << 20;
+        std::vector<const char*> bufs;
+        for (int j = 0; j < kBatchSize; j++) {
+          Key key = base + (static_cast<Key>(i * kBatchSize + j) *
+                            kNumThreads + t);
+          char* buf = list.AllocateKey(sizeof(Key));
+          memcpy(buf, &key, sizeof(Key));
+          bufs.push_back(buf);
+        }
+        list.InsertSorted<true>(bufs.data(), bufs.size());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  list.TEST_Validate();
+
+  size_t count = 0;
+  TestInlineSkipList::Iterator iter(&list);
+  Key prev = 0;
+  for (iter.SeekToFirst(); iter.Valid(); iter.Next()) {
+    ASSERT_TRUE(count == 0 || prev < Decode(iter.key()));
+    prev = Decode(iter.key());
+    count++;
+  }
+  ASSERT_EQ(static_cast<size_t>(kNumThreads * kNumBatches * kBatchSize),
+            count);
+}
+
 // We want to make sure that with a single writer and multiple
 // concurrent readers (with no synchronization other than when a
 // reader's iterator is created), the reader always observes all the
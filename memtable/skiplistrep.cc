@@ -46,6 +46,16 @@ public:
     skip_list_.InsertConcurrently(static_cast<char*>(handle));
   }
 
+  virtual void InsertSorted(KeyHandle* handles, size_t count,
+                            bool concurrently) override {
+    const char* const* keys = reinterpret_cast<const char* const*>(handles);
+    if (concurrently) {
+      skip_list_.InsertSorted<true>(keys, count);
+    } else {
+      skip_list_.InsertSorted<false>(keys, count);
+    }
+  }
+
   // Returns true iff an entry that compares equal to key is in the list.
   virtual bool Contains(const char* key) const override {
     return skip_list_.Contains(key);
@@ -40,6 +40,7 @@ ImmutableCFOptions::ImmutableCFOptions(const ImmutableDBOptions& db_options,
           cf_options.max_write_buffer_number_to_maintain),
       inplace_update_support(cf_options.inplace_update_support),
       inplace_callback(cf_options.inplace_callback),
+      inplace_update_atomic(cf_options.inplace_update_atomic),
       info_log(db_options.info_log.get()),
       statistics(db_options.statistics.get()),
       rate_limiter(db_options.rate_limiter.get()),
@@ -52,6 +53,7 @@ ImmutableCFOptions::ImmutableCFOptions(const ImmutableDBOptions& db_options,
       table_properties_collector_factories(
           cf_options.table_properties_collector_factories),
       advise_random_on_open(db_options.advise_random_on_open),
+      async_readahead(db_options.async_readahead),
       bloom_locality(cf_options.bloom_locality),
       purge_redundant_kvs_while_flush(
           cf_options.purge_redundant_kvs_while_flush),
@@ -61,6 +63,7 @@ ImmutableCFOptions::ImmutableCFOptions(const ImmutableDBOptions& db_options,
       compression_opts(cf_options.compression_opts),
       level_compaction_dynamic_level_bytes(
           cf_options.level_compaction_dynamic_level_bytes),
+      level_compaction_tiered_levels(cf_options.level_compaction_tiered_levels),
       access_hint_on_compaction_start(
           db_options.access_hint_on_compaction_start),
       new_table_reader_for_compaction_inputs(
@@ -68,13 +71,21 @@ ImmutableCFOptions::ImmutableCFOptions(const ImmutableDBOptions& db_options,
       num_levels(cf_options.num_levels),
       optimize_filters_for_hits(cf_options.optimize_filters_for_hits),
       force_consistency_checks(cf_options.force_consistency_checks),
+      enable_blob_files(cf_options.enable_blob_files),
+      min_blob_size(cf_options.min_blob_size),
+      blob_file_size(cf_options.blob_file_size),
+      blob_compression_type(cf_options.blob_compression_type),
+      enable_blob_garbage_collection(cf_options.enable_blob_garbage_collection),
+      blob_garbage_collection_age_cutoff(
+          cf_options.blob_garbage_collection_age_cutoff),
       allow_ingest_behind(db_options.allow_ingest_behind),
       preserve_deletes(db_options.preserve_deletes),
       listeners(db_options.listeners),
       row_cache(db_options.row_cache),
       max_subcompactions(db_options.max_subcompactions),
       memtable_insert_with_hint_prefix_extractor(
-          cf_options.memtable_insert_with_hint_prefix_extractor.get()) {}
+          cf_options.memtable_insert_with_hint_prefix_extractor.get()),
+      memtable_sorted_batch_insert(cf_options.memtable_sorted_batch_insert) {}
 
 // Multiple two operands. If they overflow, return op1.
 uint64_t MultiplyCheckOverflow(uint64_t op1, double op2) {
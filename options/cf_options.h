@@ -54,6 +54,8 @@ struct ImmutableCFOptions {
                                    Slice delta_value,
                                    std::string* merged_value);
 
+  bool inplace_update_atomic;
+
   Logger* info_log;
 
   Statistics* statistics;
@@ -81,6 +83,8 @@ struct ImmutableCFOptions {
 
   bool advise_random_on_open;
 
+  bool async_readahead;
+
   // This options is required by PlainTableReader. May need to move it
   // to PlainTableOptions just like bloom_bits_per_key
   uint32_t bloom_locality;
@@ -97,6 +101,8 @@ struct ImmutableCFOptions {
 
   bool level_compaction_dynamic_level_bytes;
 
+  int level_compaction_tiered_levels;
+
   Options::AccessHint access_hint_on_compaction_start;
 
   bool new_table_reader_for_compaction_inputs;
@@ -107,6 +113,18 @@ struct ImmutableCFOptions {
 
   bool force_consistency_checks;
 
+  bool enable_blob_files;
+
+  uint64_t min_blob_size;
+
+  uint64_t blob_file_size;
+
+  CompressionType blob_compression_type;
+
+  bool enable_blob_garbage_collection;
+
+  double blob_garbage_collection_age_cutoff;
+
   bool allow_ingest_behind;
 
   bool preserve_deletes;
@@ -120,6 +138,8 @@ struct ImmutableCFOptions {
   uint32_t max_subcompactions;
 
   const SliceTransform* memtable_insert_with_hint_prefix_extractor;
+
+  bool memtable_sorted_batch_insert;
 };
 
 struct MutableCFOptions {
@@ -13,6 +13,7 @@
 
 #include "port/port.h"
 #include "rocksdb/cache.h"
+#include "rocksdb/compaction_service.h"
 #include "rocksdb/env.h"
 #include "rocksdb/sst_file_manager.h"
 #include "rocksdb/wal_filter.h"
@@ -62,16 +63,26 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       access_hint_on_compaction_start(options.access_hint_on_compaction_start),
       new_table_reader_for_compaction_inputs(
           options.new_table_reader_for_compaction_inputs),
+      async_readahead(options.async_readahead),
       random_access_max_buffer_size(options.random_access_max_buffer_size),
       use_adaptive_mutex(options.use_adaptive_mutex),
       listeners(options.listeners),
       enable_thread_tracking(options.enable_thread_tracking),
       enable_pipelined_write(options.enable_pipelined_write),
+      wal_stripes(options.wal_stripes),
+      wal_sync_interval_micros(options.wal_sync_interval_micros),
+      wal_sync_interval_bytes(options.wal_sync_interval_bytes),
+      wal_compression(options.wal_compression),
+      per_column_family_write_stall(options.per_column_family_write_stall),
       allow_concurrent_memtable_write(options.allow_concurrent_memtable_write),
       enable_write_thread_adaptive_yield(
           options.enable_write_thread_adaptive_yield),
       write_thread_max_yield_usec(options.write_thread_max_yield_usec),
       write_thread_slow_yield_usec(options.write_thread_slow_yield_usec),
+      max_write_batch_group_size_bytes(
+          options.max_write_batch_group_size_bytes),
+      adaptive_write_batch_group_size(options.adaptive_write_batch_group_size),
+      async_write_threads(options.async_write_threads),
       skip_stats_update_on_db_open(options.skip_stats_update_on_db_open),
       wal_recovery_mode(options.wal_recovery_mode),
       allow_2pc(options.allow_2pc),
@@ -85,7 +96,8 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       allow_ingest_behind(options.allow_ingest_behind),
       preserve_deletes(options.preserve_deletes),
       two_write_queues(options.two_write_queues),
-      manual_wal_flush(options.manual_wal_flush) {
+      manual_wal_flush(options.manual_wal_flush),
+      compaction_service(options.compaction_service) {
 }
 
 void ImmutableDBOptions::Dump(Logger* log) const {
@@ -167,6 +179,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    static_cast<int>(access_hint_on_compaction_start));
   ROCKS_LOG_HEADER(log, " Options.new_table_reader_for_compaction_inputs: %d",
                    new_table_reader_for_compaction_inputs);
+  ROCKS_LOG_HEADER(log, "                        Options.async_readahead: %d",
+                   async_readahead);
   ROCKS_LOG_HEADER(
       log, "          Options.random_access_max_buffer_size: %" ROCKSDB_PRIszt,
       random_access_max_buffer_size);
@@ -183,6 +197,19 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    enable_thread_tracking);
   ROCKS_LOG_HEADER(log, "                 Options.enable_pipelined_write: %d",
                    enable_pipelined_write);
+  ROCKS_LOG_HEADER(
+      log, "                            Options.wal_stripes: %" ROCKSDB_PRIszt,
+      wal_stripes);
+  ROCKS_LOG_HEADER(log,
+                   "               Options.wal_sync_interval_micros: %" PRIu64,
+                   wal_sync_interval_micros);
+  ROCKS_LOG_HEADER(log,
+                   "                Options.wal_sync_interval_bytes: %" PRIu64,
+                   wal_sync_interval_bytes);
+  ROCKS_LOG_HEADER(log, "                        Options.wal_compression: %d",
+                   static_cast<int>(wal_compression));
+  ROCKS_LOG_HEADER(log, "          Options.per_column_family_write_stall: %d",
+                   per_column_family_write_stall);
   ROCKS_LOG_HEADER(log, "        Options.allow_concurrent_memtable_write: %d",
                    allow_concurrent_memtable_write);
   ROCKS_LOG_HEADER(log, "     Options.enable_write_thread_adaptive_yield: %d",
@@ -193,6 +220,13 @@ void ImmutableDBOptions::Dump(Logger* log) const {
   ROCKS_LOG_HEADER(log,
                    "           Options.write_thread_slow_yield_usec: %" PRIu64,
                    write_thread_slow_yield_usec);
+  ROCKS_LOG_HEADER(log,
+                   "       Options.max_write_batch_group_size_bytes: %" PRIu64,
+                   max_write_batch_group_size_bytes);
+  ROCKS_LOG_HEADER(log, "        Options.adaptive_write_batch_group_size: %d",
+                   adaptive_write_batch_group_size);
+  ROCKS_LOG_HEADER(log, "                    Options.async_write_threads: %d",
+                   async_write_threads);
   if (row_cache) {
     ROCKS_LOG_HEADER(
         log, "                              Options.row_cache: %" PRIu64,
@@ -216,6 +250,8 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    two_write_queues);
   ROCKS_LOG_HEADER(log, "            Options.manual_wal_flush: %d",
                    manual_wal_flush);
+  ROCKS_LOG_HEADER(log, "            Options.compaction_service: %s",
+                   compaction_service ? compaction_service->Name() : "None");
 }
 
 MutableDBOptions::MutableDBOptions()
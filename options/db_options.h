@@ -55,15 +55,24 @@ struct ImmutableDBOptions {
   std::shared_ptr<WriteBufferManager> write_buffer_manager;
   DBOptions::AccessHint access_hint_on_compaction_start;
   bool new_table_reader_for_compaction_inputs;
+  bool async_readahead;
   size_t random_access_max_buffer_size;
   bool use_adaptive_mutex;
   std::vector<std::shared_ptr<EventListener>> listeners;
   bool enable_thread_tracking;
   bool enable_pipelined_write;
+  size_t wal_stripes;
+  uint64_t wal_sync_interval_micros;
+  uint64_t wal_sync_interval_bytes;
+  CompressionType wal_compression;
+  bool per_column_family_write_stall;
   bool allow_concurrent_memtable_write;
   bool enable_write_thread_adaptive_yield;
   uint64_t write_thread_max_yield_usec;
   uint64_t write_thread_slow_yield_usec;
+  uint64_t max_write_batch_group_size_bytes;
+  bool adaptive_write_batch_group_size;
+  int async_write_threads;
   bool skip_stats_update_on_db_open;
   WALRecoveryMode wal_recovery_mode;
   bool allow_2pc;
@@ -78,6 +87,7 @@ struct ImmutableDBOptions {
   bool preserve_deletes;
   bool two_write_queues;
   bool manual_wal_flush;
+  std::shared_ptr<CompactionService> compaction_service;
 };
 
 struct MutableDBOptions {
@@ -36,7 +36,8 @@
 
 namespace rocksdb {
 
-AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions() {
+AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions()
+    : blob_compression_type(kNoCompression) {
   assert(memtable_factory.get() != nullptr);
 }
 
@@ -49,11 +50,13 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       inplace_update_support(options.inplace_update_support),
       inplace_update_num_locks(options.inplace_update_num_locks),
       inplace_callback(options.inplace_callback),
+      inplace_update_atomic(options.inplace_update_atomic),
       memtable_prefix_bloom_size_ratio(
           options.memtable_prefix_bloom_size_ratio),
       memtable_huge_page_size(options.memtable_huge_page_size),
       memtable_insert_with_hint_prefix_extractor(
           options.memtable_insert_with_hint_prefix_extractor),
+      memtable_sorted_batch_insert(options.memtable_sorted_batch_insert),
       bloom_locality(options.bloom_locality),
       arena_block_size(options.arena_block_size),
       compression_per_level(options.compression_per_level),
@@ -64,6 +67,7 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       target_file_size_multiplier(options.target_file_size_multiplier),
       level_compaction_dynamic_level_bytes(
           options.level_compaction_dynamic_level_bytes),
+      level_compaction_tiered_levels(options.level_compaction_tiered_levels),
       max_bytes_for_level_multiplier(options.max_bytes_for_level_multiplier),
       max_bytes_for_level_multiplier_additional(
           options.max_bytes_for_level_multiplier_additional),
@@ -85,7 +89,14 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       optimize_filters_for_hits(options.optimize_filters_for_hits),
       paranoid_file_checks(options.paranoid_file_checks),
       force_consistency_checks(options.force_consistency_checks),
-      report_bg_io_stats(options.report_bg_io_stats) {
+      report_bg_io_stats(options.report_bg_io_stats),
+      enable_blob_files(options.enable_blob_files),
+      min_blob_size(options.min_blob_size),
+      blob_file_size(options.blob_file_size),
+      blob_compression_type(options.blob_compression_type),
+      enable_blob_garbage_collection(options.enable_blob_garbage_collection),
+      blob_garbage_collection_age_cutoff(
+          options.blob_garbage_collection_age_cutoff) {
   assert(memtable_factory.get() != nullptr);
   if (max_bytes_for_level_multiplier_additional.size() <
       static_cast<unsigned int>(num_levels)) {
@@ -153,6 +164,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                      memtable_insert_with_hint_prefix_extractor == nullptr
                          ? "nullptr"
                          : memtable_insert_with_hint_prefix_extractor->Name());
+    ROCKS_LOG_HEADER(log,
+                     "                Options.memtable_sorted_batch_insert: %d",
+                     memtable_sorted_batch_insert);
     ROCKS_LOG_HEADER(log, "            Options.num_levels: %d", num_levels);
     ROCKS_LOG_HEADER(log, "       Options.min_write_buffer_number_to_merge: %d",
                      min_write_buffer_number_to_merge);
@@ -168,6 +182,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
         log,
         "        Options.compression_opts.max_dict_bytes: %" ROCKSDB_PRIszt,
         compression_opts.max_dict_bytes);
+    ROCKS_LOG_HEADER(log,
+                     "      Options.compression_opts.parallel_threads: %u",
+                     compression_opts.parallel_threads);
     ROCKS_LOG_HEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
                      level0_file_num_compaction_trigger);
     ROCKS_LOG_HEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -184,6 +201,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
         max_bytes_for_level_base);
     ROCKS_LOG_HEADER(log, "Options.level_compaction_dynamic_level_bytes: %d",
                      level_compaction_dynamic_level_bytes);
+    ROCKS_LOG_HEADER(log, "      Options.level_compaction_tiered_levels: %d",
+                     level_compaction_tiered_levels);
     ROCKS_LOG_HEADER(log, "         Options.max_bytes_for_level_multiplier: %f",
                      max_bytes_for_level_multiplier);
     for (size_t i = 0; i < max_bytes_for_level_multiplier_additional.size();
@@ -293,6 +312,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
         log,
         "                Options.inplace_update_num_locks: %" ROCKSDB_PRIszt,
         inplace_update_num_locks);
+    ROCKS_LOG_HEADER(log,
+                     "                   Options.inplace_update_atomic: %d",
+                     inplace_update_atomic);
     // TODO: easier config for bloom (maybe based on avg key/value size)
     ROCKS_LOG_HEADER(
         log, "              Options.memtable_prefix_bloom_size_ratio: %f",
@@ -317,6 +339,18 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                      force_consistency_checks);
     ROCKS_LOG_HEADER(log, "               Options.report_bg_io_stats: %d",
                      report_bg_io_stats);
+    ROCKS_LOG_HEADER(log, "                Options.enable_blob_files: %d",
+                     enable_blob_files);
+    ROCKS_LOG_HEADER(log, "                    Options.min_blob_size: %" PRIu64,
+                     min_blob_size);
+    ROCKS_LOG_HEADER(log, "                   Options.blob_file_size: %" PRIu64,
+                     blob_file_size);
+    ROCKS_LOG_HEADER(log, "            Options.blob_compression_type: %s",
+                     CompressionTypeToString(blob_compression_type).c_str());
+    ROCKS_LOG_HEADER(log, "   Options.enable_blob_garbage_collection: %d",
+                     enable_blob_garbage_collection);
+    ROCKS_LOG_HEADER(log, "Options.blob_garbage_collection_age_cutoff: %f",
+                     blob_garbage_collection_age_cutoff);
 }  // ColumnFamilyOptions::Dump
 
 void Options::Dump(Logger* log) const {
@@ -88,6 +88,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
       immutable_db_options.new_table_reader_for_compaction_inputs;
   options.compaction_readahead_size =
       mutable_db_options.compaction_readahead_size;
+  options.async_readahead = immutable_db_options.async_readahead;
   options.random_access_max_buffer_size =
       immutable_db_options.random_access_max_buffer_size;
   options.writable_file_max_buffer_size =
@@ -96,6 +97,13 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.listeners = immutable_db_options.listeners;
   options.enable_thread_tracking = immutable_db_options.enable_thread_tracking;
   options.delayed_write_rate = mutable_db_options.delayed_write_rate;
+  options.wal_stripes = immutable_db_options.wal_stripes;
+  options.wal_sync_interval_micros =
+      immutable_db_options.wal_sync_interval_micros;
+  options.wal_sync_interval_bytes = immutable_db_options.wal_sync_interval_bytes;
+  options.wal_compression = immutable_db_options.wal_compression;
+  options.per_column_family_write_stall =
+      immutable_db_options.per_column_family_write_stall;
   options.allow_concurrent_memtable_write =
       immutable_db_options.allow_concurrent_memtable_write;
   options.enable_write_thread_adaptive_yield =
@@ -104,6 +112,11 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
       immutable_db_options.write_thread_max_yield_usec;
   options.write_thread_slow_yield_usec =
       immutable_db_options.write_thread_slow_yield_usec;
+  options.max_write_batch_group_size_bytes =
+      immutable_db_options.max_write_batch_group_size_bytes;
+  options.adaptive_write_batch_group_size =
+      immutable_db_options.adaptive_write_batch_group_size;
+  options.async_write_threads = immutable_db_options.async_write_threads;
   options.skip_stats_update_on_db_open =
       immutable_db_options.skip_stats_update_on_db_open;
   options.wal_recovery_mode = immutable_db_options.wal_recovery_mode;
@@ -123,6 +136,7 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
       immutable_db_options.allow_ingest_behind;
   options.preserve_deletes =
       immutable_db_options.preserve_deletes;
+  options.compaction_service = immutable_db_options.compaction_service;
 
   return options;
 }
@@ -194,7 +208,8 @@ std::map<CompactionPri, std::string> OptionsHelper::compaction_pri_to_string = {
     {kByCompensatedSize, "kByCompensatedSize"},
     {kOldestLargestSeqFirst, "kOldestLargestSeqFirst"},
     {kOldestSmallestSeqFirst, "kOldestSmallestSeqFirst"},
-    {kMinOverlappingRatio, "kMinOverlappingRatio"}};
+    {kMinOverlappingRatio, "kMinOverlappingRatio"},
+    {kReadHotDeletionsFirst, "kReadHotDeletionsFirst"}};
 
 std::map<CompactionStopStyle, std::string>
     OptionsHelper::compaction_stop_style_to_string = {
@@ -466,6 +481,11 @@ bool ParseOptionHelper(char* opt_address, const OptionType& opt_type,
       return ParseEnum<BlockBasedTableOptions::IndexType>(
           block_base_table_index_type_string_map, value,
           reinterpret_cast<BlockBasedTableOptions::IndexType*>(opt_address));
+    case OptionType::kBlockBasedTableDataBlockIndexType:
+      return ParseEnum<BlockBasedTableOptions::DataBlockIndexType>(
+          block_base_table_data_block_index_type_string_map, value,
+          reinterpret_cast<BlockBasedTableOptions::DataBlockIndexType*>(
+              opt_address));
     case OptionType::kEncodingType:
       return ParseEnum<EncodingType>(
           encoding_type_string_map, value,
@@ -637,6 +657,12 @@ bool SerializeSingleOptionHelper(const char* opt_address,
           *reinterpret_cast<const BlockBasedTableOptions::IndexType*>(
               opt_address),
           value);
+    case OptionType::kBlockBasedTableDataBlockIndexType:
+      return SerializeEnum<BlockBasedTableOptions::DataBlockIndexType>(
+          block_base_table_data_block_index_type_string_map,
+          *reinterpret_cast<const BlockBasedTableOptions::DataBlockIndexType*>(
+              opt_address),
+          value);
     case OptionType::kFlushBlockPolicyFactory: {
       const auto* ptr =
           reinterpret_cast<const std::shared_ptr<FlushBlockPolicyFactory>*>(
@@ -887,9 +913,31 @@ Status ParseColumnFamilyOption(const std::string& name,
           return Status::InvalidArgument(
               "unable to parse the specified CF option " + name);
         }
+        end = value.find(':', start);
         new_options->compression_opts.max_dict_bytes =
             ParseInt(value.substr(start, value.size() - start));
       }
+      // zstd_max_train_bytes is optional for backwards compatibility
+      if (end != std::string::npos) {
+        start = end + 1;
+        if (start >= value.size()) {
+          return Status::InvalidArgument(
+              "unable to parse the specified CF option " + name);
+        }
+        end = value.find(':', start);
+        new_options->compression_opts.zstd_max_train_bytes =
+            ParseUint32(value.substr(start, value.size() - start));
+      }
+      // parallel_threads is optional for backwards compatibility
+      if (end != std::string::npos) {
+        start = end + 1;
+        if (start >= value.size()) {
+          return Status::InvalidArgument(
+              "unable to parse the specified CF option " + name);
+        }
+        new_options->compression_opts.parallel_threads =
+            ParseUint32(value.substr(start, value.size() - start));
+      }
     } else {
       auto iter = cf_options_type_info.find(name);
       if (iter == cf_options_type_info.end()) {
@@ -981,8 +1029,20 @@ Status GetStringFromDBOptions(std::string* opt_string,
 Status GetStringFromColumnFamilyOptions(std::string* opt_string,
                                         const ColumnFamilyOptions& cf_options,
                                         const std::string& delimiter) {
-  return GetStringFromStruct<ColumnFamilyOptions>(
+  Status s = GetStringFromStruct<ColumnFamilyOptions>(
       opt_string, cf_options, cf_options_type_info, delimiter);
+  if (s.ok()) {
+    // Not in cf_options_type_info, see ParseColumnFamilyOption(). Releases
+    // that parse fewer of the fields ignore the ones after them.
+    const CompressionOptions& opts = cf_options.compression_opts;
+    opt_string->append(
+        "compression_opts=" + ToString(opts.window_bits) + ":" +
+        ToString(opts.level) + ":" + ToString(opts.strategy) + ":" +
+        ToString(opts.max_dict_bytes) + ":" +
+        ToString(opts.zstd_max_train_bytes) + ":" +
+        ToString(opts.parallel_threads) + delimiter);
+  }
+  return s;
 }
 
 Status GetStringFromCompressionType(std::string* compression_str,
@@ -1299,6 +1359,10 @@ std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct DBOptions, compaction_readahead_size),
           OptionType::kSizeT, OptionVerificationType::kNormal, true,
           offsetof(struct MutableDBOptions, compaction_readahead_size)}},
+        {"async_readahead",
+         {offsetof(struct DBOptions, async_readahead), OptionType::kBoolean,
+          OptionVerificationType::kNormal, false,
+          offsetof(struct ImmutableDBOptions, async_readahead)}},
         {"random_access_max_buffer_size",
          {offsetof(struct DBOptions, random_access_max_buffer_size),
           OptionType::kSizeT, OptionVerificationType::kNormal, false, 0}},
@@ -1400,6 +1464,22 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"enable_pipelined_write",
          {offsetof(struct DBOptions, enable_pipelined_write),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"wal_stripes",
+         {offsetof(struct DBOptions, wal_stripes), OptionType::kSizeT,
+          OptionVerificationType::kNormal, false, 0}},
+        {"wal_sync_interval_micros",
+         {offsetof(struct DBOptions, wal_sync_interval_micros),
+          OptionType::kUInt64T, OptionVerificationType::kNormal, false, 0}},
+        {"wal_sync_interval_bytes",
+         {offsetof(struct DBOptions, wal_sync_interval_bytes),
+          OptionType::kUInt64T, OptionVerificationType::kNormal, false, 0}},
+        {"wal_compression",
+         {offsetof(struct DBOptions, wal_compression),
+          OptionType::kCompressionType, OptionVerificationType::kNormal, false,
+          0}},
+        {"per_column_family_write_stall",
+         {offsetof(struct DBOptions, per_column_family_write_stall),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
         {"allow_concurrent_memtable_write",
          {offsetof(struct DBOptions, allow_concurrent_memtable_write),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
@@ -1416,6 +1496,15 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"write_thread_max_yield_usec",
          {offsetof(struct DBOptions, write_thread_max_yield_usec),
           OptionType::kUInt64T, OptionVerificationType::kNormal, false, 0}},
+        {"max_write_batch_group_size_bytes",
+         {offsetof(struct DBOptions, max_write_batch_group_size_bytes),
+          OptionType::kUInt64T, OptionVerificationType::kNormal, false, 0}},
+        {"adaptive_write_batch_group_size",
+         {offsetof(struct DBOptions, adaptive_write_batch_group_size),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"async_write_threads",
+         {offsetof(struct DBOptions, async_write_threads), OptionType::kInt,
+          OptionVerificationType::kNormal, false, 0}},
         {"access_hint_on_compaction_start",
          {offsetof(struct DBOptions, access_hint_on_compaction_start),
           OptionType::kAccessHint, OptionVerificationType::kNormal, false, 0}},
@@ -1479,6 +1568,13 @@ std::unordered_map<std::string, BlockBasedTableOptions::IndexType>
         {"kTwoLevelIndexSearch",
          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch}};
 
+std::unordered_map<std::string, BlockBasedTableOptions::DataBlockIndexType>
+    OptionsHelper::block_base_table_data_block_index_type_string_map = {
+        {"kDataBlockBinarySearch",
+         BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinarySearch},
+        {"kDataBlockBinaryAndHash",
+         BlockBasedTableOptions::DataBlockIndexType::kDataBlockBinaryAndHash}};
+
 std::unordered_map<std::string, EncodingType>
     OptionsHelper::encoding_type_string_map = {{"kPlain", kPlain},
                                                {"kPrefix", kPrefix}};
@@ -1495,7 +1591,8 @@ std::unordered_map<std::string, CompactionPri>
         {"kByCompensatedSize", kByCompensatedSize},
         {"kOldestLargestSeqFirst", kOldestLargestSeqFirst},
         {"kOldestSmallestSeqFirst", kOldestSmallestSeqFirst},
-        {"kMinOverlappingRatio", kMinOverlappingRatio}};
+        {"kMinOverlappingRatio", kMinOverlappingRatio},
+        {"kReadHotDeletionsFirst", kReadHotDeletionsFirst}};
 
 std::unordered_map<std::string, WALRecoveryMode>
     OptionsHelper::wal_recovery_mode_string_map = {
@@ -1587,9 +1684,15 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"inplace_update_support",
          {offset_of(&ColumnFamilyOptions::inplace_update_support),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"inplace_update_atomic",
+         {offset_of(&ColumnFamilyOptions::inplace_update_atomic),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
         {"level_compaction_dynamic_level_bytes",
          {offset_of(&ColumnFamilyOptions::level_compaction_dynamic_level_bytes),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"level_compaction_tiered_levels",
+         {offset_of(&ColumnFamilyOptions::level_compaction_tiered_levels),
+          OptionType::kInt, OptionVerificationType::kNormal, false, 0}},
         {"optimize_filters_for_hits",
          {offset_of(&ColumnFamilyOptions::optimize_filters_for_hits),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
@@ -1600,6 +1703,25 @@ std::unordered_map<std::string, OptionTypeInfo>
         {"force_consistency_checks",
          {offset_of(&ColumnFamilyOptions::force_consistency_checks),
           OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"enable_blob_files",
+         {offset_of(&ColumnFamilyOptions::enable_blob_files),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"min_blob_size",
+         {offset_of(&ColumnFamilyOptions::min_blob_size),
+          OptionType::kUInt64T, OptionVerificationType::kNormal, false, 0}},
+        {"blob_file_size",
+         {offset_of(&ColumnFamilyOptions::blob_file_size),
+          OptionType::kUInt64T, OptionVerificationType::kNormal, false, 0}},
+        {"blob_compression_type",
+         {offset_of(&ColumnFamilyOptions::blob_compression_type),
+          OptionType::kCompressionType, OptionVerificationType::kNormal, false,
+          0}},
+        {"enable_blob_garbage_collection",
+         {offset_of(&ColumnFamilyOptions::enable_blob_garbage_collection),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
+        {"blob_garbage_collection_age_cutoff",
+         {offset_of(&ColumnFamilyOptions::blob_garbage_collection_age_cutoff),
+          OptionType::kDouble, OptionVerificationType::kNormal, false, 0}},
         {"purge_redundant_kvs_while_flush",
          {offset_of(&ColumnFamilyOptions::purge_redundant_kvs_while_flush),
           OptionType::kBoolean, OptionVerificationType::kDeprecated, false, 0}},
@@ -1751,6 +1873,9 @@ std::unordered_map<std::string, OptionTypeInfo>
               &ColumnFamilyOptions::memtable_insert_with_hint_prefix_extractor),
           OptionType::kSliceTransform, OptionVerificationType::kByNameAllowNull,
           false, 0}},
+        {"memtable_sorted_batch_insert",
+         {offset_of(&ColumnFamilyOptions::memtable_sorted_batch_insert),
+          OptionType::kBoolean, OptionVerificationType::kNormal, false, 0}},
         {"memtable_factory",
          {offset_of(&ColumnFamilyOptions::memtable_factory),
           OptionType::kMemTableRepFactory, OptionVerificationType::kByName,
@@ -798,6 +798,42 @@ TEST_F(OptionsTest, ColumnFamilyOptionsSerialization) {
   }
 }
 
+TEST_F(OptionsTest, CompressionOptionsSerialization) {
+  ColumnFamilyOptions base_opt, new_opt;
+  ASSERT_OK(GetColumnFamilyOptionsFromString(
+      base_opt, "compression_opts=4:5:6:7:8:2", &new_opt));
+  ASSERT_EQ(new_opt.compression_opts.window_bits, 4);
+  ASSERT_EQ(new_opt.compression_opts.level, 5);
+  ASSERT_EQ(new_opt.compression_opts.strategy, 6);
+  ASSERT_EQ(new_opt.compression_opts.max_dict_bytes, 7U);
+  ASSERT_EQ(new_opt.compression_opts.zstd_max_train_bytes, 8U);
+  ASSERT_EQ(new_opt.compression_opts.parallel_threads, 2U);
+  ASSERT_NOK(GetColumnFamilyOptionsFromString(
+      base_opt, "compression_opts=4:5:6:7:8:", &new_opt));
+
+  // The fields left out keep their values
+  ASSERT_OK(GetColumnFamilyOptionsFromString(
+      base_opt, "compression_opts=4:5:6:7", &new_opt));
+  ASSERT_EQ(new_opt.compression_opts.max_dict_bytes, 7U);
+  ASSERT_EQ(new_opt.compression_opts.zstd_max_train_bytes, 0U);
+  ASSERT_EQ(new_opt.compression_opts.parallel_threads, 1U);
+
+  // All fields survive a round trip through the options string
+  base_opt.compression_opts = CompressionOptions(-13, 3, 1, 1 << 14, 1 << 20);
+  base_opt.compression_opts.parallel_threads = 4;
+  std::string opt_string;
+  ASSERT_OK(GetStringFromColumnFamilyOptions(&opt_string, base_opt));
+  ASSERT_OK(
+      GetColumnFamilyOptionsFromString(ColumnFamilyOptions(), opt_string,
+                                       &new_opt));
+  ASSERT_EQ(new_opt.compression_opts.window_bits, -13);
+  ASSERT_EQ(new_opt.compression_opts.level, 3);
+  ASSERT_EQ(new_opt.compression_opts.strategy, 1);
+  ASSERT_EQ(new_opt.compression_opts.max_dict_bytes, 1U << 14);
+  ASSERT_EQ(new_opt.compression_opts.zstd_max_train_bytes, 1U << 20);
+  ASSERT_EQ(new_opt.compression_opts.parallel_threads, 4U);
+}
+
 #endif  // !ROCKSDB_LITE
 
 Status StringToMap(
@@ -161,6 +161,94 @@ void BlockIter::Seek(const Slice& target) {
   }
 }
 
+bool BlockIter::SeekForGetImpl(const Slice& target) {
+  PERF_TIMER_GUARD(block_seek_nanos);
+  if (data_ == nullptr) {  // Not init yet
+    return true;
+  }
+  Slice target_user_key = ExtractUserKey(target);
+  uint32_t map_offset = restarts_ + num_restarts_ * sizeof(uint32_t);
+  uint8_t entry =
+      data_block_hash_index_->Lookup(data_, map_offset, target_user_key);
+
+  if (entry == kCollision) {
+    // HashSeek not effective, falling back
+    Seek(target);
+    return true;
+  }
+
+  if (entry == kNoEntry) {
+    // Even if the user key is not in this block, the result may still be in
+    // the next block. Consider this example:
+    //
+    // Block N:    [aab@100, ... , app@120]
+    // boundary key: axy@50 (we make minimal assumption about a boundary key)
+    // Block N+1:  [axy@10, ...   ]
+    //
+    // If seek_key = axy@60, the search will start from Block N. Even if the
+    // user key is not found in the hash map, the caller still has to continue
+    // searching the next block.
+    //
+    // In this case, we pretend the key is in the last restart interval. The
+    // loop below searches it and stops at the first key that is larger than
+    // the seek key, or at the end of the block if no key is larger.
+    entry = static_cast<uint8_t>(num_restarts_ - 1);
+  }
+
+  uint32_t restart_index = entry;
+
+  // check if the key is in the restart_interval
+  assert(restart_index < num_restarts_);
+  SeekToRestartPoint(restart_index);
+
+  const uint32_t limit = restart_index + 1 < num_restarts_
+                             ? GetRestartPoint(restart_index + 1)
+                             : restarts_;
+  while (true) {
+    // Here we only linear seek the target key inside the restart interval.
+    // If a key does not exist inside a restart interval, we avoid further
+    // searching the block content across the restart interval boundary.
+    if (NextEntryOffset() >= limit) {
+      // Mark the iterator invalid, as if the end of the block was reached
+      current_ = restarts_;
+      restart_index_ = num_restarts_;
+      break;
+    }
+    if (!ParseNextKey() || Compare(key_.GetInternalKey(), target) >= 0) {
+      // we stop at the first potential matching user key.
+      break;
+    }
+  }
+
+  if (current_ == restarts_) {
+    // All keys of the restart interval are smaller than the target. Either
+    // the entries of the user key in this block are all newer than the
+    // target, or the user key is not in this block at all. In both cases
+    // the result may exist in the next block, so we return true.
+    return true;
+  }
+
+  // The hash index requires that equal user keys are byte-wise equal, which
+  // also spares us from needing the user comparator here.
+  if (ExtractUserKey(key_.GetInternalKey()) != target_user_key) {
+    // the key is not in this block and cannot be at the next block either.
+    return false;
+  }
+
+  // Here we are conservative and only support a limited set of cases
+  ValueType value_type = ExtractValueType(key_.GetInternalKey());
+  if (value_type != ValueType::kTypeValue &&
+      value_type != ValueType::kTypeDeletion &&
+      value_type != ValueType::kTypeSingleDeletion &&
+      value_type != ValueType::kTypeBlobIndex) {
+    Seek(target);
+    return true;
+  }
+
+  // Result found, and the iter is correctly set.
+  return true;
+}
+
 void BlockIter::SeekForPrev(const Slice& target) {
   PERF_TIMER_GUARD(block_seek_nanos);
   if (data_ == nullptr) {  // Not init yet
@@ -394,7 +482,20 @@ bool BlockIter::PrefixSeek(const Slice& target, uint32_t* index) {
 
 uint32_t Block::NumRestarts() const {
   assert(size_ >= 2*sizeof(uint32_t));
-  return DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  uint32_t num_restarts;
+  UnPackIndexTypeAndNumRestarts(
+      DecodeFixed32(data_ + size_ - sizeof(uint32_t)),
+      nullptr /* index_type */, &num_restarts);
+  return num_restarts;
+}
+
+BlockBasedTableOptions::DataBlockIndexType Block::IndexType() const {
+  assert(size_ >= 2 * sizeof(uint32_t));
+  BlockBasedTableOptions::DataBlockIndexType index_type;
+  UnPackIndexTypeAndNumRestarts(
+      DecodeFixed32(data_ + size_ - sizeof(uint32_t)), &index_type,
+      nullptr /* num_restarts */);
+  return index_type;
 }
 
 Block::Block(BlockContents&& contents, SequenceNumber _global_seqno,
@@ -402,16 +503,46 @@ Block::Block(BlockContents&& contents, SequenceNumber _global_seqno,
     : contents_(std::move(contents)),
       data_(contents_.data.data()),
       size_(contents_.data.size()),
+      restart_offset_(0),
+      num_restarts_(0),
       global_seqno_(_global_seqno) {
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
   } else {
-    restart_offset_ =
-        static_cast<uint32_t>(size_) - (1 + NumRestarts()) * sizeof(uint32_t);
-    if (restart_offset_ > size_ - sizeof(uint32_t)) {
-      // The size is too small for NumRestarts() and therefore
-      // restart_offset_ wrapped around.
-      size_ = 0;
+    num_restarts_ = NumRestarts();
+    switch (IndexType()) {
+      case BlockBasedTableOptions::kDataBlockBinarySearch:
+        restart_offset_ = static_cast<uint32_t>(size_) -
+                          (1 + num_restarts_) * sizeof(uint32_t);
+        if (restart_offset_ > size_ - sizeof(uint32_t)) {
+          // The size is too small for NumRestarts() and therefore
+          // restart_offset_ wrapped around.
+          size_ = 0;
+        }
+        break;
+      case BlockBasedTableOptions::kDataBlockBinaryAndHash:
+        if (size_ < sizeof(uint32_t) /* block footer */ +
+                        sizeof(uint16_t) /* NUM_BUCK */) {
+          size_ = 0;
+          break;
+        }
+
+        uint32_t map_offset;
+        data_block_hash_index_.Initialize(
+            data_, static_cast<uint32_t>(size_ - sizeof(uint32_t)),
+            &map_offset);
+
+        restart_offset_ = map_offset - num_restarts_ * sizeof(uint32_t);
+
+        if (map_offset > size_ - sizeof(uint32_t) ||
+            restart_offset_ > map_offset) {
+          // map_offset or restart_offset_ wrapped around, the block is
+          // corrupted
+          size_ = 0;
+        }
+        break;
+      default:
+        size_ = 0;  // Error marker
     }
   }
   if (read_amp_bytes_per_bit != 0 && statistics && size_ != 0) {
@@ -430,7 +561,7 @@ InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
       return NewErrorInternalIterator(Status::Corruption("bad block contents"));
     }
   }
-  const uint32_t num_restarts = NumRestarts();
+  const uint32_t num_restarts = num_restarts_;
   if (num_restarts == 0) {
     if (iter != nullptr) {
       iter->SetStatus(Status::OK());
@@ -441,14 +572,17 @@ InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
   } else {
     BlockPrefixIndex* prefix_index_ptr =
         total_order_seek ? nullptr : prefix_index_.get();
+    const DataBlockHashIndex* data_block_hash_index_ptr =
+        data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr;
 
     if (iter != nullptr) {
       iter->Initialize(cmp, data_, restart_offset_, num_restarts,
-                       prefix_index_ptr, global_seqno_, read_amp_bitmap_.get());
+                       prefix_index_ptr, global_seqno_, read_amp_bitmap_.get(),
+                       data_block_hash_index_ptr);
     } else {
       iter = new BlockIter(cmp, data_, restart_offset_, num_restarts,
                            prefix_index_ptr, global_seqno_,
-                           read_amp_bitmap_.get());
+                           read_amp_bitmap_.get(), data_block_hash_index_ptr);
     }
 
     if (read_amp_bitmap_) {
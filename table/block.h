@@ -26,6 +26,7 @@
 #include "rocksdb/options.h"
 #include "rocksdb/statistics.h"
 #include "table/block_prefix_index.h"
+#include "table/data_block_hash_index.h"
 #include "table/internal_iterator.h"
 #include "util/random.h"
 #include "util/sync_point.h"
@@ -151,6 +152,7 @@ class Block {
     return size_;
   }
   uint32_t NumRestarts() const;
+  BlockBasedTableOptions::DataBlockIndexType IndexType() const;
   CompressionType compression_type() const {
     return contents_.compression_type;
   }
@@ -184,12 +186,15 @@ class Block {
   const char* data_;            // contents_.data.data()
   size_t size_;                 // contents_.data.size()
   uint32_t restart_offset_;     // Offset in data_ of restart array
+  uint32_t num_restarts_;
   std::unique_ptr<BlockPrefixIndex> prefix_index_;
   std::unique_ptr<BlockReadAmpBitmap> read_amp_bitmap_;
   // All keys in the block will have seqno = global_seqno_, regardless of
   // the encoded value (kDisableGlobalSequenceNumber means disabled)
   const SequenceNumber global_seqno_;
 
+  DataBlockHashIndex data_block_hash_index_;
+
   // No copying allowed
   Block(const Block&);
   void operator=(const Block&);
@@ -209,20 +214,23 @@ class BlockIter : public InternalIterator {
         key_pinned_(false),
         global_seqno_(kDisableGlobalSequenceNumber),
         read_amp_bitmap_(nullptr),
-        last_bitmap_offset_(0) {}
+        last_bitmap_offset_(0),
+        data_block_hash_index_(nullptr) {}
 
   BlockIter(const Comparator* comparator, const char* data, uint32_t restarts,
             uint32_t num_restarts, BlockPrefixIndex* prefix_index,
-            SequenceNumber global_seqno, BlockReadAmpBitmap* read_amp_bitmap)
+            SequenceNumber global_seqno, BlockReadAmpBitmap* read_amp_bitmap,
+            const DataBlockHashIndex* data_block_hash_index = nullptr)
       : BlockIter() {
     Initialize(comparator, data, restarts, num_restarts, prefix_index,
-               global_seqno, read_amp_bitmap);
+               global_seqno, read_amp_bitmap, data_block_hash_index);
   }
 
   void Initialize(const Comparator* comparator, const char* data,
                   uint32_t restarts, uint32_t num_restarts,
                   BlockPrefixIndex* prefix_index, SequenceNumber global_seqno,
-                  BlockReadAmpBitmap* read_amp_bitmap) {
+                  BlockReadAmpBitmap* read_amp_bitmap,
+                  const DataBlockHashIndex* data_block_hash_index = nullptr) {
     assert(data_ == nullptr);           // Ensure it is called only once
     assert(num_restarts > 0);           // Ensure the param is valid
 
@@ -236,6 +244,7 @@ class BlockIter : public InternalIterator {
     global_seqno_ = global_seqno;
     read_amp_bitmap_ = read_amp_bitmap;
     last_bitmap_offset_ = current_ + 1;
+    data_block_hash_index_ = data_block_hash_index;
   }
 
   void SetStatus(Status s) {
@@ -265,6 +274,20 @@ class BlockIter : public InternalIterator {
 
   virtual void Seek(const Slice& target) override;
 
+  // Point lookup of internal key `target` for Get(). Positions the iterator
+  // like Seek() would if the user key of `target` may be in this block or
+  // in the next one. Returns false if the data block hash index proves that
+  // the user key is neither in this block nor in any later block, in which
+  // case the iterator position is unspecified. Without a hash index this is
+  // Seek() and always returns true.
+  bool SeekForGet(const Slice& target) {
+    if (data_block_hash_index_ == nullptr) {
+      Seek(target);
+      return true;
+    }
+    return SeekForGetImpl(target);
+  }
+
   virtual void SeekForPrev(const Slice& target) override;
 
   virtual void SeekToFirst() override;
@@ -314,6 +337,8 @@ class BlockIter : public InternalIterator {
   BlockReadAmpBitmap* read_amp_bitmap_;
   // last `current_` value we report to read-amp bitmp
   mutable uint32_t last_bitmap_offset_;
+  // Non-null only for data blocks that carry a hash index
+  const DataBlockHashIndex* data_block_hash_index_;
 
   struct CachedPrevEntry {
     explicit CachedPrevEntry(uint32_t _offset, const char* _key_ptr,
@@ -379,6 +404,7 @@ class BlockIter : public InternalIterator {
 
   bool PrefixSeek(const Slice& target, uint32_t* index);
 
+  bool SeekForGetImpl(const Slice& target);
 };
 
 }  // namespace rocksdb
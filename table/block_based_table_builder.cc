@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <stdio.h>
 
+#include <deque>
 #include <list>
 #include <map>
 #include <memory>
@@ -44,6 +45,7 @@
 #include "util/coding.h"
 #include "util/compression.h"
 #include "util/crc32c.h"
+#include "util/mutexlock.h"
 #include "util/stop_watch.h"
 #include "util/xxhash.h"
 
@@ -98,13 +100,41 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
   return compressed_size < raw_size - (raw_size / 8u);
 }
 
+// Fill trailer[0, kBlockTrailerSize) with the block type followed by the
+// checksum of block_contents and the type.
+void ComputeBlockTrailer(const Slice& block_contents, CompressionType type,
+                         ChecksumType checksum_type, char* trailer) {
+  trailer[0] = type;
+  char* trailer_without_type = trailer + 1;
+  switch (checksum_type) {
+    case kNoChecksum:
+      EncodeFixed32(trailer_without_type, 0);
+      break;
+    case kCRC32c: {
+      auto crc = crc32c::Value(block_contents.data(), block_contents.size());
+      crc = crc32c::Extend(crc, trailer, 1);  // Extend to cover block type
+      EncodeFixed32(trailer_without_type, crc32c::Mask(crc));
+      break;
+    }
+    case kxxHash: {
+      void* xxh = XXH32_init(0);
+      XXH32_update(xxh, block_contents.data(),
+                   static_cast<uint32_t>(block_contents.size()));
+      XXH32_update(xxh, trailer, 1);  // Extend  to cover block type
+      EncodeFixed32(trailer_without_type, XXH32_digest(xxh));
+      break;
+    }
+  }
+}
+
 }  // namespace
 
 // format_version is the block format as defined in include/rocksdb/table.h
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
-                    const Slice& compression_dict,
+                    const CompressionDict& compression_dict,
+                    CompressionContext* compression_ctx,
                     std::string* compressed_output) {
   if (*type == kNoCompression) {
     return raw;
@@ -124,7 +154,8 @@ Slice CompressBlock(const Slice& raw,
       if (Zlib_Compress(
               compression_options,
               GetCompressFormatForVersion(kZlibCompression, format_version),
-              raw.data(), raw.size(), compressed_output, compression_dict) &&
+              raw.data(), raw.size(), compressed_output,
+              compression_dict.GetRawDict()) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -142,7 +173,8 @@ Slice CompressBlock(const Slice& raw,
       if (LZ4_Compress(
               compression_options,
               GetCompressFormatForVersion(kLZ4Compression, format_version),
-              raw.data(), raw.size(), compressed_output, compression_dict) &&
+              raw.data(), raw.size(), compressed_output,
+              compression_dict.GetRawDict(), compression_ctx) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -151,7 +183,8 @@ Slice CompressBlock(const Slice& raw,
       if (LZ4HC_Compress(
               compression_options,
               GetCompressFormatForVersion(kLZ4HCCompression, format_version),
-              raw.data(), raw.size(), compressed_output, compression_dict) &&
+              raw.data(), raw.size(), compressed_output,
+              compression_dict.GetRawDict(), compression_ctx) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -166,7 +199,8 @@ Slice CompressBlock(const Slice& raw,
     case kZSTD:
     case kZSTDNotFinalCompression:
       if (ZSTD_Compress(compression_options, raw.data(), raw.size(),
-                        compressed_output, compression_dict) &&
+                        compressed_output, compression_dict,
+                        compression_ctx) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -242,6 +276,48 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
   bool prefix_filtering_;
 };
 
+// State shared between the table builder and its compression threads. Data
+// blocks are queued twice: in compress_queue until a worker picks them up, and
+// in write_queue, in file order, until the builder thread writes them out.
+struct BlockBasedTableBuilder::ParallelCompressionRep {
+  struct BlockRep {
+    std::string raw_contents;
+    std::string compressed_output;
+    // Points into raw_contents or compressed_output
+    Slice contents;
+    CompressionType type = kNoCompression;
+    char trailer[kBlockTrailerSize];
+    Status status;
+    // Keys for the index entry of this block
+    std::string last_key;
+    std::string first_key_in_next_block;
+    bool has_next_block = false;
+    // Set by the worker once contents, type, trailer and status are final.
+    // Protected by mu.
+    bool compressed = false;
+  };
+
+  explicit ParallelCompressionRep(uint32_t parallel_threads)
+      : work_cv(&mu),
+        done_cv(&mu),
+        max_blocks_in_flight(parallel_threads * kMaxBlocksInFlightPerThread) {}
+
+  // Enough queued blocks to keep every worker busy while the builder thread
+  // is writing, without buffering an unbounded part of the file in memory.
+  static const size_t kMaxBlocksInFlightPerThread = 4;
+
+  port::Mutex mu;
+  // Signaled when blocks are added to compress_queue, or on shutdown
+  port::CondVar work_cv;
+  // Signaled when a worker finishes a block
+  port::CondVar done_cv;
+  std::deque<BlockRep*> compress_queue;
+  std::deque<std::unique_ptr<BlockRep>> write_queue;
+  bool shutting_down = false;
+  const size_t max_blocks_in_flight;
+  std::vector<port::Thread> workers;
+};
+
 struct BlockBasedTableBuilder::Rep {
   const ImmutableCFOptions ioptions;
   const BlockBasedTableOptions table_options;
@@ -260,7 +336,14 @@ struct BlockBasedTableBuilder::Rep {
   const CompressionType compression_type;
   const CompressionOptions compression_opts;
   // Data for presetting the compression library's dictionary, or nullptr.
-  const std::string* compression_dict;
+  // Digested once per table when the library supports it.
+  std::unique_ptr<CompressionDict> compression_dict;
+  // Same dictionary for decompressing blocks under verify_compression.
+  std::unique_ptr<UncompressionDict> verify_dict;
+  // Compression state reused for every block of this table.
+  CompressionContext compression_ctx;
+  // Non-null when data blocks are compressed by background threads.
+  std::unique_ptr<ParallelCompressionRep> pc_rep;
   TableProperties props;
 
   bool closed = false;  // Either Finish() or Abandon() has been called.
@@ -295,12 +378,13 @@ struct BlockBasedTableBuilder::Rep {
         internal_comparator(icomparator),
         file(f),
         data_block(table_options.block_restart_interval,
-                   table_options.use_delta_encoding),
+                   table_options.use_delta_encoding,
+                   table_options.data_block_index_type,
+                   table_options.data_block_hash_table_util_ratio),
         range_del_block(1),  // TODO(andrewkr): restart_interval unnecessary
         internal_prefix_transform(_ioptions.prefix_extractor),
         compression_type(_compression_type),
         compression_opts(_compression_opts),
-        compression_dict(_compression_dict),
         flush_block_policy(
             table_options.flush_block_policy_factory->NewFlushBlockPolicy(
                 table_options, data_block)),
@@ -318,6 +402,16 @@ struct BlockBasedTableBuilder::Rep {
           table_options.index_type, &internal_comparator,
           &this->internal_prefix_transform, table_options));
     }
+    if (_compression_dict != nullptr && !_compression_dict->empty()) {
+      compression_dict.reset(new CompressionDict(
+          *_compression_dict, compression_type, compression_opts.level));
+      if (table_options.verify_compression) {
+        verify_dict.reset(new UncompressionDict(
+            compression_dict->GetRawDict(),
+            compression_type == kZSTD ||
+                compression_type == kZSTDNotFinalCompression));
+      }
+    }
     if (skip_filters) {
       filter_builder = nullptr;
     } else {
@@ -369,6 +463,23 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
   if (rep_->filter_builder != nullptr) {
     rep_->filter_builder->StartBlock(0);
   }
+  // Index entries are added when a block is written rather than when it is
+  // cut, and with a block-based filter a new filter starts at the offset of
+  // each data block, which is unknown until the block is compressed. Only the
+  // plain binary search index and full filters tolerate that.
+  if (compression_opts.parallel_threads > 1 &&
+      compression_type != kNoCompression &&
+      sanitized_table_options.index_type ==
+          BlockBasedTableOptions::kBinarySearch &&
+      (rep_->filter_builder == nullptr ||
+       !rep_->filter_builder->IsBlockBased())) {
+    rep_->pc_rep.reset(
+        new ParallelCompressionRep(compression_opts.parallel_threads));
+    for (uint32_t i = 0; i < compression_opts.parallel_threads; i++) {
+      rep_->pc_rep->workers.emplace_back(
+          &BlockBasedTableBuilder::BGWorkCompression, this);
+    }
+  }
   if (table_options.block_cache_compressed.get() != nullptr) {
     BlockBasedTable::GenerateCachePrefix(
         table_options.block_cache_compressed.get(), file->writable_file(),
@@ -379,6 +490,7 @@ BlockBasedTableBuilder::BlockBasedTableBuilder(
 
 BlockBasedTableBuilder::~BlockBasedTableBuilder() {
   assert(rep_->closed);  // Catch errors where caller forgot to call Finish()
+  StopParallelCompression();
   delete rep_;
 }
 
@@ -406,7 +518,17 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
       // entries in the first block and < all entries in subsequent
       // blocks.
       if (ok()) {
-        r->index_builder->AddIndexEntry(&r->last_key, &key, r->pending_handle);
+        if (r->pc_rep != nullptr) {
+          // The index entry is added once the block is written
+          ParallelCompressionRep::BlockRep* block =
+              r->pc_rep->write_queue.back().get();
+          block->first_key_in_next_block.assign(key.data(), key.size());
+          block->has_next_block = true;
+          WriteParallelCompressedBlocks(false /* wait_for_all */);
+        } else {
+          r->index_builder->AddIndexEntry(&r->last_key, &key,
+                                          r->pending_handle);
+        }
       }
     }
 
@@ -446,6 +568,24 @@ void BlockBasedTableBuilder::Flush() {
   assert(!r->closed);
   if (!ok()) return;
   if (r->data_block.empty()) return;
+  if (r->pc_rep != nullptr) {
+    // Hand the block over to the compression threads. It is written by
+    // WriteParallelCompressedBlocks().
+    ParallelCompressionRep* pc_rep = r->pc_rep.get();
+    std::unique_ptr<ParallelCompressionRep::BlockRep> block(
+        new ParallelCompressionRep::BlockRep());
+    Slice raw_contents = r->data_block.Finish();
+    block->raw_contents.assign(raw_contents.data(), raw_contents.size());
+    block->last_key = r->last_key;
+    r->data_block.Reset();
+    {
+      MutexLock l(&pc_rep->mu);
+      pc_rep->compress_queue.push_back(block.get());
+      pc_rep->write_queue.push_back(std::move(block));
+    }
+    pc_rep->work_cv.Signal();
+    return;
+  }
   WriteBlock(&r->data_block, &r->pending_handle, true /* is_data_block */);
   if (r->filter_builder != nullptr) {
     r->filter_builder->StartBlock(r->offset);
@@ -471,7 +611,27 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   assert(ok());
   Rep* r = rep_;
 
-  auto type = r->compression_type;
+  CompressionType type;
+  Status compression_status;
+  Slice block_contents = CompressAndVerifyBlock(
+      raw_block_contents, is_data_block, &r->compression_ctx,
+      &r->compressed_output, &type, &compression_status);
+  if (!compression_status.ok()) {
+    r->status = compression_status;
+    return;
+  }
+
+  WriteRawBlock(block_contents, type, handle);
+  r->compressed_output.clear();
+}
+
+Slice BlockBasedTableBuilder::CompressAndVerifyBlock(
+    const Slice& raw_block_contents, bool is_data_block,
+    CompressionContext* compression_ctx, std::string* compressed_output,
+    CompressionType* type, Status* status) {
+  const Rep* r = rep_;
+
+  *type = r->compression_type;
   Slice block_contents;
   bool abort_compression = false;
 
@@ -479,25 +639,30 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
     ShouldReportDetailedTime(r->ioptions.env, r->ioptions.statistics));
 
   if (raw_block_contents.size() < kCompressionSizeLimit) {
-    Slice compression_dict;
-    if (is_data_block && r->compression_dict && r->compression_dict->size()) {
-      compression_dict = *r->compression_dict;
+    // The dictionary only applies to data blocks
+    const CompressionDict* compression_dict = &CompressionDict::GetEmptyDict();
+    const UncompressionDict* verify_dict = &UncompressionDict::GetEmptyDict();
+    if (is_data_block && r->compression_dict) {
+      compression_dict = r->compression_dict.get();
+      if (r->verify_dict) {
+        verify_dict = r->verify_dict.get();
+      }
     }
 
     block_contents = CompressBlock(raw_block_contents, r->compression_opts,
-                                   &type, r->table_options.format_version,
-                                   compression_dict, &r->compressed_output);
+                                   type, r->table_options.format_version,
+                                   *compression_dict, compression_ctx,
+                                   compressed_output);
 
     // Some of the compression algorithms are known to be unreliable. If
     // the verify_compression flag is set then try to de-compress the
     // compressed data and compare to the input.
-    if (type != kNoCompression && r->table_options.verify_compression) {
+    if (*type != kNoCompression && r->table_options.verify_compression) {
       // Retrieve the uncompressed contents into a new buffer
       BlockContents contents;
       Status stat = UncompressBlockContentsForCompressionType(
           block_contents.data(), block_contents.size(), &contents,
-          r->table_options.format_version, compression_dict, type,
-          r->ioptions);
+          r->table_options.format_version, *verify_dict, *type, r->ioptions);
 
       if (stat.ok()) {
         bool compressed_ok = contents.data.compare(raw_block_contents) == 0;
@@ -506,12 +671,12 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
           abort_compression = true;
           ROCKS_LOG_ERROR(r->ioptions.info_log,
                           "Decompressed block did not match raw block");
-          r->status =
+          *status =
               Status::Corruption("Decompressed block did not match raw block");
         }
       } else {
         // Decompression reported an error. abort.
-        r->status = Status::Corruption("Could not decompress");
+        *status = Status::Corruption("Could not decompress");
         abort_compression = true;
       }
     }
@@ -524,9 +689,9 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   // verification.
   if (abort_compression) {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
-    type = kNoCompression;
+    *type = kNoCompression;
     block_contents = raw_block_contents;
-  } else if (type != kNoCompression &&
+  } else if (*type != kNoCompression &&
              ShouldReportDetailedTime(r->ioptions.env,
                                       r->ioptions.statistics)) {
     MeasureTime(r->ioptions.statistics, COMPRESSION_TIMES_NANOS,
@@ -535,14 +700,13 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
                 raw_block_contents.size());
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_COMPRESSED);
   }
-
-  WriteRawBlock(block_contents, type, handle);
-  r->compressed_output.clear();
+  return block_contents;
 }
 
 void BlockBasedTableBuilder::WriteRawBlock(const Slice& block_contents,
                                            CompressionType type,
-                                           BlockHandle* handle) {
+                                           BlockHandle* handle,
+                                           const char* trailer) {
   Rep* r = rep_;
   StopWatch sw(r->ioptions.env, r->ioptions.statistics, WRITE_RAW_BLOCK_MICROS);
   handle->set_offset(r->offset);
@@ -550,27 +714,11 @@ void BlockBasedTableBuilder::WriteRawBlock(const Slice& block_contents,
   assert(r->status.ok());
   r->status = r->file->Append(block_contents);
   if (r->status.ok()) {
-    char trailer[kBlockTrailerSize];
-    trailer[0] = type;
-    char* trailer_without_type = trailer + 1;
-    switch (r->table_options.checksum) {
-      case kNoChecksum:
-        EncodeFixed32(trailer_without_type, 0);
-        break;
-      case kCRC32c: {
-        auto crc = crc32c::Value(block_contents.data(), block_contents.size());
-        crc = crc32c::Extend(crc, trailer, 1);  // Extend to cover block type
-        EncodeFixed32(trailer_without_type, crc32c::Mask(crc));
-        break;
-      }
-      case kxxHash: {
-        void* xxh = XXH32_init(0);
-        XXH32_update(xxh, block_contents.data(),
-                     static_cast<uint32_t>(block_contents.size()));
-        XXH32_update(xxh, trailer, 1);  // Extend  to cover block type
-        EncodeFixed32(trailer_without_type, XXH32_digest(xxh));
-        break;
-      }
+    char computed_trailer[kBlockTrailerSize];
+    if (trailer == nullptr) {
+      ComputeBlockTrailer(block_contents, type, r->table_options.checksum,
+                          computed_trailer);
+      trailer = computed_trailer;
     }
 
     assert(r->status.ok());
@@ -584,6 +732,99 @@ void BlockBasedTableBuilder::WriteRawBlock(const Slice& block_contents,
   }
 }
 
+void BlockBasedTableBuilder::BGWorkCompression() {
+  ParallelCompressionRep* pc_rep = rep_->pc_rep.get();
+  CompressionContext compression_ctx;
+  while (true) {
+    ParallelCompressionRep::BlockRep* block;
+    {
+      MutexLock l(&pc_rep->mu);
+      while (pc_rep->compress_queue.empty() && !pc_rep->shutting_down) {
+        pc_rep->work_cv.Wait();
+      }
+      if (pc_rep->shutting_down) {
+        return;
+      }
+      block = pc_rep->compress_queue.front();
+      pc_rep->compress_queue.pop_front();
+    }
+
+    block->contents = CompressAndVerifyBlock(
+        block->raw_contents, true /* is_data_block */, &compression_ctx,
+        &block->compressed_output, &block->type, &block->status);
+    if (block->status.ok()) {
+      ComputeBlockTrailer(block->contents, block->type,
+                          rep_->table_options.checksum, block->trailer);
+    }
+
+    {
+      MutexLock l(&pc_rep->mu);
+      block->compressed = true;
+    }
+    pc_rep->done_cv.SignalAll();
+  }
+}
+
+void BlockBasedTableBuilder::WriteParallelCompressedBlocks(bool wait_for_all) {
+  Rep* r = rep_;
+  ParallelCompressionRep* pc_rep = r->pc_rep.get();
+  while (ok() && !pc_rep->write_queue.empty()) {
+    ParallelCompressionRep::BlockRep* block = pc_rep->write_queue.front().get();
+    {
+      MutexLock l(&pc_rep->mu);
+      if (!block->compressed) {
+        if (!wait_for_all &&
+            pc_rep->write_queue.size() <= pc_rep->max_blocks_in_flight) {
+          break;
+        }
+        while (!block->compressed) {
+          pc_rep->done_cv.Wait();
+        }
+      }
+    }
+
+    if (!block->status.ok()) {
+      r->status = block->status;
+      break;
+    }
+    WriteRawBlock(block->contents, block->type, &r->pending_handle,
+                  block->trailer);
+    if (!ok()) {
+      break;
+    }
+    if (r->filter_builder != nullptr) {
+      r->filter_builder->StartBlock(r->offset);
+    }
+    r->props.data_size = r->offset;
+    ++r->props.num_data_blocks;
+
+    Slice first_key_in_next_block(block->first_key_in_next_block);
+    r->index_builder->AddIndexEntry(
+        &block->last_key,
+        block->has_next_block ? &first_key_in_next_block : nullptr,
+        r->pending_handle);
+    pc_rep->write_queue.pop_front();
+  }
+}
+
+void BlockBasedTableBuilder::StopParallelCompression() {
+  ParallelCompressionRep* pc_rep = rep_->pc_rep.get();
+  if (pc_rep == nullptr || pc_rep->workers.empty()) {
+    return;
+  }
+  {
+    MutexLock l(&pc_rep->mu);
+    pc_rep->shutting_down = true;
+  }
+  pc_rep->work_cv.SignalAll();
+  for (auto& worker : pc_rep->workers) {
+    worker.join();
+  }
+  pc_rep->workers.clear();
+  pc_rep->compress_queue.clear();
+  pc_rep->write_queue.clear();
+}
+
 Status BlockBasedTableBuilder::status() const {
   return rep_->status;
 }
@@ -636,13 +877,18 @@ Status BlockBasedTableBuilder::Finish() {
   Rep* r = rep_;
   bool empty_data_block = r->data_block.empty();
   Flush();
+  if (r->pc_rep != nullptr) {
+    // Also adds the index entry of the last data block
+    WriteParallelCompressedBlocks(true /* wait_for_all */);
+    StopParallelCompression();
+  }
   assert(!r->closed);
   r->closed = true;
 
   // To make sure properties block is able to keep the accurate size of index
   // block, we will finish writing all index entries here and flush them
   // to storage after metaindex block is written.
-  if (ok() && !empty_data_block) {
+  if (ok() && !empty_data_block && r->pc_rep == nullptr) {
     r->index_builder->AddIndexEntry(
         &r->last_key, nullptr /* no next data block */, r->pending_handle);
   }
@@ -761,8 +1007,8 @@ Status BlockBasedTableBuilder::Finish() {
       meta_index_builder.Add(kPropertiesBlock, properties_block_handle);
 
       // Write compression dictionary block
-      if (r->compression_dict && r->compression_dict->size()) {
-        WriteRawBlock(*r->compression_dict, kNoCompression,
+      if (r->compression_dict) {
+        WriteRawBlock(r->compression_dict->GetRawDict(), kNoCompression,
                       &compression_dict_block_handle);
         meta_index_builder.Add(kCompressionDictBlock,
                                compression_dict_block_handle);
@@ -832,6 +1078,7 @@ Status BlockBasedTableBuilder::Finish() {
 void BlockBasedTableBuilder::Abandon() {
   Rep* r = rep_;
   assert(!r->closed);
+  StopParallelCompression();
   r->closed = true;
 }
 
@@ -19,6 +19,7 @@
 #include "rocksdb/options.h"
 #include "rocksdb/status.h"
 #include "table/table_builder.h"
+#include "util/compression.h"
 
 namespace rocksdb {
 
@@ -95,11 +96,35 @@ class BlockBasedTableBuilder : public TableBuilder {
   // Compress and write block content to the file.
   void WriteBlock(const Slice& block_contents, BlockHandle* handle,
                   bool is_data_block);
-  // Directly write data to the file.
-  void WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle);
+  // Compress block content and, if verify_compression is set, check that it
+  // decompresses to the original. Returns the contents to write and sets
+  // *type to the compression actually used. May be called concurrently as
+  // long as each caller passes its own compression_ctx and compressed_output.
+  Slice CompressAndVerifyBlock(const Slice& raw_block_contents,
+                               bool is_data_block,
+                               CompressionContext* compression_ctx,
+                               std::string* compressed_output,
+                               CompressionType* type, Status* status);
+  // Directly write data to the file. If trailer is not nullptr, it holds the
+  // already computed block trailer.
+  void WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle,
+                     const char* trailer = nullptr);
   Status InsertBlockInCache(const Slice& block_contents,
                             const CompressionType type,
                             const BlockHandle* handle);
+
+  // Body of the background threads compressing data blocks when
+  // compression_opts.parallel_threads > 1.
+  void BGWorkCompression();
+  // Write data blocks handed to the compression threads, in the order they
+  // were produced. If wait_for_all is false, only blocks that are already
+  // compressed are written, plus as many as needed to bound the number of
+  // blocks in flight. Otherwise waits until every queued block is written.
+  void WriteParallelCompressedBlocks(bool wait_for_all);
+  // Stop and join the compression threads. Queued blocks are dropped.
+  void StopParallelCompression();
+
+  struct ParallelCompressionRep;
   struct Rep;
   class BlockBasedTablePropertiesCollectorFactory;
   class BlockBasedTablePropertiesCollector;
@@ -123,7 +148,8 @@ class BlockBasedTableBuilder : public TableBuilder {
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
-                    const Slice& compression_dict,
+                    const CompressionDict& compression_dict,
+                    CompressionContext* compression_ctx,
                     std::string* compressed_output);
 
 }  // namespace rocksdb
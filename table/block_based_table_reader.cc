@@ -16,6 +16,7 @@
 
 #include "db/dbformat.h"
 #include "db/pinned_iterators_manager.h"
+#include "db/range_tombstone_fragmenter.h"
 
 #include "rocksdb/cache.h"
 #include "rocksdb/comparator.h"
@@ -33,6 +34,7 @@
 #include "table/block_prefix_index.h"
 #include "table/filter_block.h"
 #include "table/format.h"
+#include "table/full_filter_bits_builder.h"
 #include "table/full_filter_block.h"
 #include "table/get_context.h"
 #include "table/internal_iterator.h"
@@ -74,7 +76,7 @@ Status ReadBlockFromFile(
     RandomAccessFileReader* file, FilePrefetchBuffer* prefetch_buffer,
     const Footer& footer, const ReadOptions& options, const BlockHandle& handle,
     std::unique_ptr<Block>* result, const ImmutableCFOptions& ioptions,
-    bool do_uncompress, const Slice& compression_dict,
+    bool do_uncompress, const UncompressionDict& compression_dict,
     const PersistentCacheOptions& cache_options, SequenceNumber global_seqno,
     size_t read_amp_bytes_per_bit) {
   BlockContents contents;
@@ -168,7 +170,7 @@ class PartitionIndexReader : public IndexReader, public Cleanable {
     auto s = ReadBlockFromFile(
         file, prefetch_buffer, footer, ReadOptions(), index_handle,
         &index_block, ioptions, true /* decompress */,
-        Slice() /*compression dict*/, cache_options,
+        UncompressionDict::GetEmptyDict(), cache_options,
         kDisableGlobalSequenceNumber, 0 /* read_amp_bytes_per_bit */);
 
     if (s.ok()) {
@@ -248,14 +250,10 @@ class PartitionIndexReader : public IndexReader, public Cleanable {
       }
 
       BlockBasedTable::CachableEntry<Block> block;
-      Slice compression_dict;
-      if (rep->compression_dict_block) {
-        compression_dict = rep->compression_dict_block->data;
-      }
       const bool is_index = true;
       s = table_->MaybeLoadDataBlockToCache(prefetch_buffer.get(), rep, ro,
-                                            handle, compression_dict, &block,
-                                            is_index);
+                                            handle, rep->GetUncompressionDict(),
+                                            &block, is_index);
 
       assert(s.ok() || block.value == nullptr);
       if (s.ok() && block.value != nullptr) {
@@ -320,7 +318,7 @@ class BinarySearchIndexReader : public IndexReader {
     auto s = ReadBlockFromFile(
         file, prefetch_buffer, footer, ReadOptions(), index_handle,
         &index_block, ioptions, true /* decompress */,
-        Slice() /*compression dict*/, cache_options,
+        UncompressionDict::GetEmptyDict(), cache_options,
         kDisableGlobalSequenceNumber, 0 /* read_amp_bytes_per_bit */);
 
     if (s.ok()) {
@@ -374,7 +372,7 @@ class HashIndexReader : public IndexReader {
     auto s = ReadBlockFromFile(
         file, prefetch_buffer, footer, ReadOptions(), index_handle,
         &index_block, ioptions, true /* decompress */,
-        Slice() /*compression dict*/, cache_options,
+        UncompressionDict::GetEmptyDict(), cache_options,
         kDisableGlobalSequenceNumber, 0 /* read_amp_bytes_per_bit */);
 
     if (!s.ok()) {
@@ -412,8 +410,8 @@ class HashIndexReader : public IndexReader {
     BlockContents prefixes_contents;
     s = ReadBlockContents(file, prefetch_buffer, footer, ReadOptions(),
                           prefixes_handle, &prefixes_contents, ioptions,
-                          true /* decompress */, Slice() /*compression dict*/,
-                          cache_options);
+                          true /* decompress */,
+                          UncompressionDict::GetEmptyDict(), cache_options);
     if (!s.ok()) {
       return s;
     }
@@ -421,7 +419,7 @@ class HashIndexReader : public IndexReader {
     s = ReadBlockContents(file, prefetch_buffer, footer, ReadOptions(),
                           prefixes_meta_handle, &prefixes_meta_contents,
                           ioptions, true /* decompress */,
-                          Slice() /*compression dict*/, cache_options);
+                          UncompressionDict::GetEmptyDict(), cache_options);
     if (!s.ok()) {
       // TODO: log error
       return Status::OK();
@@ -678,28 +676,35 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
 
   // Find filter handle and filter type
   if (rep->filter_policy) {
-    for (auto filter_type :
-         {Rep::FilterType::kFullFilter, Rep::FilterType::kPartitionedFilter,
-          Rep::FilterType::kBlockFilter}) {
-      std::string prefix;
-      switch (filter_type) {
-        case Rep::FilterType::kFullFilter:
-          prefix = kFullFilterBlockPrefix;
-          break;
-        case Rep::FilterType::kPartitionedFilter:
-          prefix = kPartitionedFilterBlockPrefix;
-          break;
-        case Rep::FilterType::kBlockFilter:
-          prefix = kFilterBlockPrefix;
+    for (const auto& policy_name :
+         GetCompatibleFilterPolicyNames(rep->filter_policy->Name())) {
+      for (auto filter_type :
+           {Rep::FilterType::kFullFilter, Rep::FilterType::kPartitionedFilter,
+            Rep::FilterType::kBlockFilter}) {
+        std::string prefix;
+        switch (filter_type) {
+          case Rep::FilterType::kFullFilter:
+            prefix = kFullFilterBlockPrefix;
+            break;
+          case Rep::FilterType::kPartitionedFilter:
+            prefix = kPartitionedFilterBlockPrefix;
+            break;
+          case Rep::FilterType::kBlockFilter:
+            prefix = kFilterBlockPrefix;
+            break;
+          default:
+            assert(0);
+        }
+        std::string filter_block_key = prefix;
+        filter_block_key.append(policy_name);
+        if (FindMetaBlock(meta_iter.get(), filter_block_key,
+                          &rep->filter_handle)
+                .ok()) {
+          rep->filter_type = filter_type;
           break;
-        default:
-          assert(0);
+        }
       }
-      std::string filter_block_key = prefix;
-      filter_block_key.append(rep->filter_policy->Name());
-      if (FindMetaBlock(meta_iter.get(), filter_block_key, &rep->filter_handle)
-              .ok()) {
-        rep->filter_type = filter_type;
+      if (rep->filter_type != Rep::FilterType::kNoFilter) {
         break;
       }
     }
@@ -762,6 +767,15 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
           s.ToString().c_str());
     } else {
       rep->compression_dict_block = std::move(compression_dict_block);
+      // Digest the dictionary once here rather than for every data block.
+      const bool using_zstd =
+          rep->table_properties != nullptr &&
+          (rep->table_properties->compression_name ==
+               CompressionTypeToString(kZSTD) ||
+           rep->table_properties->compression_name ==
+               CompressionTypeToString(kZSTDNotFinalCompression));
+      rep->uncompression_dict.reset(new UncompressionDict(
+          rep->compression_dict_block->data, using_zstd));
     }
   }
 
@@ -779,7 +793,7 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
       ReadOptions read_options;
       s = MaybeLoadDataBlockToCache(
           prefetch_buffer.get(), rep, read_options, rep->range_del_handle,
-          Slice() /* compression_dict */, &rep->range_del_entry);
+          UncompressionDict::GetEmptyDict(), &rep->range_del_entry);
       if (!s.ok()) {
         ROCKS_LOG_WARN(
             rep->ioptions.info_log,
@@ -803,6 +817,24 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
                                                 rep->ioptions.info_log);
   }
 
+  // Fragment the range tombstones once so that reads don't need to rebuild an
+  // aggregation of them for every Get() or iterator. On failure readers fall
+  // back to NewRangeTombstoneIterator(), which surfaces the error.
+  if (!rep->range_del_handle.IsNull()) {
+    std::unique_ptr<InternalIterator> range_del_iter(
+        new_table->NewRangeTombstoneIterator(ReadOptions()));
+    std::shared_ptr<const FragmentedRangeTombstoneList> fragmented(
+        new FragmentedRangeTombstoneList(std::move(range_del_iter),
+                                         rep->internal_comparator));
+    if (fragmented->status().ok()) {
+      rep->fragmented_range_dels = std::move(fragmented);
+    } else {
+      ROCKS_LOG_WARN(rep->ioptions.info_log,
+                     "Encountered error while fragmenting range tombstones %s",
+                     fragmented->status().ToString().c_str());
+    }
+  }
+
   const bool pin =
       rep->table_options.pin_l0_filter_and_index_blocks_in_cache && level == 0;
   // pre-fetching of blocks is turned on
@@ -932,7 +964,7 @@ Status BlockBasedTable::ReadMetaBlock(Rep* rep,
   Status s = ReadBlockFromFile(
       rep->file.get(), prefetch_buffer, rep->footer, ReadOptions(),
       rep->footer.metaindex_handle(), &meta, rep->ioptions,
-      true /* decompress */, Slice() /*compression dict*/,
+      true /* decompress */, UncompressionDict::GetEmptyDict(),
       rep->persistent_cache_options, kDisableGlobalSequenceNumber,
       0 /* read_amp_bytes_per_bit */);
 
@@ -955,7 +987,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
     Cache* block_cache, Cache* block_cache_compressed,
     const ImmutableCFOptions& ioptions, const ReadOptions& read_options,
     BlockBasedTable::CachableEntry<Block>* block, uint32_t format_version,
-    const Slice& compression_dict, size_t read_amp_bytes_per_bit,
+    const UncompressionDict& compression_dict, size_t read_amp_bytes_per_bit,
     bool is_index) {
   Status s;
   Block* compressed_block = nullptr;
@@ -1050,8 +1082,8 @@ Status BlockBasedTable::PutDataBlockToCache(
     Cache* block_cache, Cache* block_cache_compressed,
     const ReadOptions& read_options, const ImmutableCFOptions& ioptions,
     CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-    const Slice& compression_dict, size_t read_amp_bytes_per_bit, bool is_index,
-    Cache::Priority priority) {
+    const UncompressionDict& compression_dict, size_t read_amp_bytes_per_bit,
+    bool is_index, Cache::Priority priority) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
 
@@ -1140,7 +1172,8 @@ FilterBlockReader* BlockBasedTable::ReadFilter(
   BlockContents block;
   if (!ReadBlockContents(rep->file.get(), prefetch_buffer, rep->footer,
                          ReadOptions(), filter_handle, &block, rep->ioptions,
-                         false /* decompress */, Slice() /*compression dict*/,
+                         false /* decompress */,
+                         UncompressionDict::GetEmptyDict(),
                          rep->persistent_cache_options)
            .ok()) {
     // Error reading the block
@@ -1374,18 +1407,16 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(
 // If input_iter is not null, update this iter and return it
 InternalIterator* BlockBasedTable::NewDataBlockIterator(
     Rep* rep, const ReadOptions& ro, const BlockHandle& handle,
-    BlockIter* input_iter, bool is_index, Status s) {
+    BlockIter* input_iter, bool is_index, Status s,
+    FilePrefetchBuffer* prefetch_buffer) {
   PERF_TIMER_GUARD(new_table_block_iter_nanos);
 
   const bool no_io = (ro.read_tier == kBlockCacheTier);
   Cache* block_cache = rep->table_options.block_cache.get();
   CachableEntry<Block> block;
-  Slice compression_dict;
+  const UncompressionDict& compression_dict = rep->GetUncompressionDict();
   if (s.ok()) {
-    if (rep->compression_dict_block) {
-      compression_dict = rep->compression_dict_block->data;
-    }
-    s = MaybeLoadDataBlockToCache(nullptr /*prefetch_buffer*/, rep, ro, handle,
+    s = MaybeLoadDataBlockToCache(prefetch_buffer, rep, ro, handle,
                                   compression_dict, &block, is_index);
   }
 
@@ -1401,7 +1432,7 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(
       }
     }
     std::unique_ptr<Block> block_value;
-    s = ReadBlockFromFile(rep->file.get(), nullptr /* prefetch_buffer */,
+    s = ReadBlockFromFile(rep->file.get(), prefetch_buffer,
                           rep->footer, ro, handle, &block_value, rep->ioptions,
                           true /* compress */, compression_dict,
                           rep->persistent_cache_options, rep->global_seqno,
@@ -1436,7 +1467,7 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(
 
 Status BlockBasedTable::MaybeLoadDataBlockToCache(
     FilePrefetchBuffer* prefetch_buffer, Rep* rep, const ReadOptions& ro,
-    const BlockHandle& handle, Slice compression_dict,
+    const BlockHandle& handle, const UncompressionDict& compression_dict,
     CachableEntry<Block>* block_entry, bool is_index) {
   assert(block_entry != nullptr);
   const bool no_io = (ro.read_tier == kBlockCacheTier);
@@ -1509,7 +1540,9 @@ BlockBasedTable::BlockEntryIteratorState::BlockEntryIteratorState(
       icomparator_(icomparator),
       skip_filters_(skip_filters),
       is_index_(is_index),
-      block_map_(block_map) {}
+      block_map_(block_map),
+      next_block_offset_(0),
+      num_sequential_blocks_(0) {}
 
 InternalIterator*
 BlockBasedTable::BlockEntryIteratorState::NewSecondaryIterator(
@@ -1535,8 +1568,27 @@ BlockBasedTable::BlockEntryIteratorState::NewSecondaryIterator(
           &rep->internal_comparator, nullptr, true, rep->ioptions.statistics);
     }
   }
+  // Blocks of mmapped files are never copied, so there is nothing to gain
+  if (s.ok() && !is_index_ && read_options_.readahead_size == 0 &&
+      !rep->ioptions.allow_mmap_reads) {
+    if (handle.offset() == next_block_offset_) {
+      num_sequential_blocks_++;
+    } else {
+      num_sequential_blocks_ = 0;
+      prefetch_buffer_.reset();
+    }
+    next_block_offset_ = handle.offset() + handle.size() + kBlockTrailerSize;
+    // The buffer only reads ahead when a block is not found in the block
+    // cache, and then doubles its readahead size for the next time
+    if (num_sequential_blocks_ >= kMinSequentialBlocksForReadahead &&
+        prefetch_buffer_ == nullptr) {
+      prefetch_buffer_.reset(new FilePrefetchBuffer(
+          rep->file.get(), kInitAutoReadaheadSize, kMaxAutoReadaheadSize,
+          rep->ioptions.statistics));
+    }
+  }
   return NewDataBlockIterator(rep, read_options_, handle, nullptr, is_index_,
-                              s);
+                              s, prefetch_buffer_.get());
 }
 
 bool BlockBasedTable::BlockEntryIteratorState::PrefixMayMatch(
@@ -1700,6 +1752,11 @@ InternalIterator* BlockBasedTable::NewRangeTombstoneIterator(
   return NewDataBlockIterator(rep_, read_options, Slice(str));
 }
 
+std::shared_ptr<const FragmentedRangeTombstoneList>
+BlockBasedTable::GetFragmentedRangeTombstones() {
+  return rep_->fragmented_range_dels;
+}
+
 bool BlockBasedTable::FullFilterKeyMayMatch(const ReadOptions& read_options,
                                             FilterBlockReader* filter,
                                             const Slice& internal_key,
@@ -1780,16 +1837,24 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
           break;
         }
 
-        // Call the *saver function on each entry/block until it returns false
-        for (biter.Seek(key); biter.Valid(); biter.Next()) {
-          ParsedInternalKey parsed_key;
-          if (!ParseInternalKey(biter.key(), &parsed_key)) {
-            s = Status::Corruption(Slice());
-          }
-
-          if (!get_context->SaveValue(parsed_key, biter.value(), &biter)) {
-            done = true;
-            break;
+        bool may_exist = biter.SeekForGet(key);
+        if (!may_exist) {
+          // The data block hash index shows that the key is neither in this
+          // block nor in any of the following ones.
+          done = true;
+        } else {
+          // Call the *saver function on each entry/block until it returns
+          // false
+          for (; biter.Valid(); biter.Next()) {
+            ParsedInternalKey parsed_key;
+            if (!ParseInternalKey(biter.key(), &parsed_key)) {
+              s = Status::Corruption(Slice());
+            }
+
+            if (!get_context->SaveValue(parsed_key, biter.value(), &biter)) {
+              done = true;
+              break;
+            }
           }
         }
         s = biter.status();
@@ -1813,6 +1878,171 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
   return s;
 }
 
+void BlockBasedTable::MultiGet(const ReadOptions& read_options,
+                               size_t num_keys, const Slice* keys,
+                               GetContext** get_contexts, Status* statuses,
+                               bool skip_filters) {
+  if (num_keys == 0) {
+    return;
+  }
+  const bool no_io = read_options.read_tier == kBlockCacheTier;
+  CachableEntry<FilterBlockReader> filter_entry;
+  if (!skip_filters) {
+    filter_entry = GetFilter(/*prefetch_buffer*/ nullptr, no_io);
+  }
+  FilterBlockReader* filter = filter_entry.value;
+
+  // The index iterator is only created once some key passes the full filter.
+  BlockIter iiter_on_stack;
+  InternalIterator* iiter = nullptr;
+  std::unique_ptr<InternalIterator> iiter_unique_ptr;
+  auto init_index_iterator = [&]() {
+    if (iiter == nullptr) {
+      iiter = NewIndexIterator(read_options, &iiter_on_stack);
+      if (iiter != &iiter_on_stack) {
+        iiter_unique_ptr.reset(iiter);
+      }
+    }
+  };
+
+  std::vector<bool> key_may_match(num_keys);
+  bool any_key_may_match = false;
+  for (size_t i = 0; i < num_keys; ++i) {
+    key_may_match[i] = FullFilterKeyMayMatch(read_options, filter, keys[i],
+                                             no_io);
+    any_key_may_match = any_key_may_match || key_may_match[i];
+  }
+
+  // Read the data blocks of all keys that miss the block cache with one
+  // MultiRead(), so that their I/O can proceed in parallel. Only the first
+  // block a key could be in is read; the rare key that spans blocks reads
+  // the others by itself. Blocks that fail to be read this way are simply
+  // read again below.
+  std::unique_ptr<FilePrefetchBuffer> prefetch_buffer;
+  if (!no_io && num_keys > 1 && any_key_may_match &&
+      !rep_->ioptions.allow_mmap_reads &&
+      rep_->table_options.block_cache_compressed == nullptr) {
+    init_index_iterator();
+    std::vector<std::pair<uint64_t, size_t>> ranges;
+    bool first = true;
+    uint64_t prev_offset = 0;
+    for (size_t i = 0; i < num_keys; ++i) {
+      if (!key_may_match[i]) {
+        continue;
+      }
+      iiter->Seek(keys[i]);
+      if (!iiter->Valid()) {
+        continue;
+      }
+      BlockHandle handle;
+      Slice handle_input = iiter->value();
+      if (!handle.DecodeFrom(&handle_input).ok() ||
+          (!first && handle.offset() == prev_offset)) {
+        continue;
+      }
+      first = false;
+      prev_offset = handle.offset();
+      if (!BlockInCache(handle)) {
+        ranges.emplace_back(
+            handle.offset(),
+            static_cast<size_t>(handle.size()) + kBlockTrailerSize);
+      }
+    }
+    if (ranges.size() > 1) {
+      TEST_SYNC_POINT_CALLBACK("BlockBasedTable::MultiGet:PrefetchRanges",
+                               &ranges);
+      prefetch_buffer.reset(new FilePrefetchBuffer());
+      prefetch_buffer->PrefetchRanges(rep_->file.get(), std::move(ranges));
+    }
+  }
+
+  // The most recently read data block and its offset in the file. Since keys
+  // are sorted, consecutive keys usually land in the same block, which is
+  // then searched again instead of being re-fetched. Values are copied out
+  // of the block (no value pinner is handed to the GetContext) so that the
+  // block stays owned by this iterator for the rest of the batch.
+  std::unique_ptr<InternalIterator> biter;
+  uint64_t biter_offset = 0;
+
+  for (size_t i = 0; i < num_keys; ++i) {
+    const Slice& key = keys[i];
+    GetContext* get_context = get_contexts[i];
+    Status s;
+
+    if (!key_may_match[i]) {
+      RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
+      statuses[i] = s;
+      continue;
+    }
+    init_index_iterator();
+
+    bool done = false;
+    for (iiter->Seek(key); iiter->Valid() && !done; iiter->Next()) {
+      Slice handle_value = iiter->value();
+
+      BlockHandle handle;
+      Slice handle_input = handle_value;
+      bool handle_ok = handle.DecodeFrom(&handle_input).ok();
+      bool not_exist_in_filter =
+          filter != nullptr && filter->IsBlockBased() == true && handle_ok &&
+          !filter->KeyMayMatch(ExtractUserKey(key), handle.offset(), no_io);
+
+      if (not_exist_in_filter) {
+        RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
+        break;
+      }
+
+      if (!handle_ok) {
+        biter.reset(NewDataBlockIterator(rep_, read_options, handle_value));
+      } else if (biter == nullptr || handle.offset() != biter_offset) {
+        biter.reset(NewDataBlockIterator(rep_, read_options, handle, nullptr,
+                                         false /* is_index */, Status(),
+                                         prefetch_buffer.get()));
+        biter_offset = handle.offset();
+      }
+
+      if (read_options.read_tier == kBlockCacheTier &&
+          biter->status().IsIncomplete()) {
+        // couldn't get block from block_cache
+        get_context->MarkKeyMayExist();
+        biter.reset();
+        break;
+      }
+      if (!biter->status().ok()) {
+        s = biter->status();
+        biter.reset();
+        break;
+      }
+
+      for (biter->Seek(key); biter->Valid(); biter->Next()) {
+        ParsedInternalKey parsed_key;
+        if (!ParseInternalKey(biter->key(), &parsed_key)) {
+          s = Status::Corruption(Slice());
+        }
+
+        if (!get_context->SaveValue(parsed_key, biter->value())) {
+          done = true;
+          break;
+        }
+      }
+      s = biter->status();
+      if (done) {
+        // Avoid the extra Next which is expensive in two-level indexes
+        break;
+      }
+    }
+    if (s.ok()) {
+      s = iiter->status();
+    }
+    statuses[i] = s;
+  }
+
+  // See the comment at the end of Get()
+  if (!rep_->filter_entry.IsSet()) {
+    filter_entry.Release(rep_->table_options.block_cache.get());
+  }
+}
+
 Status BlockBasedTable::Prefetch(const Slice* const begin,
                                  const Slice* const end) {
   auto& comparator = rep_->internal_comparator;
@@ -1909,7 +2139,7 @@ Status BlockBasedTable::VerifyChecksumInBlocks(InternalIterator* index_iter) {
     s = ReadBlockContents(rep_->file.get(), nullptr /* prefetch buffer */,
                           rep_->footer, ReadOptions(), handle, &contents,
                           rep_->ioptions, false /* decompress */,
-                          Slice() /*compression dict*/,
+                          UncompressionDict::GetEmptyDict(),
                           rep_->persistent_cache_options);
     if (!s.ok()) {
       break;
@@ -1918,6 +2148,23 @@ Status BlockBasedTable::VerifyChecksumInBlocks(InternalIterator* index_iter) {
   return s;
 }
 
+bool BlockBasedTable::BlockInCache(const BlockHandle& handle) const {
+  Cache* block_cache = rep_->table_options.block_cache.get();
+  if (block_cache == nullptr) {
+    return false;
+  }
+  char cache_key_storage[kMaxCacheKeyPrefixSize + kMaxVarint64Length];
+  Slice cache_key =
+      GetCacheKey(rep_->cache_key_prefix, rep_->cache_key_prefix_size, handle,
+                  cache_key_storage);
+  Cache::Handle* cache_handle = block_cache->Lookup(cache_key);
+  if (cache_handle == nullptr) {
+    return false;
+  }
+  block_cache->Release(cache_handle);
+  return true;
+}
+
 bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
                                       const Slice& key) {
   std::unique_ptr<InternalIterator> iiter(NewIndexIterator(options));
@@ -1940,9 +2187,7 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
 
   s = GetDataBlockFromCache(
       cache_key, ckey, block_cache, nullptr, rep_->ioptions, options, &block,
-      rep_->table_options.format_version,
-      rep_->compression_dict_block ? rep_->compression_dict_block->data
-                                   : Slice(),
+      rep_->table_options.format_version, rep_->GetUncompressionDict(),
       0 /* read_amp_bytes_per_bit */);
   assert(s.ok());
   bool in_cache = block.value != nullptr;
@@ -2065,6 +2310,44 @@ uint64_t BlockBasedTable::ApproximateOffsetOf(const Slice& key) {
   return result;
 }
 
+Status BlockBasedTable::ApproximateKeyAnchors(const ReadOptions& read_options,
+                                              std::vector<Anchor>* anchors) {
+  uint64_t num_blocks = 0;
+  if (rep_->table_properties) {
+    num_blocks = rep_->table_properties->num_data_blocks;
+  }
+  // Emit an anchor every `blocks_per_anchor` data blocks so that large files
+  // are still sampled with a bounded number of anchors.
+  const uint64_t blocks_per_anchor =
+      std::max<uint64_t>(1, (num_blocks + kMaxNumAnchors - 1) / kMaxNumAnchors);
+
+  unique_ptr<InternalIterator> index_iter(NewIndexIterator(read_options));
+  uint64_t range_size = 0;
+  uint64_t blocks_in_range = 0;
+  std::string last_key;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    BlockHandle handle;
+    Slice input = index_iter->value();
+    Status s = handle.DecodeFrom(&input);
+    if (!s.ok()) {
+      return s;
+    }
+    range_size += handle.size() + kBlockTrailerSize;
+    // Index keys separate data blocks: each one is at or after the last key
+    // of the block it points to and before the first key of the next block.
+    last_key = ExtractUserKey(index_iter->key()).ToString();
+    if (++blocks_in_range == blocks_per_anchor) {
+      anchors->emplace_back(last_key, range_size);
+      range_size = 0;
+      blocks_in_range = 0;
+    }
+  }
+  if (blocks_in_range > 0) {
+    anchors->emplace_back(last_key, range_size);
+  }
+  return index_iter->status();
+}
+
 bool BlockBasedTable::TEST_filter_block_preloaded() const {
   return rep_->filter != nullptr;
 }
@@ -2198,7 +2481,7 @@ Status BlockBasedTable::DumpTable(WritableFile* out_file) {
         if (ReadBlockContents(rep_->file.get(), nullptr /* prefetch_buffer */,
                               rep_->footer, ReadOptions(), handle, &block,
                               rep_->ioptions, false /*decompress*/,
-                              Slice() /*compression dict*/,
+                              UncompressionDict::GetEmptyDict(),
                               rep_->persistent_cache_options)
                 .ok()) {
           rep_->filter.reset(new BlockBasedFilterBlockReader(
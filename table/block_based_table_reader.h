@@ -107,10 +107,22 @@ class BlockBasedTable : public TableReader {
   InternalIterator* NewRangeTombstoneIterator(
       const ReadOptions& read_options) override;
 
+  std::shared_ptr<const FragmentedRangeTombstoneList>
+  GetFragmentedRangeTombstones() override;
+
   // @param skip_filters Disables loading/accessing the filter block
   Status Get(const ReadOptions& readOptions, const Slice& key,
              GetContext* get_context, bool skip_filters = false) override;
 
+  // Looks up a sorted batch of keys, fetching the filter and index once and
+  // reading each distinct data block only once for consecutive keys that
+  // fall into it. The data blocks that are not in the block cache are read
+  // together with one RandomAccessFile::MultiRead().
+  // @param skip_filters Disables loading/accessing the filter block
+  void MultiGet(const ReadOptions& readOptions, size_t num_keys,
+                const Slice* keys, GetContext** get_contexts, Status* statuses,
+                bool skip_filters = false) override;
+
   // Pre-fetch the disk blocks that correspond to the key range specified by
   // (kbegin, kend). The call will return error status in the event of
   // IO or iteration error.
@@ -124,6 +136,11 @@ class BlockBasedTable : public TableReader {
   // be close to the file length.
   uint64_t ApproximateOffsetOf(const Slice& key) override;
 
+  // Samples the index so that at most kMaxNumAnchors anchors are returned.
+  Status ApproximateKeyAnchors(const ReadOptions& read_options,
+                               std::vector<Anchor>* anchors) override;
+  static const size_t kMaxNumAnchors = 128;
+
   // Returns true if the block for the specified key is in cache.
   // REQUIRES: key is in this table && block cache enabled
   bool TEST_KeyInCache(const ReadOptions& options, const Slice& key);
@@ -219,11 +236,10 @@ class BlockBasedTable : public TableReader {
                                                 const Slice& index_value,
                                                 BlockIter* input_iter = nullptr,
                                                 bool is_index = false);
-  static InternalIterator* NewDataBlockIterator(Rep* rep, const ReadOptions& ro,
-                                                const BlockHandle& block_hanlde,
-                                                BlockIter* input_iter = nullptr,
-                                                bool is_index = false,
-                                                Status s = Status());
+  static InternalIterator* NewDataBlockIterator(
+      Rep* rep, const ReadOptions& ro, const BlockHandle& block_hanlde,
+      BlockIter* input_iter = nullptr, bool is_index = false,
+      Status s = Status(), FilePrefetchBuffer* prefetch_buffer = nullptr);
   // If block cache enabled (compressed or uncompressed), looks for the block
   // identified by handle in (1) uncompressed cache, (2) compressed cache, and
   // then (3) file. If found, inserts into the cache(s) that were searched
@@ -233,12 +249,10 @@ class BlockBasedTable : public TableReader {
   // @param block_entry value is set to the uncompressed block if found. If
   //    in uncompressed block cache, also sets cache_handle to reference that
   //    block.
-  static Status MaybeLoadDataBlockToCache(FilePrefetchBuffer* prefetch_buffer,
-                                          Rep* rep, const ReadOptions& ro,
-                                          const BlockHandle& handle,
-                                          Slice compression_dict,
-                                          CachableEntry<Block>* block_entry,
-                                          bool is_index = false);
+  static Status MaybeLoadDataBlockToCache(
+      FilePrefetchBuffer* prefetch_buffer, Rep* rep, const ReadOptions& ro,
+      const BlockHandle& handle, const UncompressionDict& compression_dict,
+      CachableEntry<Block>* block_entry, bool is_index = false);
 
   // For the following two functions:
   // if `no_io == true`, we will not try to read filter/index from sst file
@@ -274,7 +288,7 @@ class BlockBasedTable : public TableReader {
       Cache* block_cache, Cache* block_cache_compressed,
       const ImmutableCFOptions& ioptions, const ReadOptions& read_options,
       BlockBasedTable::CachableEntry<Block>* block, uint32_t format_version,
-      const Slice& compression_dict, size_t read_amp_bytes_per_bit,
+      const UncompressionDict& compression_dict, size_t read_amp_bytes_per_bit,
       bool is_index = false);
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
@@ -292,7 +306,7 @@ class BlockBasedTable : public TableReader {
       Cache* block_cache, Cache* block_cache_compressed,
       const ReadOptions& read_options, const ImmutableCFOptions& ioptions,
       CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-      const Slice& compression_dict, size_t read_amp_bytes_per_bit,
+      const UncompressionDict& compression_dict, size_t read_amp_bytes_per_bit,
       bool is_index = false, Cache::Priority pri = Cache::Priority::LOW);
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
@@ -316,6 +330,9 @@ class BlockBasedTable : public TableReader {
                              FilterBlockReader* filter, const Slice& user_key,
                              const bool no_io) const;
 
+  // Returns true if the uncompressed block is in the block cache
+  bool BlockInCache(const BlockHandle& handle) const;
+
   // Read the meta block from sst.
   static Status ReadMetaBlock(Rep* rep, FilePrefetchBuffer* prefetch_buffer,
                               std::unique_ptr<Block>* meta_block,
@@ -372,6 +389,17 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   bool is_index_;
   std::unordered_map<uint64_t, CachableEntry<Block>>* block_map_;
   port::RWMutex cleaner_mu;
+
+  // Implicit readahead for data blocks when ReadOptions::readahead_size is
+  // not set. It is turned on after kMinSequentialBlocksForReadahead blocks
+  // were read in file order, and turned off again by any other access.
+  static const int kMinSequentialBlocksForReadahead = 2;
+  static const size_t kInitAutoReadaheadSize = 8 * 1024;
+  static const size_t kMaxAutoReadaheadSize = 256 * 1024;
+  // Offset of the block following the last one read
+  uint64_t next_block_offset_;
+  int num_sequential_blocks_;
+  std::unique_ptr<FilePrefetchBuffer> prefetch_buffer_;
 };
 
 // CachableEntry represents the entries that *may* be fetched from block cache.
@@ -452,6 +480,14 @@ struct BlockBasedTable::Rep {
   // is easier because the Slice member depends on the continued existence of
   // another member ("allocation").
   std::unique_ptr<const BlockContents> compression_dict_block;
+  // Refers to compression_dict_block, plus its digested form when the table is
+  // compressed with ZSTD. nullptr if the table has no dictionary.
+  std::unique_ptr<const UncompressionDict> uncompression_dict;
+
+  const UncompressionDict& GetUncompressionDict() const {
+    return uncompression_dict ? *uncompression_dict
+                              : UncompressionDict::GetEmptyDict();
+  }
   BlockBasedTableOptions::IndexType index_type;
   bool hash_index_allow_collision;
   bool whole_key_filtering;
@@ -473,6 +509,9 @@ struct BlockBasedTable::Rep {
   // cache is enabled.
   CachableEntry<Block> range_del_entry;
   BlockHandle range_del_handle;
+  // Range tombstones fragmented once when the table is opened. nullptr if the
+  // table has none or they could not be read.
+  std::shared_ptr<const FragmentedRangeTombstoneList> fragmented_range_dels;
 
   // If global_seqno is used, all Keys in this file will have the same
   // seqno with value `global_seqno`.
@@ -462,6 +462,120 @@ TEST_F(BlockTest, BlockWithReadAmpBitmap) {
   }
 }
 
+TEST_F(BlockTest, DataBlockHashIndex) {
+  Random rnd(301);
+  InternalKeyComparator icmp(BytewiseComparator());
+  const int kNumUserKeys = 500;
+
+  // Every third user key has several versions, some of which end up in
+  // different restart intervals.
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumUserKeys; i++) {
+    std::string user_key = GenerateKey(2 * i, 0, 0, &rnd);
+    int num_versions = (i % 3 == 0) ? 3 : 1;
+    for (int v = num_versions; v > 0; v--) {
+      keys.push_back(
+          InternalKey(user_key, static_cast<SequenceNumber>(100 + v),
+                      kTypeValue)
+              .Encode()
+              .ToString());
+      values.push_back(RandomString(&rnd, 20));
+    }
+  }
+
+  BlockBuilder builder(16, true /* use_delta_encoding */,
+                       BlockBasedTableOptions::kDataBlockBinaryAndHash);
+  for (size_t i = 0; i < keys.size(); i++) {
+    builder.Add(keys[i], values[i]);
+  }
+  Slice rawblock = builder.Finish();
+
+  BlockContents contents;
+  contents.data = rawblock;
+  contents.cachable = false;
+  Block reader(std::move(contents), kDisableGlobalSequenceNumber);
+  ASSERT_EQ(BlockBasedTableOptions::kDataBlockBinaryAndHash,
+            reader.IndexType());
+  ASSERT_EQ((keys.size() + 15) / 16, reader.NumRestarts());
+
+  // Iteration is unaffected by the hash index
+  std::unique_ptr<InternalIterator> iter(reader.NewIterator(&icmp));
+  size_t count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), count++) {
+    ASSERT_EQ(keys[count], iter->key().ToString());
+    ASSERT_EQ(values[count], iter->value().ToString());
+  }
+  ASSERT_EQ(keys.size(), count);
+
+  // Point lookups of existing keys at the latest and at older snapshots
+  BlockIter biter;
+  reader.NewIterator(&icmp, &biter);
+  for (size_t i = 0; i < keys.size(); i++) {
+    ParsedInternalKey parsed;
+    ASSERT_TRUE(ParseInternalKey(keys[i], &parsed));
+    InternalKey lookup_key(parsed.user_key, parsed.sequence,
+                           kValueTypeForSeek);
+    ASSERT_TRUE(biter.SeekForGet(lookup_key.Encode()));
+    ASSERT_TRUE(biter.Valid());
+    ASSERT_EQ(keys[i], biter.key().ToString());
+    ASSERT_EQ(values[i], biter.value().ToString());
+
+    InternalKey latest_key(parsed.user_key, kMaxSequenceNumber,
+                           kValueTypeForSeek);
+    ASSERT_TRUE(biter.SeekForGet(latest_key.Encode()));
+    ASSERT_TRUE(biter.Valid());
+    ASSERT_EQ(parsed.user_key, ExtractUserKey(biter.key()));
+  }
+
+  // Keys that are not in the block: either the lookup is cut short, or the
+  // iterator is positioned where Seek() would have put it.
+  for (int i = 0; i < kNumUserKeys; i++) {
+    std::string user_key = GenerateKey(2 * i + 1, 0, 0, &rnd);
+    InternalKey lookup_key(user_key, kMaxSequenceNumber, kValueTypeForSeek);
+    if (biter.SeekForGet(lookup_key.Encode()) && biter.Valid()) {
+      ASSERT_NE(Slice(user_key), ExtractUserKey(biter.key()));
+    }
+  }
+  // A user key beyond the last key of the block may be in the next block
+  InternalKey past_last_key(GenerateKey(2 * kNumUserKeys, 0, 0, &rnd),
+                            kMaxSequenceNumber, kValueTypeForSeek);
+  ASSERT_TRUE(biter.SeekForGet(past_last_key.Encode()));
+  ASSERT_FALSE(biter.Valid());
+}
+
+TEST_F(BlockTest, DataBlockHashIndexTooManyRestarts) {
+  Random rnd(301);
+  InternalKeyComparator icmp(BytewiseComparator());
+  BlockBuilder builder(1 /* restart interval */, true /* use_delta_encoding */,
+                       BlockBasedTableOptions::kDataBlockBinaryAndHash);
+  // More restart intervals than the hash index can address
+  std::vector<std::string> keys;
+  for (int i = 0; i < 300; i++) {
+    keys.push_back(InternalKey(GenerateKey(i, 0, 0, &rnd), 1, kTypeValue)
+                       .Encode()
+                       .ToString());
+    builder.Add(keys.back(), "value");
+  }
+  Slice rawblock = builder.Finish();
+
+  BlockContents contents;
+  contents.data = rawblock;
+  contents.cachable = false;
+  Block reader(std::move(contents), kDisableGlobalSequenceNumber);
+  ASSERT_EQ(BlockBasedTableOptions::kDataBlockBinarySearch,
+            reader.IndexType());
+  ASSERT_EQ(300U, reader.NumRestarts());
+
+  BlockIter biter;
+  reader.NewIterator(&icmp, &biter);
+  for (const auto& key : keys) {
+    ASSERT_TRUE(biter.SeekForGet(key));
+    ASSERT_TRUE(biter.Valid());
+    ASSERT_EQ(key, biter.key().ToString());
+  }
+}
+
 TEST_F(BlockTest, ReadAmpBitmapPow2) {
   std::shared_ptr<Statistics> stats = rocksdb::CreateDBStatistics();
   ASSERT_EQ(BlockReadAmpBitmap(100, 1, stats.get()).GetBytesPerBit(), 1);
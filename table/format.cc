@@ -343,7 +343,7 @@ Status ReadBlockContents(RandomAccessFileReader* file,
                          const BlockHandle& handle, BlockContents* contents,
                          const ImmutableCFOptions& ioptions,
                          bool decompression_requested,
-                         const Slice& compression_dict,
+                         const UncompressionDict& compression_dict,
                          const PersistentCacheOptions& cache_options) {
   Status status;
   Slice slice;
@@ -465,7 +465,7 @@ Status ReadBlockContents(RandomAccessFileReader* file,
 
 Status UncompressBlockContentsForCompressionType(
     const char* data, size_t n, BlockContents* contents,
-    uint32_t format_version, const Slice& compression_dict,
+    uint32_t format_version, const UncompressionDict& compression_dict,
     CompressionType compression_type, const ImmutableCFOptions &ioptions) {
   std::unique_ptr<char[]> ubuf;
 
@@ -493,7 +493,7 @@ Status UncompressBlockContentsForCompressionType(
       ubuf.reset(Zlib_Uncompress(
           data, n, &decompress_size,
           GetCompressFormatForVersion(kZlibCompression, format_version),
-          compression_dict));
+          compression_dict.GetRawDict()));
       if (!ubuf) {
         static char zlib_corrupt_msg[] =
           "Zlib not supported or corrupted Zlib compressed block contents";
@@ -518,7 +518,7 @@ Status UncompressBlockContentsForCompressionType(
       ubuf.reset(LZ4_Uncompress(
           data, n, &decompress_size,
           GetCompressFormatForVersion(kLZ4Compression, format_version),
-          compression_dict));
+          compression_dict.GetRawDict()));
       if (!ubuf) {
         static char lz4_corrupt_msg[] =
           "LZ4 not supported or corrupted LZ4 compressed block contents";
@@ -531,7 +531,7 @@ Status UncompressBlockContentsForCompressionType(
       ubuf.reset(LZ4_Uncompress(
           data, n, &decompress_size,
           GetCompressFormatForVersion(kLZ4HCCompression, format_version),
-          compression_dict));
+          compression_dict.GetRawDict()));
       if (!ubuf) {
         static char lz4hc_corrupt_msg[] =
           "LZ4HC not supported or corrupted LZ4HC compressed block contents";
@@ -584,7 +584,7 @@ Status UncompressBlockContentsForCompressionType(
 // format_version is the block format as defined in include/rocksdb/table.h
 Status UncompressBlockContents(const char* data, size_t n,
                                BlockContents* contents, uint32_t format_version,
-                               const Slice& compression_dict,
+                               const UncompressionDict& compression_dict,
                                const ImmutableCFOptions &ioptions) {
   assert(data[n] != kNoCompression);
   return UncompressBlockContentsForCompressionType(
@@ -18,6 +18,7 @@
 #include "options/cf_options.h"
 #include "port/port.h"  // noexcept
 #include "table/persistent_cache_options.h"
+#include "util/compression.h"
 #include "util/file_reader_writer.h"
 
 namespace rocksdb {
@@ -218,7 +219,9 @@ extern Status ReadBlockContents(
     RandomAccessFileReader* file, FilePrefetchBuffer* prefetch_buffer,
     const Footer& footer, const ReadOptions& options, const BlockHandle& handle,
     BlockContents* contents, const ImmutableCFOptions& ioptions,
-    bool do_uncompress = true, const Slice& compression_dict = Slice(),
+    bool do_uncompress = true,
+    const UncompressionDict& compression_dict =
+        UncompressionDict::GetEmptyDict(),
     const PersistentCacheOptions& cache_options = PersistentCacheOptions());
 
 // The 'data' points to the raw block contents read in from file.
@@ -231,7 +234,7 @@ extern Status ReadBlockContents(
 extern Status UncompressBlockContents(const char* data, size_t n,
                                       BlockContents* contents,
                                       uint32_t compress_format_version,
-                                      const Slice& compression_dict,
+                                      const UncompressionDict& compression_dict,
                                       const ImmutableCFOptions &ioptions);
 
 // This is an extension to UncompressBlockContents that accepts
@@ -239,8 +242,9 @@ extern Status UncompressBlockContents(const char* data, size_t n,
 // with no compression header.
 extern Status UncompressBlockContentsForCompressionType(
     const char* data, size_t n, BlockContents* contents,
-    uint32_t compress_format_version, const Slice& compression_dict,
-    CompressionType compression_type, const ImmutableCFOptions &ioptions);
+    uint32_t compress_format_version,
+    const UncompressionDict& compression_dict, CompressionType compression_type,
+    const ImmutableCFOptions &ioptions);
 
 // Implementation details follow.  Clients should ignore,
 
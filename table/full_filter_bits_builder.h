@@ -70,4 +70,10 @@ class FullFilterBitsBuilder : public FilterBitsBuilder {
   void operator=(const FullFilterBitsBuilder&);
 };
 
+// Returns the names under which a table may store filters that the filter
+// policy named `policy_name` can read, starting with its own. The built-in
+// policies read the filters of each other.
+extern std::vector<std::string> GetCompatibleFilterPolicyNames(
+    const std::string& policy_name);
+
 }  // namespace rocksdb
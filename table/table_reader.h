@@ -9,6 +9,8 @@
 
 #pragma once
 #include <memory>
+#include <string>
+#include <vector>
 #include "table/internal_iterator.h"
 
 namespace rocksdb {
@@ -21,6 +23,7 @@ struct ReadOptions;
 struct TableProperties;
 class GetContext;
 class InternalIterator;
+class FragmentedRangeTombstoneList;
 
 // A Table is a sorted map from strings to strings.  Tables are
 // immutable and persistent.  A Table may be safely accessed from
@@ -47,6 +50,14 @@ class TableReader {
     return nullptr;
   }
 
+  // Returns the table's range tombstones fragmented into a binary-searchable
+  // list that is built once and shared by all readers. nullptr means the
+  // reader does not cache one and NewRangeTombstoneIterator() should be used.
+  virtual std::shared_ptr<const FragmentedRangeTombstoneList>
+  GetFragmentedRangeTombstones() {
+    return nullptr;
+  }
+
   // Given a key, return an approximate byte offset in the file where
   // the data for that key begins (or would begin if the key were
   // present in the file).  The returned value is in terms of file
@@ -55,6 +66,24 @@ class TableReader {
   // be close to the file length.
   virtual uint64_t ApproximateOffsetOf(const Slice& key) = 0;
 
+  // A user key in the table together with the approximate number of file
+  // bytes holding keys between the previous anchor and this one.
+  struct Anchor {
+    Anchor(const Slice& _user_key, uint64_t _range_size)
+        : user_key(_user_key.ToString()), range_size(_range_size) {}
+    std::string user_key;
+    uint64_t range_size;
+  };
+
+  // Appends a bounded number of anchors, in key order, that divide the
+  // table's data into roughly equally sized ranges. The last anchor is at or
+  // after the largest key in the table. Used to split compactions into
+  // similarly sized key ranges.
+  virtual Status ApproximateKeyAnchors(const ReadOptions& read_options,
+                                       std::vector<Anchor>* anchors) {
+    return Status::NotSupported("ApproximateKeyAnchors() not supported");
+  }
+
   // Set up the table for Compaction. Might change some parameters with
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
@@ -81,6 +110,19 @@ class TableReader {
   virtual Status Get(const ReadOptions& readOptions, const Slice& key,
                      GetContext* get_context, bool skip_filters = false) = 0;
 
+  // Batched version of Get(). keys[0, num_keys) must be sorted in ascending
+  // internal key order; get_contexts[i] and statuses[i] belong to keys[i].
+  // Implementations may share filter probes and data block reads among keys
+  // that fall into the same block. The default implementation calls Get()
+  // once per key.
+  virtual void MultiGet(const ReadOptions& readOptions, size_t num_keys,
+                        const Slice* keys, GetContext** get_contexts,
+                        Status* statuses, bool skip_filters = false) {
+    for (size_t i = 0; i < num_keys; ++i) {
+      statuses[i] = Get(readOptions, keys[i], get_contexts[i], skip_filters);
+    }
+  }
+
   // Prefetch data corresponding to a give range of keys
   // Typically this functionality is required for table implementations that
   // persists the data on a non volatile storage medium like disk/SSD
@@ -2536,6 +2536,106 @@ TEST_F(GeneralTableTest, ApproximateOffsetOfCompressed) {
   }
 }
 
+TEST_F(GeneralTableTest, CompressBlockReusesContext) {
+  std::vector<CompressionType> compression_types;
+  if (Zlib_Supported()) {
+    compression_types.push_back(kZlibCompression);
+  }
+  if (LZ4_Supported()) {
+    compression_types.push_back(kLZ4Compression);
+    compression_types.push_back(kLZ4HCCompression);
+  }
+  if (ZSTD_Supported()) {
+    compression_types.push_back(kZSTD);
+  }
+
+  Random rnd(301);
+  std::string dict_data;
+  test::CompressibleString(&rnd, 0.5, 4096, &dict_data);
+  Options options;
+  ImmutableCFOptions ioptions(options);
+  CompressionOptions compression_opts;
+  const uint32_t format_version = 2;
+  for (auto compression_type : compression_types) {
+    CompressionDict compression_dict(dict_data, compression_type,
+                                     compression_opts.level);
+    UncompressionDict uncompression_dict(
+        compression_dict.GetRawDict(), compression_type == kZSTD);
+    // Compress blocks one after another with the same context. Every block
+    // must still decompress on its own, i.e. no state may carry over.
+    CompressionContext compression_ctx;
+    for (int i = 0; i < 10; i++) {
+      std::string raw;
+      test::CompressibleString(&rnd, 0.25, 4096 + i * 512, &raw);
+      raw.append(dict_data, 0, 1024);
+      std::string compressed_output;
+      CompressionType type = compression_type;
+      Slice compressed =
+          CompressBlock(raw, compression_opts, &type, format_version,
+                        compression_dict, &compression_ctx, &compressed_output);
+      ASSERT_EQ(compression_type, type);
+      BlockContents contents;
+      ASSERT_OK(UncompressBlockContentsForCompressionType(
+          compressed.data(), compressed.size(), &contents, format_version,
+          uncompression_dict, type, ioptions));
+      ASSERT_EQ(raw, contents.data.ToString());
+    }
+  }
+}
+
+TEST_F(GeneralTableTest, ParallelCompressionProducesSameFile) {
+  if (!Zlib_Supported()) {
+    return;
+  }
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10, false));
+  BlockBasedTableFactory factory(table_options);
+  Options options;
+  const ImmutableCFOptions ioptions(options);
+  InternalKeyComparator ikc(options.comparator);
+  std::vector<std::unique_ptr<IntTblPropCollectorFactory>>
+      int_tbl_prop_collector_factories;
+  std::string column_family_name;
+
+  // Build the same table serially and with several compression threads.
+  std::string contents[2];
+  const uint32_t parallel_threads[2] = {1, 4};
+  for (int i = 0; i < 2; i++) {
+    unique_ptr<WritableFileWriter> file_writer(
+        test::GetWritableFileWriter(new test::StringSink()));
+    CompressionOptions compression_opts;
+    compression_opts.parallel_threads = parallel_threads[i];
+    std::unique_ptr<TableBuilder> builder(factory.NewTableBuilder(
+        TableBuilderOptions(ioptions, ikc, &int_tbl_prop_collector_factories,
+                            kZlibCompression, compression_opts,
+                            nullptr /* compression_dict */,
+                            false /* skip_filters */, column_family_name,
+                            -1 /* level */),
+        TablePropertiesCollectorFactory::Context::kUnknownColumnFamily,
+        file_writer.get()));
+
+    Random rnd(301);
+    for (int k = 0; k < 10000; k++) {
+      char key[20];
+      snprintf(key, sizeof(key), "key%08d", k);
+      InternalKey ikey(key, 0, kTypeValue);
+      std::string value;
+      test::CompressibleString(&rnd, 0.5, 100, &value);
+      builder->Add(ikey.Encode(), value);
+    }
+    ASSERT_OK(builder->Finish());
+    ASSERT_OK(file_writer->Flush());
+    ASSERT_EQ(builder->FileSize(), file_writer->GetFileSize());
+
+    test::StringSink* ss =
+        static_cast<test::StringSink*>(file_writer->writable_file());
+    contents[i] = ss->contents();
+  }
+  ASSERT_GT(contents[0].size(), 0U);
+  ASSERT_EQ(contents[0], contents[1]);
+}
+
 TEST_F(HarnessTest, Randomized) {
   std::vector<TestArgs> args = GenerateArgList();
   for (unsigned int i = 0; i < args.size(); i++) {
@@ -721,6 +721,11 @@ DEFINE_string(compression_type, "snappy",
 static enum rocksdb::CompressionType FLAGS_compression_type_e =
     rocksdb::kSnappyCompression;
 
+DEFINE_string(wal_compression, "none",
+              "Algorithm to use to compress the WAL, none or zstd");
+static enum rocksdb::CompressionType FLAGS_wal_compression_e =
+    rocksdb::kNoCompression;
+
 DEFINE_int32(compression_level, -1,
              "Compression level. For zlib this should be -1 for the "
              "default level, or between 0 and 9.");
@@ -733,6 +738,10 @@ DEFINE_int32(compression_zstd_max_train_bytes, 0,
              "Maximum size of training data passed to zstd's dictionary "
              "trainer.");
 
+DEFINE_int32(compression_parallel_threads, 1,
+             "Number of threads used to compress the data blocks of one SST "
+             "file.");
+
 static bool ValidateCompressionLevel(const char* flagname, int32_t value) {
   if (value < -1 || value > 9) {
     fprintf(stderr, "Invalid value for --%s: %d, must be between -1 and 9\n",
@@ -811,6 +820,9 @@ DEFINE_uint64(soft_pending_compaction_bytes_limit, 64ull * 1024 * 1024 * 1024,
 DEFINE_uint64(hard_pending_compaction_bytes_limit, 128ull * 1024 * 1024 * 1024,
               "Stop writes if pending compaction bytes exceed this number");
 
+DEFINE_bool(per_column_family_write_stall, false,
+            "Stall only the writes to the column families that need it");
+
 DEFINE_uint64(delayed_write_rate, 8388608u,
               "Limited bytes allowed to DB when soft_rate_limit or "
               "level0_slowdown_writes_trigger triggers");
@@ -818,6 +830,27 @@ DEFINE_uint64(delayed_write_rate, 8388608u,
 DEFINE_bool(enable_pipelined_write, true,
             "Allow WAL and memtable writes to be pipelined");
 
+DEFINE_uint64(max_write_batch_group_size_bytes,
+              rocksdb::Options().max_write_batch_group_size_bytes,
+              "Maximum total size of the batches of a write group");
+
+DEFINE_bool(adaptive_write_batch_group_size, false,
+            "Adapt the size of write groups to the observed WAL latencies");
+
+DEFINE_uint64(wal_stripes, rocksdb::Options().wal_stripes,
+              "Number of log files the WAL is striped over, with "
+              "enable_pipelined_write");
+
+DEFINE_uint64(wal_sync_interval_micros,
+              rocksdb::Options().wal_sync_interval_micros,
+              "If non-zero, sync writes wait for a background thread that "
+              "syncs the WAL every this many microseconds");
+
+DEFINE_uint64(wal_sync_interval_bytes,
+              rocksdb::Options().wal_sync_interval_bytes,
+              "If non-zero, the WAL syncer also syncs once this many bytes "
+              "are unsynced");
+
 DEFINE_bool(allow_concurrent_memtable_write, true,
             "Allow multi-writers to update mem tables in parallel.");
 
@@ -950,6 +983,9 @@ DEFINE_int64(keys_per_prefix, 0, "control average number of keys generated "
 DEFINE_int32(memtable_insert_with_hint_prefix_size, 0,
              "If non-zero, enable "
              "memtable insert with hint with the given prefix size.");
+DEFINE_bool(memtable_sorted_batch_insert, false,
+            "Sort the keys of each write batch and insert them into the "
+            "skiplist memtable in one pass");
 DEFINE_bool(enable_io_prio, false, "Lower the background flush/compaction "
             "threads' IO priority");
 DEFINE_bool(identity_as_first_hash, false, "the first hash function of cuckoo "
@@ -993,9 +1029,21 @@ DEFINE_double(cuckoo_hash_ratio, 0.9, "Hash ratio for Cuckoo SST table.");
 DEFINE_bool(use_hash_search, false, "if use kHashSearch "
             "instead of kBinarySearch. "
             "This is valid if only we use BlockTable");
+DEFINE_bool(use_data_block_hash_index, false,
+            "if use kDataBlockBinaryAndHash instead of kDataBlockBinarySearch "
+            "for data blocks. This is valid if only we use BlockTable");
+DEFINE_double(data_block_hash_table_util_ratio, 0.75,
+              "util ratio for data block hash index table. "
+              "This is only valid if use_data_block_hash_index is set");
 DEFINE_bool(use_block_based_filter, false, "if use kBlockBasedFilter "
             "instead of kFullFilter for filter block. "
             "This is valid if only we use BlockTable");
+DEFINE_bool(use_cache_local_bloom, false, "if use the cache-local full "
+            "filter format of NewCacheLocalBloomFilterPolicy() with "
+            "bloom_bits bits per key. Ignored with use_block_based_filter");
+DEFINE_bool(use_xor_filter, false, "if use the xor filters of "
+            "NewXorFilterPolicy() with the false positive rate of bloom_bits "
+            "bits per key. Ignored with use_block_based_filter");
 DEFINE_string(merge_operator, "", "The merge operator to use with the database."
               "If a new merge operator is specified, be sure to use fresh"
               " database The possible merge operators are defined in"
@@ -2106,6 +2154,21 @@ class Benchmark {
     std::shared_ptr<TimestampEmulator> timestamp_emulator_;
   };
 
+  const FilterPolicy* NewFilterPolicyFromFlags() {
+    if (FLAGS_bloom_bits < 0) {
+      return nullptr;
+    }
+    if (!FLAGS_use_block_based_filter) {
+      if (FLAGS_use_xor_filter) {
+        return NewXorFilterPolicy(FLAGS_bloom_bits);
+      } else if (FLAGS_use_cache_local_bloom) {
+        return NewCacheLocalBloomFilterPolicy(FLAGS_bloom_bits);
+      }
+    }
+    return NewBloomFilterPolicy(FLAGS_bloom_bits,
+                                FLAGS_use_block_based_filter);
+  }
+
   std::shared_ptr<Cache> NewCache(int64_t capacity) {
     if (capacity <= 0) {
       return nullptr;
@@ -2128,10 +2191,7 @@ class Benchmark {
   Benchmark()
       : cache_(NewCache(FLAGS_cache_size)),
         compressed_cache_(NewCache(FLAGS_compressed_cache_size)),
-        filter_policy_(FLAGS_bloom_bits >= 0
-                           ? NewBloomFilterPolicy(FLAGS_bloom_bits,
-                                                  FLAGS_use_block_based_filter)
-                           : nullptr),
+        filter_policy_(NewFilterPolicyFromFlags()),
         prefix_extractor_(NewFixedPrefixTransform(FLAGS_prefix_size)),
         num_(FLAGS_num),
         value_size_(FLAGS_value_size),
@@ -2957,6 +3017,7 @@ void VerifyDBFromDB(std::string& truth_db_name) {
           NewCappedPrefixTransform(
               FLAGS_memtable_insert_with_hint_prefix_size));
     }
+    options.memtable_sorted_batch_insert = FLAGS_memtable_sorted_batch_insert;
     options.bloom_locality = FLAGS_bloom_locality;
     options.max_file_opening_threads = FLAGS_file_opening_threads;
     options.new_table_reader_for_compaction_inputs =
@@ -3068,6 +3129,12 @@ void VerifyDBFromDB(std::string& truth_db_name) {
         block_based_options.partition_filters = true;
         block_based_options.metadata_block_size = FLAGS_metadata_block_size;
       }
+      if (FLAGS_use_data_block_hash_index) {
+        block_based_options.data_block_index_type =
+            BlockBasedTableOptions::kDataBlockBinaryAndHash;
+        block_based_options.data_block_hash_table_util_ratio =
+            FLAGS_data_block_hash_table_util_ratio;
+      }
       if (cache_ == nullptr) {
         block_based_options.no_block_cache = true;
       }
@@ -3173,6 +3240,16 @@ void VerifyDBFromDB(std::string& truth_db_name) {
     options.enable_write_thread_adaptive_yield =
         FLAGS_enable_write_thread_adaptive_yield;
     options.enable_pipelined_write = FLAGS_enable_pipelined_write;
+    options.max_write_batch_group_size_bytes =
+        FLAGS_max_write_batch_group_size_bytes;
+    options.adaptive_write_batch_group_size =
+        FLAGS_adaptive_write_batch_group_size;
+    options.wal_stripes = static_cast<size_t>(FLAGS_wal_stripes);
+    options.wal_sync_interval_micros = FLAGS_wal_sync_interval_micros;
+    options.wal_sync_interval_bytes = FLAGS_wal_sync_interval_bytes;
+    options.wal_compression = FLAGS_wal_compression_e;
+    options.per_column_family_write_stall =
+        FLAGS_per_column_family_write_stall;
     options.write_thread_max_yield_usec = FLAGS_write_thread_max_yield_usec;
     options.write_thread_slow_yield_usec = FLAGS_write_thread_slow_yield_usec;
     options.rate_limit_delay_max_milliseconds =
@@ -3249,6 +3326,8 @@ void VerifyDBFromDB(std::string& truth_db_name) {
     options.compression_opts.max_dict_bytes = FLAGS_compression_max_dict_bytes;
     options.compression_opts.zstd_max_train_bytes =
         FLAGS_compression_zstd_max_train_bytes;
+    options.compression_opts.parallel_threads =
+        FLAGS_compression_parallel_threads;
     if (FLAGS_row_cache_size) {
       if (FLAGS_cache_numshardbits >= 1) {
         options.row_cache =
@@ -5288,6 +5367,8 @@ int db_bench_tool(int argc, char** argv) {
 
   FLAGS_compression_type_e =
     StringToCompressionType(FLAGS_compression_type.c_str());
+  FLAGS_wal_compression_e =
+    StringToCompressionType(FLAGS_wal_compression.c_str());
 
 #ifndef ROCKSDB_LITE
   std::unique_ptr<Env> custom_env_guard;
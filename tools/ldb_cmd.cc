@@ -233,6 +233,10 @@ LDBCommand* LDBCommand::SelectCommand(const ParsedParams& parsed_params) {
     return new CheckPointCommand(parsed_params.cmd_params,
                                  parsed_params.option_map,
                                  parsed_params.flags);
+  } else if (parsed_params.cmd == CompactForServiceCommand::Name()) {
+    return new CompactForServiceCommand(parsed_params.cmd_params,
+                                        parsed_params.option_map,
+                                        parsed_params.flags);
   } else if (parsed_params.cmd == RepairCommand::Name()) {
     return new RepairCommand(parsed_params.cmd_params, parsed_params.option_map,
                              parsed_params.flags);
@@ -2640,6 +2644,59 @@ void CheckPointCommand::DoCommand() {
 
 // ----------------------------------------------------------------------------
 
+const std::string CompactForServiceCommand::ARG_INPUT = "input";
+const std::string CompactForServiceCommand::ARG_OUTPUT_DIR = "output_dir";
+const std::string CompactForServiceCommand::ARG_RESULT = "result";
+
+CompactForServiceCommand::CompactForServiceCommand(
+    const std::vector<std::string>& params,
+    const std::map<std::string, std::string>& options,
+    const std::vector<std::string>& flags)
+    : LDBCommand(options, flags, true /* is_read_only */,
+                 BuildCmdLineOptions({ARG_INPUT, ARG_OUTPUT_DIR, ARG_RESULT})) {
+  for (const auto* arg : {&ARG_INPUT, &ARG_OUTPUT_DIR, &ARG_RESULT}) {
+    if (options.find(*arg) == options.end()) {
+      exec_state_ =
+          LDBCommandExecuteResult::Failed("--" + *arg + ": missing argument");
+      return;
+    }
+  }
+  input_file_ = options.at(ARG_INPUT);
+  output_dir_ = options.at(ARG_OUTPUT_DIR);
+  result_file_ = options.at(ARG_RESULT);
+}
+
+void CompactForServiceCommand::Help(std::string& ret) {
+  ret.append("  ");
+  ret.append(CompactForServiceCommand::Name());
+  ret.append(" --" + ARG_INPUT + "=<compaction service input file>");
+  ret.append(" --" + ARG_OUTPUT_DIR + "=<directory for output files>");
+  ret.append(" --" + ARG_RESULT + "=<compaction service result file>");
+  ret.append("\n");
+}
+
+void CompactForServiceCommand::DoCommand() {
+  Options options = PrepareOptionsForOpenDB();
+  std::string input;
+  Status status = ReadFileToString(options.env, input_file_, &input);
+  std::string result;
+  if (status.ok()) {
+    status =
+        DB::OpenAndCompact(options, db_path_, output_dir_, input, &result);
+  }
+  if (status.ok()) {
+    status = WriteStringToFile(options.env, result, result_file_,
+                               true /* should_sync */);
+  }
+  if (status.ok()) {
+    printf("OK\n");
+  } else {
+    exec_state_ = LDBCommandExecuteResult::Failed(status.ToString());
+  }
+}
+
+// ----------------------------------------------------------------------------
+
 RepairCommand::RepairCommand(const std::vector<std::string>& params,
                              const std::map<std::string, std::string>& options,
                              const std::vector<std::string>& flags)
@@ -464,6 +464,30 @@ class CheckPointCommand : public LDBCommand {
   static const std::string ARG_CHECKPOINT_DIR;
 };
 
+class CompactForServiceCommand : public LDBCommand {
+ public:
+  static std::string Name() { return "compact_for_service"; }
+
+  CompactForServiceCommand(const std::vector<std::string>& params,
+                           const std::map<std::string, std::string>& options,
+                           const std::vector<std::string>& flags);
+
+  virtual void DoCommand() override;
+
+  virtual bool NoDBOpen() override { return true; }
+
+  static void Help(std::string& ret);
+
+ private:
+  std::string input_file_;
+  std::string output_dir_;
+  std::string result_file_;
+
+  static const std::string ARG_INPUT;
+  static const std::string ARG_OUTPUT_DIR;
+  static const std::string ARG_RESULT;
+};
+
 class RepairCommand : public LDBCommand {
  public:
   static std::string Name() { return "repair"; }
@@ -88,6 +88,7 @@ void LDBCommandRunner::PrintHelp(const LDBOptions& ldb_options,
   BackupCommand::Help(ret);
   RestoreCommand::Help(ret);
   CheckPointCommand::Help(ret);
+  CompactForServiceCommand::Help(ret);
 
   fprintf(stderr, "%s\n", ret.c_str());
 }
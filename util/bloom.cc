@@ -9,12 +9,19 @@
 
 #include "rocksdb/filter_policy.h"
 
+#include <algorithm>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 #include "rocksdb/slice.h"
 #include "table/block_based_filter_block.h"
 #include "table/full_filter_bits_builder.h"
 #include "table/full_filter_block.h"
 #include "util/coding.h"
 #include "util/hash.h"
+#include "util/xor_filter.h"
 
 namespace rocksdb {
 
@@ -135,6 +142,196 @@ inline void FullFilterBitsBuilder::AddHash(uint32_t h, char* data,
 }
 
 namespace {
+
+// Length of the metadata trailer of full filters, in both formats
+const uint32_t kFullFilterMetadataLen = 5;
+
+// In the legacy format the first metadata byte is num_probes, which is never
+// negative. -1 there marks one of the newer formats, which one being given by
+// the next byte.
+const char kNewFilterImplMarker = static_cast<char>(-1);
+const char kFastLocalBloomSubImpl = 0;
+const char kXorSubImpl = 1;
+
+// Filters in a newer format are stored under the name of the policy that
+// builds them. Releases without the format look filters up by the name of
+// their own policy, so they read the table without the filter instead of
+// misreading it.
+const char kBuiltinBloomFilterName[] = "rocksdb.BuiltinBloomFilter";
+const char kCacheLocalBloomFilterName[] = "rocksdb.CacheLocalBloomFilter";
+const char kXorFilterName[] = "rocksdb.XorFilter";
+
+// Implementation of the cache-local Bloom filter. Every key is mapped to
+// exactly one 64-byte cache line, independent of CACHE_LINE_SIZE, and all
+// of its probes fall into that line. The probe bit positions are the top 9
+// bits of h2 * 0x9e3779b9^i, which lets up to eight probes be computed and
+// checked at once with AVX2.
+//
+// Filter layout:
+// +----------------------------------------------------------------+
+// |          filter data, a multiple of 64 bytes (len_bytes)        |
+// +----------------------------------------------------------------+
+// | -1 : 1 byte | sub-impl 0 : 1 byte | block_and_probes : 1 byte  |
+// | reserved 0 : 2 bytes                                           |
+// +----------------------------------------------------------------+
+// The upper 3 bits of block_and_probes are log2(cache line bytes) - 6, and
+// the lower 5 bits are the number of probes.
+class FastLocalBloomImpl {
+ public:
+  static const uint32_t kLineBytes = 64;
+  static const int kLog2LineBytes = 6;
+  static const int kMaxProbes = 24;
+
+  // Number of probes that gives the lowest false positive rate for the given
+  // bits per key (in thousandths). Since up to 8 probes cost about the same
+  // with AVX2, this is picked for accuracy only, based on measurements of
+  // this implementation. Note that the optimum for a cache-local Bloom filter
+  // is below the one of a standard Bloom filter, e.g. 9 instead of 11 at 16
+  // bits per key.
+  static int ChooseNumProbes(int millibits_per_key) {
+    if (millibits_per_key <= 2080) {
+      return 1;
+    } else if (millibits_per_key <= 3580) {
+      return 2;
+    } else if (millibits_per_key <= 5100) {
+      return 3;
+    } else if (millibits_per_key <= 6640) {
+      return 4;
+    } else if (millibits_per_key <= 8300) {
+      return 5;
+    } else if (millibits_per_key <= 10070) {
+      return 6;
+    } else if (millibits_per_key <= 11720) {
+      return 7;
+    } else if (millibits_per_key <= 14001) {
+      // Slightly past the optimum so that more settings get away with <= 8
+      // probes, i.e. one SIMD round.
+      return 8;
+    } else if (millibits_per_key <= 16050) {
+      return 9;
+    } else if (millibits_per_key <= 18300) {
+      return 10;
+    } else if (millibits_per_key <= 22001) {
+      return 11;
+    } else if (millibits_per_key <= 25501) {
+      return 12;
+    } else if (millibits_per_key > 50000) {
+      // Top out at three rounds of eight probes
+      return kMaxProbes;
+    } else {
+      return (millibits_per_key - 1) / 2000 - 1;
+    }
+  }
+
+  // The second hash, which picks the bits within the cache line, while the
+  // upper bits of the first one pick the line. The murmur3 finalizer is a
+  // bijection with good avalanche behavior, so the two are as good as
+  // independent.
+  static inline uint32_t ProbeHash(uint32_t h1) {
+    uint32_t h = h1;
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+  }
+
+  static inline const char* CacheLineFor(uint32_t h1, uint32_t len_bytes,
+                                         const char* data) {
+    // Maps h1 to [0, num_lines) without a division
+    uint32_t line = static_cast<uint32_t>(
+        (static_cast<uint64_t>(h1) * (len_bytes >> kLog2LineBytes)) >> 32);
+    return data + (line << kLog2LineBytes);
+  }
+
+  static inline void AddHash(uint32_t h1, uint32_t len_bytes, int num_probes,
+                             char* data) {
+    char* data_at_cache_line =
+        const_cast<char*>(CacheLineFor(h1, len_bytes, data));
+    uint32_t h = ProbeHash(h1);
+    for (int i = 0; i < num_probes; ++i, h *= 0x9e3779b9) {
+      // 9-bit address within the 512-bit cache line
+      uint32_t bitpos = h >> (32 - 9);
+      data_at_cache_line[bitpos >> 3] |= static_cast<char>(1 << (bitpos & 7));
+    }
+  }
+
+  static inline bool HashMayMatch(uint32_t h1, uint32_t len_bytes,
+                                  int num_probes, const char* data) {
+    const char* data_at_cache_line = CacheLineFor(h1, len_bytes, data);
+    uint32_t h = ProbeHash(h1);
+#ifdef __AVX2__
+    int rem_probes = num_probes;
+
+    // Powers of the 32-bit golden ratio, mod 2**32
+    const __m256i multipliers =
+        _mm256_setr_epi32(0x00000001, 0x9e3779b9, 0xe35e67b1, 0x734297e9,
+                          0x35fbe861, 0xdeb7c719, 0x448b211, 0x3459b749);
+    const __m256i zero_to_seven = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    for (;;) {
+      // h * 0x9e3779b9^i for the next eight probes
+      __m256i hash_vector = _mm256_set1_epi32(static_cast<int>(h));
+      hash_vector = _mm256_mullo_epi32(hash_vector, multipliers);
+
+      // The top 9 bits of each lane address a bit in the cache line. Instead
+      // of bytes as in the portable code, work with 32-bit words here (4 bits
+      // for the word, 5 bits for the bit within it), which is equivalent on
+      // little-endian platforms.
+      const __m256i word_addresses = _mm256_srli_epi32(hash_vector, 28);
+
+      // Fetch the eight probed words. Permute both 256-bit halves of the
+      // cache line by the lower 3 bits of the word address and pick the half
+      // with the top bit. Unaligned loads, as the filter data need not be
+      // cache line aligned.
+      const __m256i* mm_data =
+          reinterpret_cast<const __m256i*>(data_at_cache_line);
+      __m256i lower = _mm256_loadu_si256(mm_data);
+      __m256i upper = _mm256_loadu_si256(mm_data + 1);
+      lower = _mm256_permutevar8x32_epi32(lower, word_addresses);
+      upper = _mm256_permutevar8x32_epi32(upper, word_addresses);
+      const __m256i upper_lower_selector = _mm256_srai_epi32(hash_vector, 31);
+      const __m256i value_vector =
+          _mm256_blendv_epi8(lower, upper, upper_lower_selector);
+
+      // Only the first rem_probes lanes are used: 1 where i < rem_probes
+      __m256i k_selector =
+          _mm256_sub_epi32(zero_to_seven, _mm256_set1_epi32(rem_probes));
+      k_selector = _mm256_srli_epi32(k_selector, 31);
+
+      // The 5-bit bit-within-word addresses, and the bits to test
+      __m256i bit_addresses = _mm256_slli_epi32(hash_vector, 4);
+      bit_addresses = _mm256_srli_epi32(bit_addresses, 27);
+      const __m256i bit_mask = _mm256_sllv_epi32(k_selector, bit_addresses);
+
+      // ((~value_vector) & bit_mask) == 0
+      bool match = _mm256_testc_si256(value_vector, bit_mask) != 0;
+
+      // Tested first so that the common num_probes <= 8 case is free of
+      // unpredictable branches
+      if (rem_probes <= 8) {
+        return match;
+      } else if (!match) {
+        return false;
+      }
+      // 0xab25f4c1 is the golden ratio to the 8th power
+      h *= 0xab25f4c1;
+      rem_probes -= 8;
+    }
+#else
+    for (int i = 0; i < num_probes; ++i, h *= 0x9e3779b9) {
+      // 9-bit address within the 512-bit cache line
+      uint32_t bitpos = h >> (32 - 9);
+      if ((data_at_cache_line[bitpos >> 3] & (1 << (bitpos & 7))) == 0) {
+        return false;
+      }
+    }
+    return true;
+#endif  // __AVX2__
+  }
+};
+
 class FullFilterBitsReader : public FilterBitsReader {
  public:
   explicit FullFilterBitsReader(const Slice& contents)
@@ -240,12 +437,261 @@ bool FullFilterBitsReader::HashMayMatch(const uint32_t& hash,
   return true;
 }
 
+class FastLocalBloomBitsBuilder : public FilterBitsBuilder {
+ public:
+  explicit FastLocalBloomBitsBuilder(int millibits_per_key)
+      : millibits_per_key_(millibits_per_key),
+        num_probes_(FastLocalBloomImpl::ChooseNumProbes(millibits_per_key)) {
+    assert(millibits_per_key_ >= 1000);
+  }
+
+  virtual void AddKey(const Slice& key) override {
+    uint32_t hash = BloomHash(key);
+    if (hash_entries_.size() == 0 || hash != hash_entries_.back()) {
+      hash_entries_.push_back(hash);
+    }
+  }
+
+  virtual Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    uint32_t len_with_metadata =
+        CalculateSpace(static_cast<uint32_t>(hash_entries_.size()));
+    char* data = new char[len_with_metadata];
+    memset(data, 0, len_with_metadata);
+
+    uint32_t len = len_with_metadata - kFullFilterMetadataLen;
+    if (len > 0) {
+      for (auto h : hash_entries_) {
+        FastLocalBloomImpl::AddHash(h, len, num_probes_, data);
+      }
+    }
+    data[len] = kNewFilterImplMarker;
+    data[len + 1] = kFastLocalBloomSubImpl;
+    // log2(line bytes) - 6 == 0 in the upper 3 bits
+    data[len + 2] = static_cast<char>(num_probes_);
+    // data[len + 3] and data[len + 4] are reserved and stay 0
+
+    buf->reset(data);
+    hash_entries_.clear();
+    return Slice(data, len_with_metadata);
+  }
+
+  virtual int CalculateNumEntry(const uint32_t space) override {
+    uint64_t num_lines = 0;
+    if (space > kFullFilterMetadataLen) {
+      num_lines =
+          (space - kFullFilterMetadataLen) / FastLocalBloomImpl::kLineBytes;
+    }
+    return static_cast<int>(num_lines * FastLocalBloomImpl::kLineBytes * 8 *
+                            1000 / millibits_per_key_);
+  }
+
+  // Space for a filter of num_entry keys, including metadata. This is the
+  // reverse of CalculateNumEntry.
+  uint32_t CalculateSpace(uint32_t num_entry) {
+    const uint64_t kMillibitsPerLine = FastLocalBloomImpl::kLineBytes * 8 * 1000;
+    uint64_t num_lines = (static_cast<uint64_t>(num_entry) *
+                              millibits_per_key_ + kMillibitsPerLine - 1) /
+                         kMillibitsPerLine;
+    return static_cast<uint32_t>(num_lines * FastLocalBloomImpl::kLineBytes +
+                                 kFullFilterMetadataLen);
+  }
+
+ private:
+  int millibits_per_key_;
+  int num_probes_;
+  std::vector<uint32_t> hash_entries_;
+
+  // No Copy allowed
+  FastLocalBloomBitsBuilder(const FastLocalBloomBitsBuilder&);
+  void operator=(const FastLocalBloomBitsBuilder&);
+};
+
+class FastLocalBloomBitsReader : public FilterBitsReader {
+ public:
+  FastLocalBloomBitsReader(const char* data, int num_probes,
+                           uint32_t len_bytes)
+      : data_(data), num_probes_(num_probes), len_bytes_(len_bytes) {}
+
+  virtual bool MayMatch(const Slice& key) override {
+    return FastLocalBloomImpl::HashMayMatch(BloomHash(key), len_bytes_,
+                                            num_probes_, data_);
+  }
+
+ private:
+  const char* data_;
+  const int num_probes_;
+  const uint32_t len_bytes_;
+
+  // No Copy allowed
+  FastLocalBloomBitsReader(const FastLocalBloomBitsReader&);
+  void operator=(const FastLocalBloomBitsReader&);
+};
+
+// Builder of the xor filters of util/xor_filter.h. The metadata trailer is
+// [-1][sub-impl 1][fingerprint bits][seed][reserved 0].
+class XorFilterBitsBuilder : public FilterBitsBuilder {
+ public:
+  explicit XorFilterBitsBuilder(int fingerprint_bits)
+      : fingerprint_bits_(fingerprint_bits) {
+    assert(fingerprint_bits_ >= XorFilter::kMinFingerprintBits &&
+           fingerprint_bits_ <= XorFilter::kMaxFingerprintBits);
+  }
+
+  virtual void AddKey(const Slice& key) override {
+    uint64_t hash = XorFilter::KeyHash(key);
+    if (hash_entries_.size() == 0 || hash != hash_entries_.back()) {
+      hash_entries_.push_back(hash);
+    }
+  }
+
+  virtual Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    // The table cannot be solved with duplicates, and keys are only
+    // guaranteed to come in order within a prefix or a whole key range
+    std::sort(hash_entries_.begin(), hash_entries_.end());
+    hash_entries_.erase(
+        std::unique(hash_entries_.begin(), hash_entries_.end()),
+        hash_entries_.end());
+
+    std::string filter;
+    uint8_t seed = 0;
+    int fingerprint_bits = fingerprint_bits_;
+    if (!hash_entries_.empty() &&
+        !XorFilter::Build(hash_entries_, fingerprint_bits, &seed, &filter)) {
+      // Practically impossible. 0 fingerprint bits are read as a filter that
+      // matches everything.
+      fingerprint_bits = 0;
+      filter.assign(XorFilter::kSegmentLengthBytes, '\0');
+    }
+    filter.push_back(kNewFilterImplMarker);
+    filter.push_back(kXorSubImpl);
+    filter.push_back(static_cast<char>(fingerprint_bits));
+    filter.push_back(static_cast<char>(seed));
+    filter.push_back(0);
+
+    char* data = new char[filter.size()];
+    memcpy(data, filter.data(), filter.size());
+    buf->reset(data);
+    hash_entries_.clear();
+    return Slice(data, filter.size());
+  }
+
+  virtual int CalculateNumEntry(const uint32_t space) override {
+    const uint32_t overhead =
+        XorFilter::kSegmentLengthBytes + kFullFilterMetadataLen;
+    if (space <= overhead) {
+      return 0;
+    }
+    uint64_t num_slots =
+        static_cast<uint64_t>(space - overhead) * 8 / fingerprint_bits_;
+    int64_t n = (static_cast<int64_t>(num_slots) - 34) * 100 / 123;
+    // Correct for rounding
+    while (n > 0 && CalculateSpace(static_cast<uint32_t>(n)) > space) {
+      n--;
+    }
+    return n > 0 ? static_cast<int>(n) : 0;
+  }
+
+  // Space for a filter of num_entry distinct keys, including metadata
+  uint32_t CalculateSpace(uint32_t num_entry) {
+    if (num_entry == 0) {
+      return kFullFilterMetadataLen;
+    }
+    return XorFilter::DataLength(XorFilter::SegmentLength(num_entry),
+                                 fingerprint_bits_) +
+           kFullFilterMetadataLen;
+  }
+
+ private:
+  int fingerprint_bits_;
+  std::vector<uint64_t> hash_entries_;
+
+  // No Copy allowed
+  XorFilterBitsBuilder(const XorFilterBitsBuilder&);
+  void operator=(const XorFilterBitsBuilder&);
+};
+
+class XorFilterBitsReader : public FilterBitsReader {
+ public:
+  XorFilterBitsReader(const char* data, uint32_t segment_length,
+                      int fingerprint_bits, uint8_t seed)
+      : data_(data),
+        segment_length_(segment_length),
+        fingerprint_bits_(fingerprint_bits),
+        seed_(seed) {}
+
+  virtual bool MayMatch(const Slice& key) override {
+    return XorFilter::MayMatch(XorFilter::KeyHash(key), data_,
+                               segment_length_, fingerprint_bits_, seed_);
+  }
+
+ private:
+  const char* data_;
+  const uint32_t segment_length_;
+  const int fingerprint_bits_;
+  const uint8_t seed_;
+
+  // No Copy allowed
+  XorFilterBitsReader(const XorFilterBitsReader&);
+  void operator=(const XorFilterBitsReader&);
+};
+
+// Reader for filters in a format this version does not know, or that are
+// corrupted
+class AlwaysTrueFilterBitsReader : public FilterBitsReader {
+ public:
+  virtual bool MayMatch(const Slice& /*key*/) override { return true; }
+};
+
 // An implementation of filter policy
 class BloomFilterPolicy : public FilterPolicy {
  public:
+  // Format of the full filters built by the policy. All policies read all
+  // formats.
+  enum FullFilterFormat {
+    kLegacyBloom,
+    kFastLocalBloom,
+    kXor,
+  };
+
   explicit BloomFilterPolicy(int bits_per_key, bool use_block_based_builder)
       : bits_per_key_(bits_per_key), hash_func_(BloomHash),
-        use_block_based_builder_(use_block_based_builder) {
+        use_block_based_builder_(use_block_based_builder),
+        format_(kLegacyBloom),
+        millibits_per_key_(bits_per_key * 1000),
+        xor_fingerprint_bits_(0) {
+    initialize();
+  }
+
+  // A policy building full filters in one of the newer formats. The
+  // block-based filters of CreateFilter() use bits_per_key rounded to an
+  // integer.
+  BloomFilterPolicy(double bits_per_key, FullFilterFormat format)
+      : bits_per_key_(static_cast<size_t>(bits_per_key + 0.5)),
+        hash_func_(BloomHash),
+        use_block_based_builder_(false),
+        format_(format) {
+    // Sanitize to [1, 100] bits per key
+    if (!(bits_per_key >= 1.0)) {
+      bits_per_key = 1.0;
+    } else if (bits_per_key > 100.0) {
+      bits_per_key = 100.0;
+    }
+    millibits_per_key_ = static_cast<int>(bits_per_key * 1000.0 + 0.5);
+    if (bits_per_key_ < 1) {
+      bits_per_key_ = 1;
+    } else if (bits_per_key_ > 100) {
+      bits_per_key_ = 100;
+    }
+    // A Bloom filter with b bits per key has a false positive rate of at
+    // best 2^(-b * ln(2)), which an xor filter matches with b * ln(2)
+    // fingerprint bits
+    xor_fingerprint_bits_ =
+        static_cast<int>(bits_per_key * 0.6931471805599453 + 0.5);
+    if (xor_fingerprint_bits_ < XorFilter::kMinFingerprintBits) {
+      xor_fingerprint_bits_ = XorFilter::kMinFingerprintBits;
+    } else if (xor_fingerprint_bits_ > XorFilter::kMaxFingerprintBits) {
+      xor_fingerprint_bits_ = XorFilter::kMaxFingerprintBits;
+    }
     initialize();
   }
 
@@ -253,7 +699,15 @@ class BloomFilterPolicy : public FilterPolicy {
   }
 
   virtual const char* Name() const override {
-    return "rocksdb.BuiltinBloomFilter";
+    switch (format_) {
+      case kFastLocalBloom:
+        return kCacheLocalBloomFilterName;
+      case kXor:
+        return kXorFilterName;
+      case kLegacyBloom:
+        break;
+    }
+    return kBuiltinBloomFilterName;
   }
 
   virtual void CreateFilter(const Slice* keys, int n,
@@ -316,12 +770,28 @@ class BloomFilterPolicy : public FilterPolicy {
     if (use_block_based_builder_) {
       return nullptr;
     }
+    switch (format_) {
+      case kFastLocalBloom:
+        return new FastLocalBloomBitsBuilder(millibits_per_key_);
+      case kXor:
+        return new XorFilterBitsBuilder(xor_fingerprint_bits_);
+      case kLegacyBloom:
+        break;
+    }
 
     return new FullFilterBitsBuilder(bits_per_key_, num_probes_);
   }
 
+  // Reads full filters of any format, no matter which one this policy
+  // builds.
   virtual FilterBitsReader* GetFilterBitsReader(const Slice& contents)
       const override {
+    uint32_t len_with_metadata = static_cast<uint32_t>(contents.size());
+    if (len_with_metadata > kFullFilterMetadataLen &&
+        contents.data()[len_with_metadata - kFullFilterMetadataLen] ==
+            kNewFilterImplMarker) {
+      return GetNewImplBitsReader(contents);
+    }
     return new FullFilterBitsReader(contents);
   }
 
@@ -334,6 +804,43 @@ class BloomFilterPolicy : public FilterPolicy {
   uint32_t (*hash_func_)(const Slice& key);
 
   const bool use_block_based_builder_;
+  const FullFilterFormat format_;
+  int millibits_per_key_;
+  int xor_fingerprint_bits_;
+
+  FilterBitsReader* GetNewImplBitsReader(const Slice& contents) const {
+    uint32_t len = static_cast<uint32_t>(contents.size()) -
+                   kFullFilterMetadataLen;
+    const char* metadata = contents.data() + len;
+    if (metadata[1] == kFastLocalBloomSubImpl) {
+      const unsigned char block_and_probes =
+          static_cast<unsigned char>(metadata[2]);
+      const int log2_block_bytes = ((block_and_probes >> 5) & 7) + 6;
+      const int num_probes = block_and_probes & 31;
+      if (log2_block_bytes == FastLocalBloomImpl::kLog2LineBytes &&
+          num_probes >= 1 && num_probes <= FastLocalBloomImpl::kMaxProbes &&
+          len % FastLocalBloomImpl::kLineBytes == 0) {
+        return new FastLocalBloomBitsReader(contents.data(), num_probes, len);
+      }
+    } else if (metadata[1] == kXorSubImpl &&
+               len >= XorFilter::kSegmentLengthBytes) {
+      const int fingerprint_bits = static_cast<unsigned char>(metadata[2]);
+      const uint8_t seed = static_cast<uint8_t>(metadata[3]);
+      const uint32_t segment_length =
+          DecodeFixed32(contents.data() + len - XorFilter::kSegmentLengthBytes);
+      if (fingerprint_bits >= XorFilter::kMinFingerprintBits &&
+          fingerprint_bits <= XorFilter::kMaxFingerprintBits &&
+          segment_length > 0 &&
+          static_cast<uint64_t>(segment_length) * 3 * fingerprint_bits <=
+              static_cast<uint64_t>(len) * 8 &&
+          XorFilter::DataLength(segment_length, fingerprint_bits) == len) {
+        return new XorFilterBitsReader(contents.data(), segment_length,
+                                       fingerprint_bits, seed);
+      }
+    }
+    // Unknown or corrupted, regard every key as a match
+    return new AlwaysTrueFilterBitsReader();
+  }
 
   void initialize() {
     // We intentionally round down to reduce probing cost a little bit
@@ -350,4 +857,30 @@ const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
   return new BloomFilterPolicy(bits_per_key, use_block_based_builder);
 }
 
+const FilterPolicy* NewCacheLocalBloomFilterPolicy(double bits_per_key) {
+  return new BloomFilterPolicy(bits_per_key,
+                               BloomFilterPolicy::kFastLocalBloom);
+}
+
+const FilterPolicy* NewXorFilterPolicy(double bloom_equivalent_bits_per_key) {
+  return new BloomFilterPolicy(bloom_equivalent_bits_per_key,
+                               BloomFilterPolicy::kXor);
+}
+
+std::vector<std::string> GetCompatibleFilterPolicyNames(
+    const std::string& policy_name) {
+  std::vector<std::string> names = {policy_name};
+  const std::vector<std::string> builtin_names = {
+      kBuiltinBloomFilterName, kCacheLocalBloomFilterName, kXorFilterName};
+  if (std::find(builtin_names.begin(), builtin_names.end(), policy_name) !=
+      builtin_names.end()) {
+    for (const auto& name : builtin_names) {
+      if (name != policy_name) {
+        names.push_back(name);
+      }
+    }
+  }
+  return names;
+}
+
 }  // namespace rocksdb
@@ -16,6 +16,8 @@ int main() {
 #else
 
 #include <gflags/gflags.h>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include "rocksdb/filter_policy.h"
@@ -196,6 +198,13 @@ class FullBloomTest : public testing::Test {
     delete policy_;
   }
 
+  // Takes ownership of policy
+  void ResetPolicy(const FilterPolicy* policy) {
+    delete policy_;
+    policy_ = policy;
+    Reset();
+  }
+
   FullFilterBitsBuilder* GetFullFilterBitsBuilder() {
     return dynamic_cast<FullFilterBitsBuilder*>(bits_builder_.get());
   }
@@ -309,6 +318,349 @@ TEST_F(FullBloomTest, FullVaryingLengths) {
   ASSERT_LE(mediocre_filters, good_filters/5);
 }
 
+class FastLocalBloomTest : public FullBloomTest {
+ public:
+  FastLocalBloomTest() {
+    ResetPolicy(NewCacheLocalBloomFilterPolicy(FLAGS_bits_per_key));
+  }
+};
+
+TEST_F(FastLocalBloomTest, EmptyFilter) {
+  ASSERT_TRUE(!Matches("hello"));
+  ASSERT_TRUE(!Matches("world"));
+}
+
+TEST_F(FastLocalBloomTest, Small) {
+  Add("hello");
+  Add("world");
+  ASSERT_TRUE(Matches("hello"));
+  ASSERT_TRUE(Matches("world"));
+  ASSERT_TRUE(!Matches("x"));
+  ASSERT_TRUE(!Matches("foo"));
+}
+
+TEST_F(FastLocalBloomTest, VaryingLengths) {
+  char buffer[sizeof(int)];
+
+  // Count number of filters that significantly exceed the false positive rate
+  int mediocre_filters = 0;
+  int good_filters = 0;
+
+  for (int length = 1; length <= 10000; length = NextLength(length)) {
+    Reset();
+    for (int i = 0; i < length; i++) {
+      Add(Key(i, buffer));
+    }
+    Build();
+
+    // Rounded up to a whole 64-byte cache line, plus metadata
+    ASSERT_LE(FilterSize(),
+              (size_t)((length * FLAGS_bits_per_key / 8) + 64 + 5))
+        << length;
+    ASSERT_EQ(0U, (FilterSize() - 5) % 64) << length;
+
+    // All added keys must match
+    for (int i = 0; i < length; i++) {
+      ASSERT_TRUE(Matches(Key(i, buffer)))
+          << "Length " << length << "; key " << i;
+    }
+
+    // Check false positive rate
+    double rate = FalsePositiveRate();
+    if (kVerbose >= 1) {
+      fprintf(stderr, "False positives: %5.2f%% @ length = %6d ; bytes = %6d\n",
+              rate*100.0, length, static_cast<int>(FilterSize()));
+    }
+    ASSERT_LE(rate, 0.02);   // Must not be over 2%
+    if (rate > 0.0125)
+      mediocre_filters++;  // Allowed, but not too often
+    else
+      good_filters++;
+  }
+  if (kVerbose >= 1) {
+    fprintf(stderr, "Filters: %d good, %d mediocre\n",
+            good_filters, mediocre_filters);
+  }
+  ASSERT_LE(mediocre_filters, good_filters/5);
+}
+
+TEST_F(FastLocalBloomTest, BitsPerKey) {
+  char buffer[sizeof(int)];
+  const int kNumKeys = 10000;
+
+  // Fractional settings, and settings that need more than one round of
+  // eight probes
+  const double kBitsPerKey[] = {1.0, 4.5, 6.0, 10.0, 15.5, 20.0, 30.0, 60.0};
+  double last_rate = 1.0;
+  for (double bits_per_key : kBitsPerKey) {
+    ResetPolicy(NewCacheLocalBloomFilterPolicy(bits_per_key));
+    for (int i = 0; i < kNumKeys; i++) {
+      Add(Key(i, buffer));
+    }
+    Build();
+    ASSERT_LE(FilterSize(),
+              static_cast<size_t>(kNumKeys * bits_per_key / 8) + 64 + 5);
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_TRUE(Matches(Key(i, buffer)))
+          << "bits_per_key " << bits_per_key << "; key " << i;
+    }
+    double rate = FalsePositiveRate();
+    if (kVerbose >= 1) {
+      fprintf(stderr, "False positives: %5.2f%% @ bits_per_key = %4.1f\n",
+              rate * 100.0, bits_per_key);
+    }
+    // More space must not hurt
+    ASSERT_LE(rate, last_rate + 0.002) << bits_per_key;
+    last_rate = rate;
+  }
+  ASSERT_LE(last_rate, 0.0005);
+}
+
+TEST_F(FastLocalBloomTest, ReadsBothFormats) {
+  char buffer[sizeof(int)];
+  std::unique_ptr<const FilterPolicy> legacy_policy(
+      NewBloomFilterPolicy(FLAGS_bits_per_key, false));
+  std::unique_ptr<const FilterPolicy> cache_local_policy(
+      NewCacheLocalBloomFilterPolicy(FLAGS_bits_per_key));
+  // The filters are stored under different names, so that older releases
+  // ignore the new format, but tables are read with the filters of either
+  ASSERT_NE(std::string(legacy_policy->Name()),
+            std::string(cache_local_policy->Name()));
+  std::unique_ptr<const FilterPolicy> xor_policy(
+      NewXorFilterPolicy(FLAGS_bits_per_key));
+  ASSERT_EQ(std::vector<std::string>({legacy_policy->Name(),
+                                      cache_local_policy->Name(),
+                                      xor_policy->Name()}),
+            GetCompatibleFilterPolicyNames(legacy_policy->Name()));
+  ASSERT_EQ(std::vector<std::string>({cache_local_policy->Name(),
+                                      legacy_policy->Name(),
+                                      xor_policy->Name()}),
+            GetCompatibleFilterPolicyNames(cache_local_policy->Name()));
+
+  for (auto builder_policy : {legacy_policy.get(), cache_local_policy.get()}) {
+    std::unique_ptr<FilterBitsBuilder> builder(
+        builder_policy->GetFilterBitsBuilder());
+    for (int i = 0; i < 1000; i++) {
+      builder->AddKey(Key(i, buffer));
+    }
+    std::unique_ptr<const char[]> buf;
+    Slice filter = builder->Finish(&buf);
+
+    for (auto reader_policy : {legacy_policy.get(), cache_local_policy.get()}) {
+      std::unique_ptr<FilterBitsReader> reader(
+          reader_policy->GetFilterBitsReader(filter));
+      int false_positives = 0;
+      for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(reader->MayMatch(Key(i, buffer)));
+        if (reader->MayMatch(Key(i + 1000000000, buffer))) {
+          false_positives++;
+        }
+      }
+      ASSERT_LE(false_positives, 40);
+    }
+  }
+}
+
+TEST_F(FastLocalBloomTest, UnknownFormat) {
+  char buffer[sizeof(int)];
+  // A sub-implementation this version does not know about must not cause
+  // false negatives
+  std::unique_ptr<const FilterPolicy> policy(
+      NewCacheLocalBloomFilterPolicy(FLAGS_bits_per_key));
+  std::unique_ptr<FilterBitsBuilder> builder(policy->GetFilterBitsBuilder());
+  for (int i = 0; i < 100; i++) {
+    builder->AddKey(Key(i, buffer));
+  }
+  std::unique_ptr<const char[]> buf;
+  Slice filter = builder->Finish(&buf);
+  std::string modified = filter.ToString();
+  modified[modified.size() - 4] = 42;
+  std::unique_ptr<FilterBitsReader> reader(
+      policy->GetFilterBitsReader(Slice(modified)));
+  ASSERT_TRUE(reader->MayMatch(Key(1000000000, buffer)));
+}
+
+class XorFilterTest : public FullBloomTest {
+ public:
+  XorFilterTest() { ResetPolicy(NewXorFilterPolicy(FLAGS_bits_per_key)); }
+};
+
+TEST_F(XorFilterTest, EmptyFilter) {
+  ASSERT_TRUE(!Matches("hello"));
+  ASSERT_TRUE(!Matches("world"));
+}
+
+TEST_F(XorFilterTest, Small) {
+  Add("hello");
+  Add("world");
+  ASSERT_TRUE(Matches("hello"));
+  ASSERT_TRUE(Matches("world"));
+  ASSERT_TRUE(!Matches("x"));
+  ASSERT_TRUE(!Matches("foo"));
+}
+
+TEST_F(XorFilterTest, DuplicateKeys) {
+  // Not in order, as with prefixes
+  for (int i = 0; i < 3; i++) {
+    Add("hello");
+    Add("world");
+  }
+  ASSERT_TRUE(Matches("hello"));
+  ASSERT_TRUE(Matches("world"));
+  ASSERT_TRUE(!Matches("foo"));
+}
+
+TEST_F(XorFilterTest, VaryingLengths) {
+  char buffer[sizeof(int)];
+  std::unique_ptr<const FilterPolicy> bloom_policy(
+      NewCacheLocalBloomFilterPolicy(FLAGS_bits_per_key));
+
+  // Count number of filters that significantly exceed the false positive rate
+  int mediocre_filters = 0;
+  int good_filters = 0;
+
+  for (int length = 1; length <= 10000; length = NextLength(length)) {
+    Reset();
+    std::unique_ptr<FilterBitsBuilder> bloom_builder(
+        bloom_policy->GetFilterBitsBuilder());
+    for (int i = 0; i < length; i++) {
+      Add(Key(i, buffer));
+      bloom_builder->AddKey(Key(i, buffer));
+    }
+    Build();
+    std::unique_ptr<const char[]> bloom_buf;
+    size_t bloom_size = bloom_builder->Finish(&bloom_buf).size();
+
+    // 1.23 slots per key plus about 32 more, of 7 bits each with 10 bits
+    // per key, and 9 bytes of metadata
+    ASSERT_LE(FilterSize(), (size_t)((length * 1.23 + 36) * 7 / 8 + 9 + 1))
+        << length;
+    if (length >= 1000) {
+      ASSERT_LE(FilterSize(), bloom_size * 0.9) << length;
+    }
+
+    // All added keys must match
+    for (int i = 0; i < length; i++) {
+      ASSERT_TRUE(Matches(Key(i, buffer)))
+          << "Length " << length << "; key " << i;
+    }
+
+    // Check false positive rate
+    double rate = FalsePositiveRate();
+    if (kVerbose >= 1) {
+      fprintf(stderr,
+              "False positives: %5.2f%% @ length = %6d ; bytes = %6d"
+              " (Bloom %6d)\n",
+              rate * 100.0, length, static_cast<int>(FilterSize()),
+              static_cast<int>(bloom_size));
+    }
+    ASSERT_LE(rate, 0.02);   // Must not be over 2%
+    if (rate > 0.0125)
+      mediocre_filters++;  // Allowed, but not too often
+    else
+      good_filters++;
+  }
+  if (kVerbose >= 1) {
+    fprintf(stderr, "Filters: %d good, %d mediocre\n",
+            good_filters, mediocre_filters);
+  }
+  ASSERT_LE(mediocre_filters, good_filters/5);
+}
+
+TEST_F(XorFilterTest, BitsPerKey) {
+  char buffer[sizeof(int)];
+  const int kNumKeys = 10000;
+
+  // 1 to 32 bits per fingerprint
+  const double kBitsPerKey[] = {1.0, 4.5, 6.0, 10.0, 15.5, 20.0, 30.0, 60.0};
+  for (double bits_per_key : kBitsPerKey) {
+    ResetPolicy(NewXorFilterPolicy(bits_per_key));
+    for (int i = 0; i < kNumKeys; i++) {
+      Add(Key(i, buffer));
+    }
+    Build();
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_TRUE(Matches(Key(i, buffer)))
+          << "bits_per_key " << bits_per_key << "; key " << i;
+    }
+    double rate = FalsePositiveRate();
+    double expected_rate =
+        std::pow(2.0, -static_cast<int>(bits_per_key * 0.693 + 0.5));
+    if (kVerbose >= 1) {
+      fprintf(stderr,
+              "False positives: %5.2f%% (expected %5.2f%%) @ bits_per_key = "
+              "%4.1f ; bytes = %6d\n",
+              rate * 100.0, expected_rate * 100.0, bits_per_key,
+              static_cast<int>(FilterSize()));
+    }
+    ASSERT_LE(rate, expected_rate * 1.5 + 0.0005) << bits_per_key;
+  }
+}
+
+TEST_F(XorFilterTest, ReadsAllFormats) {
+  char buffer[sizeof(int)];
+  std::unique_ptr<const FilterPolicy> policies[] = {
+      std::unique_ptr<const FilterPolicy>(
+          NewBloomFilterPolicy(FLAGS_bits_per_key, false)),
+      std::unique_ptr<const FilterPolicy>(
+          NewCacheLocalBloomFilterPolicy(FLAGS_bits_per_key)),
+      std::unique_ptr<const FilterPolicy>(
+          NewXorFilterPolicy(FLAGS_bits_per_key))};
+
+  for (auto& builder_policy : policies) {
+    // Every policy has its own name, and looks for the filters of the others
+    auto names = GetCompatibleFilterPolicyNames(builder_policy->Name());
+    ASSERT_EQ(3U, names.size());
+    ASSERT_EQ(std::string(builder_policy->Name()), names[0]);
+    for (auto& other_policy : policies) {
+      ASSERT_TRUE(std::find(names.begin(), names.end(),
+                            std::string(other_policy->Name())) != names.end());
+    }
+    std::unique_ptr<FilterBitsBuilder> builder(
+        builder_policy->GetFilterBitsBuilder());
+    for (int i = 0; i < 1000; i++) {
+      builder->AddKey(Key(i, buffer));
+    }
+    std::unique_ptr<const char[]> buf;
+    Slice filter = builder->Finish(&buf);
+
+    for (auto& reader_policy : policies) {
+      std::unique_ptr<FilterBitsReader> reader(
+          reader_policy->GetFilterBitsReader(filter));
+      int false_positives = 0;
+      for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(reader->MayMatch(Key(i, buffer)));
+        if (reader->MayMatch(Key(i + 1000000000, buffer))) {
+          false_positives++;
+        }
+      }
+      ASSERT_LE(false_positives, 40);
+    }
+  }
+}
+
+TEST_F(XorFilterTest, CorruptedFilter) {
+  char buffer[sizeof(int)];
+  std::unique_ptr<const FilterPolicy> policy(
+      NewXorFilterPolicy(FLAGS_bits_per_key));
+  std::unique_ptr<FilterBitsBuilder> builder(policy->GetFilterBitsBuilder());
+  for (int i = 0; i < 100; i++) {
+    builder->AddKey(Key(i, buffer));
+  }
+  std::unique_ptr<const char[]> buf;
+  Slice filter = builder->Finish(&buf);
+
+  // A segment length that does not fit the filter size, and an invalid
+  // number of fingerprint bits
+  for (size_t pos : {filter.size() - 9, filter.size() - 3}) {
+    std::string modified = filter.ToString();
+    modified[pos] = static_cast<char>(modified[pos] + 100);
+    std::unique_ptr<FilterBitsReader> reader(
+        policy->GetFilterBitsReader(Slice(modified)));
+    ASSERT_TRUE(reader->MayMatch(Key(1000000000, buffer)));
+  }
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
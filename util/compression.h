@@ -15,6 +15,7 @@
 
 #include "rocksdb/options.h"
 #include "util/coding.h"
+#include "util/compression_context_cache.h"
 
 #ifdef SNAPPY
 #include <snappy.h>
@@ -38,6 +39,15 @@
 #if ZSTD_VERSION_NUMBER >= 800  // v0.8.0+
 #include <zdict.h>
 #endif  // ZSTD_VERSION_NUMBER >= 800
+#if ZSTD_VERSION_NUMBER >= 700  // v0.7.0+
+// ZSTD can preprocess a dictionary once into ZSTD_CDict/ZSTD_DDict
+#define ROCKSDB_ZSTD_DIGESTED_DICT
+#endif  // ZSTD_VERSION_NUMBER >= 700
+#if ZSTD_VERSION_NUMBER >= 10000  // v1.0.0+
+// ZSTD_CStream/ZSTD_DStream with ZSTD_flushStream, to compress WAL records
+// against the earlier records of their file
+#define ROCKSDB_ZSTD_STREAMING
+#endif  // ZSTD_VERSION_NUMBER >= 10000
 #endif  // ZSTD
 
 #if defined(XPRESS)
@@ -94,6 +104,14 @@ inline bool ZSTD_Supported() {
 #endif
 }
 
+inline bool ZSTD_Streaming_Supported() {
+#ifdef ROCKSDB_ZSTD_STREAMING
+  return ZSTD_Supported();
+#else
+  return false;
+#endif
+}
+
 inline bool ZSTDNotFinal_Supported() {
 #ifdef ZSTD
   return true;
@@ -154,6 +172,216 @@ inline std::string CompressionTypeToString(CompressionType compression_type) {
   }
 }
 
+// Holds the dictionary used for presetting the compression library's state.
+// For ZSTD the dictionary is also digested once into a ZSTD_CDict, instead of
+// being parsed again for every compressed block.
+class CompressionDict {
+ public:
+  CompressionDict() {}
+
+  CompressionDict(std::string dict, CompressionType type, int level)
+      : dict_(std::move(dict)) {
+#ifdef ROCKSDB_ZSTD_DIGESTED_DICT
+    if (!dict_.empty() &&
+        (type == kZSTD || type == kZSTDNotFinalCompression)) {
+      zstd_cdict_ = ZSTD_createCDict(dict_.data(), dict_.size(), level);
+      assert(zstd_cdict_ != nullptr);
+    }
+#else
+    (void)type;
+    (void)level;
+#endif  // ROCKSDB_ZSTD_DIGESTED_DICT
+  }
+
+  ~CompressionDict() {
+#ifdef ROCKSDB_ZSTD_DIGESTED_DICT
+    if (zstd_cdict_ != nullptr) {
+      ZSTD_freeCDict(zstd_cdict_);
+    }
+#endif  // ROCKSDB_ZSTD_DIGESTED_DICT
+  }
+
+  Slice GetRawDict() const { return dict_; }
+
+#ifdef ROCKSDB_ZSTD_DIGESTED_DICT
+  // Returns nullptr if the dictionary is empty or not used with ZSTD.
+  const ZSTD_CDict* GetDigestedZstdCDict() const { return zstd_cdict_; }
+#endif  // ROCKSDB_ZSTD_DIGESTED_DICT
+
+  static const CompressionDict& GetEmptyDict() {
+    static CompressionDict empty_dict;
+    return empty_dict;
+  }
+
+  // No copying allowed
+  CompressionDict(const CompressionDict&) = delete;
+  CompressionDict& operator=(const CompressionDict&) = delete;
+
+ private:
+  std::string dict_;
+#ifdef ROCKSDB_ZSTD_DIGESTED_DICT
+  ZSTD_CDict* zstd_cdict_ = nullptr;
+#endif  // ROCKSDB_ZSTD_DIGESTED_DICT
+};
+
+// Counterpart of CompressionDict for decompression. The dictionary data is not
+// copied and must outlive this object.
+class UncompressionDict {
+ public:
+  UncompressionDict() {}
+
+  UncompressionDict(const Slice& dict, bool using_zstd) : dict_(dict) {
+#ifdef ROCKSDB_ZSTD_DIGESTED_DICT
+    if (!dict_.empty() && using_zstd) {
+      zstd_ddict_ = ZSTD_createDDict(dict_.data(), dict_.size());
+      assert(zstd_ddict_ != nullptr);
+    }
+#else
+    (void)using_zstd;
+#endif  // ROCKSDB_ZSTD_DIGESTED_DICT
+  }
+
+  ~UncompressionDict() {
+#ifdef ROCKSDB_ZSTD_DIGESTED_DICT
+    if (zstd_ddict_ != nullptr) {
+      ZSTD_freeDDict(zstd_ddict_);
+    }
+#endif  // ROCKSDB_ZSTD_DIGESTED_DICT
+  }
+
+  const Slice& GetRawDict() const { return dict_; }
+
+#ifdef ROCKSDB_ZSTD_DIGESTED_DICT
+  // Returns nullptr if the dictionary is empty or not used with ZSTD.
+  const ZSTD_DDict* GetDigestedZstdDDict() const { return zstd_ddict_; }
+#endif  // ROCKSDB_ZSTD_DIGESTED_DICT
+
+  static const UncompressionDict& GetEmptyDict() {
+    static UncompressionDict empty_dict;
+    return empty_dict;
+  }
+
+  // No copying allowed
+  UncompressionDict(const UncompressionDict&) = delete;
+  UncompressionDict& operator=(const UncompressionDict&) = delete;
+
+ private:
+  Slice dict_;
+#ifdef ROCKSDB_ZSTD_DIGESTED_DICT
+  ZSTD_DDict* zstd_ddict_ = nullptr;
+#endif  // ROCKSDB_ZSTD_DIGESTED_DICT
+};
+
+// Scratch state for compression that can be reused across calls made by one
+// thread, e.g. for all blocks of one table file. Everything is created on
+// first use. The ZSTD context is borrowed from the per-core
+// CompressionContextCache and handed back on destruction.
+// Not thread-safe.
+class CompressionContext {
+ public:
+  CompressionContext() {}
+
+  ~CompressionContext() {
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
+    if (zstd_ctx_ != nullptr) {
+      CompressionContextCache::Instance()->ReturnZSTDCompressionContext(
+          zstd_ctx_, zstd_ctx_core_idx_);
+    }
+#endif  // ZSTD && ZSTD_VERSION_NUMBER >= 500
+#if defined(LZ4) && LZ4_VERSION_NUMBER >= 10400  // r124+
+    if (lz4_stream_ != nullptr) {
+      LZ4_freeStream(lz4_stream_);
+    }
+    if (lz4hc_stream_ != nullptr) {
+      LZ4_freeStreamHC(lz4hc_stream_);
+    }
+#endif  // LZ4 && LZ4_VERSION_NUMBER >= 10400
+  }
+
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
+  ZSTD_CCtx* ZSTDContext() {
+    if (zstd_ctx_ == nullptr) {
+      zstd_ctx_ =
+          CompressionContextCache::Instance()->GetZSTDCompressionContext(
+              &zstd_ctx_core_idx_);
+    }
+    return zstd_ctx_;
+  }
+#endif  // ZSTD && ZSTD_VERSION_NUMBER >= 500
+
+#if defined(LZ4) && LZ4_VERSION_NUMBER >= 10400  // r124+
+  // Returns a stream in its initial state, i.e. without history from the
+  // previous call.
+  LZ4_stream_t* LZ4Stream() {
+    if (lz4_stream_ == nullptr) {
+      lz4_stream_ = LZ4_createStream();
+    } else {
+      LZ4_resetStream(lz4_stream_);
+    }
+    return lz4_stream_;
+  }
+
+  // The caller resets the returned stream with LZ4_resetStreamHC() since that
+  // also sets the compression level.
+  LZ4_streamHC_t* LZ4HCStream() {
+    if (lz4hc_stream_ == nullptr) {
+      lz4hc_stream_ = LZ4_createStreamHC();
+    }
+    return lz4hc_stream_;
+  }
+#endif  // LZ4 && LZ4_VERSION_NUMBER >= 10400
+
+  // No copying allowed
+  CompressionContext(const CompressionContext&) = delete;
+  CompressionContext& operator=(const CompressionContext&) = delete;
+
+ private:
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
+  ZSTD_CCtx* zstd_ctx_ = nullptr;
+  size_t zstd_ctx_core_idx_ = 0;
+#endif  // ZSTD && ZSTD_VERSION_NUMBER >= 500
+#if defined(LZ4) && LZ4_VERSION_NUMBER >= 10400  // r124+
+  LZ4_stream_t* lz4_stream_ = nullptr;
+  LZ4_streamHC_t* lz4hc_stream_ = nullptr;
+#endif  // LZ4 && LZ4_VERSION_NUMBER >= 10400
+};
+
+// Scratch state for decompression, see CompressionContext.
+class UncompressionContext {
+ public:
+  UncompressionContext() {}
+
+  ~UncompressionContext() {
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
+    if (zstd_ctx_ != nullptr) {
+      CompressionContextCache::Instance()->ReturnZSTDUncompressionContext(
+          zstd_ctx_, zstd_ctx_core_idx_);
+    }
+#endif  // ZSTD && ZSTD_VERSION_NUMBER >= 500
+  }
+
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
+  ZSTD_DCtx* ZSTDContext() {
+    if (zstd_ctx_ == nullptr) {
+      zstd_ctx_ =
+          CompressionContextCache::Instance()->GetZSTDUncompressionContext(
+              &zstd_ctx_core_idx_);
+    }
+    return zstd_ctx_;
+  }
+#endif  // ZSTD && ZSTD_VERSION_NUMBER >= 500
+
+  // No copying allowed
+  UncompressionContext(const UncompressionContext&) = delete;
+  UncompressionContext& operator=(const UncompressionContext&) = delete;
+
+ private:
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
+  ZSTD_DCtx* zstd_ctx_ = nullptr;
+  size_t zstd_ctx_core_idx_ = 0;
+#endif  // ZSTD && ZSTD_VERSION_NUMBER >= 500
+};
+
 // compress_format_version can have two values:
 // 1 -- decompressed sizes for BZip2 and Zlib are not included in the compressed
 // block. Also, decompressed sizes for LZ4 are encoded in platform-dependent
@@ -530,10 +758,12 @@ inline char* BZip2_Uncompress(const char* input_data, size_t input_length,
 // header in varint32 format
 // @param compression_dict Data for presetting the compression library's
 //    dictionary.
+// @param ctx Reusable compression state. A temporary one is used if nullptr.
 inline bool LZ4_Compress(const CompressionOptions& opts,
                          uint32_t compress_format_version, const char* input,
                          size_t length, ::std::string* output,
-                         const Slice compression_dict = Slice()) {
+                         const Slice compression_dict = Slice(),
+                         CompressionContext* ctx = nullptr) {
 #ifdef LZ4
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -558,7 +788,11 @@ inline bool LZ4_Compress(const CompressionOptions& opts,
 
   int outlen;
 #if LZ4_VERSION_NUMBER >= 10400  // r124+
-  LZ4_stream_t* stream = LZ4_createStream();
+  CompressionContext local_ctx;
+  if (ctx == nullptr) {
+    ctx = &local_ctx;
+  }
+  LZ4_stream_t* stream = ctx->LZ4Stream();
   if (compression_dict.size()) {
     LZ4_loadDict(stream, compression_dict.data(),
                  static_cast<int>(compression_dict.size()));
@@ -572,8 +806,8 @@ inline bool LZ4_Compress(const CompressionOptions& opts,
       stream, input, &(*output)[output_header_len], static_cast<int>(length),
       compress_bound);
 #endif
-  LZ4_freeStream(stream);
 #else   // up to r123
+  (void)ctx;
   outlen = LZ4_compress_limitedOutput(input, &(*output)[output_header_len],
                                       static_cast<int>(length), compress_bound);
 #endif  // LZ4_VERSION_NUMBER >= 10400
@@ -618,15 +852,14 @@ inline char* LZ4_Uncompress(const char* input_data, size_t input_length,
 
   char* output = new char[output_len];
 #if LZ4_VERSION_NUMBER >= 10400  // r124+
-  LZ4_streamDecode_t* stream = LZ4_createStreamDecode();
-  if (compression_dict.size()) {
-    LZ4_setStreamDecode(stream, compression_dict.data(),
-                        static_cast<int>(compression_dict.size()));
-  }
+  // The decode stream is small enough to live on the stack. Setting the
+  // dictionary, even an empty one, fully initializes it.
+  LZ4_streamDecode_t stream;
+  LZ4_setStreamDecode(&stream, compression_dict.data(),
+                      static_cast<int>(compression_dict.size()));
   *decompress_size = LZ4_decompress_safe_continue(
-      stream, input_data, output, static_cast<int>(input_length),
+      &stream, input_data, output, static_cast<int>(input_length),
       static_cast<int>(output_len));
-  LZ4_freeStreamDecode(stream);
 #else   // up to r123
   *decompress_size =
       LZ4_decompress_safe(input_data, output, static_cast<int>(input_length),
@@ -649,10 +882,12 @@ inline char* LZ4_Uncompress(const char* input_data, size_t input_length,
 // header in varint32 format
 // @param compression_dict Data for presetting the compression library's
 //    dictionary.
+// @param ctx Reusable compression state. A temporary one is used if nullptr.
 inline bool LZ4HC_Compress(const CompressionOptions& opts,
                            uint32_t compress_format_version, const char* input,
                            size_t length, ::std::string* output,
-                           const Slice& compression_dict = Slice()) {
+                           const Slice& compression_dict = Slice(),
+                           CompressionContext* ctx = nullptr) {
 #ifdef LZ4
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -677,7 +912,11 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
 
   int outlen;
 #if LZ4_VERSION_NUMBER >= 10400  // r124+
-  LZ4_streamHC_t* stream = LZ4_createStreamHC();
+  CompressionContext local_ctx;
+  if (ctx == nullptr) {
+    ctx = &local_ctx;
+  }
+  LZ4_streamHC_t* stream = ctx->LZ4HCStream();
   LZ4_resetStreamHC(stream, opts.level);
   const char* compression_dict_data =
       compression_dict.size() > 0 ? compression_dict.data() : nullptr;
@@ -694,13 +933,14 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
       stream, input, &(*output)[output_header_len], static_cast<int>(length),
       compress_bound);
 #endif  // LZ4_VERSION_NUMBER >= 10700
-  LZ4_freeStreamHC(stream);
 
 #elif LZ4_VERSION_MAJOR  // r113-r123
+  (void)ctx;
   outlen = LZ4_compressHC2_limitedOutput(input, &(*output)[output_header_len],
                                          static_cast<int>(length),
                                          compress_bound, opts.level);
 #else                    // up to r112
+  (void)ctx;
   outlen =
       LZ4_compressHC_limitedOutput(input, &(*output)[output_header_len],
                                    static_cast<int>(length), compress_bound);
@@ -734,10 +974,13 @@ inline char* XPRESS_Uncompress(const char* input_data, size_t input_length,
 
 
 // @param compression_dict Data for presetting the compression library's
-//    dictionary.
-inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
-                          size_t length, ::std::string* output,
-                          const Slice& compression_dict = Slice()) {
+//    dictionary. Its digested form is used when available.
+// @param ctx Reusable compression state. A temporary one is used if nullptr.
+inline bool ZSTD_Compress(
+    const CompressionOptions& opts, const char* input, size_t length,
+    ::std::string* output,
+    const CompressionDict& compression_dict = CompressionDict::GetEmptyDict(),
+    CompressionContext* ctx = nullptr) {
 #ifdef ZSTD
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -751,12 +994,27 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
   output->resize(static_cast<size_t>(output_header_len + compressBound));
   size_t outlen;
 #if ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
-  ZSTD_CCtx* context = ZSTD_createCCtx();
-  outlen = ZSTD_compress_usingDict(
-      context, &(*output)[output_header_len], compressBound, input, length,
-      compression_dict.data(), compression_dict.size(), opts.level);
-  ZSTD_freeCCtx(context);
+  CompressionContext local_ctx;
+  if (ctx == nullptr) {
+    ctx = &local_ctx;
+  }
+  ZSTD_CCtx* context = ctx->ZSTDContext();
+#ifdef ROCKSDB_ZSTD_DIGESTED_DICT
+  if (compression_dict.GetDigestedZstdCDict() != nullptr) {
+    outlen = ZSTD_compress_usingCDict(context, &(*output)[output_header_len],
+                                      compressBound, input, length,
+                                      compression_dict.GetDigestedZstdCDict());
+  } else
+#endif  // ROCKSDB_ZSTD_DIGESTED_DICT
+  {
+    Slice dict = compression_dict.GetRawDict();
+    outlen = ZSTD_compress_usingDict(context, &(*output)[output_header_len],
+                                     compressBound, input, length, dict.data(),
+                                     dict.size(), opts.level);
+  }
 #else  // up to v0.4.x
+  (void)compression_dict;
+  (void)ctx;
   outlen = ZSTD_compress(&(*output)[output_header_len], compressBound, input,
                          length, opts.level);
 #endif  // ZSTD_VERSION_NUMBER >= 500
@@ -770,10 +1028,13 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 }
 
 // @param compression_dict Data for presetting the compression library's
-//    dictionary.
-inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
-                             int* decompress_size,
-                             const Slice& compression_dict = Slice()) {
+//    dictionary. Its digested form is used when available.
+// @param ctx Reusable decompression state. A temporary one is used if nullptr.
+inline char* ZSTD_Uncompress(
+    const char* input_data, size_t input_length, int* decompress_size,
+    const UncompressionDict& compression_dict =
+        UncompressionDict::GetEmptyDict(),
+    UncompressionContext* ctx = nullptr) {
 #ifdef ZSTD
   uint32_t output_len = 0;
   if (!compression::GetDecompressedSizeInfo(&input_data, &input_length,
@@ -784,12 +1045,27 @@ inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
   char* output = new char[output_len];
   size_t actual_output_length;
 #if ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
-  ZSTD_DCtx* context = ZSTD_createDCtx();
-  actual_output_length = ZSTD_decompress_usingDict(
-      context, output, output_len, input_data, input_length,
-      compression_dict.data(), compression_dict.size());
-  ZSTD_freeDCtx(context);
+  UncompressionContext local_ctx;
+  if (ctx == nullptr) {
+    ctx = &local_ctx;
+  }
+  ZSTD_DCtx* context = ctx->ZSTDContext();
+#ifdef ROCKSDB_ZSTD_DIGESTED_DICT
+  if (compression_dict.GetDigestedZstdDDict() != nullptr) {
+    actual_output_length = ZSTD_decompress_usingDDict(
+        context, output, output_len, input_data, input_length,
+        compression_dict.GetDigestedZstdDDict());
+  } else
+#endif  // ROCKSDB_ZSTD_DIGESTED_DICT
+  {
+    const Slice& dict = compression_dict.GetRawDict();
+    actual_output_length =
+        ZSTD_decompress_usingDict(context, output, output_len, input_data,
+                                  input_length, dict.data(), dict.size());
+  }
 #else  // up to v0.4.x
+  (void)compression_dict;
+  (void)ctx;
   actual_output_length =
       ZSTD_decompress(output, output_len, input_data, input_length);
 #endif  // ZSTD_VERSION_NUMBER >= 500
@@ -800,6 +1076,136 @@ inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
   return nullptr;
 }
 
+// Compresses a sequence of records into one ZSTD stream, so that records are
+// compressed against the history of the records before them, e.g. within one
+// WAL file. Every record is flushed, so that a ZSTDStreamingUncompress fed
+// the same records in the same order can uncompress each as soon as it is
+// read. Only works if ZSTD_Streaming_Supported(). Not thread-safe.
+class ZSTDStreamingCompress {
+ public:
+  explicit ZSTDStreamingCompress(int level) {
+#ifdef ROCKSDB_ZSTD_STREAMING
+    stream_ = ZSTD_createCStream();
+    if (stream_ != nullptr && ZSTD_isError(ZSTD_initCStream(stream_, level))) {
+      ZSTD_freeCStream(stream_);
+      stream_ = nullptr;
+    }
+#else
+    (void)level;
+#endif  // ROCKSDB_ZSTD_STREAMING
+  }
+
+  ~ZSTDStreamingCompress() {
+#ifdef ROCKSDB_ZSTD_STREAMING
+    if (stream_ != nullptr) {
+      ZSTD_freeCStream(stream_);
+    }
+#endif  // ROCKSDB_ZSTD_STREAMING
+  }
+
+  // Appends the compressed record to *output. After a failure the stream
+  // cannot be used any more.
+  bool Compress(const Slice& input, std::string* output) {
+#ifdef ROCKSDB_ZSTD_STREAMING
+    if (stream_ == nullptr) {
+      return false;
+    }
+    ZSTD_inBuffer in = {input.data(), input.size(), 0};
+    const size_t chunk_size = ZSTD_CStreamOutSize();
+    size_t to_flush;
+    do {
+      size_t old_size = output->size();
+      output->resize(old_size + chunk_size);
+      ZSTD_outBuffer out = {&(*output)[old_size], chunk_size, 0};
+      if (in.pos < in.size) {
+        to_flush = ZSTD_compressStream(stream_, &out, &in);
+      } else {
+        to_flush = ZSTD_flushStream(stream_, &out);
+      }
+      output->resize(old_size + out.pos);
+      if (ZSTD_isError(to_flush)) {
+        return false;
+      }
+    } while (in.pos < in.size || to_flush > 0);
+    return true;
+#else
+    (void)input;
+    (void)output;
+    return false;
+#endif  // ROCKSDB_ZSTD_STREAMING
+  }
+
+  // No copying allowed
+  ZSTDStreamingCompress(const ZSTDStreamingCompress&) = delete;
+  ZSTDStreamingCompress& operator=(const ZSTDStreamingCompress&) = delete;
+
+ private:
+#ifdef ROCKSDB_ZSTD_STREAMING
+  ZSTD_CStream* stream_ = nullptr;
+#endif  // ROCKSDB_ZSTD_STREAMING
+};
+
+// Uncompresses the records of a ZSTDStreamingCompress, see there.
+class ZSTDStreamingUncompress {
+ public:
+  ZSTDStreamingUncompress() {
+#ifdef ROCKSDB_ZSTD_STREAMING
+    stream_ = ZSTD_createDStream();
+    if (stream_ != nullptr && ZSTD_isError(ZSTD_initDStream(stream_))) {
+      ZSTD_freeDStream(stream_);
+      stream_ = nullptr;
+    }
+#endif  // ROCKSDB_ZSTD_STREAMING
+  }
+
+  ~ZSTDStreamingUncompress() {
+#ifdef ROCKSDB_ZSTD_STREAMING
+    if (stream_ != nullptr) {
+      ZSTD_freeDStream(stream_);
+    }
+#endif  // ROCKSDB_ZSTD_STREAMING
+  }
+
+  // Appends the uncompressed record to *output. After a failure the stream
+  // cannot be used any more.
+  bool Uncompress(const Slice& input, std::string* output) {
+#ifdef ROCKSDB_ZSTD_STREAMING
+    if (stream_ == nullptr) {
+      return false;
+    }
+    ZSTD_inBuffer in = {input.data(), input.size(), 0};
+    const size_t chunk_size = ZSTD_DStreamOutSize();
+    bool output_full;
+    do {
+      size_t old_size = output->size();
+      output->resize(old_size + chunk_size);
+      ZSTD_outBuffer out = {&(*output)[old_size], chunk_size, 0};
+      size_t ret = ZSTD_decompressStream(stream_, &out, &in);
+      output->resize(old_size + out.pos);
+      if (ZSTD_isError(ret)) {
+        return false;
+      }
+      // A full output buffer may leave more to flush
+      output_full = out.pos == chunk_size;
+    } while (in.pos < in.size || output_full);
+    return true;
+#else
+    (void)input;
+    (void)output;
+    return false;
+#endif  // ROCKSDB_ZSTD_STREAMING
+  }
+
+  // No copying allowed
+  ZSTDStreamingUncompress(const ZSTDStreamingUncompress&) = delete;
+  ZSTDStreamingUncompress& operator=(const ZSTDStreamingUncompress&) = delete;
+
+ private:
+#ifdef ROCKSDB_ZSTD_STREAMING
+  ZSTD_DStream* stream_ = nullptr;
+#endif  // ROCKSDB_ZSTD_STREAMING
+};
+
 inline std::string ZSTD_TrainDictionary(const std::string& samples,
                                         const std::vector<size_t>& sample_lens,
                                         size_t max_dict_bytes) {
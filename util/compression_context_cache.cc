@@ -0,0 +1,125 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+
+#include "util/compression_context_cache.h"
+
+#include <assert.h>
+#include <atomic>
+
+#include "port/port.h"
+#include "util/core_local.h"
+
+// Only generate field unused warning for padding array, or build under
+// GCC 4.8.1 will fail.
+#ifdef __clang__
+#define ROCKSDB_FIELD_UNUSED __attribute__((__unused__))
+#else
+#define ROCKSDB_FIELD_UNUSED
+#endif  // __clang__
+
+namespace rocksdb {
+
+class CompressionContextCache::Rep {
+ public:
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
+  ~Rep() {
+    for (size_t i = 0; i < per_core_.Size(); ++i) {
+      ZSTDCachedContexts* slot = per_core_.AccessAtCore(i);
+      ZSTD_CCtx* cctx = slot->cctx.exchange(nullptr);
+      if (cctx != nullptr) {
+        ZSTD_freeCCtx(cctx);
+      }
+      ZSTD_DCtx* dctx = slot->dctx.exchange(nullptr);
+      if (dctx != nullptr) {
+        ZSTD_freeDCtx(dctx);
+      }
+    }
+  }
+
+  ZSTD_CCtx* GetCCtx(size_t* core_idx) {
+    auto slot_and_idx = per_core_.AccessElementAndIndex();
+    *core_idx = slot_and_idx.second;
+    ZSTD_CCtx* ctx = slot_and_idx.first->cctx.exchange(nullptr);
+    if (ctx == nullptr) {
+      ctx = ZSTD_createCCtx();
+    }
+    return ctx;
+  }
+
+  void ReturnCCtx(ZSTD_CCtx* ctx, size_t core_idx) {
+    ZSTD_CCtx* expected = nullptr;
+    if (!per_core_.AccessAtCore(core_idx)->cctx.compare_exchange_strong(
+            expected, ctx)) {
+      ZSTD_freeCCtx(ctx);
+    }
+  }
+
+  ZSTD_DCtx* GetDCtx(size_t* core_idx) {
+    auto slot_and_idx = per_core_.AccessElementAndIndex();
+    *core_idx = slot_and_idx.second;
+    ZSTD_DCtx* ctx = slot_and_idx.first->dctx.exchange(nullptr);
+    if (ctx == nullptr) {
+      ctx = ZSTD_createDCtx();
+    }
+    return ctx;
+  }
+
+  void ReturnDCtx(ZSTD_DCtx* ctx, size_t core_idx) {
+    ZSTD_DCtx* expected = nullptr;
+    if (!per_core_.AccessAtCore(core_idx)->dctx.compare_exchange_strong(
+            expected, ctx)) {
+      ZSTD_freeDCtx(ctx);
+    }
+  }
+
+ private:
+  // One idle context of each kind per core. Padded so slots of different
+  // cores never share a cache line.
+  struct ZSTDCachedContexts {
+    std::atomic<ZSTD_CCtx*> cctx{nullptr};
+    std::atomic<ZSTD_DCtx*> dctx{nullptr};
+    char padding[CACHE_LINE_SIZE - sizeof(std::atomic<ZSTD_CCtx*>) -
+                 sizeof(std::atomic<ZSTD_DCtx*>)] ROCKSDB_FIELD_UNUSED;
+  };
+
+  CoreLocalArray<ZSTDCachedContexts> per_core_;
+#endif  // ZSTD && ZSTD_VERSION_NUMBER >= 500
+};
+
+CompressionContextCache* CompressionContextCache::Instance() {
+  // Intentionally leaked, as compression may still happen in background
+  // threads during static destruction.
+  static CompressionContextCache* instance = new CompressionContextCache();
+  return instance;
+}
+
+CompressionContextCache::CompressionContextCache() : rep_(new Rep()) {}
+
+CompressionContextCache::~CompressionContextCache() {}
+
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
+ZSTD_CCtx* CompressionContextCache::GetZSTDCompressionContext(
+    size_t* core_idx) {
+  return rep_->GetCCtx(core_idx);
+}
+
+ZSTD_DCtx* CompressionContextCache::GetZSTDUncompressionContext(
+    size_t* core_idx) {
+  return rep_->GetDCtx(core_idx);
+}
+
+void CompressionContextCache::ReturnZSTDCompressionContext(ZSTD_CCtx* ctx,
+                                                           size_t core_idx) {
+  rep_->ReturnCCtx(ctx, core_idx);
+}
+
+void CompressionContextCache::ReturnZSTDUncompressionContext(
+    ZSTD_DCtx* ctx, size_t core_idx) {
+  rep_->ReturnDCtx(ctx, core_idx);
+}
+#endif  // ZSTD && ZSTD_VERSION_NUMBER >= 500
+
+}  // namespace rocksdb
@@ -0,0 +1,53 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+
+// Compression context cache allows to cache compression/uncompression contexts
+// per core so they are not created and destroyed for every compressed block.
+// ZSTD contexts are several hundred KB each, so allocating one per block shows
+// up both in compaction and in cold reads.
+
+#pragma once
+
+#include <stddef.h>
+#include <memory>
+
+#if defined(ZSTD)
+#include <zstd.h>
+#endif  // ZSTD
+
+namespace rocksdb {
+
+class CompressionContextCache {
+ public:
+  // Singleton, never destroyed.
+  static CompressionContextCache* Instance();
+
+#if defined(ZSTD) && ZSTD_VERSION_NUMBER >= 500  // v0.5.0+
+  // Returns an idle context cached for the current core, or a newly created
+  // one if there is none. *core_idx receives the slot the context should be
+  // returned to.
+  ZSTD_CCtx* GetZSTDCompressionContext(size_t* core_idx);
+  ZSTD_DCtx* GetZSTDUncompressionContext(size_t* core_idx);
+
+  // Puts a context obtained above back into slot core_idx. The context is
+  // freed if another one has been cached there in the meantime.
+  void ReturnZSTDCompressionContext(ZSTD_CCtx* ctx, size_t core_idx);
+  void ReturnZSTDUncompressionContext(ZSTD_DCtx* ctx, size_t core_idx);
+#endif  // ZSTD && ZSTD_VERSION_NUMBER >= 500
+
+  // No copying allowed
+  CompressionContextCache(const CompressionContextCache&) = delete;
+  CompressionContextCache& operator=(const CompressionContextCache&) = delete;
+
+ private:
+  CompressionContextCache();
+  ~CompressionContextCache();
+
+  class Rep;
+  std::unique_ptr<Rep> rep_;
+};
+
+}  // namespace rocksdb
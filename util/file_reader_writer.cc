@@ -10,14 +10,17 @@
 #include "util/file_reader_writer.h"
 
 #include <algorithm>
+#include <condition_variable>
 #include <mutex>
 
 #include "monitoring/histogram.h"
 #include "monitoring/iostats_context_imp.h"
+#include "monitoring/statistics.h"
 #include "port/port.h"
 #include "util/random.h"
 #include "util/rate_limiter.h"
 #include "util/sync_point.h"
+#include "util/threadpool_imp.h"
 
 namespace rocksdb {
 
@@ -148,6 +151,34 @@ Status RandomAccessFileReader::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+Status RandomAccessFileReader::MultiRead(ReadRequest* reqs,
+                                         size_t num_reqs) const {
+  if (use_direct_io() || (for_compaction_ && rate_limiter_ != nullptr)) {
+    for (size_t i = 0; i < num_reqs; ++i) {
+      ReadRequest& req = reqs[i];
+      req.status = Read(req.offset, req.len, &req.result, req.scratch);
+    }
+    return Status::OK();
+  }
+  Status s;
+  uint64_t elapsed = 0;
+  {
+    StopWatch sw(env_, stats_, hist_type_,
+                 (stats_ != nullptr) ? &elapsed : nullptr);
+    IOSTATS_TIMER_GUARD(read_nanos);
+    s = file_->MultiRead(reqs, num_reqs);
+    for (size_t i = 0; s.ok() && i < num_reqs; ++i) {
+      if (reqs[i].status.ok()) {
+        IOSTATS_ADD_IF_POSITIVE(bytes_read, reqs[i].result.size());
+      }
+    }
+  }
+  if (stats_ != nullptr && file_read_hist_ != nullptr) {
+    file_read_hist_->Add(elapsed);
+  }
+  return s;
+}
+
 Status WritableFileWriter::Append(const Slice& data) {
   const char* src = data.data();
   size_t left = data.size();
@@ -473,10 +504,76 @@ Status WritableFileWriter::WriteDirect() {
 #endif  // !ROCKSDB_LITE
 
 namespace {
+// Threads reading ahead for all ReadaheadRandomAccessFiles in async mode.
+// They only ever do a single read per job and never wait for anything else,
+// and a reader that needs data that is still queued reads it itself, so a
+// small pool shared by all DBs in the process suffices.
+const int kAsyncReadaheadThreads = 4;
+
+ThreadPoolImpl* AsyncReadaheadThreadPool() {
+  // Never destroyed, so that files being closed during static destruction
+  // do not race with the pool going away
+  static ThreadPoolImpl* pool = [] {
+    ThreadPoolImpl* p = new ThreadPoolImpl();
+    p->SetBackgroundThreads(kAsyncReadaheadThreads);
+    return p;
+  }();
+  return pool;
+}
+
+// The next readahead chunk of a ReadaheadRandomAccessFile in async mode,
+// read by a thread of AsyncReadaheadThreadPool(). Shared with the job, which
+// may only run after the file is gone.
+struct AsyncReadahead {
+  enum State {
+    kIdle,
+    // Submitted but not started. The reader may take it back.
+    kQueued,
+    // Being read; has to be waited for
+    kRunning,
+    // buffer holds [offset, offset + len) or the read failed
+    kDone,
+    // The file was closed
+    kAbandoned,
+  };
+
+  std::mutex mu;
+  std::condition_variable cv;
+  State state = kIdle;
+  RandomAccessFile* file = nullptr;
+  uint64_t offset = 0;
+  size_t len = 0;
+  AlignedBuffer buffer;
+  Status status;
+
+  static void Run(const std::shared_ptr<AsyncReadahead>& r) {
+    uint64_t offset;
+    size_t n;
+    {
+      std::lock_guard<std::mutex> lock(r->mu);
+      if (r->state != kQueued) {
+        // Taken back by the reader, or the file is closed
+        return;
+      }
+      r->state = kRunning;
+      offset = r->offset;
+      n = r->buffer.Capacity();
+    }
+    TEST_SYNC_POINT("AsyncReadahead::Run:BeforeRead");
+    Slice result;
+    Status s = r->file->Read(offset, n, &result, r->buffer.BufferStart());
+    std::lock_guard<std::mutex> lock(r->mu);
+    r->status = s;
+    r->len = s.ok() ? result.size() : 0;
+    r->state = kDone;
+    r->cv.notify_all();
+  }
+};
+
 class ReadaheadRandomAccessFile : public RandomAccessFile {
  public:
   ReadaheadRandomAccessFile(std::unique_ptr<RandomAccessFile>&& file,
-                            size_t readahead_size)
+                            size_t readahead_size, bool async)
       : file_(std::move(file)),
         alignment_(file_->GetRequiredBufferAlignment()),
         readahead_size_(Roundup(readahead_size, alignment_)),
@@ -486,6 +583,24 @@ class ReadaheadRandomAccessFile : public RandomAccessFile {
 
     buffer_.Alignment(alignment_);
     buffer_.AllocateNewBuffer(readahead_size_);
+    if (async) {
+      next_.reset(new AsyncReadahead());
+      next_->file = file_.get();
+      next_->buffer.Alignment(alignment_);
+      next_->buffer.AllocateNewBuffer(readahead_size_);
+    }
+  }
+
+  ~ReadaheadRandomAccessFile() {
+    if (next_ != nullptr) {
+      // A queued job must not touch file_ anymore, and a running one has to
+      // be done with it
+      std::unique_lock<std::mutex> lock(next_->mu);
+      next_->cv.wait(lock, [this] {
+        return next_->state != AsyncReadahead::kRunning;
+      });
+      next_->state = AsyncReadahead::kAbandoned;
+    }
   }
 
  ReadaheadRandomAccessFile(const ReadaheadRandomAccessFile&) = delete;
@@ -511,6 +626,7 @@ class ReadaheadRandomAccessFile : public RandomAccessFile {
          // End of file
          buffer_len_ < readahead_size_)) {
       *result = Slice(scratch, cached_len);
+      MaybeStartAsyncReadahead(offset + cached_len);
       return Status::OK();
     }
     size_t advanced_offset = offset + cached_len;
@@ -519,7 +635,10 @@ class ReadaheadRandomAccessFile : public RandomAccessFile {
     size_t chunk_offset = TruncateToPageBoundary(alignment_, advanced_offset);
     Slice readahead_result;
 
-    Status s = ReadIntoBuffer(chunk_offset, readahead_size_);
+    Status s;
+    if (!TakeAsyncReadahead(chunk_offset)) {
+      s = ReadIntoBuffer(chunk_offset, readahead_size_);
+    }
     if (s.ok()) {
       // In the case of cache miss, i.e. when cached_len equals 0, an offset can
       // exceed the file end position, so the following check is required
@@ -536,6 +655,7 @@ class ReadaheadRandomAccessFile : public RandomAccessFile {
       } else {
         *result = Slice(scratch, cached_len);
       }
+      MaybeStartAsyncReadahead(offset + result->size());
     }
     return s;
   }
@@ -577,6 +697,77 @@ class ReadaheadRandomAccessFile : public RandomAccessFile {
     return true;
   }
 
+  // Once the reader is past the middle of a full buffer, starts reading the
+  // chunk after it in the background. Called with lock_ held.
+  void MaybeStartAsyncReadahead(uint64_t read_end) const {
+    if (next_ == nullptr || buffer_len_ < readahead_size_ ||
+        read_end < buffer_offset_ + buffer_len_ / 2) {
+      return;
+    }
+    uint64_t next_offset = buffer_offset_ + buffer_len_;
+    {
+      std::lock_guard<std::mutex> lock(next_->mu);
+      if (next_->state == AsyncReadahead::kDone &&
+          next_->offset != next_offset) {
+        // Left over from before a seek
+        next_->state = AsyncReadahead::kIdle;
+      }
+      if (next_->state != AsyncReadahead::kIdle) {
+        return;
+      }
+      next_->state = AsyncReadahead::kQueued;
+      next_->offset = next_offset;
+    }
+    std::shared_ptr<AsyncReadahead> next = next_;
+    AsyncReadaheadThreadPool()->SubmitJob(
+        [next]() { AsyncReadahead::Run(next); });
+  }
+
+  // Makes the background readahead of offset the current buffer. Returns
+  // false if there is none, in which case the caller reads it. Called with
+  // lock_ held.
+  bool TakeAsyncReadahead(uint64_t offset) const {
+    if (next_ == nullptr) {
+      return false;
+    }
+    TEST_SYNC_POINT("ReadaheadRandomAccessFile::TakeAsyncReadahead");
+    std::unique_lock<std::mutex> lock(next_->mu);
+    if (next_->offset != offset) {
+      // Not what we need, but if it is still queued, take it back so that
+      // a new one can be started
+      if (next_->state == AsyncReadahead::kQueued ||
+          next_->state == AsyncReadahead::kDone) {
+        next_->state = AsyncReadahead::kIdle;
+      }
+      return false;
+    }
+    switch (next_->state) {
+      case AsyncReadahead::kQueued:
+        // Reading it ourselves is faster than waiting for a thread
+        next_->state = AsyncReadahead::kIdle;
+        return false;
+      case AsyncReadahead::kRunning:
+        next_->cv.wait(lock, [this] {
+          return next_->state != AsyncReadahead::kRunning;
+        });
+        break;
+      case AsyncReadahead::kDone:
+        break;
+      default:
+        return false;
+    }
+    assert(next_->state == AsyncReadahead::kDone);
+    next_->state = AsyncReadahead::kIdle;
+    if (!next_->status.ok()) {
+      // Let the caller retry and report it
+      return false;
+    }
+    std::swap(buffer_, next_->buffer);
+    buffer_offset_ = next_->offset;
+    buffer_len_ = next_->len;
+    return true;
+  }
+
   Status ReadIntoBuffer(uint64_t offset, size_t n) const {
     if (n > buffer_.Capacity()) {
       n = buffer_.Capacity();
@@ -600,41 +791,117 @@ class ReadaheadRandomAccessFile : public RandomAccessFile {
   mutable AlignedBuffer buffer_;
   mutable uint64_t buffer_offset_;
   mutable size_t buffer_len_;
+  // Only set in async mode
+  std::shared_ptr<AsyncReadahead> next_;
 };
 }  // namespace
 
+FilePrefetchBuffer::~FilePrefetchBuffer() { RecordUnusedBytes(); }
+
+void FilePrefetchBuffer::RecordUnusedBytes() {
+  if (buffer_len_ > buffer_bytes_used_) {
+    RecordTick(stats_, PREFETCH_BYTES_WASTED,
+               buffer_len_ - buffer_bytes_used_);
+  }
+}
+
 Status FilePrefetchBuffer::Prefetch(RandomAccessFileReader* reader,
                                     uint64_t offset, size_t n) {
   size_t alignment = reader->file()->GetRequiredBufferAlignment();
-  uint64_t roundup_offset = Roundup(offset, alignment);
-  uint64_t roundup_len = Roundup(n, alignment);
+  uint64_t rounddown_offset =
+      offset - (offset & static_cast<uint64_t>(alignment - 1));
+  uint64_t roundup_end = Roundup(static_cast<size_t>(offset + n), alignment);
+  uint64_t roundup_len = roundup_end - rounddown_offset;
+  RecordUnusedBytes();
   buffer_.Alignment(alignment);
-  buffer_.AllocateNewBuffer(roundup_len);
+  buffer_.AllocateNewBuffer(static_cast<size_t>(roundup_len));
+  buffer_len_ = 0;
+  buffer_bytes_used_ = 0;
 
   Slice result;
-  Status s =
-      reader->Read(roundup_offset, roundup_len, &result, buffer_.BufferStart());
+  Status s = reader->Read(rounddown_offset, static_cast<size_t>(roundup_len),
+                          &result, buffer_.BufferStart());
   if (s.ok()) {
-    buffer_offset_ = roundup_offset;
+    buffer_offset_ = rounddown_offset;
     buffer_len_ = result.size();
+    RecordTick(stats_, PREFETCH_BYTES, buffer_len_);
+  }
+  return s;
+}
+
+Status FilePrefetchBuffer::PrefetchRanges(
+    RandomAccessFileReader* reader,
+    std::vector<std::pair<uint64_t, size_t>> ranges) {
+  std::sort(ranges.begin(), ranges.end());
+  size_t total = 0;
+  for (const auto& range : ranges) {
+    total += range.second;
+  }
+  ranges_.clear();
+  ranges_buf_.reset(new char[total]);
+  std::vector<ReadRequest> reqs(ranges.size());
+  char* scratch = ranges_buf_.get();
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    reqs[i].offset = ranges[i].first;
+    reqs[i].len = ranges[i].second;
+    reqs[i].scratch = scratch;
+    scratch += ranges[i].second;
+  }
+  Status s = reader->MultiRead(reqs.data(), reqs.size());
+  if (!s.ok()) {
+    return s;
+  }
+  // Ranges that failed or were cut short are left to the caller to read
+  for (size_t i = 0; i < reqs.size(); ++i) {
+    if (reqs[i].status.ok() && reqs[i].result.size() == reqs[i].len) {
+      ranges_.emplace_back(reqs[i].offset, reqs[i].result);
+    }
   }
   return s;
 }
 
 bool FilePrefetchBuffer::TryReadFromCache(uint64_t offset, size_t n,
-                                          Slice* result) const {
+                                          Slice* result) {
+  if (!ranges_.empty()) {
+    auto it = std::upper_bound(
+        ranges_.begin(), ranges_.end(), offset,
+        [](uint64_t off, const std::pair<uint64_t, Slice>& range) {
+          return off < range.first;
+        });
+    if (it != ranges_.begin()) {
+      --it;
+      if (offset + n <= it->first + it->second.size()) {
+        *result = Slice(it->second.data() + (offset - it->first), n);
+        return true;
+      }
+    }
+  }
   if (offset < buffer_offset_ || offset + n > buffer_offset_ + buffer_len_) {
-    return false;
+    if (file_reader_ == nullptr || readahead_size_ == 0) {
+      return false;
+    }
+    // A failed prefetch is not an error: the caller reads the block itself
+    Status s = Prefetch(file_reader_, offset, n + readahead_size_);
+    if (!s.ok()) {
+      return false;
+    }
+    readahead_size_ = std::min(max_readahead_size_, readahead_size_ * 2);
+    if (offset + n > buffer_offset_ + buffer_len_) {
+      // End of file
+      return false;
+    }
   }
   uint64_t offset_in_buffer = offset - buffer_offset_;
   *result = Slice(buffer_.BufferStart() + offset_in_buffer, n);
+  buffer_bytes_used_ += n;
   return true;
 }
 
 std::unique_ptr<RandomAccessFile> NewReadaheadRandomAccessFile(
-    std::unique_ptr<RandomAccessFile>&& file, size_t readahead_size) {
+    std::unique_ptr<RandomAccessFile>&& file, size_t readahead_size,
+    bool async) {
   std::unique_ptr<RandomAccessFile> result(
-    new ReadaheadRandomAccessFile(std::move(file), readahead_size));
+    new ReadaheadRandomAccessFile(std::move(file), readahead_size, async));
   return result;
 }
 
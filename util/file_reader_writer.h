@@ -8,7 +8,10 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #pragma once
 #include <atomic>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 #include "port/port.h"
 #include "rocksdb/env.h"
 #include "rocksdb/rate_limiter.h"
@@ -20,8 +23,13 @@ namespace rocksdb {
 class Statistics;
 class HistogramImpl;
 
+// Returns a file that reads readahead_size bytes at a time from file and
+// serves smaller reads from that buffer. With async set, the chunk after
+// the buffer is read in the background once about half of the buffer has
+// been consumed, so that sequential readers do not wait for the disk.
 std::unique_ptr<RandomAccessFile> NewReadaheadRandomAccessFile(
-  std::unique_ptr<RandomAccessFile>&& file, size_t readahead_size);
+  std::unique_ptr<RandomAccessFile>&& file, size_t readahead_size,
+  bool async = false);
 
 class SequentialFileReader {
  private:
@@ -105,6 +113,11 @@ class RandomAccessFileReader {
 
   Status Read(uint64_t offset, size_t n, Slice* result, char* scratch) const;
 
+  // Reads all requests with RandomAccessFile::MultiRead(). With direct I/O,
+  // or when the reads are rate limited, they are done one by one with
+  // Read(), which takes care of alignment and rate limiting.
+  Status MultiRead(ReadRequest* reqs, size_t num_reqs) const;
+
   Status Prefetch(uint64_t offset, size_t n) const {
     return file_->Prefetch(offset, n);
   }
@@ -199,16 +212,49 @@ class WritableFileWriter {
   Status SyncInternal(bool use_fsync);
 };
 
+// FilePrefetchBuffer can automatically do the readahead if file_reader,
+// readahead_size, and max_readahead_size are passed in. A read that misses
+// the buffer then prefetches readahead_size bytes beyond it, and the
+// readahead size doubles on every such miss until it reaches
+// max_readahead_size. If stats is given, the bytes prefetched that way and
+// the bytes that were discarded without being read are recorded in
+// PREFETCH_BYTES and PREFETCH_BYTES_WASTED.
 class FilePrefetchBuffer {
  public:
-  FilePrefetchBuffer() : buffer_offset_(0), buffer_len_(0) {}
+  FilePrefetchBuffer(RandomAccessFileReader* file_reader = nullptr,
+                     size_t readahead_size = 0, size_t max_readahead_size = 0,
+                     Statistics* stats = nullptr)
+      : buffer_offset_(0),
+        buffer_len_(0),
+        buffer_bytes_used_(0),
+        file_reader_(file_reader),
+        readahead_size_(readahead_size),
+        max_readahead_size_(max_readahead_size),
+        stats_(stats) {}
+  ~FilePrefetchBuffer();
   Status Prefetch(RandomAccessFileReader* reader, uint64_t offset, size_t n);
-  bool TryReadFromCache(uint64_t offset, size_t n, Slice* result) const;
+  // Reads the given non-overlapping (offset, length) ranges with a single
+  // RandomAccessFileReader::MultiRead(). TryReadFromCache() then also serves
+  // reads that fall within one of the ranges read successfully.
+  Status PrefetchRanges(RandomAccessFileReader* reader,
+                        std::vector<std::pair<uint64_t, size_t>> ranges);
+  bool TryReadFromCache(uint64_t offset, size_t n, Slice* result);
 
  private:
+  void RecordUnusedBytes();
+
   AlignedBuffer buffer_;
   uint64_t buffer_offset_;
   size_t buffer_len_;
+  // Bytes of the buffer handed out by TryReadFromCache()
+  size_t buffer_bytes_used_;
+  RandomAccessFileReader* file_reader_;
+  size_t readahead_size_;
+  size_t max_readahead_size_;
+  Statistics* stats_;
+  // Data of the ranges read by PrefetchRanges(), sorted by offset
+  std::vector<std::pair<uint64_t, Slice>> ranges_;
+  std::unique_ptr<char[]> ranges_buf_;
 };
 
 extern Status NewWritableFile(Env* env, const std::string& fname,
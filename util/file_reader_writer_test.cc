@@ -5,6 +5,7 @@
 //
 #include "util/file_reader_writer.h"
 #include <algorithm>
+#include <tuple>
 #include <vector>
 #include "util/random.h"
 #include "util/testharness.h"
@@ -217,13 +218,18 @@ TEST_F(WritableFileWriterTest, AppendStatusReturn) {
 
 class ReadaheadRandomAccessFileTest
     : public testing::Test,
-      public testing::WithParamInterface<size_t> {
+      public testing::WithParamInterface<std::tuple<size_t, bool>> {
  public:
-  static std::vector<size_t> GetReadaheadSizeList() {
-    return {1lu << 12, 1lu << 16};
+  static std::vector<std::tuple<size_t, bool>> GetReadaheadSizeList() {
+    // (readahead size, async)
+    return {std::make_tuple(1lu << 12, false),
+            std::make_tuple(1lu << 16, false),
+            std::make_tuple(1lu << 12, true),
+            std::make_tuple(1lu << 16, true)};
   }
   virtual void SetUp() override {
-    readahead_size_ = GetParam();
+    readahead_size_ = std::get<0>(GetParam());
+    async_ = std::get<1>(GetParam());
     scratch_.reset(new char[2 * readahead_size_]);
     ResetSourceStr();
   }
@@ -240,13 +246,14 @@ class ReadaheadRandomAccessFileTest
     write_holder->Flush();
     auto read_holder = std::unique_ptr<RandomAccessFile>(
         new test::StringSource(control_contents_));
-    test_read_holder_ =
-        NewReadaheadRandomAccessFile(std::move(read_holder), readahead_size_);
+    test_read_holder_ = NewReadaheadRandomAccessFile(
+        std::move(read_holder), readahead_size_, async_);
   }
   size_t GetReadaheadSize() const { return readahead_size_; }
 
  private:
   size_t readahead_size_;
+  bool async_;
   Slice control_contents_;
   std::unique_ptr<RandomAccessFile> test_read_holder_;
   std::unique_ptr<char[]> scratch_;
@@ -303,6 +310,32 @@ TEST_P(ReadaheadRandomAccessFileTest, NExceedReadaheadTest) {
   }
 }
 
+TEST_P(ReadaheadRandomAccessFileTest, SequentialReadTest) {
+  Random rng(301);
+  size_t strLen = 10 * GetReadaheadSize() +
+                  rng.Uniform(static_cast<int>(GetReadaheadSize()));
+  std::string str =
+      test::RandomHumanReadableString(&rng, static_cast<int>(strLen));
+  for (int pass = 0; pass < 3; ++pass) {
+    ResetSourceStr(str);
+    // Forward in small steps, as an iterator does, with the occasional jump
+    // that leaves a background readahead behind
+    size_t offset = 0;
+    while (offset < strLen) {
+      size_t n = 1 + rng.Uniform(static_cast<int>(GetReadaheadSize() / 4));
+      ASSERT_EQ(str.substr(offset, std::min(n, str.size() - offset)),
+                Read(offset, n));
+      offset += n;
+      if (pass > 0 && rng.OneIn(20)) {
+        offset = rng.Uniform(static_cast<int>(strLen));
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(
+    SequentialReadTest, ReadaheadRandomAccessFileTest,
+    ::testing::ValuesIn(ReadaheadRandomAccessFileTest::GetReadaheadSizeList()));
 INSTANTIATE_TEST_CASE_P(
     EmptySourceStrTest, ReadaheadRandomAccessFileTest,
     ::testing::ValuesIn(ReadaheadRandomAccessFileTest::GetReadaheadSizeList()));
@@ -10,6 +10,7 @@
 #pragma once
 #include <assert.h>
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include "port/port.h"
@@ -128,4 +129,32 @@ class SpinMutex {
   std::atomic<bool> locked_;
 };
 
+//
+// A fixed number of SpinMutexes, each padded to its own cache line, that
+// latch a larger set of objects. An object is protected by the stripe its
+// hash maps to.
+//
+class StripedSpinMutex {
+ public:
+  explicit StripedSpinMutex(size_t num_stripes)
+      : stripes_(new Stripe[num_stripes]), num_stripes_(num_stripes) {
+    assert(num_stripes > 0);
+  }
+
+  SpinMutex& Get(size_t hash) { return stripes_[hash % num_stripes_].mutex; }
+
+ private:
+  struct Stripe {
+    SpinMutex mutex;
+    char padding[CACHE_LINE_SIZE - sizeof(SpinMutex)];
+  };
+
+  std::unique_ptr<Stripe[]> stripes_;
+  const size_t num_stripes_;
+
+  // No copying allowed
+  StripedSpinMutex(const StripedSpinMutex&) = delete;
+  StripedSpinMutex& operator=(const StripedSpinMutex&) = delete;
+};
+
 }  // namespace rocksdb
@@ -0,0 +1,111 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "util/xor_filter.h"
+
+#include <assert.h>
+#include <algorithm>
+#include <utility>
+
+namespace rocksdb {
+
+bool XorFilter::Build(const std::vector<uint64_t>& key_hashes,
+                      int fingerprint_bits, uint8_t* seed, std::string* dst) {
+  assert(fingerprint_bits >= kMinFingerprintBits &&
+         fingerprint_bits <= kMaxFingerprintBits);
+  const size_t num_keys = key_hashes.size();
+  const uint32_t segment_length = SegmentLength(num_keys);
+  const size_t num_slots = static_cast<size_t>(segment_length) * 3;
+  const uint64_t mask = FingerprintMask(fingerprint_bits);
+
+  std::vector<uint32_t> counts(num_slots);
+  std::vector<uint64_t> xors(num_slots);
+  std::vector<uint32_t> queue;
+  // (seeded hash, slot) in the order the keys were peeled off
+  std::vector<std::pair<uint64_t, uint32_t>> stack;
+  queue.reserve(num_slots);
+  stack.reserve(num_keys);
+  uint32_t slots[3];
+
+  for (int s = 0; s < kMaxSeeds; ++s) {
+    const uint8_t try_seed = static_cast<uint8_t>(s);
+    std::fill(counts.begin(), counts.end(), 0);
+    std::fill(xors.begin(), xors.end(), 0);
+    queue.clear();
+    stack.clear();
+
+    for (uint64_t key_hash : key_hashes) {
+      uint64_t h = SeededHash(key_hash, try_seed);
+      Slots(h, segment_length, slots);
+      for (int i = 0; i < 3; ++i) {
+        counts[slots[i]]++;
+        xors[slots[i]] ^= h;
+      }
+    }
+
+    // Peel off keys that are alone in one of their slots, until there are
+    // none left. The keys of a slot with count 1 are given by the xor of
+    // their hashes.
+    for (uint32_t i = 0; i < num_slots; ++i) {
+      if (counts[i] == 1) {
+        queue.push_back(i);
+      }
+    }
+    while (!queue.empty()) {
+      uint32_t slot = queue.back();
+      queue.pop_back();
+      if (counts[slot] != 1) {
+        continue;
+      }
+      uint64_t h = xors[slot];
+      stack.emplace_back(h, slot);
+      Slots(h, segment_length, slots);
+      for (int i = 0; i < 3; ++i) {
+        counts[slots[i]]--;
+        xors[slots[i]] ^= h;
+        if (counts[slots[i]] == 1) {
+          queue.push_back(slots[i]);
+        }
+      }
+    }
+    if (stack.size() != num_keys) {
+      // The remaining keys form a cycle; try another hash function
+      continue;
+    }
+
+    // Assign the fingerprints in reverse peeling order, so that the slot of
+    // each key is free to be set when its turn comes and the other two are
+    // final.
+    std::vector<uint64_t> values(num_slots, 0);
+    for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+      uint64_t h = it->first;
+      Slots(h, segment_length, slots);
+      values[it->second] = (Fingerprint(h) ^ values[slots[0]] ^
+                            values[slots[1]] ^ values[slots[2]]) &
+                           mask;
+    }
+
+    // Pack them, with room for the 8-byte read-modify-write at the end
+    const uint32_t fingerprint_bytes =
+        DataLength(segment_length, fingerprint_bits) - kSegmentLengthBytes;
+    std::string packed(fingerprint_bytes + sizeof(uint64_t), '\0');
+    char* data = &packed[0];
+    for (size_t i = 0; i < num_slots; ++i) {
+      uint64_t bitpos = static_cast<uint64_t>(i) * fingerprint_bits;
+      char* word = data + (bitpos >> 3);
+      EncodeFixed64(word,
+                    DecodeFixed64(word) | (values[i] << (bitpos & 7)));
+    }
+    packed.resize(fingerprint_bytes);
+
+    dst->append(packed);
+    PutFixed32(dst, segment_length);
+    *seed = try_seed;
+    return true;
+  }
+  return false;
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,141 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+// Static xor filter (Graf and Lemire, "Xor Filters: Faster and Smaller Than
+// Bloom and Cuckoo Filters"), used by NewXorFilterPolicy() for full and
+// partitioned filter blocks.
+//
+// Every key is hashed to three slots, one in each third of a table of r-bit
+// fingerprints, and the table is solved such that the xor of the three slots
+// equals the fingerprint of the key. A query for a key that was not added
+// matches with probability 2^-r. The table has 1.23 slots per key, so a
+// filter takes about 1.23 * r bits per key, against about 1.44 * r for a
+// Bloom filter with the same false positive rate.
+//
+// Unlike a Bloom filter, the table can only be built once all keys are
+// known, which is the case for the filters of a table file.
+//
+// Layout of the filter data, not including the 5-byte metadata trailer of
+// full filters (see util/bloom.cc):
+// +----------------------------------------------------------------+
+// | 3 * segment_length fingerprints of r bits each, packed          |
+// | little-endian and padded to a byte                              |
+// +----------------------------------------------------------------+
+// | segment_length : fixed32                                        |
+// +----------------------------------------------------------------+
+// The metadata trailer holds r and the seed of the hash function. The
+// segment length and the trailer together make up more than 7 bytes, so a
+// fingerprint can always be read with one 8-byte load.
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "util/coding.h"
+#include "util/hash.h"
+
+namespace rocksdb {
+
+class XorFilter {
+ public:
+  static const int kMinFingerprintBits = 1;
+  static const int kMaxFingerprintBits = 32;
+  // Number of seeds tried before giving up on building a filter. Building
+  // fails with a probability well below 10% per seed, so this is never
+  // reached in practice.
+  static const int kMaxSeeds = 64;
+  // Bytes between the fingerprints and the metadata trailer
+  static const uint32_t kSegmentLengthBytes = 4;
+
+  // 64-bit hash of a key, so that the false positive rate does not suffer
+  // from hash collisions even for very large filters
+  static inline uint64_t KeyHash(const Slice& key) {
+    return (static_cast<uint64_t>(BloomHash(key)) << 32) |
+           Hash(key.data(), key.size(), 0x3ad24a5b);
+  }
+
+  // Number of slots in each of the three segments for num_keys keys
+  static uint32_t SegmentLength(size_t num_keys) {
+    uint64_t capacity =
+        32 + (static_cast<uint64_t>(num_keys) * 123 + 99) / 100;
+    return static_cast<uint32_t>((capacity + 2) / 3);
+  }
+
+  // Bytes taken by the fingerprints and the segment length, without the
+  // metadata trailer
+  static uint32_t DataLength(uint32_t segment_length, int fingerprint_bits) {
+    uint64_t bits = static_cast<uint64_t>(segment_length) * 3 *
+                    static_cast<uint64_t>(fingerprint_bits);
+    return static_cast<uint32_t>((bits + 7) / 8) + kSegmentLengthBytes;
+  }
+
+  // Solves the table for the given distinct key hashes and appends the
+  // fingerprints and the segment length to *dst. Returns false if no seed
+  // below kMaxSeeds worked, in which case *dst is left unchanged.
+  static bool Build(const std::vector<uint64_t>& key_hashes,
+                    int fingerprint_bits, uint8_t* seed, std::string* dst);
+
+  // data[0, len) is what Build() appended
+  static inline bool MayMatch(uint64_t key_hash, const char* data,
+                              uint32_t segment_length, int fingerprint_bits,
+                              uint8_t seed) {
+    uint64_t h = SeededHash(key_hash, seed);
+    uint32_t slots[3];
+    Slots(h, segment_length, slots);
+    uint64_t mask = FingerprintMask(fingerprint_bits);
+    uint64_t f = Fingerprint(h) ^ Get(data, slots[0], fingerprint_bits) ^
+                 Get(data, slots[1], fingerprint_bits) ^
+                 Get(data, slots[2], fingerprint_bits);
+    return (f & mask) == 0;
+  }
+
+ private:
+  static inline uint64_t SeededHash(uint64_t key_hash, uint8_t seed) {
+    // murmur3 fmix64, a bijection, so distinct key hashes stay distinct
+    uint64_t h = key_hash + (seed + 1) * 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  // Maps x to [0, n) without a division
+  static inline uint32_t Reduce(uint32_t x, uint32_t n) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(x) * n) >> 32);
+  }
+
+  static inline uint64_t Rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+  }
+
+  static inline void Slots(uint64_t h, uint32_t segment_length,
+                           uint32_t* slots) {
+    slots[0] = Reduce(static_cast<uint32_t>(h), segment_length);
+    slots[1] = Reduce(static_cast<uint32_t>(Rotl(h, 21)), segment_length) +
+               segment_length;
+    slots[2] = Reduce(static_cast<uint32_t>(Rotl(h, 42)), segment_length) +
+               2 * segment_length;
+  }
+
+  static inline uint64_t Fingerprint(uint64_t h) { return h ^ (h >> 32); }
+
+  static inline uint64_t FingerprintMask(int fingerprint_bits) {
+    return (uint64_t{1} << fingerprint_bits) - 1;
+  }
+
+  // The fingerprint in slot, not masked
+  static inline uint64_t Get(const char* data, uint32_t slot,
+                             int fingerprint_bits) {
+    uint64_t bitpos = static_cast<uint64_t>(slot) * fingerprint_bits;
+    return DecodeFixed64(data + (bitpos >> 3)) >> (bitpos & 7);
+  }
+};
+
+}  // namespace rocksdb
@@ -957,7 +957,8 @@ Slice BlobDBImpl::GetCompressedSlice(const Slice& raw,
   CompressionType ct = bdb_options_.compression;
   CompressionOptions compression_opts;
   CompressBlock(raw, compression_opts, &ct, kBlockBasedTableVersionFormat,
-                Slice(), compression_output);
+                CompressionDict::GetEmptyDict(), nullptr /* compression_ctx */,
+                compression_output);
   return *compression_output;
 }
 
@@ -1248,8 +1249,8 @@ Status BlobDBImpl::GetBlobValue(const Slice& key, const Slice& index_entry,
                                  BLOB_DB_DECOMPRESSION_MICROS);
       s = UncompressBlockContentsForCompressionType(
           blob_value.data(), blob_value.size(), &contents,
-          kBlockBasedTableVersionFormat, Slice(), bfile->compression(),
-          *(cfh->cfd()->ioptions()));
+          kBlockBasedTableVersionFormat, UncompressionDict::GetEmptyDict(),
+          bfile->compression(), *(cfh->cfd()->ioptions()));
     }
     *(value->GetSelf()) = contents.data.ToString();
   }
@@ -229,8 +229,8 @@ Status CheckpointImpl::CreateCustomCheckpoint(
       s = Status::Corruption("Can't parse file name. This is very bad");
       break;
     }
-    // we should only get sst, options, manifest and current files here
-    assert(type == kTableFile || type == kDescriptorFile ||
+    // we should only get sst, blob, options, manifest and current files here
+    assert(type == kTableFile || type == kBlobFile || type == kDescriptorFile ||
            type == kCurrentFile || type == kOptionsFile);
     assert(live_files[i].size() > 0 && live_files[i][0] == '/');
     if (type == kCurrentFile) {
@@ -245,17 +245,18 @@ Status CheckpointImpl::CreateCustomCheckpoint(
     std::string src_fname = live_files[i];
 
     // rules:
-    // * if it's kTableFile, then it's shared
+    // * if it's kTableFile or kBlobFile, then it's shared
     // * if it's kDescriptorFile, limit the size to manifest_file_size
     // * always copy if cross-device link
-    if ((type == kTableFile) && same_fs) {
+    const bool is_shared = type == kTableFile || type == kBlobFile;
+    if (is_shared && same_fs) {
       s = link_file_cb(db_->GetName(), src_fname, type);
       if (s.IsNotSupported()) {
         same_fs = false;
         s = Status::OK();
       }
     }
-    if ((type != kTableFile) || (!same_fs)) {
+    if (!is_shared || !same_fs) {
       s = copy_file_cb(db_->GetName(), src_fname,
                        (type == kDescriptorFile) ? manifest_file_size : 0,
                        type);
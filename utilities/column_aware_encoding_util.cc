@@ -80,7 +80,6 @@ void ColumnAwareEncodingReader::DecodeBlocks(
 
     auto& slice_final_with_bit = block;
     uint32_t format_version = 2;
-    Slice compression_dict;
     BlockContents contents;
     const char* content_ptr;
 
@@ -89,7 +88,8 @@ void ColumnAwareEncodingReader::DecodeBlocks(
     if (type != kNoCompression) {
       UncompressBlockContents(slice_final_with_bit.c_str(),
                               slice_final_with_bit.size() - 1, &contents,
-                              format_version, compression_dict, ioptions);
+                              format_version,
+                              UncompressionDict::GetEmptyDict(), ioptions);
       content_ptr = contents.data.data();
     } else {
       content_ptr = slice_final_with_bit.data();
@@ -162,7 +162,6 @@ void ColumnAwareEncodingReader::DecodeBlocksFromRowFormat(
   for (auto& block : *blocks) {
     auto& slice_final_with_bit = block;
     uint32_t format_version = 2;
-    Slice compression_dict;
     BlockContents contents;
     std::string decoded_content;
 
@@ -171,7 +170,8 @@ void ColumnAwareEncodingReader::DecodeBlocksFromRowFormat(
     if (type != kNoCompression) {
       UncompressBlockContents(slice_final_with_bit.c_str(),
                               slice_final_with_bit.size() - 1, &contents,
-                              format_version, compression_dict, ioptions);
+                              format_version,
+                              UncompressionDict::GetEmptyDict(), ioptions);
       decoded_content = std::string(contents.data.data(), contents.data.size());
     } else {
       decoded_content = std::move(slice_final_with_bit);
@@ -242,10 +242,10 @@ void CompressDataBlock(const std::string& output_content, Slice* slice_final,
                        CompressionType* type, std::string* compressed_output) {
   CompressionOptions compression_opts;
   uint32_t format_version = 2;  // hard-coded version
-  Slice compression_dict;
-  *slice_final =
-      CompressBlock(output_content, compression_opts, type, format_version,
-                    compression_dict, compressed_output);
+  *slice_final = CompressBlock(output_content, compression_opts, type,
+                               format_version, CompressionDict::GetEmptyDict(),
+                               nullptr /* compression_ctx */,
+                               compressed_output);
 }
 
 }  // namespace
@@ -1912,6 +1912,15 @@ TEST_P(TransactionTest, WriteConflictTest) {
   s = db->Put(write_options, "foo", "xxx");
   ASSERT_TRUE(s.IsTimedOut());
 
+  // So will an async write
+  WriteBatch batch;
+  batch.Put("foo", "xxx");
+  Status async_status;
+  s = db->WriteAsync(write_options, &batch,
+                     [&](const Status& status) { async_status = status; });
+  ASSERT_OK(s);
+  ASSERT_TRUE(async_status.IsTimedOut());
+
   s = db->Get(read_options, "foo", &value);
   ASSERT_EQ(value, "A");
 